@@ -6,6 +6,7 @@ extern "C" {
 #endif
 
 #include <stddef.h>
+#include <stdint.h>
 
 /* These rules specify the order of arguments in API calls:
  *
@@ -56,6 +57,15 @@ typedef struct rustsecp256k1zkp_v0_5_0_context_struct rustsecp256k1zkp_v0_5_0_co
  */
 typedef struct rustsecp256k1zkp_v0_5_0_scratch_space_struct rustsecp256k1zkp_v0_5_0_scratch_space;
 
+/** Opaque data structure that holds precomputed multiples of a public key
+ *
+ *  It is created in caller-provided memory by
+ *  rustsecp256k1zkp_v0_5_0_point_table_preallocated_create and makes multiplying the
+ *  public key by many scalars much faster than rustsecp256k1zkp_v0_5_0_ec_pubkey_tweak_mul.
+ *  It is never modified after creation and can be shared between threads.
+ */
+typedef struct rustsecp256k1zkp_v0_5_0_point_table_struct rustsecp256k1zkp_v0_5_0_point_table;
+
 /** Opaque data structure that holds a parsed and valid public key.
  *
  *  The exact representation of data inside is implementation defined and not
@@ -106,6 +116,36 @@ typedef int (*rustsecp256k1zkp_v0_5_0_nonce_function)(
     unsigned int attempt
 );
 
+/** A pointer to a function that runs a number of tasks, for example on a pool
+ *  of worker threads. The library itself never creates threads.
+ *
+ *  The function must call task(task_data, i) exactly once for every i from 0
+ *  to n_tasks - 1 and return only after all of these calls have returned. The
+ *  calls may run concurrently and in any order.
+ *
+ * In:      task:      the task to run (will not be NULL)
+ *          task_data: pointer to pass to every call of task
+ *          n_tasks:   number of tasks to run
+ *          data:      Arbitrary data pointer that is passed through.
+ */
+typedef void (*rustsecp256k1zkp_v0_5_0_task_runner)(
+    void (*task)(void *task_data, size_t i),
+    void *task_data,
+    size_t n_tasks,
+    void *data
+);
+
+/** A pointer to a function that reads a clock, used to measure how long
+ *  computations take.
+ *
+ *  Returns: the current time in any fixed unit not coarser than a microsecond,
+ *           for example nanoseconds of a monotonic clock.
+ *  In:      data: Arbitrary data pointer that is passed through.
+ */
+typedef uint64_t (*rustsecp256k1zkp_v0_5_0_timer)(
+    void *data
+);
+
 # if !defined(SECP256K1_GNUC_PREREQ)
 #  if defined(__GNUC__)&&defined(__GNUC_MINOR__)
 #   define SECP256K1_GNUC_PREREQ(_maj,_min) \
@@ -309,6 +349,35 @@ SECP256K1_API void rustsecp256k1zkp_v0_5_0_context_set_error_callback(
  *          scratch: space to destroy
  */
 
+/** Measure on the running CPU which multi-scalar multiplication algorithm is
+ *  fastest for each number of points, and use it with a scratch space.
+ *
+ *  Functions given a scratch space choose between Strauss' algorithm and two
+ *  kernels of Pippenger's algorithm, and the bucket window of the latter, by
+ *  the number of points they multiply at once. By default these choices follow
+ *  measurements taken on other hardware. This function times every algorithm
+ *  and bucket window in the scratch space and makes all later functions using
+ *  this scratch space choose by these timings. The choices are kept with the
+ *  scratch space, so every scratch space has to be calibrated on its own.
+ *
+ *  Calibration takes around a second with a scratch space of a few megabytes,
+ *  and less with smaller ones, which cannot fit the largest bucket windows.
+ *
+ *  Returns: 1 if the scratch space has been calibrated.
+ *           0 if it is too small to multiply any points with Pippenger's
+ *           algorithm, in which case it is left unchanged.
+ *  Args:       ctx: a secp256k1 context object, initialized for verification.
+ *          scratch: the scratch space to calibrate.
+ *  In:       timer: clock to measure the algorithms with (cannot be NULL)
+ *       timer_data: arbitrary data pointer passed to the timer (can be NULL)
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_scratch_space_calibrate(
+    const rustsecp256k1zkp_v0_5_0_context* ctx,
+    rustsecp256k1zkp_v0_5_0_scratch_space* scratch,
+    rustsecp256k1zkp_v0_5_0_timer timer,
+    void *timer_data
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
 /** Parse a variable-length public key into the pubkey object.
  *
  *  Returns: 1 if the public key was fully valid.
@@ -700,6 +769,38 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_ec_pubkey
     const unsigned char *tweak32
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
 
+/** Multiply the public key of a point table by a scalar, in constant time.
+ *
+ *  Computes the same as rustsecp256k1zkp_v0_5_0_ec_pubkey_tweak_mul, with one point
+ *  addition per window of the table and no point doublings.
+ *
+ *  Returns: 0 if the arguments are invalid. 1 otherwise.
+ *  Args:    ctx:   pointer to a context object (cannot be NULL).
+ *  Out:  pubkey:   pointer to a public key object for the product. It will be
+ *                  set to an invalid value if this function returns 0 (cannot
+ *                  be NULL).
+ *  In:    table:   point table created for the public key to multiply (cannot
+ *                  be NULL).
+ *      scalar32:   pointer to a 32-byte scalar. If the scalar is invalid
+ *                  according to rustsecp256k1zkp_v0_5_0_ec_seckey_verify, this function
+ *                  returns 0 (cannot be NULL).
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_point_table_mul(
+    const rustsecp256k1zkp_v0_5_0_context* ctx,
+    rustsecp256k1zkp_v0_5_0_pubkey *pubkey,
+    const rustsecp256k1zkp_v0_5_0_point_table *table,
+    const unsigned char *scalar32
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
+/** Same as rustsecp256k1zkp_v0_5_0_point_table_mul, but in variable time. Only use it with
+ *  scalars that are not secret, e.g. when verifying. */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_point_table_mul_var(
+    const rustsecp256k1zkp_v0_5_0_context* ctx,
+    rustsecp256k1zkp_v0_5_0_pubkey *pubkey,
+    const rustsecp256k1zkp_v0_5_0_point_table *table,
+    const unsigned char *scalar32
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
 /** Updates the context randomization to protect against side-channel leakage.
  *  Returns: 1: randomization successfully updated or nothing to randomize
  *           0: error
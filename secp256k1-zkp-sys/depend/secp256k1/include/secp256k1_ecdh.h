@@ -55,6 +55,35 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_ecdh(
   void *data
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
 
+/** Compute the EC Diffie-Hellman secrets of one secret key with many public keys in constant time
+ *
+ *  Returns: 1: exponentiation was successful
+ *           0: scalar was invalid (zero or overflow), a public key could not be loaded or hashfp returned 0
+ *  Args:    ctx:        pointer to a context object (cannot be NULL)
+ *  Out:     output:     pointer to an array of n_pubkeys * outputlen bytes. The output of hashfp for
+ *                       pubkeys[i] is written to output + i * outputlen.
+ *  In:      outputlen:  number of bytes reserved for each output, must be at least 32 if hashfp is NULL
+ *           pubkeys:    pointer to an array of n_pubkeys initialized public keys
+ *           n_pubkeys:  number of public keys
+ *           seckey:     a 32-byte scalar with which to multiply the points
+ *           hashfp:     pointer to a hash function. If NULL, rustsecp256k1zkp_v0_5_0_ecdh_hash_function_sha256 is used
+ *                       (in which case, 32 bytes will be written to each output)
+ *           data:       arbitrary data pointer that is passed through to hashfp
+ *
+ *  The result is the same as calling rustsecp256k1zkp_v0_5_0_ecdh for every public key, but the shared points are
+ *  converted to affine coordinates in batches with a single field inversion each.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_ecdh_batch(
+  const rustsecp256k1zkp_v0_5_0_context* ctx,
+  unsigned char *output,
+  size_t outputlen,
+  const rustsecp256k1zkp_v0_5_0_pubkey *pubkeys,
+  size_t n_pubkeys,
+  const unsigned char *seckey,
+  rustsecp256k1zkp_v0_5_0_ecdh_hash_function hashfp,
+  void *data
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(6);
+
 #ifdef __cplusplus
 }
 #endif
@@ -96,6 +96,28 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_ecdsa_s2c
     const rustsecp256k1zkp_v0_5_0_ecdsa_s2c_opening *opening
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
 
+/** Verify a batch of sign-to-contract commitments.
+ *
+ *  Returns: 1: every signature contains a commitment to its data32 (or the batch is empty)
+ *           0: at least one opening is incorrect
+ *  Args:    ctx: a secp256k1 context object, initialized for verification.
+ *  In:     sigs: array of pointers to the signatures (cannot be NULL unless n_sigs is 0)
+ *        data32: array of pointers to the 32-byte data committed to (cannot be NULL
+ *                unless n_sigs is 0)
+ *      openings: array of pointers to the openings created during signing (cannot be
+ *                NULL unless n_sigs is 0)
+ *        n_sigs: number of signatures
+ *
+ *  Equivalent to calling rustsecp256k1zkp_v0_5_0_ecdsa_s2c_verify_commit for every signature.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_ecdsa_s2c_verify_commit_batch(
+    const rustsecp256k1zkp_v0_5_0_context* ctx,
+    const rustsecp256k1zkp_v0_5_0_ecdsa_signature *const *sigs,
+    const unsigned char *const *data32,
+    const rustsecp256k1zkp_v0_5_0_ecdsa_s2c_opening *const *openings,
+    size_t n_sigs
+) SECP256K1_ARG_NONNULL(1);
+
 
 /** ECDSA Anti-Exfil Protocol
  *
@@ -227,6 +249,38 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_anti_exfi
     const rustsecp256k1zkp_v0_5_0_ecdsa_s2c_opening *opening
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(5) SECP256K1_ARG_NONNULL(6);
 
+/** Verify a batch of signatures made with the ECDSA Anti-Exfil Protocol, e.g. for
+ *  all inputs of a transaction.
+ *
+ *  Returns: 1: every signature is valid and contains a commitment to its host_data32
+ *              (or the batch is empty)
+ *           0: at least one signature or opening is incorrect
+ *  Args:    ctx: a secp256k1 context object, initialized for verification.
+ *  In:     sigs: array of pointers to the signatures produced by the signer (cannot be
+ *                NULL unless n_sigs is 0)
+ *     msghash32: array of pointers to the 32-byte message hashes being verified (cannot
+ *                be NULL unless n_sigs is 0)
+ *       pubkeys: array of pointers to the signer's public keys (cannot be NULL unless
+ *                n_sigs is 0)
+ *   host_data32: array of pointers to the 32-byte data provided by the host (cannot be
+ *                NULL unless n_sigs is 0)
+ *      openings: array of pointers to the s2c openings provided by the signer (cannot be
+ *                NULL unless n_sigs is 0)
+ *        n_sigs: number of signatures
+ *
+ *  Equivalent to calling rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify for every signature. All
+ *  commitments are checked before any signature is verified.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify_batch(
+    const rustsecp256k1zkp_v0_5_0_context* ctx,
+    const rustsecp256k1zkp_v0_5_0_ecdsa_signature *const *sigs,
+    const unsigned char *const *msghash32,
+    const rustsecp256k1zkp_v0_5_0_pubkey *const *pubkeys,
+    const unsigned char *const *host_data32,
+    const rustsecp256k1zkp_v0_5_0_ecdsa_s2c_opening *const *openings,
+    size_t n_sigs
+) SECP256K1_ARG_NONNULL(1);
+
 #ifdef __cplusplus
 }
 #endif
@@ -151,6 +151,41 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_xonly_pub
     const unsigned char *tweak32
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(5);
 
+/** Checks a batch of tweaked x-only public keys, e.g. all Taproot outputs of a
+ *  block, at once.
+ *
+ *  All checks are combined with random weights into a single multi-scalar
+ *  multiplication, which is faster than rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check
+ *  for each of them. The randomizers are derived from a hash of all inputs.
+ *
+ *  Returns: 1 if every tweaked pubkey is the result of tweaking its internal
+ *           pubkey with its tweak (or the batch is empty). 0 if the arguments
+ *           are invalid or at least one check fails, in which case the failing
+ *           checks have to be found with rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check.
+ *  Args:            ctx: pointer to a context object initialized for verification
+ *                        (cannot be NULL)
+ *               scratch: scratch space used for the multi-multiplication. If
+ *                        NULL, the points are multiplied one at a time.
+ *  In: tweaked_pubkey32: array of pointers to serialized xonly_pubkeys (cannot be
+ *                        NULL unless n_checks is 0)
+ *     tweaked_pk_parity: array of the parities of the tweaked pubkeys, each 0 or 1
+ *                        (cannot be NULL unless n_checks is 0)
+ *       internal_pubkey: array of pointers to the x-only public key objects the
+ *                        tweaks are applied to (cannot be NULL unless n_checks is 0)
+ *               tweak32: array of pointers to 32-byte tweaks (cannot be NULL unless
+ *                        n_checks is 0)
+ *              n_checks: number of tweaked pubkeys to check
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(
+    const rustsecp256k1zkp_v0_5_0_context* ctx,
+    rustsecp256k1zkp_v0_5_0_scratch_space *scratch,
+    const unsigned char *const *tweaked_pubkey32,
+    const int *tweaked_pk_parity,
+    const rustsecp256k1zkp_v0_5_0_xonly_pubkey *const *internal_pubkey,
+    const unsigned char *const *tweak32,
+    size_t n_checks
+) SECP256K1_ARG_NONNULL(1);
+
 /** Compute the keypair for a secret key.
  *
  *  Returns: 1: secret was valid, keypair is ready to use
@@ -136,6 +136,19 @@ typedef struct {
     unsigned char data[32];
 } rustsecp256k1zkp_v0_5_0_musig_partial_signature;
 
+/** Opaque data structure that caches the key aggregation data of one signer:
+ *  its MuSig coefficient and precomputed odd multiples of its public key.
+ *
+ *  The exact representation of data inside is implementation defined and not
+ *  guaranteed to be portable between different platforms or versions. It is
+ *  however guaranteed to be 580 bytes in size, and can be safely copied/moved.
+ *  It is created by `musig_keyagg_cache_init` and used by
+ *  `musig_partial_sig_verify_cached`.
+ */
+typedef struct {
+    unsigned char data[580];
+} rustsecp256k1zkp_v0_5_0_musig_keyagg_signer;
+
 /** Computes a combined public key and the hash of the given public keys.
  *  Different orders of `pubkeys` result in different `combined_pk`s.
  *
@@ -161,6 +174,40 @@ SECP256K1_API int rustsecp256k1zkp_v0_5_0_musig_pubkey_combine(
     size_t n_pubkeys
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(5);
 
+/** Computes a combined public key like `musig_pubkey_combine` and caches the
+ *  key aggregation data of every signer.
+ *
+ *  For a signer set that signs many messages, the cache is computed once and
+ *  then passed to `musig_partial_sig_verify_cached`, which avoids hashing the
+ *  MuSig coefficient and precomputing a multiplication table for the signer's
+ *  public key on every verification. The cache does not depend on the tweak,
+ *  so it can also be used with sessions whose pre_session was tweaked with
+ *  `musig_pubkey_tweak_add`.
+ *
+ *  Returns: 1 if the public keys were successfully combined, 0 otherwise
+ *  Args:        ctx: pointer to a context object initialized for verification
+ *                    (cannot be NULL)
+ *           scratch: scratch space used to compute the combined pubkey by
+ *                    multiexponentiation. If NULL, an inefficient algorithm is used.
+ *  Out: combined_pk: the MuSig-combined xonly public key (cannot be NULL)
+ *       pre_session: pointer to a musig_pre_session struct to be used in
+ *                    `musig_session_init` or `musig_pubkey_tweak_add` (cannot
+ *                    be NULL)
+ *           signers: array of n_pubkeys entries receiving the cached data of
+ *                    each signer, in the order of pubkeys (cannot be NULL)
+ *   In:     pubkeys: input array of public keys to combine (cannot be NULL)
+ *         n_pubkeys: length of pubkeys array. Must be greater than 0.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_musig_keyagg_cache_init(
+    const rustsecp256k1zkp_v0_5_0_context* ctx,
+    rustsecp256k1zkp_v0_5_0_scratch_space *scratch,
+    rustsecp256k1zkp_v0_5_0_xonly_pubkey *combined_pk,
+    rustsecp256k1zkp_v0_5_0_musig_pre_session *pre_session,
+    rustsecp256k1zkp_v0_5_0_musig_keyagg_signer *signers,
+    const rustsecp256k1zkp_v0_5_0_xonly_pubkey *pubkeys,
+    size_t n_pubkeys
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(5) SECP256K1_ARG_NONNULL(6);
+
 /** Tweak an x-only public key by adding the generator multiplied with tweak32
  *  to it. The resulting output_pubkey with the given internal_pubkey and tweak
  *  passes `rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_test`.
@@ -417,6 +464,77 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_musig_par
     const rustsecp256k1zkp_v0_5_0_xonly_pubkey *pubkey
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(5);
 
+/** Checks that an individual partial signature verifies, like
+ *  `musig_partial_sig_verify`, using cached key aggregation data instead of
+ *  the signer's public key.
+ *
+ *  Returns: 1: partial signature verifies
+ *           0: invalid signature or bad data
+ *  Args:          ctx: pointer to a context object initialized for
+ *                      verification (cannot be NULL)
+ *             session: active session for which the combined nonce has been
+ *                      computed (cannot be NULL)
+ *              signer: data for the signer who produced this signature (cannot
+ *                      be NULL)
+ *  In:    partial_sig: signature to verify (cannot be NULL)
+ *       keyagg_signer: the entry for this signer computed by
+ *                      `musig_keyagg_cache_init` for the keys of the session
+ *                      (cannot be NULL)
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(
+    const rustsecp256k1zkp_v0_5_0_context* ctx,
+    const rustsecp256k1zkp_v0_5_0_musig_session *session,
+    const rustsecp256k1zkp_v0_5_0_musig_session_signer_data *signer,
+    const rustsecp256k1zkp_v0_5_0_musig_partial_signature *partial_sig,
+    const rustsecp256k1zkp_v0_5_0_musig_keyagg_signer *keyagg_signer
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(5);
+
+/** Checks that many partial signatures verify, using one multi-scalar
+ *  multiplication over random linear combinations of their verification
+ *  equations.
+ *
+ *  The signatures can belong to one or many sessions. If the batch does not
+ *  verify, every signature is checked on its own to find the invalid ones.
+ *  Either `pubkeys` or `keyagg_signers` must be given; the latter saves
+ *  hashing the MuSig coefficient of each signer.
+ *
+ *  Returns: 1: all partial signatures verify (also when n_sigs is 0)
+ *           0: at least one signature is invalid, or bad data
+ *  Args:           ctx: pointer to a context object initialized for
+ *                       verification (cannot be NULL)
+ *              scratch: scratch space used for the multi-multiplication (can
+ *                       be NULL, in which case the points are multiplied one
+ *                       at a time)
+ *  Out:        invalid: if non-NULL, an array of n_sigs entries receiving the
+ *                       positions in the batch of the invalid signatures in
+ *                       ascending order, when 0 is returned
+ *            n_invalid: number of positions written to invalid (can be NULL
+ *                       if invalid is NULL)
+ *  In:        sessions: array of pointers to the session of each signature,
+ *                       for which the combined nonce has been computed
+ *              signers: array of pointers to the data of the signer who
+ *                       produced each signature
+ *         partial_sigs: array of pointers to the signatures to verify
+ *              pubkeys: array of pointers to the public keys of the signers,
+ *                       or NULL if keyagg_signers is given
+ *       keyagg_signers: array of pointers to the entries of the signers
+ *                       computed by `musig_keyagg_cache_init`, or NULL if
+ *                       pubkeys is given
+ *               n_sigs: number of signatures in the arrays
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch(
+    const rustsecp256k1zkp_v0_5_0_context* ctx,
+    rustsecp256k1zkp_v0_5_0_scratch_space *scratch,
+    size_t *invalid,
+    size_t *n_invalid,
+    const rustsecp256k1zkp_v0_5_0_musig_session *const *sessions,
+    const rustsecp256k1zkp_v0_5_0_musig_session_signer_data *const *signers,
+    const rustsecp256k1zkp_v0_5_0_musig_partial_signature *const *partial_sigs,
+    const rustsecp256k1zkp_v0_5_0_xonly_pubkey *const *pubkeys,
+    const rustsecp256k1zkp_v0_5_0_musig_keyagg_signer *const *keyagg_signers,
+    size_t n_sigs
+) SECP256K1_ARG_NONNULL(1);
+
 /** Combines partial signatures
  *
  *  Returns: 1: all partial signatures have values in range. Does NOT mean the
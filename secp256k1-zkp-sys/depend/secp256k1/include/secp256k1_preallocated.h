@@ -121,6 +121,92 @@ SECP256K1_API void rustsecp256k1zkp_v0_5_0_context_preallocated_destroy(
     rustsecp256k1zkp_v0_5_0_context* ctx
 );
 
+/** Determine the memory size of a scratch space object to be created in
+ *  caller-provided memory.
+ *
+ *  Returns: the required size of the caller-provided memory block.
+ *  In:      size: amount of memory to be available as scratch space.
+ */
+SECP256K1_API size_t rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_size(
+    size_t size
+) SECP256K1_WARN_UNUSED_RESULT;
+
+/** Create a scratch space object in caller-provided memory.
+ *
+ *  The caller must ensure that the memory remains valid and is not used for
+ *  anything else until the scratch space has been destroyed. A scratch space
+ *  can be reused by any number of calls, but not by concurrent ones.
+ *
+ *  Returns: a newly created scratch space.
+ *  Args:      ctx: an existing context object (cannot be NULL)
+ *  In:   prealloc: a pointer to a rewritable contiguous block of memory of
+ *                  size at least rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_size(size)
+ *                  bytes, suitably aligned to hold an object of any type
+ *                  (cannot be NULL)
+ *            size: amount of memory to be available as scratch space.
+ */
+SECP256K1_API rustsecp256k1zkp_v0_5_0_scratch_space* rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_create(
+    const rustsecp256k1zkp_v0_5_0_context* ctx,
+    void* prealloc,
+    size_t size
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_WARN_UNUSED_RESULT;
+
+/** Destroy a scratch space object that has been created in caller-provided
+ *  memory.
+ *
+ *  The scratch space pointer may not be used afterwards. It is the
+ *  responsibility of the caller to deallocate the block of memory.
+ *
+ *  Args:     ctx: a secp256k1 context object.
+ *        scratch: space to destroy, constructed using
+ *                 rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_create
+ */
+SECP256K1_API void rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_destroy(
+    const rustsecp256k1zkp_v0_5_0_context* ctx,
+    rustsecp256k1zkp_v0_5_0_scratch_space* scratch
+) SECP256K1_ARG_NONNULL(1);
+
+/** Determine the memory size of a point table to be created in caller-provided
+ *  memory.
+ *
+ *  A point table splits scalars into windows of a given number of bits and
+ *  holds one multiple of the public key for every value of every window, i.e.
+ *  ceil(256/bits) * 2^bits * 64 bytes. Multiplying adds one point per window.
+ *  The constant-time rustsecp256k1zkp_v0_5_0_point_table_mul reads all of the table on every
+ *  multiplication and is fastest with about 5 bits (104 KiB), while
+ *  rustsecp256k1zkp_v0_5_0_point_table_mul_var gets faster up to 8 bits (512 KiB).
+ *
+ *  Returns: the required size of the caller-provided memory block, or 0 if bits
+ *           is not between 1 and 8.
+ *  In:      bits: number of bits per window.
+ */
+SECP256K1_API size_t rustsecp256k1zkp_v0_5_0_point_table_preallocated_size(
+    unsigned int bits
+) SECP256K1_WARN_UNUSED_RESULT;
+
+/** Create a point table for a public key in caller-provided memory.
+ *
+ *  The caller must ensure that the memory remains valid and unchanged while
+ *  the point table is used. The point table needs no destruction, the caller
+ *  can simply deallocate the memory afterwards.
+ *
+ *  Returns: the point table, or NULL if the public key could not be parsed or
+ *           bits is not between 1 and 8.
+ *  Args:      ctx: an existing context object (cannot be NULL)
+ *  In:   prealloc: a pointer to a rewritable contiguous block of memory of
+ *                  size at least rustsecp256k1zkp_v0_5_0_point_table_preallocated_size(bits)
+ *                  bytes, suitably aligned to hold an object of any type
+ *                  (cannot be NULL)
+ *          pubkey: the public key to precompute multiples of (cannot be NULL)
+ *            bits: number of bits per window.
+ */
+SECP256K1_API rustsecp256k1zkp_v0_5_0_point_table* rustsecp256k1zkp_v0_5_0_point_table_preallocated_create(
+    const rustsecp256k1zkp_v0_5_0_context* ctx,
+    void* prealloc,
+    const rustsecp256k1zkp_v0_5_0_pubkey* pubkey,
+    unsigned int bits
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_WARN_UNUSED_RESULT;
+
 #ifdef __cplusplus
 }
 #endif
@@ -220,6 +220,85 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_rangeproo
   const rustsecp256k1zkp_v0_5_0_generator *gen
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(6) SECP256K1_ARG_NONNULL(7) SECP256K1_ARG_NONNULL(8) SECP256K1_ARG_NONNULL(9) SECP256K1_ARG_NONNULL(10) SECP256K1_ARG_NONNULL(14);
 
+/** Verify a range proof and rewind it to recover only the value and blinding factor.
+ *  Returns 1: Value is within the range [0..2^64), the specifically proven range is in the min/max value outputs, and the value and blinding were recovered.
+ *          0: Proof failed, rewind failed, or other error.
+ *  In:   ctx: pointer to a context object, initialized for range-proof and Pedersen commitment (cannot be NULL)
+ *        commit: the commitment being proved. (cannot be NULL)
+ *        proof: pointer to character array with the proof. (cannot be NULL)
+ *        plen: length of proof in bytes.
+ *        nonce: 32-byte secret nonce used by the prover (cannot be NULL)
+ *        extra_commit: additional data covered in rangeproof signature
+ *        extra_commit_len: length of extra_commit byte array (0 if NULL)
+ *        gen: additional generator 'h'
+ *  In/Out: blind_out: storage for the 32-byte blinding factor used for the commitment
+ *        value_out: pointer to an unsigned int64 which has the exact value of the commitment.
+ *        min_value: pointer to an unsigned int64 which will be updated with the minimum value that commit could have. (cannot be NULL)
+ *        max_value: pointer to an unsigned int64 which will be updated with the maximum value that commit could have. (cannot be NULL)
+ *
+ *  Equivalent to rustsecp256k1zkp_v0_5_0_rangeproof_rewind without a message output. The prover's random values are only
+ *  regenerated for the last ring, which encodes the value, so this is cheaper than recovering the message.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_only(
+  const rustsecp256k1zkp_v0_5_0_context* ctx,
+  unsigned char *blind_out,
+  uint64_t *value_out,
+  const unsigned char *nonce,
+  uint64_t *min_value,
+  uint64_t *max_value,
+  const rustsecp256k1zkp_v0_5_0_pedersen_commitment *commit,
+  const unsigned char *proof,
+  size_t plen,
+  const unsigned char *extra_commit,
+  size_t extra_commit_len,
+  const rustsecp256k1zkp_v0_5_0_generator *gen
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(5) SECP256K1_ARG_NONNULL(6) SECP256K1_ARG_NONNULL(7) SECP256K1_ARG_NONNULL(8) SECP256K1_ARG_NONNULL(12);
+
+/** Derive the range proof nonces shared with the senders of many outputs.
+ *  Returns 1: All nonces were derived.
+ *          0: The scan key is invalid or a public key could not be parsed, nonces is zeroed.
+ *  In:   ctx: pointer to a context object (cannot be NULL)
+ *        scan_key: 32-byte secret key the outputs were blinded to (cannot be NULL)
+ *        pubkeys: array of the ephemeral (nonce commitment) public keys of the outputs (cannot be NULL)
+ *        n_pubkeys: number of public keys in pubkeys
+ *  Out:  nonces: pointer to an array of 32 * n_pubkeys bytes receiving the nonces (cannot be NULL)
+ *
+ *  The nonce for pubkeys[i] is the SHA256 of the default ECDH hash of scan_key * pubkeys[i], which is
+ *  SHA256(SHA256(compressed shared point)). This is the nonce wallets pass to rustsecp256k1zkp_v0_5_0_rangeproof_sign.
+ *  The shared points are converted to affine coordinates in batches with a single field inversion each.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_rangeproof_ecdh_nonces(
+  const rustsecp256k1zkp_v0_5_0_context* ctx,
+  unsigned char *nonces,
+  const unsigned char *scan_key,
+  const rustsecp256k1zkp_v0_5_0_pubkey *pubkeys,
+  size_t n_pubkeys
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
+/** Cheaply check whether a range proof could be rewound with a nonce, without verifying it.
+ *  Returns 1: The proof may rewind with this nonce, it still has to be rewound to know.
+ *          0: The proof certainly does not rewind with this nonce, or is malformed.
+ *  In:   ctx: pointer to a context object (cannot be NULL)
+ *        nonce: 32-byte secret nonce to try (cannot be NULL)
+ *        commit: the commitment being proved. (cannot be NULL)
+ *        proof: pointer to character array with the proof. (cannot be NULL)
+ *        plen: length of proof in bytes.
+ *        gen: additional generator 'h' (cannot be NULL)
+ *
+ *  Only the prover's random values for the last ring are regenerated, and their encoding of the value is
+ *  looked for. No group operations are performed, so scanning many proofs with this first and rewinding
+ *  only those that pass avoids verifying proofs that belong to someone else. Proofs of an exact value
+ *  carry no value encoding and always pass.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_rangeproof_rewind_precheck(
+  const rustsecp256k1zkp_v0_5_0_context* ctx,
+  const unsigned char *nonce,
+  const rustsecp256k1zkp_v0_5_0_pedersen_commitment *commit,
+  const unsigned char *proof,
+  size_t plen,
+  const rustsecp256k1zkp_v0_5_0_generator *gen
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(6);
+
 /** Author a proof that a committed value is within a range.
  *  Returns 1: Proof successfully created.
  *          0: Error
@@ -103,6 +103,38 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_ecdsa_rec
     const unsigned char *msghash32
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
 
+/** Recover the ECDSA public keys of many signatures.
+ *
+ *  Returns: 1: all public keys were successfully recovered (which guarantees correct signatures).
+ *           0: otherwise.
+ *  Args:    ctx:        pointer to a context object, initialized for verification (cannot be NULL)
+ *  Out:     pubkeys:    pointer to an array of n_sigs public keys. pubkeys[i] is set to the public key
+ *                       recovered from sigs[i], and is left unchanged if it cannot be recovered.
+ *                       (cannot be NULL unless n_sigs is 0)
+ *           invalid:    pointer to an array of n_sigs indices, which receives the positions of the
+ *                       signatures that could not be recovered in ascending order (can be NULL)
+ *           n_invalid:  pointer to the number of positions written to invalid (can be NULL unless
+ *                       invalid is not NULL)
+ *  In:      sigs:       array of pointers to initialized signatures that support pubkey recovery
+ *                       (cannot be NULL unless n_sigs is 0)
+ *           msghash32:  array of pointers to the 32-byte message hashes assumed to be signed (cannot be
+ *                       NULL unless n_sigs is 0)
+ *           n_sigs:     number of signatures
+ *
+ *  The result is the same as calling rustsecp256k1zkp_v0_5_0_ecdsa_recover for every signature, but the r values
+ *  of the signatures are inverted, and the recovered public keys converted to affine coordinates, in
+ *  batches with a single inversion each.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_ecdsa_recover_batch(
+    const rustsecp256k1zkp_v0_5_0_context* ctx,
+    rustsecp256k1zkp_v0_5_0_pubkey *pubkeys,
+    size_t *invalid,
+    size_t *n_invalid,
+    const rustsecp256k1zkp_v0_5_0_ecdsa_recoverable_signature *const *sigs,
+    const unsigned char *const *msghash32,
+    size_t n_sigs
+) SECP256K1_ARG_NONNULL(1);
+
 #ifdef __cplusplus
 }
 #endif
@@ -104,6 +104,72 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_schnorrsi
     const rustsecp256k1zkp_v0_5_0_xonly_pubkey *pubkey
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
 
+/** Verify a set of Schnorr signatures in one batch.
+ *
+ *  The signatures are combined with random weights derived from a hash of all
+ *  inputs and checked with a single multi-multiplication, which is much faster
+ *  than verifying them one by one. A failing batch does not tell which
+ *  signature is invalid; use rustsecp256k1zkp_v0_5_0_schnorrsig_verify for that.
+ *
+ *  Returns: 1: all signatures are correct (also when n_sigs is 0)
+ *           0: at least one signature is incorrect, or an input is invalid
+ *  Args:    ctx: a secp256k1 context object, initialized for verification.
+ *       scratch: scratch space used for the multi-multiplication (can be NULL,
+ *                in which case the points are multiplied one at a time)
+ *  In:    sig64: array of pointers to 64-byte signatures (cannot be NULL
+ *                unless n_sigs is 0)
+ *         msg32: array of pointers to the 32-byte messages (cannot be NULL
+ *                unless n_sigs is 0)
+ *            pk: array of pointers to x-only public keys (cannot be NULL
+ *                unless n_sigs is 0)
+ *        n_sigs: number of signatures in the arrays
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(
+    const rustsecp256k1zkp_v0_5_0_context* ctx,
+    rustsecp256k1zkp_v0_5_0_scratch_space *scratch,
+    const unsigned char *const *sig64,
+    const unsigned char *const *msg32,
+    const rustsecp256k1zkp_v0_5_0_xonly_pubkey *const *pk,
+    size_t n_sigs
+) SECP256K1_ARG_NONNULL(1);
+
+/** Verify a set of Schnorr signatures in one batch, split across workers.
+ *
+ *  Like rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch, but the multi-multiplication is
+ *  split into up to n_workers tasks which are handed to the runner, e.g. to
+ *  run them on a thread pool. Each task works on a contiguous range of the
+ *  signatures with its own scratch space. This only pays off for large batches;
+ *  small batches use fewer tasks and are verified on the calling thread.
+ *
+ *  Returns: 1: all signatures are correct (also when n_sigs is 0)
+ *           0: at least one signature is incorrect, or an input is invalid
+ *  Args:        ctx: a secp256k1 context object, initialized for verification.
+ *           scratch: array of n_workers scratch spaces, one for each task (cannot
+ *                    be NULL). The first one also holds some state of the batch.
+ *         n_workers: the maximum number of tasks to split the work into (must
+ *                    be at least 1)
+ *            runner: function that runs the tasks (cannot be NULL)
+ *       runner_data: arbitrary data pointer passed to the runner (can be NULL)
+ *  In:        sig64: array of pointers to 64-byte signatures (cannot be NULL
+ *                    unless n_sigs is 0)
+ *             msg32: array of pointers to the 32-byte messages (cannot be NULL
+ *                    unless n_sigs is 0)
+ *                pk: array of pointers to x-only public keys (cannot be NULL
+ *                    unless n_sigs is 0)
+ *            n_sigs: number of signatures in the arrays
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_parallel(
+    const rustsecp256k1zkp_v0_5_0_context* ctx,
+    rustsecp256k1zkp_v0_5_0_scratch_space *const *scratch,
+    size_t n_workers,
+    rustsecp256k1zkp_v0_5_0_task_runner runner,
+    void *runner_data,
+    const unsigned char *const *sig64,
+    const unsigned char *const *msg32,
+    const rustsecp256k1zkp_v0_5_0_xonly_pubkey *const *pk,
+    size_t n_sigs
+) SECP256K1_ARG_NONNULL(1);
+
 #ifdef __cplusplus
 }
 #endif
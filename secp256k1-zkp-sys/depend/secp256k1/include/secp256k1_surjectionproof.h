@@ -173,6 +173,42 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_surjectio
   const unsigned char *random_seed32
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(7);
 
+/** Surjection proof initialization function without retries; decides on inputs to use
+ *  To be used to initialize stack-allocated rustsecp256k1zkp_v0_5_0_surjectionproof struct
+ * Returns 0: inputs could not be selected, because no input tag matches the output tag or
+ *            n_input_tags_to_use is zero
+ *         1: inputs were selected
+ *
+ * In:               ctx: pointer to a context object
+ *      fixed_input_tags: fixed input tags `A_i` for all inputs. (If the fixed tag is not known,
+ *                        e.g. in a coinjoin with others' inputs, an ephemeral tag can be given;
+ *                        this won't match the output tag but might be used in the anonymity set.)
+ *          n_input_tags: the number of entries in the fixed_input_tags array
+ *   n_input_tags_to_use: the number of inputs to select randomly to put in the anonymity set
+ *                        Must be <= SECP256K1_SURJECTIONPROOF_MAX_USED_INPUTS
+ *      fixed_output_tag: fixed output tag
+ *         random_seed32: a random seed to be used for input selection
+ * Out:            proof: The proof whose bitvector will be initialized. In case of failure,
+ *                        the state of the proof is undefined.
+ *          input_index: The index of the actual input that is secretly mapped to the output
+ *
+ * The selected set of inputs has the same distribution as the one chosen by
+ * rustsecp256k1zkp_v0_5_0_surjectionproof_initialize: it is uniformly random among all sets of
+ * n_input_tags_to_use inputs that contain at least one input matching the output tag. Instead of
+ * drawing random sets until one of them contains a matching input, the number of matching inputs
+ * in the set is drawn first, so this function never gives up when a matching input exists.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(
+  const rustsecp256k1zkp_v0_5_0_context* ctx,
+  rustsecp256k1zkp_v0_5_0_surjectionproof* proof,
+  size_t *input_index,
+  const rustsecp256k1zkp_v0_5_0_fixed_asset_tag* fixed_input_tags,
+  const size_t n_input_tags,
+  const size_t n_input_tags_to_use,
+  const rustsecp256k1zkp_v0_5_0_fixed_asset_tag* fixed_output_tag,
+  const unsigned char *random_seed32
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(7);
+
 
 /** Surjection proof allocation and initialization function; decides on inputs to use
  * Returns 0: inputs could not be selected, or malloc failure
@@ -261,6 +297,30 @@ SECP256K1_API int rustsecp256k1zkp_v0_5_0_surjectionproof_verify(
   size_t n_ephemeral_input_tags,
   const rustsecp256k1zkp_v0_5_0_generator* ephemeral_output_tag
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(5);
+
+/** Surjection proof verification function operating on a serialized proof
+ * Returns 0: proof was invalid or could not be parsed
+ *         1: proof was valid
+ *
+ * In:     ctx: pointer to a context object, initialized for signing and verification
+ *         input: pointer to the serialized proof to be verified
+ *         inputlen: length of the array pointed to by input
+ *      ephemeral_input_tags: the ephemeral asset tag of all inputs
+ *    n_ephemeral_input_tags: the number of entries in the ephemeral_input_tags array
+ *      ephemeral_output_tag: the ephemeral asset tag of the output
+ *
+ * Equivalent to rustsecp256k1zkp_v0_5_0_surjectionproof_parse followed by
+ * rustsecp256k1zkp_v0_5_0_surjectionproof_verify, but reads the proof in place instead of
+ * copying it into a rustsecp256k1zkp_v0_5_0_surjectionproof object.
+ */
+SECP256K1_API int rustsecp256k1zkp_v0_5_0_surjectionproof_verify_serialized(
+  const rustsecp256k1zkp_v0_5_0_context* ctx,
+  const unsigned char *input,
+  size_t inputlen,
+  const rustsecp256k1zkp_v0_5_0_generator* ephemeral_input_tags,
+  size_t n_ephemeral_input_tags,
+  const rustsecp256k1zkp_v0_5_0_generator* ephemeral_output_tag
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(6);
 #endif
 
 #ifdef __cplusplus
@@ -37,6 +37,25 @@ typedef struct {
     unsigned char data[32 * (1 + SECP256K1_WHITELIST_MAX_N_KEYS)];
 } rustsecp256k1zkp_v0_5_0_whitelist_signature;
 
+/** Opaque data structure that holds a parsed list of online/offline keys
+ *
+ *  The keys are stored in a form that can be loaded without parsing, together
+ *  with the compressed serializations that the signature message commits to.
+ *  Verifying many signatures against the same key list with
+ *  rustsecp256k1zkp_v0_5_0_whitelist_verify_keyset then only does the work that depends
+ *  on the whitelisted sub-key.
+ *
+ *  The exact representation of data inside is implementation defined and not
+ *  guaranteed to be portable between different platforms or versions. It is
+ *  exposed only to allow creation of these objects on the stack; please *do
+ *  not* use these internals directly.
+ */
+typedef struct {
+    size_t n_keys;
+    /* per key: online pubkey, offline pubkey, serialized offline and online key */
+    unsigned char data[(64 + 64 + 33 + 33) * SECP256K1_WHITELIST_MAX_N_KEYS];
+} rustsecp256k1zkp_v0_5_0_whitelist_keyset;
+
 /** Parse a whitelist signature
  *
  *  Returns: 1 when the signature could be parsed, 0 otherwise.
@@ -145,6 +164,41 @@ SECP256K1_API int rustsecp256k1zkp_v0_5_0_whitelist_verify(
   const rustsecp256k1zkp_v0_5_0_pubkey *sub_pubkey
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(6);
 
+/** Precompute a key set for repeated whitelist verification
+ * Returns 1: key set was successfully created
+ *         0: one of the keys is invalid
+ * In:     ctx: pointer to a context object
+ *         online_pubkeys: list of all online pubkeys
+ *         offline_pubkeys: list of all offline pubkeys
+ *         n_keys: the number of entries in each of the above two arrays
+ * Out:    keyset: the produced key set
+ */
+SECP256K1_API int rustsecp256k1zkp_v0_5_0_whitelist_keyset_create(
+  const rustsecp256k1zkp_v0_5_0_context* ctx,
+  rustsecp256k1zkp_v0_5_0_whitelist_keyset *keyset,
+  const rustsecp256k1zkp_v0_5_0_pubkey *online_pubkeys,
+  const rustsecp256k1zkp_v0_5_0_pubkey *offline_pubkeys,
+  const size_t n_keys
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
+/** Verify a whitelist signature against a precomputed key set
+ * Returns 1: signature is valid
+ *         0: signature is not valid
+ * In:     ctx: pointer to a context object, initialized for verification
+ *         sig: the signature to be verified
+ *         keyset: the online/offline keys, see rustsecp256k1zkp_v0_5_0_whitelist_keyset_create
+ *         sub_pubkey: the key to be whitelisted
+ *
+ * This is equivalent to calling rustsecp256k1zkp_v0_5_0_whitelist_verify with the keys
+ * the key set was created from.
+ */
+SECP256K1_API int rustsecp256k1zkp_v0_5_0_whitelist_verify_keyset(
+  const rustsecp256k1zkp_v0_5_0_context* ctx,
+  const rustsecp256k1zkp_v0_5_0_whitelist_signature *sig,
+  const rustsecp256k1zkp_v0_5_0_whitelist_keyset *keyset,
+  const rustsecp256k1zkp_v0_5_0_pubkey *sub_pubkey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,7 +3,14 @@
  * Distributed under the MIT software license, see the accompanying    *
  * file COPYING or https://www.opensource.org/licenses/mit-license.php.*
  ***********************************************************************/
+#if defined HAVE_CONFIG_H
+#include "libsecp256k1-config.h"
+#endif
+
 #include <stdio.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 
 #include "include/secp256k1.h"
 
@@ -18,6 +25,7 @@
 #include "secp256k1.c"
 
 #define POINTS 32768
+#define MAX_THREADS 8
 
 typedef struct {
     /* Setup once in advance */
@@ -28,10 +36,15 @@ typedef struct {
     rustsecp256k1zkp_v0_5_0_scalar* seckeys;
     rustsecp256k1zkp_v0_5_0_gej* expected_output;
     rustsecp256k1zkp_v0_5_0_ecmult_multi_func ecmult_multi;
+    /* Scratch spaces and callback data of the threads of ecmult_multi_var_parallel */
+    rustsecp256k1zkp_v0_5_0_scratch_space* thread_scratch[MAX_THREADS];
+    void* thread_cbdata[MAX_THREADS];
 
     /* Changes per test */
     size_t count;
     int includes_g;
+    /* Use ecmult_multi_var_parallel with this many threads if not 0 */
+    size_t threads;
 
     /* Changes per test iteration */
     size_t offset1;
@@ -54,6 +67,58 @@ static int bench_callback(rustsecp256k1zkp_v0_5_0_scalar* sc, rustsecp256k1zkp_v
     return 1;
 }
 
+#ifdef HAVE_PTHREAD
+typedef struct {
+    void (*task)(void *task_data, size_t i);
+    void *task_data;
+    size_t i;
+} bench_thread_task;
+
+static void* bench_thread_run(void* arg) {
+    bench_thread_task* t = (bench_thread_task*)arg;
+    t->task(t->task_data, t->i);
+    return NULL;
+}
+
+/* Runs task 0 on the calling thread and every other task on a new thread. */
+static void bench_task_runner(void (*task)(void *task_data, size_t i), void *task_data, size_t n_tasks, void *data) {
+    pthread_t threads[MAX_THREADS];
+    bench_thread_task tasks[MAX_THREADS];
+    size_t i;
+    (void)data;
+
+    CHECK(n_tasks <= MAX_THREADS);
+    for (i = 1; i < n_tasks; i++) {
+        tasks[i].task = task;
+        tasks[i].task_data = task_data;
+        tasks[i].i = i;
+        CHECK(pthread_create(&threads[i], NULL, bench_thread_run, &tasks[i]) == 0);
+    }
+    task(task_data, 0);
+    for (i = 1; i < n_tasks; i++) {
+        CHECK(pthread_join(threads[i], NULL) == 0);
+    }
+}
+#endif
+
+static uint64_t bench_timer(void *data) {
+    (void)data;
+    return (uint64_t)gettime_i64();
+}
+
+static void print_calibration(const rustsecp256k1zkp_v0_5_0_scratch_space* scratch) {
+    const rustsecp256k1zkp_v0_5_0_ecmult_multi_tuning* tuning = &scratch->tuning;
+    int affine, w;
+    printf("pippenger_threshold = %lu, pippenger_affine_threshold = %lu\n", (unsigned long)tuning->pippenger_threshold, (unsigned long)tuning->pippenger_affine_threshold);
+    for (affine = 0; affine < 2; affine++) {
+        printf("%s window maximum points:", affine ? "pippenger_affine" : "pippenger_wnaf");
+        for (w = 1; w < PIPPENGER_MAX_BUCKET_WINDOW; w++) {
+            printf(" %lu", (unsigned long)tuning->window_max_points[affine][w - 1]);
+        }
+        printf("\n");
+    }
+}
+
 static void bench_ecmult(void* arg, int iters) {
     bench_data* data = (bench_data*)arg;
 
@@ -63,7 +128,14 @@ static void bench_ecmult(void* arg, int iters) {
     iters = iters / data->count;
 
     for (iter = 0; iter < iters; ++iter) {
-        data->ecmult_multi(&data->ctx->error_callback, &data->ctx->ecmult_ctx, data->scratch, &data->output[iter], data->includes_g ? &data->scalars[data->offset1] : NULL, bench_callback, arg, count - includes_g);
+#ifdef HAVE_PTHREAD
+        if (data->threads > 0) {
+            rustsecp256k1zkp_v0_5_0_ecmult_multi_var_parallel(&data->ctx->error_callback, &data->ctx->ecmult_ctx, data->thread_scratch, data->threads, bench_task_runner, NULL, &data->output[iter], data->includes_g ? &data->scalars[data->offset1] : NULL, bench_callback, data->thread_cbdata, count - includes_g);
+        } else
+#endif
+        {
+            data->ecmult_multi(&data->ctx->error_callback, &data->ctx->ecmult_ctx, data->scratch, &data->output[iter], data->includes_g ? &data->scalars[data->offset1] : NULL, bench_callback, arg, count - includes_g);
+        }
         data->offset1 = (data->offset1 + count) % POINTS;
         data->offset2 = (data->offset2 + count - 1) % POINTS;
     }
@@ -128,13 +200,19 @@ static void run_test(bench_data* data, size_t count, int includes_g, int num_ite
     }
 
     /* Run the benchmark. */
-    sprintf(str, includes_g ? "ecmult_%ig" : "ecmult_%i", (int)count);
+    if (data->threads > 0) {
+        sprintf(str, includes_g ? "ecmult_%ig_%it" : "ecmult_%i_%it", (int)count, (int)data->threads);
+    } else {
+        sprintf(str, includes_g ? "ecmult_%ig" : "ecmult_%i", (int)count);
+    }
     run_benchmark(str, bench_ecmult, bench_ecmult_setup, bench_ecmult_teardown, data, 10, count * iters);
 }
 
 int main(int argc, char **argv) {
     bench_data data;
     int i, p;
+    size_t t;
+    int parallel = 0;
     rustsecp256k1zkp_v0_5_0_gej* pubkeys_gej;
     size_t scratch_size;
 
@@ -144,11 +222,15 @@ int main(int argc, char **argv) {
     scratch_size = rustsecp256k1zkp_v0_5_0_strauss_scratch_size(POINTS) + STRAUSS_SCRATCH_OBJECTS*16;
     data.scratch = rustsecp256k1zkp_v0_5_0_scratch_space_create(data.ctx, scratch_size);
     data.ecmult_multi = rustsecp256k1zkp_v0_5_0_ecmult_multi_var;
+    data.threads = 0;
 
     if (argc > 1) {
         if(have_flag(argc, argv, "pippenger_wnaf")) {
             printf("Using pippenger_wnaf:\n");
             data.ecmult_multi = rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch_single;
+        } else if(have_flag(argc, argv, "pippenger_affine")) {
+            printf("Using pippenger_affine:\n");
+            data.ecmult_multi = rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_batch_single;
         } else if(have_flag(argc, argv, "strauss_wnaf")) {
             printf("Using strauss_wnaf:\n");
             data.ecmult_multi = rustsecp256k1zkp_v0_5_0_ecmult_strauss_batch_single;
@@ -157,9 +239,28 @@ int main(int argc, char **argv) {
             data.ecmult_multi = rustsecp256k1zkp_v0_5_0_ecmult_multi_var;
             rustsecp256k1zkp_v0_5_0_scratch_space_destroy(data.ctx, data.scratch);
             data.scratch = NULL;
+        } else if(have_flag(argc, argv, "calibrate")) {
+            int64_t begin = gettime_i64();
+            CHECK(rustsecp256k1zkp_v0_5_0_scratch_space_calibrate(data.ctx, data.scratch, bench_timer, NULL));
+            printf("Calibrated in %i ms:\n", (int)((gettime_i64() - begin) / 1000));
+            print_calibration(data.scratch);
+            printf("Using the calibrated combined algorithm:\n");
+#ifdef HAVE_PTHREAD
+        } else if(have_flag(argc, argv, "parallel")) {
+            printf("Using ecmult_multi_var_parallel with 1 to %i threads:\n", MAX_THREADS);
+            parallel = 1;
+            for (t = 0; t < MAX_THREADS; t++) {
+                data.thread_scratch[t] = rustsecp256k1zkp_v0_5_0_scratch_space_create(data.ctx, scratch_size);
+                data.thread_cbdata[t] = &data;
+            }
+#endif
         } else {
             fprintf(stderr, "%s: unrecognized argument '%s'.\n", argv[0], argv[1]);
-            fprintf(stderr, "Use 'pippenger_wnaf', 'strauss_wnaf', 'simple' or no argument to benchmark a combined algorithm.\n");
+#ifdef HAVE_PTHREAD
+            fprintf(stderr, "Use 'pippenger_wnaf', 'pippenger_affine', 'strauss_wnaf', 'simple', 'calibrate', 'parallel' or no argument to benchmark a combined algorithm.\n");
+#else
+            fprintf(stderr, "Use 'pippenger_wnaf', 'pippenger_affine', 'strauss_wnaf', 'simple', 'calibrate' or no argument to benchmark a combined algorithm.\n");
+#endif
             return 1;
         }
     }
@@ -185,17 +286,30 @@ int main(int argc, char **argv) {
     rustsecp256k1zkp_v0_5_0_ge_set_all_gej_var(data.pubkeys, pubkeys_gej, POINTS);
     free(pubkeys_gej);
 
-    for (i = 1; i <= 8; ++i) {
-        run_test(&data, i, 1, iters);
-    }
+    if (parallel) {
+        /* Only large multiplications are split across threads. */
+        for (t = 1; t <= MAX_THREADS; t *= 2) {
+            data.threads = t;
+            for (p = 11; p <= 15; ++p) {
+                run_test(&data, 1 << p, 1, iters);
+            }
+        }
+        for (t = 0; t < MAX_THREADS; t++) {
+            rustsecp256k1zkp_v0_5_0_scratch_space_destroy(data.ctx, data.thread_scratch[t]);
+        }
+    } else {
+        for (i = 1; i <= 8; ++i) {
+            run_test(&data, i, 1, iters);
+        }
 
-    /* This is disabled with low count of iterations because the loop runs 77 times even with iters=1
-    * and the higher it goes the longer the computation takes(more points)
-    * So we don't run this benchmark with low iterations to prevent slow down */
-     if (iters > 2) {
-        for (p = 0; p <= 11; ++p) {
-            for (i = 9; i <= 16; ++i) {
-                run_test(&data, i << p, 1, iters);
+        /* This is disabled with low count of iterations because the loop runs 77 times even with iters=1
+        * and the higher it goes the longer the computation takes(more points)
+        * So we don't run this benchmark with low iterations to prevent slow down */
+        if (iters > 2) {
+            for (p = 0; p <= 11; ++p) {
+                for (i = 9; i <= 16; ++i) {
+                    run_test(&data, i << p, 1, iters);
+                }
             }
         }
     }
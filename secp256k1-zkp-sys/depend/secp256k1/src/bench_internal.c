@@ -22,6 +22,8 @@
 typedef struct {
     rustsecp256k1zkp_v0_5_0_scalar scalar[2];
     rustsecp256k1zkp_v0_5_0_fe fe[4];
+    rustsecp256k1zkp_v0_5_0_fe batch[128];
+    int fe_vec;
     rustsecp256k1zkp_v0_5_0_ge ge[2];
     rustsecp256k1zkp_v0_5_0_gej gej[2];
     unsigned char data[64];
@@ -29,6 +31,7 @@ typedef struct {
 } bench_inv;
 
 void bench_setup(void* arg) {
+    int i;
     bench_inv *data = (bench_inv*)arg;
 
     static const unsigned char init[4][32] = {
@@ -78,6 +81,10 @@ void bench_setup(void* arg) {
     rustsecp256k1zkp_v0_5_0_gej_rescale(&data->gej[1], &data->fe[3]);
     memcpy(data->data, init[0], 32);
     memcpy(data->data + 32, init[1], 32);
+    for (i = 0; i < 128; i++) {
+        rustsecp256k1zkp_v0_5_0_fe_mul(&data->batch[i], &data->fe[i % 4], &data->fe[(i / 4) % 4]);
+    }
+    data->fe_vec = rustsecp256k1zkp_v0_5_0_fe_vec_available();
 }
 
 void bench_scalar_add(void* arg, int iters) {
@@ -186,6 +193,34 @@ void bench_field_sqr(void* arg, int iters) {
     }
 }
 
+/* The batch benchmarks report the time per field element. */
+void bench_field_mul_all(void* arg, int iters) {
+    int i;
+    bench_inv *data = (bench_inv*)arg;
+
+    for (i = 0; i < iters; i += 64) {
+        rustsecp256k1zkp_v0_5_0_fe_mul_all(data->batch, data->batch, &data->batch[64], 64, data->fe_vec);
+    }
+}
+
+void bench_field_sqr_all(void* arg, int iters) {
+    int i;
+    bench_inv *data = (bench_inv*)arg;
+
+    for (i = 0; i < iters; i += 64) {
+        rustsecp256k1zkp_v0_5_0_fe_sqr_all(data->batch, data->batch, 64, data->fe_vec);
+    }
+}
+
+void bench_field_inverse_all_var(void* arg, int iters) {
+    int i;
+    bench_inv *data = (bench_inv*)arg;
+
+    for (i = 0; i < iters; i += 64) {
+        rustsecp256k1zkp_v0_5_0_fe_inv_all_var(&data->batch[64 - (i / 64 % 2) * 64], &data->batch[(i / 64 % 2) * 64], 64, data->fe_vec);
+    }
+}
+
 void bench_field_inverse(void* arg, int iters) {
     int i;
     bench_inv *data = (bench_inv*)arg;
@@ -219,6 +254,27 @@ void bench_field_sqrt(void* arg, int iters) {
     CHECK(j <= iters);
 }
 
+void bench_field_is_quad_var(void* arg, int iters) {
+    int i, j = 0;
+    bench_inv *data = (bench_inv*)arg;
+
+    for (i = 0; i < iters; i++) {
+        j += rustsecp256k1zkp_v0_5_0_fe_is_quad_var(&data->fe[0]);
+        rustsecp256k1zkp_v0_5_0_fe_add(&data->fe[0], &data->fe[1]);
+    }
+    CHECK(j <= iters);
+}
+
+void bench_field_sqrt_all(void* arg, int iters) {
+    int i, j = 0;
+    bench_inv *data = (bench_inv*)arg;
+
+    for (i = 0; i < iters; i += 64) {
+        j += rustsecp256k1zkp_v0_5_0_fe_sqrt_all(&data->batch[64 - (i / 64 % 2) * 64], &data->batch[(i / 64 % 2) * 64], 64, data->fe_vec);
+    }
+    CHECK(j <= iters);
+}
+
 void bench_group_double_var(void* arg, int iters) {
     int i;
     bench_inv *data = (bench_inv*)arg;
@@ -318,6 +374,61 @@ void bench_wnaf_const(void* arg, int iters) {
 }
 
 
+void bench_ecmult_const_256(void* arg, int iters) {
+    int i;
+    bench_inv *data = (bench_inv*)arg;
+
+    for (i = 0; i < iters; i++) {
+        rustsecp256k1zkp_v0_5_0_ecmult_const(&data->gej[0], &data->ge[0], &data->scalar[0], 256);
+        rustsecp256k1zkp_v0_5_0_scalar_add(&data->scalar[0], &data->scalar[0], &data->scalar[1]);
+    }
+}
+
+void bench_ecmult_const_64(void* arg, int iters) {
+    int i;
+    bench_inv *data = (bench_inv*)arg;
+    rustsecp256k1zkp_v0_5_0_scalar q;
+
+    for (i = 0; i < iters; i++) {
+        /* Keep the low 64 bits of the scalar, like the values of Pedersen commitments */
+        rustsecp256k1zkp_v0_5_0_scalar_get_b32(data->data, &data->scalar[0]);
+        memset(data->data, 0, 24);
+        rustsecp256k1zkp_v0_5_0_scalar_set_b32(&q, data->data, NULL);
+        rustsecp256k1zkp_v0_5_0_ecmult_const(&data->gej[0], &data->ge[0], &q, 64);
+        rustsecp256k1zkp_v0_5_0_scalar_add(&data->scalar[0], &data->scalar[0], &data->scalar[1]);
+    }
+}
+
+#define BENCH_FIXED_BITS 5
+static rustsecp256k1zkp_v0_5_0_ge_storage bench_fixed_pre[ECMULT_FIXED_TABLE_SIZE(BENCH_FIXED_BITS)];
+
+void bench_ecmult_fixed_setup(void* arg) {
+    bench_inv *data = (bench_inv*)arg;
+
+    bench_setup(arg);
+    rustsecp256k1zkp_v0_5_0_ecmult_fixed_table(bench_fixed_pre, &data->ge[0], BENCH_FIXED_BITS);
+}
+
+void bench_ecmult_fixed(void* arg, int iters) {
+    int i;
+    bench_inv *data = (bench_inv*)arg;
+
+    for (i = 0; i < iters; i++) {
+        rustsecp256k1zkp_v0_5_0_ecmult_fixed(&data->gej[0], bench_fixed_pre, BENCH_FIXED_BITS, &data->scalar[0]);
+        rustsecp256k1zkp_v0_5_0_scalar_add(&data->scalar[0], &data->scalar[0], &data->scalar[1]);
+    }
+}
+
+void bench_ecmult_fixed_var(void* arg, int iters) {
+    int i;
+    bench_inv *data = (bench_inv*)arg;
+
+    for (i = 0; i < iters; i++) {
+        rustsecp256k1zkp_v0_5_0_ecmult_fixed_var(&data->gej[0], bench_fixed_pre, BENCH_FIXED_BITS, &data->scalar[0]);
+        rustsecp256k1zkp_v0_5_0_scalar_add(&data->scalar[0], &data->scalar[0], &data->scalar[1]);
+    }
+}
+
 void bench_sha256(void* arg, int iters) {
     int i;
     bench_inv *data = (bench_inv*)arg;
@@ -403,9 +514,14 @@ int main(int argc, char **argv) {
     if (have_flag(argc, argv, "field") || have_flag(argc, argv, "normalize")) run_benchmark("field_normalize_weak", bench_field_normalize_weak, bench_setup, NULL, &data, 10, iters*100);
     if (have_flag(argc, argv, "field") || have_flag(argc, argv, "sqr")) run_benchmark("field_sqr", bench_field_sqr, bench_setup, NULL, &data, 10, iters*10);
     if (have_flag(argc, argv, "field") || have_flag(argc, argv, "mul")) run_benchmark("field_mul", bench_field_mul, bench_setup, NULL, &data, 10, iters*10);
+    if (have_flag(argc, argv, "field") || have_flag(argc, argv, "sqr")) run_benchmark("field_sqr_all", bench_field_sqr_all, bench_setup, NULL, &data, 10, iters*10);
+    if (have_flag(argc, argv, "field") || have_flag(argc, argv, "mul")) run_benchmark("field_mul_all", bench_field_mul_all, bench_setup, NULL, &data, 10, iters*10);
     if (have_flag(argc, argv, "field") || have_flag(argc, argv, "inverse")) run_benchmark("field_inverse", bench_field_inverse, bench_setup, NULL, &data, 10, iters);
     if (have_flag(argc, argv, "field") || have_flag(argc, argv, "inverse")) run_benchmark("field_inverse_var", bench_field_inverse_var, bench_setup, NULL, &data, 10, iters);
+    if (have_flag(argc, argv, "field") || have_flag(argc, argv, "inverse")) run_benchmark("field_inverse_all_var", bench_field_inverse_all_var, bench_setup, NULL, &data, 10, iters*10);
     if (have_flag(argc, argv, "field") || have_flag(argc, argv, "sqrt")) run_benchmark("field_sqrt", bench_field_sqrt, bench_setup, NULL, &data, 10, iters);
+    if (have_flag(argc, argv, "field") || have_flag(argc, argv, "sqrt")) run_benchmark("field_sqrt_all", bench_field_sqrt_all, bench_setup, NULL, &data, 10, iters);
+    if (have_flag(argc, argv, "field") || have_flag(argc, argv, "sqrt")) run_benchmark("field_is_quad_var", bench_field_is_quad_var, bench_setup, NULL, &data, 10, iters);
 
     if (have_flag(argc, argv, "group") || have_flag(argc, argv, "double")) run_benchmark("group_double_var", bench_group_double_var, bench_setup, NULL, &data, 10, iters*10);
     if (have_flag(argc, argv, "group") || have_flag(argc, argv, "add")) run_benchmark("group_add_var", bench_group_add_var, bench_setup, NULL, &data, 10, iters*10);
@@ -416,6 +532,10 @@ int main(int argc, char **argv) {
 
     if (have_flag(argc, argv, "ecmult") || have_flag(argc, argv, "wnaf")) run_benchmark("wnaf_const", bench_wnaf_const, bench_setup, NULL, &data, 10, iters);
     if (have_flag(argc, argv, "ecmult") || have_flag(argc, argv, "wnaf")) run_benchmark("ecmult_wnaf", bench_ecmult_wnaf, bench_setup, NULL, &data, 10, iters);
+    if (have_flag(argc, argv, "ecmult") || have_flag(argc, argv, "const")) run_benchmark("ecmult_const_256", bench_ecmult_const_256, bench_setup, NULL, &data, 10, iters / 10);
+    if (have_flag(argc, argv, "ecmult") || have_flag(argc, argv, "const")) run_benchmark("ecmult_const_64", bench_ecmult_const_64, bench_setup, NULL, &data, 10, iters / 10);
+    if (have_flag(argc, argv, "ecmult") || have_flag(argc, argv, "fixed")) run_benchmark("ecmult_fixed", bench_ecmult_fixed, bench_ecmult_fixed_setup, NULL, &data, 10, iters / 10);
+    if (have_flag(argc, argv, "ecmult") || have_flag(argc, argv, "fixed")) run_benchmark("ecmult_fixed_var", bench_ecmult_fixed_var, bench_ecmult_fixed_setup, NULL, &data, 10, iters / 10);
 
     if (have_flag(argc, argv, "hash") || have_flag(argc, argv, "sha256")) run_benchmark("hash_sha256", bench_sha256, bench_setup, NULL, &data, 10, iters);
     if (have_flag(argc, argv, "hash") || have_flag(argc, argv, "hmac")) run_benchmark("hash_hmac_sha256", bench_hmac_sha256, bench_setup, NULL, &data, 10, iters);
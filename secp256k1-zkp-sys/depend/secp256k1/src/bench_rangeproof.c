@@ -49,6 +49,27 @@ static void bench_rangeproof(void* arg, int iters) {
     }
 }
 
+static void bench_pedersen_commit(void* arg, int iters) {
+    int i;
+    bench_rangeproof_t *data = (bench_rangeproof_t*)arg;
+    rustsecp256k1zkp_v0_5_0_pedersen_commitment commit;
+
+    for (i = 0; i < iters; i++) {
+        CHECK(rustsecp256k1zkp_v0_5_0_pedersen_commit(data->ctx, &commit, data->blind, data->v + i, rustsecp256k1zkp_v0_5_0_generator_h));
+        data->blind[0] = commit.data[1];
+    }
+}
+
+static void bench_rangeproof_sign(void* arg, int iters) {
+    int i;
+    bench_rangeproof_t *data = (bench_rangeproof_t*)arg;
+
+    for (i = 0; i < iters; i++) {
+        data->len = 5134;
+        CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_sign(data->ctx, data->proof, &data->len, 0, &data->commit, data->blind, (const unsigned char*)&data->commit, 0, data->min_bits, data->v, NULL, 0, NULL, 0, rustsecp256k1zkp_v0_5_0_generator_h));
+    }
+}
+
 int main(void) {
     bench_rangeproof_t data;
     int iters;
@@ -59,6 +80,8 @@ int main(void) {
     iters = data.min_bits*get_iters(32);
 
     run_benchmark("rangeproof_verify_bit", bench_rangeproof, bench_rangeproof_setup, NULL, &data, 10, iters);
+    run_benchmark("rangeproof_sign", bench_rangeproof_sign, bench_rangeproof_setup, NULL, &data, 10, get_iters(32));
+    run_benchmark("pedersen_commit", bench_pedersen_commit, bench_rangeproof_setup, NULL, &data, 10, get_iters(20000));
 
     rustsecp256k1zkp_v0_5_0_context_destroy(data.ctx);
     return 0;
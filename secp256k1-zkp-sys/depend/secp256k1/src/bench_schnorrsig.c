@@ -6,6 +6,7 @@
 
 #include <string.h>
 #include <stdlib.h>
+#include <stdio.h>
 
 
 #include "include/secp256k1.h"
@@ -21,6 +22,9 @@ typedef struct {
     const unsigned char **pk;
     const unsigned char **sigs;
     const unsigned char **msgs;
+    const rustsecp256k1zkp_v0_5_0_xonly_pubkey **xonly_pks;
+    rustsecp256k1zkp_v0_5_0_scratch_space *scratch;
+    size_t batch_size;
 } bench_schnorrsig_data;
 
 void bench_schnorrsig_sign(void* arg, int iters) {
@@ -47,16 +51,29 @@ void bench_schnorrsig_verify(void* arg, int iters) {
     }
 }
 
+void bench_schnorrsig_verify_batch(void* arg, int iters) {
+    bench_schnorrsig_data *data = (bench_schnorrsig_data *)arg;
+    size_t i;
+
+    for (i = 0; i < (size_t)iters; i += data->batch_size) {
+        size_t n = (size_t)iters - i < data->batch_size ? (size_t)iters - i : data->batch_size;
+        CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(data->ctx, data->scratch, &data->sigs[i], &data->msgs[i], &data->xonly_pks[i], n));
+    }
+}
+
 int main(void) {
     int i;
     bench_schnorrsig_data data;
     int iters = get_iters(10000);
+    size_t batch_sizes[] = { 1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 4096, 10000 };
 
     data.ctx = rustsecp256k1zkp_v0_5_0_context_create(SECP256K1_CONTEXT_VERIFY | SECP256K1_CONTEXT_SIGN);
     data.keypairs = (const rustsecp256k1zkp_v0_5_0_keypair **)malloc(iters * sizeof(rustsecp256k1zkp_v0_5_0_keypair *));
     data.pk = (const unsigned char **)malloc(iters * sizeof(unsigned char *));
     data.msgs = (const unsigned char **)malloc(iters * sizeof(unsigned char *));
     data.sigs = (const unsigned char **)malloc(iters * sizeof(unsigned char *));
+    data.xonly_pks = (const rustsecp256k1zkp_v0_5_0_xonly_pubkey **)malloc(iters * sizeof(rustsecp256k1zkp_v0_5_0_xonly_pubkey *));
+    data.scratch = rustsecp256k1zkp_v0_5_0_scratch_space_create(data.ctx, 16 * 1024 * 1024);
 
     for (i = 0; i < iters; i++) {
         unsigned char sk[32];
@@ -64,6 +81,7 @@ int main(void) {
         unsigned char *sig = (unsigned char *)malloc(64);
         rustsecp256k1zkp_v0_5_0_keypair *keypair = (rustsecp256k1zkp_v0_5_0_keypair *)malloc(sizeof(*keypair));
         unsigned char *pk_char = (unsigned char *)malloc(32);
+        rustsecp256k1zkp_v0_5_0_xonly_pubkey *xonly_pk = (rustsecp256k1zkp_v0_5_0_xonly_pubkey *)malloc(sizeof(*xonly_pk));
         rustsecp256k1zkp_v0_5_0_xonly_pubkey pk;
         msg[0] = sk[0] = i;
         msg[1] = sk[1] = i >> 8;
@@ -81,21 +99,35 @@ int main(void) {
         CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_sign(data.ctx, sig, msg, keypair, NULL, NULL));
         CHECK(rustsecp256k1zkp_v0_5_0_keypair_xonly_pub(data.ctx, &pk, NULL, keypair));
         CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_serialize(data.ctx, pk_char, &pk) == 1);
+        *xonly_pk = pk;
+        data.xonly_pks[i] = xonly_pk;
     }
 
     run_benchmark("schnorrsig_sign", bench_schnorrsig_sign, NULL, NULL, (void *) &data, 10, iters);
     run_benchmark("schnorrsig_verify", bench_schnorrsig_verify, NULL, NULL, (void *) &data, 10, iters);
+    for (i = 0; i < (int)(sizeof(batch_sizes) / sizeof(batch_sizes[0])); i++) {
+        char name[64];
+        if (batch_sizes[i] > (size_t)iters) {
+            break;
+        }
+        data.batch_size = batch_sizes[i];
+        sprintf(name, "schnorrsig_verify_batch_%i", (int)batch_sizes[i]);
+        run_benchmark(name, bench_schnorrsig_verify_batch, NULL, NULL, (void *) &data, 10, iters);
+    }
 
     for (i = 0; i < iters; i++) {
         free((void *)data.keypairs[i]);
         free((void *)data.pk[i]);
         free((void *)data.msgs[i]);
         free((void *)data.sigs[i]);
+        free((void *)data.xonly_pks[i]);
     }
     free(data.keypairs);
     free(data.pk);
     free(data.msgs);
     free(data.sigs);
+    free(data.xonly_pks);
+    rustsecp256k1zkp_v0_5_0_scratch_space_destroy(data.ctx, data.scratch);
 
     rustsecp256k1zkp_v0_5_0_context_destroy(data.ctx);
     return 0;
@@ -15,7 +15,7 @@
 #include "scalar_impl.h"
 #include "testrand_impl.h"
 
-#define MAX_N_KEYS 30
+#define MAX_N_KEYS 255
 
 typedef struct {
     rustsecp256k1zkp_v0_5_0_context* ctx;
@@ -26,6 +26,7 @@ typedef struct {
     unsigned char csub[32];
     rustsecp256k1zkp_v0_5_0_pubkey sub_pubkey;
     rustsecp256k1zkp_v0_5_0_whitelist_signature sig;
+    rustsecp256k1zkp_v0_5_0_whitelist_keyset keyset;
     size_t n_keys;
 } bench_data;
 
@@ -37,16 +38,27 @@ static void bench_whitelist(void* arg, int iters) {
     }
 }
 
+static void bench_whitelist_keyset(void* arg, int iters) {
+    bench_data* data = (bench_data*)arg;
+    int i;
+    for (i = 0; i < iters; i++) {
+        CHECK(rustsecp256k1zkp_v0_5_0_whitelist_verify_keyset(data->ctx, &data->sig, &data->keyset, &data->sub_pubkey) == 1);
+    }
+}
+
 static void bench_whitelist_setup(void* arg) {
     bench_data* data = (bench_data*)arg;
     int i = 0;
     CHECK(rustsecp256k1zkp_v0_5_0_whitelist_sign(data->ctx, &data->sig, data->online_pubkeys, data->offline_pubkeys, data->n_keys, &data->sub_pubkey, data->online_seckey[i], data->summed_seckey[i], i, NULL, NULL));
+    CHECK(rustsecp256k1zkp_v0_5_0_whitelist_keyset_create(data->ctx, &data->keyset, data->online_pubkeys, data->offline_pubkeys, data->n_keys));
 }
 
 static void run_test(bench_data* data, int iters) {
     char str[32];
     sprintf(str, "whitelist_%i", (int)data->n_keys);
     run_benchmark(str, bench_whitelist, bench_whitelist_setup, NULL, data, 100, iters);
+    sprintf(str, "whitelist_keyset_%i", (int)data->n_keys);
+    run_benchmark(str, bench_whitelist_keyset, bench_whitelist_setup, NULL, data, 100, iters);
 }
 
 void random_scalar_order(rustsecp256k1zkp_v0_5_0_scalar *num) {
@@ -65,7 +77,8 @@ void random_scalar_order(rustsecp256k1zkp_v0_5_0_scalar *num) {
 int main(void) {
     bench_data data;
     size_t i;
-    size_t n_keys = 30;
+    size_t n_keys = MAX_N_KEYS;
+    static const size_t bench_n_keys[] = { 1, 2, 4, 8, 16, 32, 64, 128, MAX_N_KEYS };
     rustsecp256k1zkp_v0_5_0_scalar ssub;
     int iters = get_iters(5);
 
@@ -98,8 +111,8 @@ int main(void) {
     }
 
     /* Run test */
-    for (i = 1; i <= n_keys; ++i) {
-        data.n_keys = i;
+    for (i = 0; i < sizeof(bench_n_keys) / sizeof(bench_n_keys[0]); ++i) {
+        data.n_keys = bench_n_keys[i];
         run_test(&data, iters);
     }
 
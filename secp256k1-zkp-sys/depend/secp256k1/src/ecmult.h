@@ -28,6 +28,17 @@ static int rustsecp256k1zkp_v0_5_0_ecmult_context_is_built(const rustsecp256k1zk
 /** Double multiply: R = na*A + ng*G */
 static void rustsecp256k1zkp_v0_5_0_ecmult(const rustsecp256k1zkp_v0_5_0_ecmult_context *ctx, rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_gej *a, const rustsecp256k1zkp_v0_5_0_scalar *na, const rustsecp256k1zkp_v0_5_0_scalar *ng);
 
+/** Maximum number of odd multiples in a table built by ecmult_point_table. */
+#define ECMULT_POINT_TABLE_SIZE 8
+
+/** Fill pre with the affine odd multiples [1*A, 3*A, 5*A, ...] used by
+ *  ecmult_with_table. pre must have room for ECMULT_POINT_TABLE_SIZE points. */
+static void rustsecp256k1zkp_v0_5_0_ecmult_point_table(rustsecp256k1zkp_v0_5_0_ge_storage *pre, const rustsecp256k1zkp_v0_5_0_gej *a);
+
+/** Double multiply with a table from ecmult_point_table: R = na*A + ng*G.
+ *  Skips building the table of A, which pays off when A is used many times. */
+static void rustsecp256k1zkp_v0_5_0_ecmult_with_table(const rustsecp256k1zkp_v0_5_0_ecmult_context *ctx, rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_ge_storage *pre_a, const rustsecp256k1zkp_v0_5_0_scalar *na, const rustsecp256k1zkp_v0_5_0_scalar *ng);
+
 typedef int (rustsecp256k1zkp_v0_5_0_ecmult_multi_callback)(rustsecp256k1zkp_v0_5_0_scalar *sc, rustsecp256k1zkp_v0_5_0_ge *pt, size_t idx, void *data);
 
 /**
@@ -43,4 +54,21 @@ typedef int (rustsecp256k1zkp_v0_5_0_ecmult_multi_callback)(rustsecp256k1zkp_v0_
  */
 static int rustsecp256k1zkp_v0_5_0_ecmult_multi_var(const rustsecp256k1zkp_v0_5_0_callback* error_callback, const rustsecp256k1zkp_v0_5_0_ecmult_context *ctx, rustsecp256k1zkp_v0_5_0_scratch *scratch, rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_scalar *inp_g_sc, rustsecp256k1zkp_v0_5_0_ecmult_multi_callback cb, void *cbdata, size_t n);
 
+/**
+ * Multi-multiply split across n_workers tasks run by the given task runner.
+ * Worker j multiplies a contiguous range of the points with scratch[j] and
+ * calls cb with cbdata[j], so callbacks with state need one copy of it per
+ * worker. Worker 0 also multiplies G. The partial sums are added up once the
+ * runner returns. Small inputs use fewer workers, and if the worker state does
+ * not fit into scratch[0] this falls back to ecmult_multi_var with worker 0.
+ * Returns: 1 on success, 0 if any worker fails.
+ */
+static int rustsecp256k1zkp_v0_5_0_ecmult_multi_var_parallel(const rustsecp256k1zkp_v0_5_0_callback* error_callback, const rustsecp256k1zkp_v0_5_0_ecmult_context *ctx, rustsecp256k1zkp_v0_5_0_scratch *const *scratch, size_t n_workers, rustsecp256k1zkp_v0_5_0_task_runner runner, void *runner_data, rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_scalar *inp_g_sc, rustsecp256k1zkp_v0_5_0_ecmult_multi_callback cb, void *const *cbdata, size_t n);
+
+/** Times the algorithms of ecmult_multi_var on the running CPU and makes
+ *  ecmult_multi_var choose between them by these timings whenever it uses this
+ *  scratch space. Returns 0 and leaves the scratch space unchanged if it is too
+ *  small for pippenger_batch. */
+static int rustsecp256k1zkp_v0_5_0_ecmult_multi_calibrate(const rustsecp256k1zkp_v0_5_0_callback* error_callback, const rustsecp256k1zkp_v0_5_0_ecmult_context *ctx, rustsecp256k1zkp_v0_5_0_scratch *scratch, rustsecp256k1zkp_v0_5_0_timer timer, void *timer_data);
+
 #endif /* SECP256K1_ECMULT_H */
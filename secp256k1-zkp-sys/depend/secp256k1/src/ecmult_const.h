@@ -10,6 +10,34 @@
 #include "scalar.h"
 #include "group.h"
 
+/* The window sizes of ecmult_const for scalars of more than 128 bits, which
+ * it splits into two halves with the endomorphism, and for shorter ones, like
+ * the 64-bit values of Pedersen commitments. A window of w bits takes one
+ * addition per w - 1 bits of the scalar, and a table of 2^(w-2) points which
+ * every addition scans in full. */
+#define ECMULT_CONST_MIN_WINDOW 2
+#define ECMULT_CONST_MAX_WINDOW 8
+#if defined(EXHAUSTIVE_TEST_ORDER)
+/* The tables cannot have infinities in them, see WINDOW_A in ecmult_impl.h */
+#  define ECMULT_CONST_WINDOW WINDOW_A
+#  define ECMULT_CONST_SHORT_WINDOW WINDOW_A
+#else
+#  ifndef ECMULT_CONST_WINDOW
+#    define ECMULT_CONST_WINDOW 5
+#  endif
+#  ifndef ECMULT_CONST_SHORT_WINDOW
+#    define ECMULT_CONST_SHORT_WINDOW 5
+#  endif
+#  if ECMULT_CONST_WINDOW < ECMULT_CONST_MIN_WINDOW || ECMULT_CONST_WINDOW > ECMULT_CONST_MAX_WINDOW
+#    error Set ECMULT_CONST_WINDOW to an integer in range [2..8]
+#  endif
+#  if ECMULT_CONST_SHORT_WINDOW < ECMULT_CONST_MIN_WINDOW || ECMULT_CONST_SHORT_WINDOW > ECMULT_CONST_MAX_WINDOW
+#    error Set ECMULT_CONST_SHORT_WINDOW to an integer in range [2..8]
+#  endif
+#endif
+/* The larger of the two, which sizes the tables on the stack. */
+#define ECMULT_CONST_TABLE_WINDOW (ECMULT_CONST_WINDOW > ECMULT_CONST_SHORT_WINDOW ? ECMULT_CONST_WINDOW : ECMULT_CONST_SHORT_WINDOW)
+
 /**
  * Multiply: R = q*A (in constant-time)
  * Here `bits` should be set to the maximum bitlength of the _absolute value_ of `q`, plus
@@ -17,4 +45,28 @@
  */
 static void rustsecp256k1zkp_v0_5_0_ecmult_const(rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_ge *a, const rustsecp256k1zkp_v0_5_0_scalar *q, int bits);
 
+/** The number of points in a table of ecmult_fixed with the given number of
+ *  bits per window, from 1 to ECMULT_FIXED_MAX_BITS. */
+#define ECMULT_FIXED_MAX_BITS 8
+#define ECMULT_FIXED_WINDOWS(bits) ((256 + (bits) - 1) / (bits))
+#define ECMULT_FIXED_TABLE_SIZE(bits) (ECMULT_FIXED_WINDOWS(bits) << (bits))
+
+/**
+ * Fill pre with the ECMULT_FIXED_TABLE_SIZE(bits) points ecmult_fixed needs to
+ * multiply A by any scalar. Runs in variable time.
+ */
+static void rustsecp256k1zkp_v0_5_0_ecmult_fixed_table(rustsecp256k1zkp_v0_5_0_ge_storage *pre, const rustsecp256k1zkp_v0_5_0_ge *a, int bits);
+
+/**
+ * Multiply: R = q*A (in constant-time), with a table built for A by
+ * ecmult_fixed_table. Takes one addition and no doubling per window of bits
+ * bits of q.
+ */
+static void rustsecp256k1zkp_v0_5_0_ecmult_fixed(rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_ge_storage *pre, int bits, const rustsecp256k1zkp_v0_5_0_scalar *q);
+
+/**
+ * Multiply: R = q*A like ecmult_fixed, but in variable time.
+ */
+static void rustsecp256k1zkp_v0_5_0_ecmult_fixed_var(rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_ge_storage *pre, int bits, const rustsecp256k1zkp_v0_5_0_scalar *q);
+
 #endif /* SECP256K1_ECMULT_CONST_H */
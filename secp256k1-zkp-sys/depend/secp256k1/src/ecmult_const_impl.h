@@ -134,31 +134,40 @@ static int rustsecp256k1zkp_v0_5_0_wnaf_const(int *wnaf, const rustsecp256k1zkp_
     return skew;
 }
 
-static void rustsecp256k1zkp_v0_5_0_ecmult_const(rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_ge *a, const rustsecp256k1zkp_v0_5_0_scalar *scalar, int size) {
-    rustsecp256k1zkp_v0_5_0_ge pre_a[ECMULT_TABLE_SIZE(WINDOW_A)];
+/* Multiply: R = q*A (in constant-time), with a table of the odd multiples of
+ * A (and of lambda*A for scalars of more than 128 bits) for windows of w bits,
+ * which must be ECMULT_CONST_WINDOW or ECMULT_CONST_SHORT_WINDOW.
+ * w, size and everything derived from them must be public. */
+static void rustsecp256k1zkp_v0_5_0_ecmult_const_window(rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_ge *a, const rustsecp256k1zkp_v0_5_0_scalar *scalar, int size, int w) {
+    rustsecp256k1zkp_v0_5_0_ge pre_a[ECMULT_TABLE_SIZE(ECMULT_CONST_TABLE_WINDOW)];
+    rustsecp256k1zkp_v0_5_0_gej prej[ECMULT_TABLE_SIZE(ECMULT_CONST_TABLE_WINDOW)];
+    rustsecp256k1zkp_v0_5_0_fe zr[ECMULT_TABLE_SIZE(ECMULT_CONST_TABLE_WINDOW)];
     rustsecp256k1zkp_v0_5_0_ge tmpa;
     rustsecp256k1zkp_v0_5_0_fe Z;
 
     int skew_1;
-    rustsecp256k1zkp_v0_5_0_ge pre_a_lam[ECMULT_TABLE_SIZE(WINDOW_A)];
-    int wnaf_lam[1 + WNAF_SIZE(WINDOW_A - 1)];
+    rustsecp256k1zkp_v0_5_0_ge pre_a_lam[ECMULT_TABLE_SIZE(ECMULT_CONST_TABLE_WINDOW)];
+    int wnaf_lam[1 + WNAF_SIZE(ECMULT_CONST_MIN_WINDOW - 1)];
     int skew_lam;
     rustsecp256k1zkp_v0_5_0_scalar q_1, q_lam;
-    int wnaf_1[1 + WNAF_SIZE(WINDOW_A - 1)];
+    int wnaf_1[1 + WNAF_SIZE(ECMULT_CONST_MIN_WINDOW - 1)];
 
     int i;
+    int rsize = size;
+
+    VERIFY_CHECK(w == ECMULT_CONST_WINDOW || w == ECMULT_CONST_SHORT_WINDOW);
+    VERIFY_CHECK(size > 0 && size <= 256);
 
     /* build wnaf representation for q. */
-    int rsize = size;
     if (size > 128) {
         rsize = 128;
         /* split q into q_1 and q_lam (where q = q_1 + q_lam*lambda, and q_1 and q_lam are ~128 bit) */
         rustsecp256k1zkp_v0_5_0_scalar_split_lambda(&q_1, &q_lam, scalar);
-        skew_1   = rustsecp256k1zkp_v0_5_0_wnaf_const(wnaf_1,   &q_1,   WINDOW_A - 1, 128);
-        skew_lam = rustsecp256k1zkp_v0_5_0_wnaf_const(wnaf_lam, &q_lam, WINDOW_A - 1, 128);
+        skew_1   = rustsecp256k1zkp_v0_5_0_wnaf_const(wnaf_1,   &q_1,   w - 1, 128);
+        skew_lam = rustsecp256k1zkp_v0_5_0_wnaf_const(wnaf_lam, &q_lam, w - 1, 128);
     } else
     {
-        skew_1   = rustsecp256k1zkp_v0_5_0_wnaf_const(wnaf_1, scalar, WINDOW_A - 1, size);
+        skew_1   = rustsecp256k1zkp_v0_5_0_wnaf_const(wnaf_1, scalar, w - 1, size);
         skew_lam = 0;
     }
 
@@ -169,12 +178,13 @@ static void rustsecp256k1zkp_v0_5_0_ecmult_const(rustsecp256k1zkp_v0_5_0_gej *r,
      * the Z coordinate of the result once at the end.
      */
     rustsecp256k1zkp_v0_5_0_gej_set_ge(r, a);
-    rustsecp256k1zkp_v0_5_0_ecmult_odd_multiples_table_globalz_windowa(pre_a, &Z, r);
-    for (i = 0; i < ECMULT_TABLE_SIZE(WINDOW_A); i++) {
+    rustsecp256k1zkp_v0_5_0_ecmult_odd_multiples_table(ECMULT_TABLE_SIZE(w), prej, zr, r);
+    rustsecp256k1zkp_v0_5_0_ge_globalz_set_table_gej(ECMULT_TABLE_SIZE(w), pre_a, &Z, prej, zr);
+    for (i = 0; i < ECMULT_TABLE_SIZE(w); i++) {
         rustsecp256k1zkp_v0_5_0_fe_normalize_weak(&pre_a[i].y);
     }
     if (size > 128) {
-        for (i = 0; i < ECMULT_TABLE_SIZE(WINDOW_A); i++) {
+        for (i = 0; i < ECMULT_TABLE_SIZE(w); i++) {
             rustsecp256k1zkp_v0_5_0_ge_mul_lambda(&pre_a_lam[i], &pre_a[i]);
         }
 
@@ -183,31 +193,31 @@ static void rustsecp256k1zkp_v0_5_0_ecmult_const(rustsecp256k1zkp_v0_5_0_gej *r,
     /* first loop iteration (separated out so we can directly set r, rather
      * than having it start at infinity, get doubled several times, then have
      * its new value added to it) */
-    i = wnaf_1[WNAF_SIZE_BITS(rsize, WINDOW_A - 1)];
+    i = wnaf_1[WNAF_SIZE_BITS(rsize, w - 1)];
     VERIFY_CHECK(i != 0);
-    ECMULT_CONST_TABLE_GET_GE(&tmpa, pre_a, i, WINDOW_A);
+    ECMULT_CONST_TABLE_GET_GE(&tmpa, pre_a, i, w);
     rustsecp256k1zkp_v0_5_0_gej_set_ge(r, &tmpa);
     if (size > 128) {
-        i = wnaf_lam[WNAF_SIZE_BITS(rsize, WINDOW_A - 1)];
+        i = wnaf_lam[WNAF_SIZE_BITS(rsize, w - 1)];
         VERIFY_CHECK(i != 0);
-        ECMULT_CONST_TABLE_GET_GE(&tmpa, pre_a_lam, i, WINDOW_A);
+        ECMULT_CONST_TABLE_GET_GE(&tmpa, pre_a_lam, i, w);
         rustsecp256k1zkp_v0_5_0_gej_add_ge(r, r, &tmpa);
     }
     /* remaining loop iterations */
-    for (i = WNAF_SIZE_BITS(rsize, WINDOW_A - 1) - 1; i >= 0; i--) {
+    for (i = WNAF_SIZE_BITS(rsize, w - 1) - 1; i >= 0; i--) {
         int n;
         int j;
-        for (j = 0; j < WINDOW_A - 1; ++j) {
+        for (j = 0; j < w - 1; ++j) {
             rustsecp256k1zkp_v0_5_0_gej_double(r, r);
         }
 
         n = wnaf_1[i];
-        ECMULT_CONST_TABLE_GET_GE(&tmpa, pre_a, n, WINDOW_A);
+        ECMULT_CONST_TABLE_GET_GE(&tmpa, pre_a, n, w);
         VERIFY_CHECK(n != 0);
         rustsecp256k1zkp_v0_5_0_gej_add_ge(r, r, &tmpa);
         if (size > 128) {
             n = wnaf_lam[i];
-            ECMULT_CONST_TABLE_GET_GE(&tmpa, pre_a_lam, n, WINDOW_A);
+            ECMULT_CONST_TABLE_GET_GE(&tmpa, pre_a_lam, n, w);
             VERIFY_CHECK(n != 0);
             rustsecp256k1zkp_v0_5_0_gej_add_ge(r, r, &tmpa);
         }
@@ -216,38 +226,149 @@ static void rustsecp256k1zkp_v0_5_0_ecmult_const(rustsecp256k1zkp_v0_5_0_gej *r,
     rustsecp256k1zkp_v0_5_0_fe_mul(&r->z, &r->z, &Z);
 
     {
-        /* Correct for wNAF skew */
-        rustsecp256k1zkp_v0_5_0_ge correction = *a;
-        rustsecp256k1zkp_v0_5_0_ge_storage correction_1_stor;
-        rustsecp256k1zkp_v0_5_0_ge_storage correction_lam_stor;
-        rustsecp256k1zkp_v0_5_0_ge_storage a2_stor;
+        /* Correct for wNAF skew. For even numbers it is 1 (so subtract a),
+         * for odd ones 2 (so subtract a twice). This takes two additions
+         * and a cmov instead of the field inversion that bringing 2a to
+         * affine coordinates would need. */
+        rustsecp256k1zkp_v0_5_0_ge correction;
         rustsecp256k1zkp_v0_5_0_gej tmpj;
-        rustsecp256k1zkp_v0_5_0_gej_set_ge(&tmpj, &correction);
-        rustsecp256k1zkp_v0_5_0_gej_double_var(&tmpj, &tmpj, NULL);
-        rustsecp256k1zkp_v0_5_0_ge_set_gej(&correction, &tmpj);
-        rustsecp256k1zkp_v0_5_0_ge_to_storage(&correction_1_stor, a);
+        rustsecp256k1zkp_v0_5_0_ge_neg(&correction, a);
+        rustsecp256k1zkp_v0_5_0_gej_add_ge(r, r, &correction);
+        rustsecp256k1zkp_v0_5_0_gej_add_ge(&tmpj, r, &correction);
+        rustsecp256k1zkp_v0_5_0_gej_cmov(r, &tmpj, skew_1 == 2);
+
         if (size > 128) {
-            rustsecp256k1zkp_v0_5_0_ge_to_storage(&correction_lam_stor, a);
+            rustsecp256k1zkp_v0_5_0_ge_mul_lambda(&correction, &correction);
+            rustsecp256k1zkp_v0_5_0_gej_add_ge(r, r, &correction);
+            rustsecp256k1zkp_v0_5_0_gej_add_ge(&tmpj, r, &correction);
+            rustsecp256k1zkp_v0_5_0_gej_cmov(r, &tmpj, skew_lam == 2);
         }
-        rustsecp256k1zkp_v0_5_0_ge_to_storage(&a2_stor, &correction);
+    }
+}
 
-        /* For odd numbers this is 2a (so replace it), for even ones a (so no-op) */
-        rustsecp256k1zkp_v0_5_0_ge_storage_cmov(&correction_1_stor, &a2_stor, skew_1 == 2);
-        if (size > 128) {
-            rustsecp256k1zkp_v0_5_0_ge_storage_cmov(&correction_lam_stor, &a2_stor, skew_lam == 2);
+static void rustsecp256k1zkp_v0_5_0_ecmult_const(rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_ge *a, const rustsecp256k1zkp_v0_5_0_scalar *q, int bits) {
+    rustsecp256k1zkp_v0_5_0_ecmult_const_window(r, a, q, bits, bits > 128 ? ECMULT_CONST_WINDOW : ECMULT_CONST_SHORT_WINDOW);
+}
+
+/* The number of table entries ecmult_fixed_table converts to affine
+ * coordinates with one field inversion */
+#define ECMULT_FIXED_BATCH 32
+
+/* Tries to fill pre with the table of ecmult_fixed for a, where window j
+ * holds 2^j*nums + i*2^(j*bits)*a for all i (and the offset of the last window
+ * cancels all others). Returns 0 if any entry is infinity, which the
+ * constant-time addition of ecmult_fixed does not support. */
+static int rustsecp256k1zkp_v0_5_0_ecmult_fixed_table_try(rustsecp256k1zkp_v0_5_0_ge_storage *pre, const rustsecp256k1zkp_v0_5_0_ge *a, int bits, const rustsecp256k1zkp_v0_5_0_gej *nums) {
+    rustsecp256k1zkp_v0_5_0_gej batchj[ECMULT_FIXED_BATCH];
+    rustsecp256k1zkp_v0_5_0_ge batch[ECMULT_FIXED_BATCH];
+    rustsecp256k1zkp_v0_5_0_gej base, numsbase, cur;
+    int n_windows = ECMULT_FIXED_WINDOWS(bits);
+    int i, j, k = 0, m;
+    size_t n = 0;
+
+    rustsecp256k1zkp_v0_5_0_gej_set_ge(&base, a);
+    numsbase = *nums;
+    for (j = 0; j < n_windows; j++) {
+        cur = numsbase;
+        for (i = 0; i < (1 << bits); i++) {
+            if (i > 0) {
+                rustsecp256k1zkp_v0_5_0_gej_add_var(&cur, &cur, &base, NULL);
+            }
+            if (rustsecp256k1zkp_v0_5_0_gej_is_infinity(&cur)) {
+                return 0;
+            }
+            batchj[k++] = cur;
+            if (k == ECMULT_FIXED_BATCH) {
+                rustsecp256k1zkp_v0_5_0_ge_set_all_gej_var(batch, batchj, k);
+                for (m = 0; m < k; m++) {
+                    rustsecp256k1zkp_v0_5_0_ge_to_storage(&pre[n++], &batch[m]);
+                }
+                k = 0;
+            }
+        }
+        for (i = 0; i < bits; i++) {
+            rustsecp256k1zkp_v0_5_0_gej_double_var(&base, &base, NULL);
         }
+        rustsecp256k1zkp_v0_5_0_gej_double_var(&numsbase, &numsbase, NULL);
+        if (j == n_windows - 2) {
+            /* In the last iteration, numsbase is (1 - 2^j) * nums instead. */
+            rustsecp256k1zkp_v0_5_0_gej_neg(&numsbase, &numsbase);
+            rustsecp256k1zkp_v0_5_0_gej_add_var(&numsbase, &numsbase, nums, NULL);
+        }
+    }
+    if (k > 0) {
+        rustsecp256k1zkp_v0_5_0_ge_set_all_gej_var(batch, batchj, k);
+        for (m = 0; m < k; m++) {
+            rustsecp256k1zkp_v0_5_0_ge_to_storage(&pre[n++], &batch[m]);
+        }
+    }
+    VERIFY_CHECK(n == (size_t)ECMULT_FIXED_TABLE_SIZE(bits));
+    return 1;
+}
 
-        /* Apply the correction */
-        rustsecp256k1zkp_v0_5_0_ge_from_storage(&correction, &correction_1_stor);
-        rustsecp256k1zkp_v0_5_0_ge_neg(&correction, &correction);
-        rustsecp256k1zkp_v0_5_0_gej_add_ge(r, r, &correction);
+static void rustsecp256k1zkp_v0_5_0_ecmult_fixed_table(rustsecp256k1zkp_v0_5_0_ge_storage *pre, const rustsecp256k1zkp_v0_5_0_ge *a, int bits) {
+    static const unsigned char nums_b32[33] = "The scalar for this x is unknown";
+    rustsecp256k1zkp_v0_5_0_fe nums_x;
+    rustsecp256k1zkp_v0_5_0_ge nums_ge;
+    rustsecp256k1zkp_v0_5_0_gej nums;
+    int r;
 
-        if (size > 128) {
-            rustsecp256k1zkp_v0_5_0_ge_from_storage(&correction, &correction_lam_stor);
-            rustsecp256k1zkp_v0_5_0_ge_neg(&correction, &correction);
-            rustsecp256k1zkp_v0_5_0_ge_mul_lambda(&correction, &correction);
-            rustsecp256k1zkp_v0_5_0_gej_add_ge(r, r, &correction);
+    VERIFY_CHECK(bits >= 1 && bits <= ECMULT_FIXED_MAX_BITS);
+    VERIFY_CHECK(!a->infinity);
+
+    /* The same nothing-up-my-sleeve offset as ecmult_gen uses, so that no
+     * partial sum of ecmult_fixed is infinity unless a was chosen for it. */
+    r = rustsecp256k1zkp_v0_5_0_fe_set_b32(&nums_x, nums_b32);
+    (void)r;
+    VERIFY_CHECK(r);
+    r = rustsecp256k1zkp_v0_5_0_ge_set_xo_var(&nums_ge, &nums_x, 0);
+    (void)r;
+    VERIFY_CHECK(r);
+    rustsecp256k1zkp_v0_5_0_gej_set_ge(&nums, &nums_ge);
+    /* A maliciously chosen a can make a table entry infinity. Moving the
+     * offset changes every entry, so retry until none is. */
+    while (!rustsecp256k1zkp_v0_5_0_ecmult_fixed_table_try(pre, a, bits, &nums)) {
+        rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&nums, &nums, a, NULL);
+        rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&nums, &nums, &rustsecp256k1zkp_v0_5_0_ge_const_g, NULL);
+    }
+}
+
+static void rustsecp256k1zkp_v0_5_0_ecmult_fixed(rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_ge_storage *pre, int bits, const rustsecp256k1zkp_v0_5_0_scalar *q) {
+    rustsecp256k1zkp_v0_5_0_ge add;
+    rustsecp256k1zkp_v0_5_0_ge_storage adds;
+    int n_windows = ECMULT_FIXED_WINDOWS(bits);
+    int window;
+    int i, j;
+
+    memset(&adds, 0, sizeof(adds));
+    rustsecp256k1zkp_v0_5_0_gej_set_infinity(r);
+    for (j = 0; j < n_windows; j++) {
+        int count = j == n_windows - 1 ? 256 - j * bits : bits;
+        window = rustsecp256k1zkp_v0_5_0_scalar_get_bits_var(q, j * bits, count);
+        for (i = 0; i < (1 << bits); i++) {
+            /* This uses a conditional move to avoid any secret data in array
+             * indexes. See the comment in ecmult_gen_impl.h for rationale. */
+            rustsecp256k1zkp_v0_5_0_ge_storage_cmov(&adds, &pre[(j << bits) + i], i == window);
         }
+        rustsecp256k1zkp_v0_5_0_ge_from_storage(&add, &adds);
+        rustsecp256k1zkp_v0_5_0_gej_add_ge(r, r, &add);
+    }
+    window = 0;
+    rustsecp256k1zkp_v0_5_0_ge_clear(&add);
+    memset(&adds, 0, sizeof(adds));
+}
+
+static void rustsecp256k1zkp_v0_5_0_ecmult_fixed_var(rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_ge_storage *pre, int bits, const rustsecp256k1zkp_v0_5_0_scalar *q) {
+    rustsecp256k1zkp_v0_5_0_ge add;
+    int n_windows = ECMULT_FIXED_WINDOWS(bits);
+    int j;
+
+    rustsecp256k1zkp_v0_5_0_gej_set_infinity(r);
+    for (j = 0; j < n_windows; j++) {
+        int count = j == n_windows - 1 ? 256 - j * bits : bits;
+        int window = rustsecp256k1zkp_v0_5_0_scalar_get_bits_var(q, j * bits, count);
+        rustsecp256k1zkp_v0_5_0_ge_from_storage(&add, &pre[(j << bits) + window]);
+        rustsecp256k1zkp_v0_5_0_gej_add_ge_var(r, r, &add, NULL);
     }
 }
 
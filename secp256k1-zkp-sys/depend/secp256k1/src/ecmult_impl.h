@@ -68,14 +68,24 @@
 
 /* The number of objects allocated on the scratch space for ecmult_multi algorithms */
 #define PIPPENGER_SCRATCH_OBJECTS 6
+#define PIPPENGER_AFFINE_SCRATCH_OBJECTS 11
 #define STRAUSS_SCRATCH_OBJECTS 6
 
 #define PIPPENGER_MAX_BUCKET_WINDOW 12
 
+#if PIPPENGER_MAX_BUCKET_WINDOW != SCRATCH_TUNING_WINDOWS
+#error "SCRATCH_TUNING_WINDOWS must match PIPPENGER_MAX_BUCKET_WINDOW"
+#endif
+
 /* Minimum number of points for which pippenger_wnaf is faster than strauss wnaf */
 #define ECMULT_PIPPENGER_THRESHOLD 88
+/* Minimum number of points for which pippenger_affine_wnaf is faster than pippenger_wnaf */
+#define ECMULT_PIPPENGER_AFFINE_THRESHOLD 256
 
 #define ECMULT_MAX_POINTS_PER_BATCH 5000000
+/* Splitting fewer points than this across another worker costs more in lost
+ * Pippenger efficiency and synchronization than it saves. */
+#define ECMULT_MIN_POINTS_PER_WORKER 1024
 
 /** Fill a table 'prej' with precomputed odd multiples of a. Prej will contain
  *  the values [1*a,3*a,...,(2*n-1)*a], so it space for n values. zr[0] will
@@ -574,6 +584,83 @@ static void rustsecp256k1zkp_v0_5_0_ecmult(const rustsecp256k1zkp_v0_5_0_ecmult_
     rustsecp256k1zkp_v0_5_0_ecmult_strauss_wnaf(ctx, &state, r, 1, a, na, ng);
 }
 
+#if ECMULT_TABLE_SIZE(WINDOW_A) > ECMULT_POINT_TABLE_SIZE
+#  error ECMULT_POINT_TABLE_SIZE is too small for WINDOW_A.
+#endif
+
+static void rustsecp256k1zkp_v0_5_0_ecmult_point_table(rustsecp256k1zkp_v0_5_0_ge_storage *pre, const rustsecp256k1zkp_v0_5_0_gej *a) {
+    rustsecp256k1zkp_v0_5_0_ecmult_odd_multiples_table_storage_var(ECMULT_TABLE_SIZE(WINDOW_A), pre, a);
+}
+
+static void rustsecp256k1zkp_v0_5_0_ecmult_with_table(const rustsecp256k1zkp_v0_5_0_ecmult_context *ctx, rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_ge_storage *pre_a, const rustsecp256k1zkp_v0_5_0_scalar *na, const rustsecp256k1zkp_v0_5_0_scalar *ng) {
+    rustsecp256k1zkp_v0_5_0_ge pre_a_ge[ECMULT_TABLE_SIZE(WINDOW_A)];
+    rustsecp256k1zkp_v0_5_0_ge pre_a_lam[ECMULT_TABLE_SIZE(WINDOW_A)];
+    rustsecp256k1zkp_v0_5_0_ge tmpa;
+    rustsecp256k1zkp_v0_5_0_scalar na_1, na_lam;
+    rustsecp256k1zkp_v0_5_0_scalar ng_1, ng_128;
+    int wnaf_na_1[129];
+    int bits_na_1 = 0;
+    int wnaf_na_lam[129];
+    int bits_na_lam = 0;
+    int wnaf_ng_1[129];
+    int bits_ng_1 = 0;
+    int wnaf_ng_128[129];
+    int bits_ng_128 = 0;
+    int bits;
+    int i;
+
+    if (!rustsecp256k1zkp_v0_5_0_scalar_is_zero(na)) {
+        for (i = 0; i < ECMULT_TABLE_SIZE(WINDOW_A); i++) {
+            rustsecp256k1zkp_v0_5_0_ge_from_storage(&pre_a_ge[i], &pre_a[i]);
+            rustsecp256k1zkp_v0_5_0_ge_mul_lambda(&pre_a_lam[i], &pre_a_ge[i]);
+        }
+        /* split na into na_1 and na_lam (where na = na_1 + na_lam*lambda, and na_1 and na_lam are ~128 bit) */
+        rustsecp256k1zkp_v0_5_0_scalar_split_lambda(&na_1, &na_lam, na);
+        bits_na_1 = rustsecp256k1zkp_v0_5_0_ecmult_wnaf(wnaf_na_1, 129, &na_1, WINDOW_A);
+        bits_na_lam = rustsecp256k1zkp_v0_5_0_ecmult_wnaf(wnaf_na_lam, 129, &na_lam, WINDOW_A);
+    }
+    if (ng) {
+        /* split ng into ng_1 and ng_128 (where gn = gn_1 + gn_128*2^128, and gn_1 and gn_128 are ~128 bit) */
+        rustsecp256k1zkp_v0_5_0_scalar_split_128(&ng_1, &ng_128, ng);
+        bits_ng_1 = rustsecp256k1zkp_v0_5_0_ecmult_wnaf(wnaf_ng_1, 129, &ng_1, WINDOW_G);
+        bits_ng_128 = rustsecp256k1zkp_v0_5_0_ecmult_wnaf(wnaf_ng_128, 129, &ng_128, WINDOW_G);
+    }
+    bits = bits_na_1;
+    if (bits_na_lam > bits) {
+        bits = bits_na_lam;
+    }
+    if (bits_ng_1 > bits) {
+        bits = bits_ng_1;
+    }
+    if (bits_ng_128 > bits) {
+        bits = bits_ng_128;
+    }
+
+    /* All tables are affine, so unlike ecmult_strauss_wnaf no Z correction
+     * is needed at the end. */
+    rustsecp256k1zkp_v0_5_0_gej_set_infinity(r);
+    for (i = bits - 1; i >= 0; i--) {
+        int n;
+        rustsecp256k1zkp_v0_5_0_gej_double_var(r, r, NULL);
+        if (i < bits_na_1 && (n = wnaf_na_1[i])) {
+            ECMULT_TABLE_GET_GE(&tmpa, pre_a_ge, n, WINDOW_A);
+            rustsecp256k1zkp_v0_5_0_gej_add_ge_var(r, r, &tmpa, NULL);
+        }
+        if (i < bits_na_lam && (n = wnaf_na_lam[i])) {
+            ECMULT_TABLE_GET_GE(&tmpa, pre_a_lam, n, WINDOW_A);
+            rustsecp256k1zkp_v0_5_0_gej_add_ge_var(r, r, &tmpa, NULL);
+        }
+        if (i < bits_ng_1 && (n = wnaf_ng_1[i])) {
+            ECMULT_TABLE_GET_GE_STORAGE(&tmpa, *ctx->pre_g, n, WINDOW_G);
+            rustsecp256k1zkp_v0_5_0_gej_add_ge_var(r, r, &tmpa, NULL);
+        }
+        if (i < bits_ng_128 && (n = wnaf_ng_128[i])) {
+            ECMULT_TABLE_GET_GE_STORAGE(&tmpa, *ctx->pre_g_128, n, WINDOW_G);
+            rustsecp256k1zkp_v0_5_0_gej_add_ge_var(r, r, &tmpa, NULL);
+        }
+    }
+}
+
 static size_t rustsecp256k1zkp_v0_5_0_strauss_scratch_size(size_t n_points) {
     static const size_t point_size = (2 * sizeof(rustsecp256k1zkp_v0_5_0_ge) + sizeof(rustsecp256k1zkp_v0_5_0_gej) + sizeof(rustsecp256k1zkp_v0_5_0_fe)) * ECMULT_TABLE_SIZE(WINDOW_A) + sizeof(struct rustsecp256k1zkp_v0_5_0_strauss_point_state) + sizeof(rustsecp256k1zkp_v0_5_0_gej) + sizeof(rustsecp256k1zkp_v0_5_0_scalar);
     return n_points*point_size;
@@ -789,6 +876,258 @@ static int rustsecp256k1zkp_v0_5_0_ecmult_pippenger_wnaf(rustsecp256k1zkp_v0_5_0
     return 1;
 }
 
+/* Additional state of pippenger_affine_wnaf. The points of bucket j are
+ * sorted[bucket_start[j]] to sorted[bucket_start[j] + bucket_len[j] - 1].
+ * fe_vec caches fe_vec_available for the batch field operations. */
+struct rustsecp256k1zkp_v0_5_0_pippenger_affine_state {
+    rustsecp256k1zkp_v0_5_0_ge *sorted;
+    rustsecp256k1zkp_v0_5_0_fe *inv;
+    rustsecp256k1zkp_v0_5_0_fe *acc;
+    size_t *bucket_start;
+    size_t *bucket_len;
+    int fe_vec;
+};
+
+/* Sets d to the denominator of the slope of the line through a and b, or to 1
+ * if a + b can be computed without a division. d is never zero. */
+static void rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_denominator(rustsecp256k1zkp_v0_5_0_fe *d, const rustsecp256k1zkp_v0_5_0_ge *a, const rustsecp256k1zkp_v0_5_0_ge *b) {
+    rustsecp256k1zkp_v0_5_0_fe t;
+
+    if (a->infinity || b->infinity) {
+        rustsecp256k1zkp_v0_5_0_fe_set_int(d, 1);
+        return;
+    }
+    rustsecp256k1zkp_v0_5_0_fe_negate(d, &a->x, 1);
+    rustsecp256k1zkp_v0_5_0_fe_add(d, &b->x);
+    if (rustsecp256k1zkp_v0_5_0_fe_normalizes_to_zero_var(d)) {
+        rustsecp256k1zkp_v0_5_0_fe_negate(&t, &a->y, 1);
+        rustsecp256k1zkp_v0_5_0_fe_add(&t, &b->y);
+        if (rustsecp256k1zkp_v0_5_0_fe_normalizes_to_zero_var(&t)) {
+            /* a == b, the slope of the tangent is 3*x^2 / 2*y */
+            *d = a->y;
+            rustsecp256k1zkp_v0_5_0_fe_mul_int(d, 2);
+        } else {
+            /* a == -b */
+            rustsecp256k1zkp_v0_5_0_fe_set_int(d, 1);
+        }
+    }
+}
+
+/* Sets n to the numerator of the slope of the line through a and b, matching
+ * ecmult_pippenger_affine_denominator. If a + b needs no division, n is
+ * arbitrary. n has magnitude at most 3. */
+static void rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_numerator(rustsecp256k1zkp_v0_5_0_fe *n, const rustsecp256k1zkp_v0_5_0_ge *a, const rustsecp256k1zkp_v0_5_0_ge *b) {
+    rustsecp256k1zkp_v0_5_0_fe t;
+
+    if (a->infinity || b->infinity) {
+        rustsecp256k1zkp_v0_5_0_fe_set_int(n, 0);
+        return;
+    }
+    rustsecp256k1zkp_v0_5_0_fe_negate(&t, &a->x, 1);
+    rustsecp256k1zkp_v0_5_0_fe_add(&t, &b->x);
+    if (rustsecp256k1zkp_v0_5_0_fe_normalizes_to_zero_var(&t)) {
+        rustsecp256k1zkp_v0_5_0_fe_sqr(n, &a->x);
+        rustsecp256k1zkp_v0_5_0_fe_mul_int(n, 3);
+    } else {
+        rustsecp256k1zkp_v0_5_0_fe_negate(n, &a->y, 1);
+        rustsecp256k1zkp_v0_5_0_fe_add(n, &b->y);
+    }
+}
+
+/* Sets r = a + b given t = a.x - x3 and lt = lambda*t, where lambda is the
+ * slope and x3 = lambda^2 - a.x - b.x. The coordinates of a and b must have
+ * magnitude 1, and so do the coordinates of r. r may alias a or b. */
+static void rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_add(rustsecp256k1zkp_v0_5_0_ge *r, const rustsecp256k1zkp_v0_5_0_ge *a, const rustsecp256k1zkp_v0_5_0_ge *b, const rustsecp256k1zkp_v0_5_0_fe *t, const rustsecp256k1zkp_v0_5_0_fe *lt) {
+    rustsecp256k1zkp_v0_5_0_fe x3, y3, u;
+
+    if (a->infinity) {
+        *r = *b;
+        return;
+    }
+    if (b->infinity) {
+        *r = *a;
+        return;
+    }
+    rustsecp256k1zkp_v0_5_0_fe_negate(&u, &a->x, 1);
+    rustsecp256k1zkp_v0_5_0_fe_add(&u, &b->x);
+    if (rustsecp256k1zkp_v0_5_0_fe_normalizes_to_zero_var(&u)) {
+        rustsecp256k1zkp_v0_5_0_fe_negate(&u, &a->y, 1);
+        rustsecp256k1zkp_v0_5_0_fe_add(&u, &b->y);
+        if (!rustsecp256k1zkp_v0_5_0_fe_normalizes_to_zero_var(&u)) {
+            rustsecp256k1zkp_v0_5_0_ge_set_infinity(r);
+            return;
+        }
+    }
+    /* x3 = a.x - t, y3 = lambda*(a.x - x3) - a.y */
+    rustsecp256k1zkp_v0_5_0_fe_negate(&x3, t, 5);
+    rustsecp256k1zkp_v0_5_0_fe_add(&x3, &a->x);
+    rustsecp256k1zkp_v0_5_0_fe_negate(&y3, &a->y, 1);
+    rustsecp256k1zkp_v0_5_0_fe_add(&y3, lt);
+    rustsecp256k1zkp_v0_5_0_fe_normalize_weak(&x3);
+    rustsecp256k1zkp_v0_5_0_fe_normalize_weak(&y3);
+    rustsecp256k1zkp_v0_5_0_ge_set_xy(r, &x3, &y3);
+}
+
+/* Adds up the points of every bucket in affine coordinates until each bucket
+ * holds at most one point. In every round the points of each bucket are added
+ * pairwise, and all additions of a round share a single field inversion
+ * (Montgomery's trick), which makes them cheaper than mixed additions. The
+ * multiplications of a round are done with the batch field operations, which
+ * process eight pairs at once where the CPU supports it. */
+static void rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_reduce(struct rustsecp256k1zkp_v0_5_0_pippenger_affine_state *state, size_t n_buckets) {
+    for (;;) {
+        size_t n_pairs = 0;
+        size_t i, j, k;
+
+        for (j = 0; j < n_buckets; j++) {
+            const rustsecp256k1zkp_v0_5_0_ge *p = &state->sorted[state->bucket_start[j]];
+            for (k = 0; k + 1 < state->bucket_len[j]; k += 2) {
+                rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_denominator(&state->acc[n_pairs++], &p[k], &p[k + 1]);
+            }
+        }
+        if (n_pairs == 0) {
+            return;
+        }
+        rustsecp256k1zkp_v0_5_0_fe_inv_all_var(state->inv, state->acc, n_pairs, state->fe_vec);
+
+        /* lambda = numerator / denominator, into inv, and lambda^2 into acc. */
+        i = 0;
+        for (j = 0; j < n_buckets; j++) {
+            const rustsecp256k1zkp_v0_5_0_ge *p = &state->sorted[state->bucket_start[j]];
+            for (k = 0; k + 1 < state->bucket_len[j]; k += 2) {
+                rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_numerator(&state->acc[i++], &p[k], &p[k + 1]);
+            }
+        }
+        rustsecp256k1zkp_v0_5_0_fe_mul_all(state->inv, state->inv, state->acc, n_pairs, state->fe_vec);
+        rustsecp256k1zkp_v0_5_0_fe_sqr_all(state->acc, state->inv, n_pairs, state->fe_vec);
+
+        /* t = a.x - x3 = 2*a.x + b.x - lambda^2 into acc, and lambda*t into inv. */
+        i = 0;
+        for (j = 0; j < n_buckets; j++) {
+            const rustsecp256k1zkp_v0_5_0_ge *p = &state->sorted[state->bucket_start[j]];
+            for (k = 0; k + 1 < state->bucket_len[j]; k += 2) {
+                rustsecp256k1zkp_v0_5_0_fe_negate(&state->acc[i], &state->acc[i], 1);
+                rustsecp256k1zkp_v0_5_0_fe_add(&state->acc[i], &p[k].x);
+                rustsecp256k1zkp_v0_5_0_fe_add(&state->acc[i], &p[k].x);
+                rustsecp256k1zkp_v0_5_0_fe_add(&state->acc[i], &p[k + 1].x);
+                i++;
+            }
+        }
+        rustsecp256k1zkp_v0_5_0_fe_mul_all(state->inv, state->inv, state->acc, n_pairs, state->fe_vec);
+
+        /* The sum of points 2*k and 2*k + 1 of a bucket becomes its point k. */
+        i = 0;
+        for (j = 0; j < n_buckets; j++) {
+            rustsecp256k1zkp_v0_5_0_ge *p = &state->sorted[state->bucket_start[j]];
+            size_t len = state->bucket_len[j];
+            for (k = 0; k + 1 < len; k += 2) {
+                rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_add(&p[k / 2], &p[k], &p[k + 1], &state->acc[i], &state->inv[i]);
+                i++;
+            }
+            if (len % 2 == 1) {
+                p[len / 2] = p[len - 1];
+            }
+            state->bucket_len[j] = (len + 1) / 2;
+        }
+    }
+}
+
+/*
+ * pippenger_affine_wnaf computes the same result as pippenger_wnaf, but sorts
+ * the points of each window by bucket and adds them up with
+ * ecmult_pippenger_affine_reduce instead of adding each point to its bucket
+ * in Jacobian coordinates.
+ */
+static int rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_wnaf(struct rustsecp256k1zkp_v0_5_0_pippenger_affine_state *affine_state, int bucket_window, struct rustsecp256k1zkp_v0_5_0_pippenger_state *state, rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_scalar *sc, const rustsecp256k1zkp_v0_5_0_ge *pt, size_t num) {
+    size_t n_wnaf = WNAF_SIZE(bucket_window+1);
+    size_t n_buckets = ECMULT_TABLE_SIZE(bucket_window+2);
+    size_t np;
+    size_t no = 0;
+    size_t j;
+    int i;
+
+    for (np = 0; np < num; ++np) {
+        if (rustsecp256k1zkp_v0_5_0_scalar_is_zero(&sc[np]) || rustsecp256k1zkp_v0_5_0_ge_is_infinity(&pt[np])) {
+            continue;
+        }
+        state->ps[no].input_pos = np;
+        state->ps[no].skew_na = rustsecp256k1zkp_v0_5_0_wnaf_fixed(&state->wnaf_na[no*n_wnaf], &sc[np], bucket_window+1);
+        no++;
+    }
+    rustsecp256k1zkp_v0_5_0_gej_set_infinity(r);
+
+    if (no == 0) {
+        return 1;
+    }
+
+    for (i = n_wnaf - 1; i >= 0; i--) {
+        rustsecp256k1zkp_v0_5_0_gej running_sum;
+        size_t pos = 0;
+
+        /* Sort the points of this window by bucket. */
+        for (j = 0; j < n_buckets; j++) {
+            affine_state->bucket_len[j] = 0;
+        }
+        for (np = 0; np < no; ++np) {
+            int n = state->wnaf_na[np*n_wnaf + i];
+            if (n != 0) {
+                affine_state->bucket_len[(n > 0 ? n - 1 : -n - 1) / 2]++;
+            }
+        }
+        for (j = 0; j < n_buckets; j++) {
+            affine_state->bucket_start[j] = pos;
+            pos += affine_state->bucket_len[j];
+            affine_state->bucket_len[j] = 0;
+        }
+        for (np = 0; np < no; ++np) {
+            int n = state->wnaf_na[np*n_wnaf + i];
+            rustsecp256k1zkp_v0_5_0_ge *p;
+            if (n == 0) {
+                continue;
+            }
+            j = (n > 0 ? n - 1 : -n - 1) / 2;
+            p = &affine_state->sorted[affine_state->bucket_start[j] + affine_state->bucket_len[j]++];
+            if (n > 0) {
+                *p = pt[state->ps[np].input_pos];
+            } else {
+                rustsecp256k1zkp_v0_5_0_ge_neg(p, &pt[state->ps[np].input_pos]);
+            }
+            rustsecp256k1zkp_v0_5_0_fe_normalize_weak(&p->x);
+            rustsecp256k1zkp_v0_5_0_fe_normalize_weak(&p->y);
+        }
+        rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_reduce(affine_state, n_buckets);
+
+        for (j = 0; j < (size_t)bucket_window; j++) {
+            rustsecp256k1zkp_v0_5_0_gej_double_var(r, r, NULL);
+        }
+
+        /* Accumulate the sum as in pippenger_wnaf. */
+        rustsecp256k1zkp_v0_5_0_gej_set_infinity(&running_sum);
+        for (j = n_buckets - 1; j > 0; j--) {
+            if (affine_state->bucket_len[j] > 0) {
+                rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&running_sum, &running_sum, &affine_state->sorted[affine_state->bucket_start[j]], NULL);
+            }
+            rustsecp256k1zkp_v0_5_0_gej_add_var(r, r, &running_sum, NULL);
+        }
+        if (affine_state->bucket_len[0] > 0) {
+            rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&running_sum, &running_sum, &affine_state->sorted[affine_state->bucket_start[0]], NULL);
+        }
+        if (i == 0) {
+            /* correct for wnaf skew */
+            for (np = 0; np < no; ++np) {
+                if (state->ps[np].skew_na) {
+                    rustsecp256k1zkp_v0_5_0_ge tmp;
+                    rustsecp256k1zkp_v0_5_0_ge_neg(&tmp, &pt[state->ps[np].input_pos]);
+                    rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&running_sum, &running_sum, &tmp, NULL);
+                }
+            }
+        }
+        rustsecp256k1zkp_v0_5_0_gej_double_var(r, r, NULL);
+        rustsecp256k1zkp_v0_5_0_gej_add_var(r, r, &running_sum, NULL);
+    }
+    return 1;
+}
+
 /**
  * Returns optimal bucket_window (number of bits of a scalar represented by a
  * set of buckets) for a given number of points.
@@ -840,6 +1179,101 @@ static size_t rustsecp256k1zkp_v0_5_0_pippenger_bucket_window_inv(int bucket_win
     return 0;
 }
 
+/**
+ * Returns the optimal bucket_window of pippenger_affine_wnaf for a given number
+ * of points. Measured separately from pippenger_bucket_window because filling
+ * the buckets costs less relative to summing them up.
+ */
+static int rustsecp256k1zkp_v0_5_0_pippenger_affine_bucket_window(size_t n) {
+    if (n <= 1) {
+        return 1;
+    } else if (n <= 4) {
+        return 2;
+    } else if (n <= 20) {
+        return 3;
+    } else if (n <= 57) {
+        return 4;
+    } else if (n <= 136) {
+        return 5;
+    } else if (n <= 235) {
+        return 6;
+    } else if (n <= 1500) {
+        return 7;
+    } else if (n <= 3000) {
+        return 8;
+    } else if (n <= 6000) {
+        return 9;
+    } else if (n <= 12000) {
+        return 10;
+    } else if (n <= 28000) {
+        return 11;
+    } else {
+        return PIPPENGER_MAX_BUCKET_WINDOW;
+    }
+}
+
+/**
+ * Returns the maximum optimal number of points for a bucket_window of
+ * pippenger_affine_wnaf.
+ */
+static size_t rustsecp256k1zkp_v0_5_0_pippenger_affine_bucket_window_inv(int bucket_window) {
+    switch(bucket_window) {
+        case 1: return 1;
+        case 2: return 4;
+        case 3: return 20;
+        case 4: return 57;
+        case 5: return 136;
+        case 6: return 235;
+        case 7: return 1500;
+        case 8: return 3000;
+        case 9: return 6000;
+        case 10: return 12000;
+        case 11: return 28000;
+        case PIPPENGER_MAX_BUCKET_WINDOW: return SIZE_MAX;
+    }
+    return 0;
+}
+
+/**
+ * Returns the maximum optimal number of points for a bucket_window of
+ * pippenger_batch, or of pippenger_affine_batch if affine is set, taking the
+ * measurements of ecmult_multi_calibrate if the scratch space has any.
+ */
+static size_t rustsecp256k1zkp_v0_5_0_pippenger_scratch_window_inv(const rustsecp256k1zkp_v0_5_0_scratch *scratch, int bucket_window, int affine) {
+    if (scratch->tuning.calibrated) {
+        return scratch->tuning.window_max_points[affine][bucket_window - 1];
+    }
+    return affine ? rustsecp256k1zkp_v0_5_0_pippenger_affine_bucket_window_inv(bucket_window) : rustsecp256k1zkp_v0_5_0_pippenger_bucket_window_inv(bucket_window);
+}
+
+/**
+ * Returns the optimal bucket_window of pippenger_batch, or of
+ * pippenger_affine_batch if affine is set, for a given number of points and
+ * scratch space.
+ */
+static int rustsecp256k1zkp_v0_5_0_pippenger_scratch_window(const rustsecp256k1zkp_v0_5_0_scratch *scratch, size_t n, int affine) {
+    int bucket_window;
+    if (!scratch->tuning.calibrated) {
+        return affine ? rustsecp256k1zkp_v0_5_0_pippenger_affine_bucket_window(n) : rustsecp256k1zkp_v0_5_0_pippenger_bucket_window(n);
+    }
+    for (bucket_window = 1; bucket_window < PIPPENGER_MAX_BUCKET_WINDOW; bucket_window++) {
+        if (n <= scratch->tuning.window_max_points[affine][bucket_window - 1]) {
+            break;
+        }
+    }
+    return bucket_window;
+}
+
+/**
+ * Returns the minimum number of points for which pippenger_batch, or
+ * pippenger_affine_batch if affine is set, is used with a scratch space.
+ */
+static size_t rustsecp256k1zkp_v0_5_0_pippenger_scratch_threshold(const rustsecp256k1zkp_v0_5_0_scratch *scratch, int affine) {
+    if (scratch->tuning.calibrated) {
+        return affine ? scratch->tuning.pippenger_affine_threshold : scratch->tuning.pippenger_threshold;
+    }
+    return affine ? ECMULT_PIPPENGER_AFFINE_THRESHOLD : ECMULT_PIPPENGER_THRESHOLD;
+}
 
 SECP256K1_INLINE static void rustsecp256k1zkp_v0_5_0_ecmult_endo_split(rustsecp256k1zkp_v0_5_0_scalar *s1, rustsecp256k1zkp_v0_5_0_scalar *s2, rustsecp256k1zkp_v0_5_0_ge *p1, rustsecp256k1zkp_v0_5_0_ge *p2) {
     rustsecp256k1zkp_v0_5_0_scalar tmp = *s1;
@@ -866,7 +1300,19 @@ static size_t rustsecp256k1zkp_v0_5_0_pippenger_scratch_size(size_t n_points, in
     return (sizeof(rustsecp256k1zkp_v0_5_0_gej) << bucket_window) + sizeof(struct rustsecp256k1zkp_v0_5_0_pippenger_state) + entries * entry_size;
 }
 
-static int rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch(const rustsecp256k1zkp_v0_5_0_callback* error_callback, const rustsecp256k1zkp_v0_5_0_ecmult_context *ctx, rustsecp256k1zkp_v0_5_0_scratch *scratch, rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_scalar *inp_g_sc, rustsecp256k1zkp_v0_5_0_ecmult_multi_callback cb, void *cbdata, size_t n_points, size_t cb_offset) {
+/**
+ * Returns the scratch size required by pippenger_affine_wnaf for a given
+ * number of points (excluding base point G) without considering alignment.
+ */
+static size_t rustsecp256k1zkp_v0_5_0_pippenger_affine_scratch_size(size_t n_points, int bucket_window) {
+    size_t entries = 2*n_points + 2;
+    size_t entry_size = 2*sizeof(rustsecp256k1zkp_v0_5_0_ge) + sizeof(rustsecp256k1zkp_v0_5_0_fe) + sizeof(rustsecp256k1zkp_v0_5_0_scalar) + sizeof(struct rustsecp256k1zkp_v0_5_0_pippenger_point_state) + (WNAF_SIZE(bucket_window+1)+1)*sizeof(int);
+    return ((2*sizeof(size_t)) << bucket_window) + sizeof(struct rustsecp256k1zkp_v0_5_0_pippenger_state) + sizeof(struct rustsecp256k1zkp_v0_5_0_pippenger_affine_state) + entries * entry_size;
+}
+
+/* Shared by pippenger_batch and pippenger_affine_batch, which differ in the
+ * bucket window, the scratch space layout and the kernel. */
+static int rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch_impl(const rustsecp256k1zkp_v0_5_0_callback* error_callback, rustsecp256k1zkp_v0_5_0_scratch *scratch, rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_scalar *inp_g_sc, rustsecp256k1zkp_v0_5_0_ecmult_multi_callback cb, void *cbdata, size_t n_points, size_t cb_offset, int affine, int bucket_window) {
     const size_t scratch_checkpoint = rustsecp256k1zkp_v0_5_0_scratch_checkpoint(error_callback, scratch);
     /* Use 2(n+1) with the endomorphism, when calculating batch
      * sizes. The reason for +1 is that we add the G scalar to the list of
@@ -874,20 +1320,18 @@ static int rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch(const rustsecp256k1zkp
     size_t entries = 2*n_points + 2;
     rustsecp256k1zkp_v0_5_0_ge *points;
     rustsecp256k1zkp_v0_5_0_scalar *scalars;
-    rustsecp256k1zkp_v0_5_0_gej *buckets;
+    rustsecp256k1zkp_v0_5_0_gej *buckets = NULL;
     struct rustsecp256k1zkp_v0_5_0_pippenger_state *state_space;
+    struct rustsecp256k1zkp_v0_5_0_pippenger_affine_state *affine_state = NULL;
     size_t idx = 0;
     size_t point_idx = 0;
     int i, j;
-    int bucket_window;
 
-    (void)ctx;
     rustsecp256k1zkp_v0_5_0_gej_set_infinity(r);
     if (inp_g_sc == NULL && n_points == 0) {
         return 1;
     }
 
-    bucket_window = rustsecp256k1zkp_v0_5_0_pippenger_bucket_window(n_points);
     points = (rustsecp256k1zkp_v0_5_0_ge *) rustsecp256k1zkp_v0_5_0_scratch_alloc(error_callback, scratch, entries * sizeof(*points));
     scalars = (rustsecp256k1zkp_v0_5_0_scalar *) rustsecp256k1zkp_v0_5_0_scratch_alloc(error_callback, scratch, entries * sizeof(*scalars));
     state_space = (struct rustsecp256k1zkp_v0_5_0_pippenger_state *) rustsecp256k1zkp_v0_5_0_scratch_alloc(error_callback, scratch, sizeof(*state_space));
@@ -898,11 +1342,34 @@ static int rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch(const rustsecp256k1zkp
 
     state_space->ps = (struct rustsecp256k1zkp_v0_5_0_pippenger_point_state *) rustsecp256k1zkp_v0_5_0_scratch_alloc(error_callback, scratch, entries * sizeof(*state_space->ps));
     state_space->wnaf_na = (int *) rustsecp256k1zkp_v0_5_0_scratch_alloc(error_callback, scratch, entries*(WNAF_SIZE(bucket_window+1)) * sizeof(int));
-    buckets = (rustsecp256k1zkp_v0_5_0_gej *) rustsecp256k1zkp_v0_5_0_scratch_alloc(error_callback, scratch, (1<<bucket_window) * sizeof(*buckets));
-    if (state_space->ps == NULL || state_space->wnaf_na == NULL || buckets == NULL) {
+    if (state_space->ps == NULL || state_space->wnaf_na == NULL) {
         rustsecp256k1zkp_v0_5_0_scratch_apply_checkpoint(error_callback, scratch, scratch_checkpoint);
         return 0;
     }
+    if (affine) {
+        affine_state = (struct rustsecp256k1zkp_v0_5_0_pippenger_affine_state *) rustsecp256k1zkp_v0_5_0_scratch_alloc(error_callback, scratch, sizeof(*affine_state));
+        if (affine_state == NULL) {
+            rustsecp256k1zkp_v0_5_0_scratch_apply_checkpoint(error_callback, scratch, scratch_checkpoint);
+            return 0;
+        }
+        affine_state->sorted = (rustsecp256k1zkp_v0_5_0_ge *) rustsecp256k1zkp_v0_5_0_scratch_alloc(error_callback, scratch, entries * sizeof(*affine_state->sorted));
+        /* Every round adds at most entries/2 pairs. */
+        affine_state->inv = (rustsecp256k1zkp_v0_5_0_fe *) rustsecp256k1zkp_v0_5_0_scratch_alloc(error_callback, scratch, (entries / 2) * sizeof(*affine_state->inv));
+        affine_state->acc = (rustsecp256k1zkp_v0_5_0_fe *) rustsecp256k1zkp_v0_5_0_scratch_alloc(error_callback, scratch, (entries / 2) * sizeof(*affine_state->acc));
+        affine_state->bucket_start = (size_t *) rustsecp256k1zkp_v0_5_0_scratch_alloc(error_callback, scratch, (1<<bucket_window) * sizeof(*affine_state->bucket_start));
+        affine_state->bucket_len = (size_t *) rustsecp256k1zkp_v0_5_0_scratch_alloc(error_callback, scratch, (1<<bucket_window) * sizeof(*affine_state->bucket_len));
+        affine_state->fe_vec = rustsecp256k1zkp_v0_5_0_fe_vec_available();
+        if (affine_state->sorted == NULL || affine_state->inv == NULL || affine_state->acc == NULL || affine_state->bucket_start == NULL || affine_state->bucket_len == NULL) {
+            rustsecp256k1zkp_v0_5_0_scratch_apply_checkpoint(error_callback, scratch, scratch_checkpoint);
+            return 0;
+        }
+    } else {
+        buckets = (rustsecp256k1zkp_v0_5_0_gej *) rustsecp256k1zkp_v0_5_0_scratch_alloc(error_callback, scratch, (1<<bucket_window) * sizeof(*buckets));
+        if (buckets == NULL) {
+            rustsecp256k1zkp_v0_5_0_scratch_apply_checkpoint(error_callback, scratch, scratch_checkpoint);
+            return 0;
+        }
+    }
 
     if (inp_g_sc != NULL) {
         scalars[0] = *inp_g_sc;
@@ -923,7 +1390,11 @@ static int rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch(const rustsecp256k1zkp
         point_idx++;
     }
 
-    rustsecp256k1zkp_v0_5_0_ecmult_pippenger_wnaf(buckets, bucket_window, state_space, r, scalars, points, idx);
+    if (affine) {
+        rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_wnaf(affine_state, bucket_window, state_space, r, scalars, points, idx);
+    } else {
+        rustsecp256k1zkp_v0_5_0_ecmult_pippenger_wnaf(buckets, bucket_window, state_space, r, scalars, points, idx);
+    }
 
     /* Clear data */
     for(i = 0; (size_t)i < idx; i++) {
@@ -933,37 +1404,66 @@ static int rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch(const rustsecp256k1zkp
             state_space->wnaf_na[i * WNAF_SIZE(bucket_window+1) + j] = 0;
         }
     }
-    for(i = 0; i < 1<<bucket_window; i++) {
-        rustsecp256k1zkp_v0_5_0_gej_clear(&buckets[i]);
+    if (affine) {
+        for(i = 0; (size_t)i < idx; i++) {
+            rustsecp256k1zkp_v0_5_0_ge_clear(&affine_state->sorted[i]);
+        }
+    } else {
+        for(i = 0; i < 1<<bucket_window; i++) {
+            rustsecp256k1zkp_v0_5_0_gej_clear(&buckets[i]);
+        }
     }
     rustsecp256k1zkp_v0_5_0_scratch_apply_checkpoint(error_callback, scratch, scratch_checkpoint);
     return 1;
 }
 
+static int rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch(const rustsecp256k1zkp_v0_5_0_callback* error_callback, const rustsecp256k1zkp_v0_5_0_ecmult_context *ctx, rustsecp256k1zkp_v0_5_0_scratch *scratch, rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_scalar *inp_g_sc, rustsecp256k1zkp_v0_5_0_ecmult_multi_callback cb, void *cbdata, size_t n_points, size_t cb_offset) {
+    (void)ctx;
+    return rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch_impl(error_callback, scratch, r, inp_g_sc, cb, cbdata, n_points, cb_offset, 0, rustsecp256k1zkp_v0_5_0_pippenger_scratch_window(scratch, n_points, 0));
+}
+
+static int rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_batch(const rustsecp256k1zkp_v0_5_0_callback* error_callback, const rustsecp256k1zkp_v0_5_0_ecmult_context *ctx, rustsecp256k1zkp_v0_5_0_scratch *scratch, rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_scalar *inp_g_sc, rustsecp256k1zkp_v0_5_0_ecmult_multi_callback cb, void *cbdata, size_t n_points, size_t cb_offset) {
+    (void)ctx;
+    return rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch_impl(error_callback, scratch, r, inp_g_sc, cb, cbdata, n_points, cb_offset, 1, rustsecp256k1zkp_v0_5_0_pippenger_scratch_window(scratch, n_points, 1));
+}
+
 /* Wrapper for rustsecp256k1zkp_v0_5_0_ecmult_multi_func interface */
 static int rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch_single(const rustsecp256k1zkp_v0_5_0_callback* error_callback, const rustsecp256k1zkp_v0_5_0_ecmult_context *actx, rustsecp256k1zkp_v0_5_0_scratch *scratch, rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_scalar *inp_g_sc, rustsecp256k1zkp_v0_5_0_ecmult_multi_callback cb, void *cbdata, size_t n) {
     return rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch(error_callback, actx, scratch, r, inp_g_sc, cb, cbdata, n, 0);
 }
 
+/* Wrapper for rustsecp256k1zkp_v0_5_0_ecmult_multi_func interface */
+static int rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_batch_single(const rustsecp256k1zkp_v0_5_0_callback* error_callback, const rustsecp256k1zkp_v0_5_0_ecmult_context *actx, rustsecp256k1zkp_v0_5_0_scratch *scratch, rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_scalar *inp_g_sc, rustsecp256k1zkp_v0_5_0_ecmult_multi_callback cb, void *cbdata, size_t n) {
+    return rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_batch(error_callback, actx, scratch, r, inp_g_sc, cb, cbdata, n, 0);
+}
+
 /**
  * Returns the maximum number of points in addition to G that can be used with
  * a given scratch space. The function ensures that fewer points may also be
  * used.
  */
-static size_t rustsecp256k1zkp_v0_5_0_pippenger_max_points(const rustsecp256k1zkp_v0_5_0_callback* error_callback, rustsecp256k1zkp_v0_5_0_scratch *scratch) {
-    size_t max_alloc = rustsecp256k1zkp_v0_5_0_scratch_max_allocation(error_callback, scratch, PIPPENGER_SCRATCH_OBJECTS);
+static size_t rustsecp256k1zkp_v0_5_0_pippenger_max_points_impl(const rustsecp256k1zkp_v0_5_0_callback* error_callback, rustsecp256k1zkp_v0_5_0_scratch *scratch, int affine) {
+    size_t max_alloc = rustsecp256k1zkp_v0_5_0_scratch_max_allocation(error_callback, scratch, affine ? PIPPENGER_AFFINE_SCRATCH_OBJECTS : PIPPENGER_SCRATCH_OBJECTS);
     int bucket_window;
     size_t res = 0;
 
     for (bucket_window = 1; bucket_window <= PIPPENGER_MAX_BUCKET_WINDOW; bucket_window++) {
         size_t n_points;
-        size_t max_points = rustsecp256k1zkp_v0_5_0_pippenger_bucket_window_inv(bucket_window);
+        size_t max_points = rustsecp256k1zkp_v0_5_0_pippenger_scratch_window_inv(scratch, bucket_window, affine);
         size_t space_for_points;
         size_t space_overhead;
         size_t entry_size = sizeof(rustsecp256k1zkp_v0_5_0_ge) + sizeof(rustsecp256k1zkp_v0_5_0_scalar) + sizeof(struct rustsecp256k1zkp_v0_5_0_pippenger_point_state) + (WNAF_SIZE(bucket_window+1)+1)*sizeof(int);
 
+        if (affine) {
+            /* The sorted points, and one slot in each of inv and acc per pair */
+            entry_size += sizeof(rustsecp256k1zkp_v0_5_0_ge) + sizeof(rustsecp256k1zkp_v0_5_0_fe);
+        }
         entry_size = 2*entry_size;
-        space_overhead = (sizeof(rustsecp256k1zkp_v0_5_0_gej) << bucket_window) + entry_size + sizeof(struct rustsecp256k1zkp_v0_5_0_pippenger_state);
+        if (affine) {
+            space_overhead = ((2*sizeof(size_t)) << bucket_window) + entry_size + sizeof(struct rustsecp256k1zkp_v0_5_0_pippenger_state) + sizeof(struct rustsecp256k1zkp_v0_5_0_pippenger_affine_state);
+        } else {
+            space_overhead = (sizeof(rustsecp256k1zkp_v0_5_0_gej) << bucket_window) + entry_size + sizeof(struct rustsecp256k1zkp_v0_5_0_pippenger_state);
+        }
         if (space_overhead > max_alloc) {
             break;
         }
@@ -984,6 +1484,18 @@ static size_t rustsecp256k1zkp_v0_5_0_pippenger_max_points(const rustsecp256k1zk
     return res;
 }
 
+static size_t rustsecp256k1zkp_v0_5_0_pippenger_max_points(const rustsecp256k1zkp_v0_5_0_callback* error_callback, rustsecp256k1zkp_v0_5_0_scratch *scratch) {
+    return rustsecp256k1zkp_v0_5_0_pippenger_max_points_impl(error_callback, scratch, 0);
+}
+
+/**
+ * Returns the maximum number of points in addition to G that can be used with
+ * pippenger_affine_batch and a given scratch space.
+ */
+static size_t rustsecp256k1zkp_v0_5_0_pippenger_affine_max_points(const rustsecp256k1zkp_v0_5_0_callback* error_callback, rustsecp256k1zkp_v0_5_0_scratch *scratch) {
+    return rustsecp256k1zkp_v0_5_0_pippenger_max_points_impl(error_callback, scratch, 1);
+}
+
 /* Computes ecmult_multi by simply multiplying and adding each point. Does not
  * require a scratch space */
 static int rustsecp256k1zkp_v0_5_0_ecmult_multi_simple_var(const rustsecp256k1zkp_v0_5_0_ecmult_context *ctx, rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_scalar *inp_g_sc, rustsecp256k1zkp_v0_5_0_ecmult_multi_callback cb, void *cbdata, size_t n_points) {
@@ -1059,7 +1571,19 @@ static int rustsecp256k1zkp_v0_5_0_ecmult_multi_var(const rustsecp256k1zkp_v0_5_
     if (!rustsecp256k1zkp_v0_5_0_ecmult_multi_batch_size_helper(&n_batches, &n_batch_points, rustsecp256k1zkp_v0_5_0_pippenger_max_points(error_callback, scratch), n)) {
         return rustsecp256k1zkp_v0_5_0_ecmult_multi_simple_var(ctx, r, inp_g_sc, cb, cbdata, n);
     }
-    if (n_batch_points >= ECMULT_PIPPENGER_THRESHOLD) {
+    if (n_batch_points >= rustsecp256k1zkp_v0_5_0_pippenger_scratch_threshold(scratch, 1)) {
+        /* pippenger_affine_batch needs more space per point. Stick with
+         * pippenger_batch if that would leave too few points per batch. */
+        size_t n_affine_batches;
+        size_t n_affine_batch_points;
+        f = rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch;
+        if (rustsecp256k1zkp_v0_5_0_ecmult_multi_batch_size_helper(&n_affine_batches, &n_affine_batch_points, rustsecp256k1zkp_v0_5_0_pippenger_affine_max_points(error_callback, scratch), n)
+            && n_affine_batch_points >= rustsecp256k1zkp_v0_5_0_pippenger_scratch_threshold(scratch, 1)) {
+            f = rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_batch;
+            n_batches = n_affine_batches;
+            n_batch_points = n_affine_batch_points;
+        }
+    } else if (n_batch_points >= rustsecp256k1zkp_v0_5_0_pippenger_scratch_threshold(scratch, 0)) {
         f = rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch;
     } else {
         if (!rustsecp256k1zkp_v0_5_0_ecmult_multi_batch_size_helper(&n_batches, &n_batch_points, rustsecp256k1zkp_v0_5_0_strauss_max_points(error_callback, scratch), n)) {
@@ -1080,4 +1604,261 @@ static int rustsecp256k1zkp_v0_5_0_ecmult_multi_var(const rustsecp256k1zkp_v0_5_
     return 1;
 }
 
+typedef struct {
+    const rustsecp256k1zkp_v0_5_0_callback *error_callback;
+    const rustsecp256k1zkp_v0_5_0_ecmult_context *ctx;
+    rustsecp256k1zkp_v0_5_0_scratch *scratch;
+    const rustsecp256k1zkp_v0_5_0_scalar *inp_g_sc;
+    rustsecp256k1zkp_v0_5_0_ecmult_multi_callback *cb;
+    void *cbdata;
+    size_t offset;
+    size_t n;
+    rustsecp256k1zkp_v0_5_0_gej r;
+    int ret;
+} rustsecp256k1zkp_v0_5_0_ecmult_multi_worker;
+
+static int rustsecp256k1zkp_v0_5_0_ecmult_multi_worker_callback(rustsecp256k1zkp_v0_5_0_scalar *sc, rustsecp256k1zkp_v0_5_0_ge *pt, size_t idx, void *data) {
+    const rustsecp256k1zkp_v0_5_0_ecmult_multi_worker *worker = (const rustsecp256k1zkp_v0_5_0_ecmult_multi_worker *) data;
+    return worker->cb(sc, pt, worker->offset + idx, worker->cbdata);
+}
+
+static void rustsecp256k1zkp_v0_5_0_ecmult_multi_worker_run(void *workers, size_t i) {
+    rustsecp256k1zkp_v0_5_0_ecmult_multi_worker *worker = &((rustsecp256k1zkp_v0_5_0_ecmult_multi_worker *) workers)[i];
+    worker->ret = rustsecp256k1zkp_v0_5_0_ecmult_multi_var(worker->error_callback, worker->ctx, worker->scratch, &worker->r, worker->inp_g_sc, rustsecp256k1zkp_v0_5_0_ecmult_multi_worker_callback, (void *) worker, worker->n);
+}
+
+static int rustsecp256k1zkp_v0_5_0_ecmult_multi_var_parallel(const rustsecp256k1zkp_v0_5_0_callback* error_callback, const rustsecp256k1zkp_v0_5_0_ecmult_context *ctx, rustsecp256k1zkp_v0_5_0_scratch *const *scratch, size_t n_workers, rustsecp256k1zkp_v0_5_0_task_runner runner, void *runner_data, rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_scalar *inp_g_sc, rustsecp256k1zkp_v0_5_0_ecmult_multi_callback cb, void *const *cbdata, size_t n) {
+    rustsecp256k1zkp_v0_5_0_ecmult_multi_worker *workers;
+    size_t scratch_checkpoint;
+    size_t n_worker_points;
+    size_t i;
+    int ret = 1;
+
+    VERIFY_CHECK(n_workers > 0);
+    if (n_workers > 1 + (n - 1) / ECMULT_MIN_POINTS_PER_WORKER) {
+        n_workers = 1 + (n - 1) / ECMULT_MIN_POINTS_PER_WORKER;
+    }
+    if (n == 0 || n_workers == 1) {
+        return rustsecp256k1zkp_v0_5_0_ecmult_multi_var(error_callback, ctx, scratch[0], r, inp_g_sc, cb, cbdata[0], n);
+    }
+    /* Compute ceil(n/n_workers), the number of points per worker, and drop the
+     * workers that would be left without points. */
+    n_worker_points = 1 + (n - 1) / n_workers;
+    n_workers = 1 + (n - 1) / n_worker_points;
+
+    scratch_checkpoint = rustsecp256k1zkp_v0_5_0_scratch_checkpoint(error_callback, scratch[0]);
+    workers = (rustsecp256k1zkp_v0_5_0_ecmult_multi_worker *) rustsecp256k1zkp_v0_5_0_scratch_alloc(error_callback, scratch[0], n_workers * sizeof(rustsecp256k1zkp_v0_5_0_ecmult_multi_worker));
+    if (workers == NULL) {
+        return rustsecp256k1zkp_v0_5_0_ecmult_multi_var(error_callback, ctx, scratch[0], r, inp_g_sc, cb, cbdata[0], n);
+    }
+    for (i = 0; i < n_workers; i++) {
+        workers[i].error_callback = error_callback;
+        workers[i].ctx = ctx;
+        workers[i].scratch = scratch[i];
+        workers[i].inp_g_sc = i == 0 ? inp_g_sc : NULL;
+        workers[i].cb = cb;
+        workers[i].cbdata = cbdata[i];
+        workers[i].offset = i * n_worker_points;
+        workers[i].n = n - workers[i].offset < n_worker_points ? n - workers[i].offset : n_worker_points;
+        workers[i].ret = 0;
+    }
+    runner(rustsecp256k1zkp_v0_5_0_ecmult_multi_worker_run, (void *) workers, n_workers, runner_data);
+
+    rustsecp256k1zkp_v0_5_0_gej_set_infinity(r);
+    for (i = 0; i < n_workers; i++) {
+        ret &= workers[i].ret;
+        rustsecp256k1zkp_v0_5_0_gej_add_var(r, r, &workers[i].r, NULL);
+    }
+    rustsecp256k1zkp_v0_5_0_scratch_apply_checkpoint(error_callback, scratch[0], scratch_checkpoint);
+    return ret;
+}
+
+/* The number of distinct points and the number of runs, of which the fastest
+ * counts, in every measurement of ecmult_multi_calibrate */
+#define ECMULT_CALIBRATION_POINTS 16
+#define ECMULT_CALIBRATION_RUNS 2
+/* ecmult_multi_calibrate compares the algorithms for up to this many points */
+#define ECMULT_CALIBRATION_MAX_POINTS 65536
+
+typedef struct {
+    rustsecp256k1zkp_v0_5_0_ge pt[ECMULT_CALIBRATION_POINTS];
+    unsigned char seed[32];
+} rustsecp256k1zkp_v0_5_0_ecmult_calibration_data;
+
+/* The running time a*n + b of an algorithm for n points, in 1/1024 timer units */
+typedef struct {
+    int64_t a;
+    int64_t b;
+    int valid;
+} rustsecp256k1zkp_v0_5_0_ecmult_calibration_line;
+
+static int rustsecp256k1zkp_v0_5_0_ecmult_calibration_callback(rustsecp256k1zkp_v0_5_0_scalar *sc, rustsecp256k1zkp_v0_5_0_ge *pt, size_t idx, void *data) {
+    const rustsecp256k1zkp_v0_5_0_ecmult_calibration_data *calibration_data = (const rustsecp256k1zkp_v0_5_0_ecmult_calibration_data *) data;
+    rustsecp256k1zkp_v0_5_0_scalar unused;
+    rustsecp256k1zkp_v0_5_0_scalar_chacha20(sc, &unused, calibration_data->seed, idx);
+    *pt = calibration_data->pt[idx % ECMULT_CALIBRATION_POINTS];
+    return 1;
+}
+
+/* Sets t to the time the fastest of ECMULT_CALIBRATION_RUNS multiplications of
+ * n points and G takes with strauss_batch if bucket_window is 0, and with
+ * pippenger_batch or pippenger_affine_batch and bucket_window otherwise.
+ * Returns 0 if the scratch space is too small. */
+static int rustsecp256k1zkp_v0_5_0_ecmult_calibration_time(int64_t *t, const rustsecp256k1zkp_v0_5_0_callback* error_callback, const rustsecp256k1zkp_v0_5_0_ecmult_context *ctx, rustsecp256k1zkp_v0_5_0_scratch *scratch, rustsecp256k1zkp_v0_5_0_timer timer, void *timer_data, rustsecp256k1zkp_v0_5_0_ecmult_calibration_data *data, int affine, int bucket_window, size_t n) {
+    uint64_t best = UINT64_MAX;
+    rustsecp256k1zkp_v0_5_0_scalar g_sc;
+    rustsecp256k1zkp_v0_5_0_gej r;
+    int run;
+
+    rustsecp256k1zkp_v0_5_0_scalar_set_int(&g_sc, 1);
+    for (run = 0; run < ECMULT_CALIBRATION_RUNS; run++) {
+        uint64_t start = timer(timer_data);
+        uint64_t elapsed;
+        int ret;
+        if (bucket_window == 0) {
+            ret = rustsecp256k1zkp_v0_5_0_ecmult_strauss_batch(error_callback, ctx, scratch, &r, &g_sc, rustsecp256k1zkp_v0_5_0_ecmult_calibration_callback, data, n, 0);
+        } else {
+            ret = rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch_impl(error_callback, scratch, &r, &g_sc, rustsecp256k1zkp_v0_5_0_ecmult_calibration_callback, data, n, 0, affine, bucket_window);
+        }
+        elapsed = timer(timer_data) - start;
+        if (!ret) {
+            return 0;
+        }
+        if (elapsed < best) {
+            best = elapsed;
+        }
+    }
+    /* Keep the arithmetic of ecmult_multi_calibrate within 64 bits even for
+     * slow timers. */
+    *t = (int64_t)(best < 0xFFFFFFFFULL ? best : 0xFFFFFFFFULL);
+    return 1;
+}
+
+/* Fits a line through the times the algorithm takes for n_lo and n_hi points.
+ * If the scratch space is too small for n_hi points, tries n_hi/2 instead.
+ * Sets line->valid to 0 if it is too small for either. */
+static void rustsecp256k1zkp_v0_5_0_ecmult_calibration_fit(rustsecp256k1zkp_v0_5_0_ecmult_calibration_line *line, const rustsecp256k1zkp_v0_5_0_callback* error_callback, const rustsecp256k1zkp_v0_5_0_ecmult_context *ctx, rustsecp256k1zkp_v0_5_0_scratch *scratch, rustsecp256k1zkp_v0_5_0_timer timer, void *timer_data, rustsecp256k1zkp_v0_5_0_ecmult_calibration_data *data, int affine, int bucket_window, size_t n_lo, size_t n_hi) {
+    int64_t t_lo, t_hi;
+
+    line->a = line->b = 0;
+    line->valid = 0;
+    while (!rustsecp256k1zkp_v0_5_0_ecmult_calibration_time(&t_hi, error_callback, ctx, scratch, timer, timer_data, data, affine, bucket_window, n_hi)) {
+        if (n_hi < 4*n_lo) {
+            return;
+        }
+        n_hi /= 2;
+    }
+    if (!rustsecp256k1zkp_v0_5_0_ecmult_calibration_time(&t_lo, error_callback, ctx, scratch, timer, timer_data, data, affine, bucket_window, n_lo)) {
+        return;
+    }
+    line->a = ((t_hi - t_lo) * 1024) / (int64_t)(n_hi - n_lo);
+    line->b = t_lo * 1024 - line->a * (int64_t)n_lo;
+    line->valid = 1;
+}
+
+static int64_t rustsecp256k1zkp_v0_5_0_ecmult_calibration_eval(const rustsecp256k1zkp_v0_5_0_ecmult_calibration_line *line, size_t n) {
+    return line->a * (int64_t)n + line->b;
+}
+
+/* Derives the maximum number of points for which each bucket window is
+ * optimal from the lines of all windows. Windows that are never optimal get
+ * the same maximum as the window below them, like window 8 in
+ * pippenger_bucket_window_inv. */
+static void rustsecp256k1zkp_v0_5_0_ecmult_calibration_windows(size_t *window_max_points, const rustsecp256k1zkp_v0_5_0_ecmult_calibration_line *lines) {
+    size_t prev = 0;
+    int w, v;
+
+    for (w = 0; w < PIPPENGER_MAX_BUCKET_WINDOW; w++) {
+        size_t max_points = prev;
+        if (lines[w].valid) {
+            max_points = SIZE_MAX;
+            /* Larger windows take fewer additions per point but more for the
+             * buckets, so they overtake this window at some number of points. */
+            for (v = w + 1; v < PIPPENGER_MAX_BUCKET_WINDOW; v++) {
+                if (lines[v].valid && lines[w].a > lines[v].a) {
+                    int64_t cross = (lines[v].b - lines[w].b) / (lines[w].a - lines[v].a);
+                    if (cross <= 0) {
+                        max_points = 0;
+                    } else if ((uint64_t)cross < max_points) {
+                        max_points = (size_t)cross;
+                    }
+                }
+            }
+            if (max_points < prev) {
+                max_points = prev;
+            }
+        }
+        window_max_points[w] = max_points;
+        prev = max_points;
+    }
+    window_max_points[PIPPENGER_MAX_BUCKET_WINDOW - 1] = SIZE_MAX;
+}
+
+/* Returns the time of the optimal bucket window for n points according to
+ * window_max_points. */
+static int64_t rustsecp256k1zkp_v0_5_0_ecmult_calibration_eval_windows(const rustsecp256k1zkp_v0_5_0_ecmult_calibration_line *lines, const size_t *window_max_points, size_t n) {
+    int w = 0;
+    while (w < PIPPENGER_MAX_BUCKET_WINDOW - 1 && n > window_max_points[w]) {
+        w++;
+    }
+    return rustsecp256k1zkp_v0_5_0_ecmult_calibration_eval(&lines[w], n);
+}
+
+static int rustsecp256k1zkp_v0_5_0_ecmult_multi_calibrate(const rustsecp256k1zkp_v0_5_0_callback* error_callback, const rustsecp256k1zkp_v0_5_0_ecmult_context *ctx, rustsecp256k1zkp_v0_5_0_scratch *scratch, rustsecp256k1zkp_v0_5_0_timer timer, void *timer_data) {
+    rustsecp256k1zkp_v0_5_0_ecmult_calibration_data data;
+    rustsecp256k1zkp_v0_5_0_ecmult_multi_tuning tuning;
+    rustsecp256k1zkp_v0_5_0_ecmult_calibration_line strauss;
+    rustsecp256k1zkp_v0_5_0_ecmult_calibration_line lines[2][PIPPENGER_MAX_BUCKET_WINDOW];
+    rustsecp256k1zkp_v0_5_0_gej pt[ECMULT_CALIBRATION_POINTS];
+    int affine, w;
+    size_t i, n;
+
+    rustsecp256k1zkp_v0_5_0_gej_set_ge(&pt[0], &rustsecp256k1zkp_v0_5_0_ge_const_g);
+    for (i = 1; i < ECMULT_CALIBRATION_POINTS; i++) {
+        rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&pt[i], &pt[i - 1], &rustsecp256k1zkp_v0_5_0_ge_const_g, NULL);
+    }
+    rustsecp256k1zkp_v0_5_0_ge_set_all_gej_var(data.pt, pt, ECMULT_CALIBRATION_POINTS);
+    memset(data.seed, 0, sizeof(data.seed));
+
+    /* Every algorithm takes time linear in the number of points, so two
+     * measurements fit it. Bucket window w is measured at 2^w and 2^(w+2)
+     * points, where filling and summing up its 2^w buckets cost about the
+     * same and where it is about to be optimal. */
+    rustsecp256k1zkp_v0_5_0_ecmult_calibration_fit(&strauss, error_callback, ctx, scratch, timer, timer_data, &data, 0, 0, 32, 128);
+    for (affine = 0; affine < 2; affine++) {
+        for (w = 0; w < PIPPENGER_MAX_BUCKET_WINDOW; w++) {
+            rustsecp256k1zkp_v0_5_0_ecmult_calibration_fit(&lines[affine][w], error_callback, ctx, scratch, timer, timer_data, &data, affine, w + 1, (size_t)1 << (w + 1), (size_t)1 << (w + 3));
+        }
+    }
+    if (!lines[0][0].valid) {
+        return 0;
+    }
+
+    tuning.calibrated = 1;
+    rustsecp256k1zkp_v0_5_0_ecmult_calibration_windows(tuning.window_max_points[0], lines[0]);
+    rustsecp256k1zkp_v0_5_0_ecmult_calibration_windows(tuning.window_max_points[1], lines[1]);
+    tuning.pippenger_threshold = 1;
+    if (strauss.valid) {
+        for (n = 1; n < ECMULT_CALIBRATION_MAX_POINTS; n++) {
+            if (rustsecp256k1zkp_v0_5_0_ecmult_calibration_eval_windows(lines[0], tuning.window_max_points[0], n) < rustsecp256k1zkp_v0_5_0_ecmult_calibration_eval(&strauss, n)) {
+                break;
+            }
+        }
+        tuning.pippenger_threshold = n;
+    }
+    tuning.pippenger_affine_threshold = SIZE_MAX;
+    if (lines[1][0].valid) {
+        for (n = 1; n <= ECMULT_CALIBRATION_MAX_POINTS; n++) {
+            int64_t t = rustsecp256k1zkp_v0_5_0_ecmult_calibration_eval_windows(lines[1], tuning.window_max_points[1], n);
+            if (t < rustsecp256k1zkp_v0_5_0_ecmult_calibration_eval_windows(lines[0], tuning.window_max_points[0], n)
+                && (n >= tuning.pippenger_threshold || t < rustsecp256k1zkp_v0_5_0_ecmult_calibration_eval(&strauss, n))) {
+                tuning.pippenger_affine_threshold = n;
+                break;
+            }
+        }
+    }
+    scratch->tuning = tuning;
+    return 1;
+}
+
 #endif /* SECP256K1_ECMULT_IMPL_H */
@@ -114,6 +114,28 @@ static void rustsecp256k1zkp_v0_5_0_fe_inv(rustsecp256k1zkp_v0_5_0_fe *r, const
 /** Potentially faster version of rustsecp256k1zkp_v0_5_0_fe_inv, without constant-time guarantee. */
 static void rustsecp256k1zkp_v0_5_0_fe_inv_var(rustsecp256k1zkp_v0_5_0_fe *r, const rustsecp256k1zkp_v0_5_0_fe *a);
 
+/** Returns whether the batch operations below can be vectorized on this CPU. This queries the CPU
+ *  and is comparatively slow, so the result should be passed to many batch operations. */
+static int rustsecp256k1zkp_v0_5_0_fe_vec_available(void);
+
+/** Sets r[i] = a[i] * b[i] for i < len, with the magnitude rules of rustsecp256k1zkp_v0_5_0_fe_mul. r may alias a,
+ *  but not b. If vec is the result of rustsecp256k1zkp_v0_5_0_fe_vec_available, groups of eight elements may be
+ *  multiplied in parallel; the results are the same either way. */
+static void rustsecp256k1zkp_v0_5_0_fe_mul_all(rustsecp256k1zkp_v0_5_0_fe *r, const rustsecp256k1zkp_v0_5_0_fe *a, const rustsecp256k1zkp_v0_5_0_fe *b, size_t len, int vec);
+
+/** Sets r[i] = a[i]^2 for i < len, like rustsecp256k1zkp_v0_5_0_fe_mul_all. r may alias a. */
+static void rustsecp256k1zkp_v0_5_0_fe_sqr_all(rustsecp256k1zkp_v0_5_0_fe *r, const rustsecp256k1zkp_v0_5_0_fe *a, size_t len, int vec);
+
+/** Sets r[i] to the inverse of a[i] for i < len, using a single inversion (Montgomery's trick). None
+ *  of the inputs may be zero, their magnitudes must be at most 8, and r must not overlap a. The
+ *  output magnitude is 1. vec is used as in rustsecp256k1zkp_v0_5_0_fe_mul_all. */
+static void rustsecp256k1zkp_v0_5_0_fe_inv_all_var(rustsecp256k1zkp_v0_5_0_fe *r, const rustsecp256k1zkp_v0_5_0_fe *a, size_t len, int vec);
+
+/** Sets r[i] to a square root of a[i] (or of its negation) for i < len, like rustsecp256k1zkp_v0_5_0_fe_sqrt, and
+ *  returns whether all of the a[i] have one. The inputs' magnitudes can be at most 8, the output
+ *  magnitude is 1, and r must not overlap a. vec is used as in rustsecp256k1zkp_v0_5_0_fe_mul_all. */
+static int rustsecp256k1zkp_v0_5_0_fe_sqrt_all(rustsecp256k1zkp_v0_5_0_fe *r, const rustsecp256k1zkp_v0_5_0_fe *a, size_t len, int vec);
+
 /** Convert a field element to the storage type. */
 static void rustsecp256k1zkp_v0_5_0_fe_to_storage(rustsecp256k1zkp_v0_5_0_fe_storage *r, const rustsecp256k1zkp_v0_5_0_fe *a);
 
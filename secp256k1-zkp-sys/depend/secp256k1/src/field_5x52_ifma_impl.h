@@ -0,0 +1,167 @@
+/***********************************************************************
+ * Distributed under the MIT software license, see the accompanying    *
+ * file COPYING or https://www.opensource.org/licenses/mit-license.php.*
+ ***********************************************************************/
+
+#ifndef SECP256K1_FIELD_INNER5X52_IFMA_IMPL_H
+#define SECP256K1_FIELD_INNER5X52_IFMA_IMPL_H
+
+/* AVX-512 IFMA versions of fe_mul and fe_sqr, operating on eight field
+ * elements at once. Lane k of every vector holds a limb of the k'th element,
+ * and vpmadd52{lo,hi}uq compute the low and high 52 bits of the 104-bit
+ * product of two limbs, so a column of the schoolbook product is just a sum
+ * of such halves. The functions are compiled for AVX-512 IFMA regardless of
+ * the compiler flags, and must only be called when fe_ifma_available
+ * returned 1. */
+
+#include <immintrin.h>
+
+#define SECP256K1_FE_IFMA_TARGET __attribute__((target("avx512f,avx512ifma")))
+
+static int rustsecp256k1zkp_v0_5_0_fe_ifma_available(void) {
+    uint32_t eax, ebx, ecx, edx;
+
+    __asm__ ("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(0), "c"(0));
+    if (eax < 7) {
+        return 0;
+    }
+    /* The OS must save the ZMM registers (XCR0 bits 1, 2 and 5 to 7). */
+    __asm__ ("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(1), "c"(0));
+    if (!((ecx >> 27) & 1)) {
+        return 0;
+    }
+    __asm__ ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    if ((eax & 0xE6) != 0xE6) {
+        return 0;
+    }
+    /* AVX512F and AVX512IFMA. */
+    __asm__ ("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(7), "c"(0));
+    return ((ebx >> 16) & 1) && ((ebx >> 21) & 1);
+}
+
+SECP256K1_FE_IFMA_TARGET SECP256K1_INLINE static __m512i rustsecp256k1zkp_v0_5_0_fe_ifma_index(void) {
+    const long long s = sizeof(rustsecp256k1zkp_v0_5_0_fe) / sizeof(uint64_t);
+    VERIFY_CHECK(sizeof(rustsecp256k1zkp_v0_5_0_fe) % sizeof(uint64_t) == 0);
+    return _mm512_set_epi64(7 * s, 6 * s, 5 * s, 4 * s, 3 * s, 2 * s, s, 0);
+}
+
+/* Loads the limbs of a[0..7], carried so that each fits in 52 bits. This keeps
+ * the value, which is less than 2^260 for inputs of magnitude at most 8. */
+SECP256K1_FE_IFMA_TARGET SECP256K1_INLINE static void rustsecp256k1zkp_v0_5_0_fe_ifma_load(__m512i *v, const rustsecp256k1zkp_v0_5_0_fe *a) {
+    const __m512i index = rustsecp256k1zkp_v0_5_0_fe_ifma_index();
+    const __m512i mask = _mm512_set1_epi64(0xFFFFFFFFFFFFFULL);
+    int i;
+
+#ifdef VERIFY
+    for (i = 0; i < 8; i++) {
+        VERIFY_CHECK(a[i].magnitude <= 8);
+        rustsecp256k1zkp_v0_5_0_fe_verify(&a[i]);
+    }
+#endif
+    for (i = 0; i < 5; i++) {
+        v[i] = _mm512_i64gather_epi64(index, &a[0].n[i], 8);
+    }
+    for (i = 0; i < 4; i++) {
+        v[i + 1] = _mm512_add_epi64(v[i + 1], _mm512_srli_epi64(v[i], 52));
+        v[i] = _mm512_and_si512(v[i], mask);
+    }
+}
+
+/* Reduces the 520-bit columns c[0..9] (each less than 2^58) modulo p into r[0..7],
+ * with magnitude 1. */
+SECP256K1_FE_IFMA_TARGET SECP256K1_INLINE static void rustsecp256k1zkp_v0_5_0_fe_ifma_reduce(rustsecp256k1zkp_v0_5_0_fe *r, __m512i *c) {
+    const __m512i index = rustsecp256k1zkp_v0_5_0_fe_ifma_index();
+    const __m512i mask = _mm512_set1_epi64(0xFFFFFFFFFFFFFULL);
+    /* 2^260 = 0x1000003D10 (mod p) and 2^256 = 0x1000003D1 (mod p). */
+    const __m512i r260 = _mm512_set1_epi64(0x1000003D10ULL);
+    const __m512i r256 = _mm512_set1_epi64(0x1000003D1ULL);
+    __m512i c10, c5, t;
+    int i;
+
+    /* Carry the upper columns into 52-bit limbs, so they can be multiplied. */
+    for (i = 5; i < 9; i++) {
+        c[i + 1] = _mm512_add_epi64(c[i + 1], _mm512_srli_epi64(c[i], 52));
+        c[i] = _mm512_and_si512(c[i], mask);
+    }
+    c10 = _mm512_srli_epi64(c[9], 52);
+    c[9] = _mm512_and_si512(c[9], mask);
+    /* Fold c[5..10] * 2^260 back into c[0..5]. */
+    for (i = 5; i < 9; i++) {
+        c[i - 5] = _mm512_madd52lo_epu64(c[i - 5], c[i], r260);
+        c[i - 4] = _mm512_madd52hi_epu64(c[i - 4], c[i], r260);
+    }
+    c[4] = _mm512_madd52lo_epu64(c[4], c[9], r260);
+    c5 = _mm512_madd52hi_epu64(_mm512_setzero_si512(), c[9], r260);
+    c5 = _mm512_madd52lo_epu64(c5, c10, r260);
+    /* c5 is less than 2^44, fold it once more. */
+    c[0] = _mm512_madd52lo_epu64(c[0], c5, r260);
+    c[1] = _mm512_madd52hi_epu64(c[1], c5, r260);
+    /* Carry, and fold the bits of c[4] above 2^256 into c[0]. */
+    for (i = 0; i < 4; i++) {
+        c[i + 1] = _mm512_add_epi64(c[i + 1], _mm512_srli_epi64(c[i], 52));
+        c[i] = _mm512_and_si512(c[i], mask);
+    }
+    t = _mm512_srli_epi64(c[4], 48);
+    c[4] = _mm512_and_si512(c[4], _mm512_set1_epi64(0x0FFFFFFFFFFFFULL));
+    c[0] = _mm512_madd52lo_epu64(c[0], t, r256);
+    c[1] = _mm512_add_epi64(c[1], _mm512_srli_epi64(c[0], 52));
+    c[0] = _mm512_and_si512(c[0], mask);
+
+    for (i = 0; i < 5; i++) {
+        _mm512_i64scatter_epi64(&r[0].n[i], index, c[i], 8);
+    }
+#ifdef VERIFY
+    for (i = 0; i < 8; i++) {
+        r[i].magnitude = 1;
+        r[i].normalized = 0;
+        rustsecp256k1zkp_v0_5_0_fe_verify(&r[i]);
+    }
+#endif
+}
+
+/* Sets r[i] = a[i] * b[i] for i < 8. r may alias a or b. */
+SECP256K1_FE_IFMA_TARGET static void rustsecp256k1zkp_v0_5_0_fe_mul_ifma(rustsecp256k1zkp_v0_5_0_fe *r, const rustsecp256k1zkp_v0_5_0_fe *a, const rustsecp256k1zkp_v0_5_0_fe *b) {
+    __m512i va[5], vb[5], c[10];
+    int i, j;
+
+    rustsecp256k1zkp_v0_5_0_fe_ifma_load(va, a);
+    rustsecp256k1zkp_v0_5_0_fe_ifma_load(vb, b);
+    for (i = 0; i < 10; i++) {
+        c[i] = _mm512_setzero_si512();
+    }
+    for (i = 0; i < 5; i++) {
+        for (j = 0; j < 5; j++) {
+            c[i + j] = _mm512_madd52lo_epu64(c[i + j], va[i], vb[j]);
+            c[i + j + 1] = _mm512_madd52hi_epu64(c[i + j + 1], va[i], vb[j]);
+        }
+    }
+    rustsecp256k1zkp_v0_5_0_fe_ifma_reduce(r, c);
+}
+
+/* Sets r[i] = a[i]^2 for i < 8. r may alias a. */
+SECP256K1_FE_IFMA_TARGET static void rustsecp256k1zkp_v0_5_0_fe_sqr_ifma(rustsecp256k1zkp_v0_5_0_fe *r, const rustsecp256k1zkp_v0_5_0_fe *a) {
+    __m512i va[5], c[10], d[10];
+    int i, j;
+
+    rustsecp256k1zkp_v0_5_0_fe_ifma_load(va, a);
+    for (i = 0; i < 10; i++) {
+        c[i] = _mm512_setzero_si512();
+        d[i] = _mm512_setzero_si512();
+    }
+    /* The products a[i]*a[j] with i < j occur twice, so they are summed in c
+     * and doubled once, the squares a[i]^2 are summed in d. */
+    for (i = 0; i < 5; i++) {
+        for (j = i + 1; j < 5; j++) {
+            c[i + j] = _mm512_madd52lo_epu64(c[i + j], va[i], va[j]);
+            c[i + j + 1] = _mm512_madd52hi_epu64(c[i + j + 1], va[i], va[j]);
+        }
+        d[2 * i] = _mm512_madd52lo_epu64(d[2 * i], va[i], va[i]);
+        d[2 * i + 1] = _mm512_madd52hi_epu64(d[2 * i + 1], va[i], va[i]);
+    }
+    for (i = 0; i < 10; i++) {
+        c[i] = _mm512_add_epi64(_mm512_add_epi64(c[i], c[i]), d[i]);
+    }
+    rustsecp256k1zkp_v0_5_0_fe_ifma_reduce(r, c);
+}
+
+#endif /* SECP256K1_FIELD_INNER5X52_IFMA_IMPL_H */
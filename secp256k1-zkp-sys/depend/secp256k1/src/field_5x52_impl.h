@@ -498,4 +498,11 @@ static SECP256K1_INLINE void rustsecp256k1zkp_v0_5_0_fe_from_storage(rustsecp256
 #endif
 }
 
+/* Eight-way field multiplication for fe_mul_all and friends, selected at
+ * runtime. Define SECP256K1_NO_FIELD_IFMA to leave it out. */
+#if defined(__x86_64__) && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5)) && !defined(SECP256K1_NO_FIELD_IFMA)
+#define SECP256K1_FIELD_IFMA 1
+#include "field_5x52_ifma_impl.h"
+#endif
+
 #endif /* SECP256K1_FIELD_REPR_IMPL_H */
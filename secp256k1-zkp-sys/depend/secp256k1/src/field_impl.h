@@ -263,6 +263,325 @@ static void rustsecp256k1zkp_v0_5_0_fe_inv_var(rustsecp256k1zkp_v0_5_0_fe *r, co
 #endif
 }
 
+static int rustsecp256k1zkp_v0_5_0_fe_vec_available(void) {
+#ifdef SECP256K1_FIELD_IFMA
+    return rustsecp256k1zkp_v0_5_0_fe_ifma_available();
+#else
+    return 0;
+#endif
+}
+
+static void rustsecp256k1zkp_v0_5_0_fe_mul_all(rustsecp256k1zkp_v0_5_0_fe *r, const rustsecp256k1zkp_v0_5_0_fe *a, const rustsecp256k1zkp_v0_5_0_fe *b, size_t len, int vec) {
+    size_t i = 0;
+#ifdef SECP256K1_FIELD_IFMA
+    if (vec) {
+        for (; i + 8 <= len; i += 8) {
+            rustsecp256k1zkp_v0_5_0_fe_mul_ifma(&r[i], &a[i], &b[i]);
+        }
+    }
+#else
+    (void)vec;
+#endif
+    for (; i < len; i++) {
+        rustsecp256k1zkp_v0_5_0_fe_mul(&r[i], &a[i], &b[i]);
+    }
+}
+
+static void rustsecp256k1zkp_v0_5_0_fe_sqr_all(rustsecp256k1zkp_v0_5_0_fe *r, const rustsecp256k1zkp_v0_5_0_fe *a, size_t len, int vec) {
+    size_t i = 0;
+#ifdef SECP256K1_FIELD_IFMA
+    if (vec) {
+        for (; i + 8 <= len; i += 8) {
+            rustsecp256k1zkp_v0_5_0_fe_sqr_ifma(&r[i], &a[i]);
+        }
+    }
+#else
+    (void)vec;
+#endif
+    for (; i < len; i++) {
+        rustsecp256k1zkp_v0_5_0_fe_sqr(&r[i], &a[i]);
+    }
+}
+
+static void rustsecp256k1zkp_v0_5_0_fe_inv_all_var(rustsecp256k1zkp_v0_5_0_fe *r, const rustsecp256k1zkp_v0_5_0_fe *a, size_t len, int vec) {
+    rustsecp256k1zkp_v0_5_0_fe u, t;
+    size_t i;
+
+    if (len == 0) {
+        return;
+    }
+    VERIFY_CHECK(r + len <= a || a + len <= r);
+#ifdef SECP256K1_FIELD_IFMA
+    if (vec && len >= 16) {
+        /* Keep eight interleaved running products, r[i] = a[i]*a[i - 8]*a[i - 16]*...,
+         * over a[0..n-1] so that they can be computed in parallel, and a ninth one
+         * over the remaining a[n..len-1]. */
+        rustsecp256k1zkp_v0_5_0_fe totals[9], inv[9];
+        size_t n = len - len % 8, k;
+
+        for (i = 0; i < 8; i++) {
+            r[i] = a[i];
+        }
+        for (i = 8; i < n; i += 8) {
+            rustsecp256k1zkp_v0_5_0_fe_mul_ifma(&r[i], &r[i - 8], &a[i]);
+        }
+        for (i = n; i < len; i++) {
+            if (i == n) {
+                r[i] = a[i];
+            } else {
+                rustsecp256k1zkp_v0_5_0_fe_mul(&r[i], &r[i - 1], &a[i]);
+            }
+        }
+        for (k = 0; k < 8; k++) {
+            totals[k] = r[n - 8 + k];
+        }
+        totals[8] = r[len - 1];
+        rustsecp256k1zkp_v0_5_0_fe_inv_all_var(inv, totals, 8 + (n < len), 0);
+
+        for (i = len - 1; i > n; i--) {
+            rustsecp256k1zkp_v0_5_0_fe_mul(&t, &inv[8], &r[i - 1]);
+            rustsecp256k1zkp_v0_5_0_fe_mul(&inv[8], &inv[8], &a[i]);
+            r[i] = t;
+        }
+        if (n < len) {
+            r[n] = inv[8];
+        }
+        /* inv[k] is the inverse of r[i + k], the product of a[i + k] and r[i + k - 8]. */
+        for (i = n - 8; i > 0; i -= 8) {
+            rustsecp256k1zkp_v0_5_0_fe_mul_ifma(&r[i], inv, &r[i - 8]);
+            rustsecp256k1zkp_v0_5_0_fe_mul_ifma(inv, inv, &a[i]);
+        }
+        for (k = 0; k < 8; k++) {
+            r[k] = inv[k];
+        }
+        return;
+    }
+#else
+    (void)vec;
+#endif
+    r[0] = a[0];
+    for (i = 1; i < len; i++) {
+        rustsecp256k1zkp_v0_5_0_fe_mul(&r[i], &r[i - 1], &a[i]);
+    }
+    rustsecp256k1zkp_v0_5_0_fe_inv_var(&u, &r[len - 1]);
+    for (i = len - 1; i > 0; i--) {
+        rustsecp256k1zkp_v0_5_0_fe_mul(&t, &u, &r[i - 1]);
+        rustsecp256k1zkp_v0_5_0_fe_mul(&u, &u, &a[i]);
+        r[i] = t;
+    }
+    r[0] = u;
+}
+
+/* Sets r[i] = r[i]^(2^k) * m[i] for i < len. */
+static void rustsecp256k1zkp_v0_5_0_fe_sqr_mul_all(rustsecp256k1zkp_v0_5_0_fe *r, int k, const rustsecp256k1zkp_v0_5_0_fe *m, size_t len, int vec) {
+    int j;
+    for (j = 0; j < k; j++) {
+        rustsecp256k1zkp_v0_5_0_fe_sqr_all(r, r, len, vec);
+    }
+    rustsecp256k1zkp_v0_5_0_fe_mul_all(r, r, m, len, vec);
+}
+
+static int rustsecp256k1zkp_v0_5_0_fe_sqrt_all(rustsecp256k1zkp_v0_5_0_fe *r, const rustsecp256k1zkp_v0_5_0_fe *a, size_t len, int vec) {
+    /* The addition chain of rustsecp256k1zkp_v0_5_0_fe_sqrt, on up to eight elements at a
+     * time so that the vectorized multiplication can be used. */
+    rustsecp256k1zkp_v0_5_0_fe x2[8], x3[8], x11[8], x22[8], x44[8], x88[8], t[8];
+    size_t i, j, n;
+    int ret = 1;
+
+    VERIFY_CHECK(r + len <= a || a + len <= r);
+    for (i = 0; i < len; i += n) {
+        n = len - i < 8 ? len - i : 8;
+
+        rustsecp256k1zkp_v0_5_0_fe_sqr_all(x2, &a[i], n, vec);
+        rustsecp256k1zkp_v0_5_0_fe_mul_all(x2, x2, &a[i], n, vec);
+        for (j = 0; j < n; j++) {
+            x3[j] = x2[j];
+        }
+        rustsecp256k1zkp_v0_5_0_fe_sqr_mul_all(x3, 1, &a[i], n, vec);
+        for (j = 0; j < n; j++) {
+            t[j] = x3[j];
+        }
+        rustsecp256k1zkp_v0_5_0_fe_sqr_mul_all(t, 3, x3, n, vec);
+        rustsecp256k1zkp_v0_5_0_fe_sqr_mul_all(t, 3, x3, n, vec);
+        for (j = 0; j < n; j++) {
+            x11[j] = t[j];
+        }
+        rustsecp256k1zkp_v0_5_0_fe_sqr_mul_all(x11, 2, x2, n, vec);
+        for (j = 0; j < n; j++) {
+            x22[j] = x11[j];
+        }
+        rustsecp256k1zkp_v0_5_0_fe_sqr_mul_all(x22, 11, x11, n, vec);
+        for (j = 0; j < n; j++) {
+            x44[j] = x22[j];
+        }
+        rustsecp256k1zkp_v0_5_0_fe_sqr_mul_all(x44, 22, x22, n, vec);
+        for (j = 0; j < n; j++) {
+            x88[j] = x44[j];
+        }
+        rustsecp256k1zkp_v0_5_0_fe_sqr_mul_all(x88, 44, x44, n, vec);
+        for (j = 0; j < n; j++) {
+            t[j] = x88[j];
+        }
+        rustsecp256k1zkp_v0_5_0_fe_sqr_mul_all(t, 88, x88, n, vec);
+        rustsecp256k1zkp_v0_5_0_fe_sqr_mul_all(t, 44, x44, n, vec);
+        rustsecp256k1zkp_v0_5_0_fe_sqr_mul_all(t, 3, x3, n, vec);
+        rustsecp256k1zkp_v0_5_0_fe_sqr_mul_all(t, 23, x22, n, vec);
+        rustsecp256k1zkp_v0_5_0_fe_sqr_mul_all(t, 6, x2, n, vec);
+        rustsecp256k1zkp_v0_5_0_fe_sqr_all(t, t, n, vec);
+        rustsecp256k1zkp_v0_5_0_fe_sqr_all(&r[i], t, n, vec);
+
+        /* Check that square roots were actually calculated */
+        rustsecp256k1zkp_v0_5_0_fe_sqr_all(t, &r[i], n, vec);
+        for (j = 0; j < n; j++) {
+            ret &= rustsecp256k1zkp_v0_5_0_fe_equal(&t[j], &a[i + j]);
+        }
+    }
+    return ret;
+}
+
+#ifdef USE_NUM_NONE
+/* Computes the Jacobi symbol (a|n) with the binary algorithm, for odd n given as len little-endian
+ * 64-bit limbs. Both are clobbered. Returns 0 if a and n are not coprime. */
+static int rustsecp256k1zkp_v0_5_0_jacobi64_var(uint64_t *a, uint64_t *n, int len) {
+    int flip = 0;
+    int i, k, z;
+    VERIFY_CHECK(n[0] & 1);
+    while (1) {
+        /* Remove the factors of two of a. Each one flips the symbol iff n = 3 or 5 mod 8. */
+        for (k = 0; k < len && a[k] == 0; k++);
+        if (k == len) {
+            break;
+        }
+        z = rustsecp256k1zkp_v0_5_0_ctz64_var(a[k]);
+        if (z > 0) {
+            for (i = 0; i + k + 1 < len; i++) {
+                a[i] = (a[i + k] >> z) | (a[i + k + 1] << (64 - z));
+            }
+            a[i] = a[i + k] >> z;
+            flip ^= z & ((n[0] >> 1) ^ (n[0] >> 2)) & 1;
+        } else {
+            for (i = 0; i + k < len; i++) {
+                a[i] = a[i + k];
+            }
+        }
+        for (i = len - k; i < len; i++) {
+            a[i] = 0;
+        }
+        /* Both are odd now: make a >= n by quadratic reciprocity, then reduce a by n. */
+        for (i = len - 1; i > 0 && a[i] == n[i]; i--);
+        if (a[i] < n[i]) {
+            uint64_t *t = a;
+            a = n;
+            n = t;
+            flip ^= (a[0] & n[0] & 2) >> 1;
+        }
+        {
+            uint64_t borrow = 0;
+            for (i = 0; i < len; i++) {
+                uint64_t d = a[i] - n[i];
+                uint64_t b = (a[i] < n[i]) | (d < borrow);
+                a[i] = d - borrow;
+                borrow = b;
+            }
+        }
+        while (len > 1 && a[len - 1] == 0 && n[len - 1] == 0) {
+            len--;
+        }
+    }
+    /* a is zero, so n is gcd(a, n). */
+    for (i = 1; i < len; i++) {
+        if (n[i] != 0) {
+            return 0;
+        }
+    }
+    return n[0] == 1 ? 1 - 2 * flip : 0;
+}
+
+#ifdef SECP256K1_WIDEMUL_INT128
+static int rustsecp256k1zkp_v0_5_0_bitlen320_var(const uint64_t *x) {
+    int k = 4;
+    while (k > 0 && x[k] == 0) {
+        k--;
+    }
+    return 64 * k + 64 - rustsecp256k1zkp_v0_5_0_clz64_var(x[k]);
+}
+
+/* Computes the Jacobi symbol (g|f) like rustsecp256k1zkp_v0_5_0_jacobi64_var, for odd f and any g below 2^256
+ * given as 5 little-endian 64-bit limbs, but in batches of 62 halvings of g whose effect on f and g is
+ * accumulated from their lowest limbs in a 2x2 matrix and applied at once, as in the safegcd
+ * inversion. Unlike there, g is only ever increased by multiples of f and f and g stay
+ * non-negative, so quadratic reciprocity applies at every swap. Which of f and g is larger is
+ * only estimated from their bit lengths, which affects the speed but not the result. */
+static int rustsecp256k1zkp_v0_5_0_jacobi64_posdivsteps_var(uint64_t *g, uint64_t *f) {
+    int jac = 0;
+    int batch, i, k, z, d, lim;
+    for (batch = 0; batch < 40; batch++) {
+        /* The transition matrix [u v; q r] maps (f, g) before the batch to 2^62 * (f, g) after it. */
+        uint64_t fl = f[0], gl = g[0], u = 1, v = 0, q = 0, r = 1, w, t;
+        uint128_t cf = 0, cg = 0;
+        uint64_t tf[6], tg[6];
+        if (fl == 1 && (f[1] | f[2] | f[3] | f[4]) == 0) {
+            return 1 - 2 * jac;
+        }
+        if ((gl | g[1] | g[2] | g[3] | g[4]) == 0) {
+            return 0;
+        }
+        /* d estimates the bit length of f minus that of g. */
+        d = rustsecp256k1zkp_v0_5_0_bitlen320_var(f) - rustsecp256k1zkp_v0_5_0_bitlen320_var(g);
+        i = 62;
+        while (1) {
+            z = rustsecp256k1zkp_v0_5_0_ctz64_var(gl | ((uint64_t)1 << i));
+            gl >>= z;
+            u <<= z;
+            v <<= z;
+            i -= z;
+            d += z;
+            jac ^= (int)((z & ((fl >> 1) ^ (fl >> 2))) & 1);
+            if (i == 0) {
+                break;
+            }
+            /* f and g are odd. Swap them if g is shorter, then clear up to 6 low bits of g by
+             * adding a multiple of f, but no more than g is estimated to exceed f by. */
+            if (d > 0) {
+                t = fl; fl = gl; gl = t;
+                t = u; u = q; q = t;
+                t = v; v = r; r = t;
+                d = -d;
+                jac ^= (int)((fl & gl) >> 1) & 1;
+            }
+            lim = 1 - d;
+            lim = lim > i ? i : lim;
+            lim = lim > 6 ? 6 : lim;
+            /* fl * (2 - fl * fl) is the inverse of fl modulo 64. */
+            w = (-gl * fl * (2 - fl * fl)) & ((((uint64_t)1) << lim) - 1);
+            gl += fl * w;
+            q += u * w;
+            r += v * w;
+        }
+        /* Both rows of the matrix sum to at most 2^62, so no sum below exceeds 2^127. */
+        VERIFY_CHECK(u + v <= ((uint64_t)1 << 62) && q + r <= ((uint64_t)1 << 62));
+        for (k = 0; k < 5; k++) {
+            cf += (uint128_t)u * f[k] + (uint128_t)v * g[k];
+            cg += (uint128_t)q * f[k] + (uint128_t)r * g[k];
+            tf[k] = (uint64_t)cf;
+            tg[k] = (uint64_t)cg;
+            cf >>= 64;
+            cg >>= 64;
+        }
+        tf[5] = (uint64_t)cf;
+        tg[5] = (uint64_t)cg;
+        VERIFY_CHECK((tf[0] & (((uint64_t)1 << 62) - 1)) == 0 && (tg[0] & (((uint64_t)1 << 62) - 1)) == 0);
+        for (k = 0; k < 5; k++) {
+            f[k] = (tf[k] >> 62) | (tf[k + 1] << 2);
+            g[k] = (tg[k] >> 62) | (tg[k + 1] << 2);
+        }
+    }
+    /* Each batch at most doubles f and g, so they still fit; finish without estimates. */
+    return (1 - 2 * jac) * rustsecp256k1zkp_v0_5_0_jacobi64_var(g, f, 5);
+}
+#endif
+#endif
+
 static int rustsecp256k1zkp_v0_5_0_fe_is_quad_var(const rustsecp256k1zkp_v0_5_0_fe *a) {
 #ifndef USE_NUM_NONE
     unsigned char b[32];
@@ -283,8 +602,30 @@ static int rustsecp256k1zkp_v0_5_0_fe_is_quad_var(const rustsecp256k1zkp_v0_5_0_
     rustsecp256k1zkp_v0_5_0_num_set_bin(&m, prime, 32);
     return rustsecp256k1zkp_v0_5_0_num_jacobi(&n, &m) >= 0;
 #else
-    rustsecp256k1zkp_v0_5_0_fe r;
-    return rustsecp256k1zkp_v0_5_0_fe_sqrt(&r, a);
+    unsigned char b[32];
+    uint64_t x[5];
+    /* secp256k1 field prime as little-endian 64-bit limbs. */
+    uint64_t p[5] = {
+        0xFFFFFFFEFFFFFC2FULL, 0xFFFFFFFFFFFFFFFFULL, 0xFFFFFFFFFFFFFFFFULL, 0xFFFFFFFFFFFFFFFFULL, 0
+    };
+    int i, j;
+
+    rustsecp256k1zkp_v0_5_0_fe c = *a;
+    rustsecp256k1zkp_v0_5_0_fe_normalize_var(&c);
+    rustsecp256k1zkp_v0_5_0_fe_get_b32(b, &c);
+    for (i = 0; i < 4; i++) {
+        x[i] = 0;
+        for (j = 0; j < 8; j++) {
+            x[i] = (x[i] << 8) | b[24 - 8 * i + j];
+        }
+    }
+    x[4] = 0;
+    /* Zero is a square; p is prime, so the symbol is 0 for nothing else. */
+#ifdef SECP256K1_WIDEMUL_INT128
+    return rustsecp256k1zkp_v0_5_0_jacobi64_posdivsteps_var(x, p) >= 0;
+#else
+    return rustsecp256k1zkp_v0_5_0_jacobi64_var(x, p, 4) >= 0;
+#endif
 #endif
 }
 
@@ -49,6 +49,11 @@ static void rustsecp256k1zkp_v0_5_0_ge_set_xy(rustsecp256k1zkp_v0_5_0_ge *r, con
  */
 static int rustsecp256k1zkp_v0_5_0_ge_set_xquad(rustsecp256k1zkp_v0_5_0_ge *r, const rustsecp256k1zkp_v0_5_0_fe *x);
 
+/** Sets r[i] to the point with x coordinate x[i] and a quadratic residue y coordinate for i < len,
+ *  like rustsecp256k1zkp_v0_5_0_ge_set_xquad, and returns whether all of them exist. The square roots are
+ *  computed together, see rustsecp256k1zkp_v0_5_0_fe_sqrt_all. */
+static int rustsecp256k1zkp_v0_5_0_ge_set_xquad_all(rustsecp256k1zkp_v0_5_0_ge *r, const rustsecp256k1zkp_v0_5_0_fe *x, size_t len, int vec);
+
 /** Set a group element (affine) equal to the point with the given X coordinate, and given oddness
  *  for Y. Return value indicates whether the result is valid. */
 static int rustsecp256k1zkp_v0_5_0_ge_set_xo_var(rustsecp256k1zkp_v0_5_0_ge *r, const rustsecp256k1zkp_v0_5_0_fe *x, int odd);
@@ -71,6 +76,10 @@ static void rustsecp256k1zkp_v0_5_0_ge_set_gej_var(rustsecp256k1zkp_v0_5_0_ge *r
 /** Set a batch of group elements equal to the inputs given in jacobian coordinates */
 static void rustsecp256k1zkp_v0_5_0_ge_set_all_gej_var(rustsecp256k1zkp_v0_5_0_ge *r, const rustsecp256k1zkp_v0_5_0_gej *a, size_t len);
 
+/** Set a batch of group elements equal to the inputs given in jacobian coordinates, in constant time.
+ *  None of the inputs may be infinity, and len must be positive. */
+static void rustsecp256k1zkp_v0_5_0_ge_set_all_gej(rustsecp256k1zkp_v0_5_0_ge *r, const rustsecp256k1zkp_v0_5_0_gej *a, size_t len);
+
 /** Bring a batch inputs given in jacobian coordinates (with known z-ratios) to
  *  the same global z "denominator". zr must contain the known z-ratios such
  *  that mul(a[i].z, zr[i+1]) == a[i+1].z. zr[0] is ignored. The x and y
@@ -137,6 +146,9 @@ static void rustsecp256k1zkp_v0_5_0_ge_from_storage(rustsecp256k1zkp_v0_5_0_ge *
 /** If flag is true, set *r equal to *a; otherwise leave it. Constant-time.  Both *r and *a must be initialized.*/
 static void rustsecp256k1zkp_v0_5_0_ge_storage_cmov(rustsecp256k1zkp_v0_5_0_ge_storage *r, const rustsecp256k1zkp_v0_5_0_ge_storage *a, int flag);
 
+/** If flag is true, set *r equal to *a; otherwise leave it. Constant-time.  Both *r and *a must be initialized.*/
+static void rustsecp256k1zkp_v0_5_0_gej_cmov(rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_gej *a, int flag);
+
 /** Rescale a jacobian point by b which must be non-zero. Constant-time. */
 static void rustsecp256k1zkp_v0_5_0_gej_rescale(rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_fe *b);
 
@@ -156,6 +156,27 @@ static void rustsecp256k1zkp_v0_5_0_ge_set_all_gej_var(rustsecp256k1zkp_v0_5_0_g
     }
 }
 
+static void rustsecp256k1zkp_v0_5_0_ge_set_all_gej(rustsecp256k1zkp_v0_5_0_ge *r, const rustsecp256k1zkp_v0_5_0_gej *a, size_t len) {
+    rustsecp256k1zkp_v0_5_0_fe u;
+    rustsecp256k1zkp_v0_5_0_fe zi;
+    size_t i;
+    VERIFY_CHECK(len > 0);
+    VERIFY_CHECK(!a[0].infinity);
+    /* Use destination's x coordinates as scratch space */
+    r[0].x = a[0].z;
+    for (i = 1; i < len; i++) {
+        VERIFY_CHECK(!a[i].infinity);
+        rustsecp256k1zkp_v0_5_0_fe_mul(&r[i].x, &r[i - 1].x, &a[i].z);
+    }
+    rustsecp256k1zkp_v0_5_0_fe_inv(&u, &r[len - 1].x);
+    for (i = len - 1; i > 0; i--) {
+        rustsecp256k1zkp_v0_5_0_fe_mul(&zi, &r[i - 1].x, &u);
+        rustsecp256k1zkp_v0_5_0_fe_mul(&u, &u, &a[i].z);
+        rustsecp256k1zkp_v0_5_0_ge_set_gej_zinv(&r[i], &a[i], &zi);
+    }
+    rustsecp256k1zkp_v0_5_0_ge_set_gej_zinv(&r[0], &a[0], &u);
+}
+
 static void rustsecp256k1zkp_v0_5_0_ge_globalz_set_table_gej(size_t len, rustsecp256k1zkp_v0_5_0_ge *r, rustsecp256k1zkp_v0_5_0_fe *globalz, const rustsecp256k1zkp_v0_5_0_gej *a, const rustsecp256k1zkp_v0_5_0_fe *zr) {
     size_t i = len - 1;
     rustsecp256k1zkp_v0_5_0_fe zs;
@@ -217,6 +238,27 @@ static int rustsecp256k1zkp_v0_5_0_ge_set_xquad(rustsecp256k1zkp_v0_5_0_ge *r, c
     return rustsecp256k1zkp_v0_5_0_fe_sqrt(&r->y, &x3);
 }
 
+static int rustsecp256k1zkp_v0_5_0_ge_set_xquad_all(rustsecp256k1zkp_v0_5_0_ge *r, const rustsecp256k1zkp_v0_5_0_fe *x, size_t len, int vec) {
+    rustsecp256k1zkp_v0_5_0_fe c[8], y[8];
+    size_t i, j, n;
+    int ret = 1;
+    for (i = 0; i < len; i += n) {
+        n = len - i < 8 ? len - i : 8;
+        for (j = 0; j < n; j++) {
+            rustsecp256k1zkp_v0_5_0_fe_sqr(&c[j], &x[i + j]);
+            rustsecp256k1zkp_v0_5_0_fe_mul(&c[j], &c[j], &x[i + j]);
+            rustsecp256k1zkp_v0_5_0_fe_add(&c[j], &rustsecp256k1zkp_v0_5_0_fe_const_b);
+        }
+        ret &= rustsecp256k1zkp_v0_5_0_fe_sqrt_all(y, c, n, vec);
+        for (j = 0; j < n; j++) {
+            r[i + j].x = x[i + j];
+            r[i + j].y = y[j];
+            r[i + j].infinity = 0;
+        }
+    }
+    return ret;
+}
+
 static int rustsecp256k1zkp_v0_5_0_ge_set_xo_var(rustsecp256k1zkp_v0_5_0_ge *r, const rustsecp256k1zkp_v0_5_0_fe *x, int odd) {
     if (!rustsecp256k1zkp_v0_5_0_ge_set_xquad(r, x)) {
         return 0;
@@ -646,6 +688,13 @@ static SECP256K1_INLINE void rustsecp256k1zkp_v0_5_0_ge_storage_cmov(rustsecp256
     rustsecp256k1zkp_v0_5_0_fe_storage_cmov(&r->y, &a->y, flag);
 }
 
+static SECP256K1_INLINE void rustsecp256k1zkp_v0_5_0_gej_cmov(rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_gej *a, int flag) {
+    rustsecp256k1zkp_v0_5_0_fe_cmov(&r->x, &a->x, flag);
+    rustsecp256k1zkp_v0_5_0_fe_cmov(&r->y, &a->y, flag);
+    rustsecp256k1zkp_v0_5_0_fe_cmov(&r->z, &a->z, flag);
+    r->infinity ^= (r->infinity ^ a->infinity) & flag;
+}
+
 static void rustsecp256k1zkp_v0_5_0_ge_mul_lambda(rustsecp256k1zkp_v0_5_0_ge *r, const rustsecp256k1zkp_v0_5_0_ge *a) {
     static const rustsecp256k1zkp_v0_5_0_fe beta = SECP256K1_FE_CONST(
         0x7ae96a2bul, 0x657c0710ul, 0x6e64479eul, 0xac3434e9ul,
@@ -68,4 +68,73 @@ int rustsecp256k1zkp_v0_5_0_ecdh(const rustsecp256k1zkp_v0_5_0_context* ctx, uns
     return !!ret & !overflow;
 }
 
+/* Number of shared points converted to affine coordinates with each field inversion. */
+#define ECDH_BATCH_SIZE 32
+
+int rustsecp256k1zkp_v0_5_0_ecdh_batch(const rustsecp256k1zkp_v0_5_0_context* ctx, unsigned char *output, size_t outputlen, const rustsecp256k1zkp_v0_5_0_pubkey *pubkeys, size_t n_pubkeys, const unsigned char *scalar, rustsecp256k1zkp_v0_5_0_ecdh_hash_function hashfp, void *data) {
+    int ret = 1;
+    int overflow = 0;
+    rustsecp256k1zkp_v0_5_0_gej res[ECDH_BATCH_SIZE];
+    rustsecp256k1zkp_v0_5_0_ge pt[ECDH_BATCH_SIZE];
+    rustsecp256k1zkp_v0_5_0_scalar s;
+    unsigned char x[32];
+    unsigned char y[32];
+    size_t i;
+    size_t j;
+    size_t n;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(output != NULL || n_pubkeys == 0);
+    ARG_CHECK(pubkeys != NULL || n_pubkeys == 0);
+    ARG_CHECK(scalar != NULL);
+    ARG_CHECK(outputlen == 0 || n_pubkeys <= SIZE_MAX / outputlen);
+
+    if (hashfp == NULL) {
+        hashfp = rustsecp256k1zkp_v0_5_0_ecdh_hash_function_default;
+        ARG_CHECK(outputlen >= 32);
+    }
+
+    rustsecp256k1zkp_v0_5_0_scalar_set_b32(&s, scalar, &overflow);
+
+    overflow |= rustsecp256k1zkp_v0_5_0_scalar_is_zero(&s);
+    rustsecp256k1zkp_v0_5_0_scalar_cmov(&s, &rustsecp256k1zkp_v0_5_0_scalar_one, overflow);
+
+    for (i = 0; i < n_pubkeys; i += n) {
+        n = n_pubkeys - i;
+        if (n > ECDH_BATCH_SIZE) {
+            n = ECDH_BATCH_SIZE;
+        }
+        for (j = 0; j < n; j++) {
+            if (!rustsecp256k1zkp_v0_5_0_pubkey_load(ctx, &pt[j], &pubkeys[i + j])) {
+                ret = 0;
+                break;
+            }
+            rustsecp256k1zkp_v0_5_0_ecmult_const(&res[j], &pt[j], &s, 256);
+        }
+        if (!ret) {
+            break;
+        }
+        /* The shared points are not infinity, as the scalar is never zero. */
+        rustsecp256k1zkp_v0_5_0_ge_set_all_gej(pt, res, n);
+
+        /* Compute a hash of each point */
+        for (j = 0; j < n; j++) {
+            rustsecp256k1zkp_v0_5_0_fe_normalize(&pt[j].x);
+            rustsecp256k1zkp_v0_5_0_fe_normalize(&pt[j].y);
+            rustsecp256k1zkp_v0_5_0_fe_get_b32(x, &pt[j].x);
+            rustsecp256k1zkp_v0_5_0_fe_get_b32(y, &pt[j].y);
+
+            ret &= !!hashfp(&output[(i + j) * outputlen], x, y, data);
+        }
+    }
+
+    memset(x, 0, 32);
+    memset(y, 0, 32);
+    memset(res, 0, sizeof(res));
+    memset(pt, 0, sizeof(pt));
+    rustsecp256k1zkp_v0_5_0_scalar_clear(&s);
+
+    return ret & !overflow;
+}
+
 #endif /* SECP256K1_MODULE_ECDH_MAIN_H */
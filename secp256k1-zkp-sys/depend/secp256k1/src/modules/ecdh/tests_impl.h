@@ -123,10 +123,65 @@ void test_bad_scalar(void) {
     CHECK(rustsecp256k1zkp_v0_5_0_ecdh(ctx, output, &point, s_overflow, ecdh_hash_function_test_fail, NULL) == 0);
 }
 
+void test_ecdh_batch(void) {
+    rustsecp256k1zkp_v0_5_0_pubkey points[70];
+    unsigned char s_b32[32];
+    unsigned char s_zero[32] = { 0 };
+    unsigned char output[70 * 65];
+    unsigned char output_single[65];
+    rustsecp256k1zkp_v0_5_0_scalar s;
+    int32_t ecount = 0;
+    size_t i;
+
+    for (i = 0; i < 70; i++) {
+        random_scalar_order_test(&s);
+        rustsecp256k1zkp_v0_5_0_scalar_get_b32(s_b32, &s);
+        CHECK(rustsecp256k1zkp_v0_5_0_ec_pubkey_create(ctx, &points[i], s_b32) == 1);
+    }
+    random_scalar_order_test(&s);
+    rustsecp256k1zkp_v0_5_0_scalar_get_b32(s_b32, &s);
+
+    /* Compare against single ECDH, with batches that do and do not fill the last chunk */
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdh_batch(ctx, output, 32, points, 70, s_b32, NULL, NULL) == 1);
+    for (i = 0; i < 70; i++) {
+        CHECK(rustsecp256k1zkp_v0_5_0_ecdh(ctx, output_single, &points[i], s_b32, NULL, NULL) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_memcmp_var(&output[i * 32], output_single, 32) == 0);
+    }
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdh_batch(ctx, output, 65, points, 64, s_b32, ecdh_hash_function_custom, NULL) == 1);
+    for (i = 0; i < 64; i++) {
+        CHECK(rustsecp256k1zkp_v0_5_0_ecdh(ctx, output_single, &points[i], s_b32, ecdh_hash_function_custom, NULL) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_memcmp_var(&output[i * 65], output_single, 65) == 0);
+    }
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdh_batch(ctx, output, 32, points, 1, s_b32, NULL, NULL) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdh_batch(ctx, NULL, 32, NULL, 0, s_b32, NULL, NULL) == 1);
+
+    /* Bad scalar and hash function failure */
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdh_batch(ctx, output, 32, points, 70, s_zero, NULL, NULL) == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdh_batch(ctx, output, 32, points, 70, s_b32, ecdh_hash_function_test_fail, NULL) == 0);
+
+    /* Illegal arguments */
+    rustsecp256k1zkp_v0_5_0_context_set_illegal_callback(ctx, counting_illegal_callback_fn, &ecount);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdh_batch(ctx, NULL, 32, points, 1, s_b32, NULL, NULL) == 0);
+    CHECK(ecount == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdh_batch(ctx, output, 32, NULL, 1, s_b32, NULL, NULL) == 0);
+    CHECK(ecount == 2);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdh_batch(ctx, output, 32, points, 1, NULL, NULL, NULL) == 0);
+    CHECK(ecount == 3);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdh_batch(ctx, output, 31, points, 1, s_b32, NULL, NULL) == 0);
+    CHECK(ecount == 4);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdh_batch(ctx, output, SIZE_MAX / 2, points, 3, s_b32, ecdh_hash_function_custom, NULL) == 0);
+    CHECK(ecount == 5);
+    memset(&points[1], 0, sizeof(points[1]));
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdh_batch(ctx, output, 32, points, 3, s_b32, NULL, NULL) == 0);
+    CHECK(ecount == 6);
+    rustsecp256k1zkp_v0_5_0_context_set_illegal_callback(ctx, NULL, NULL);
+}
+
 void run_ecdh_tests(void) {
     test_ecdh_api();
     test_ecdh_generator_basepoint();
     test_bad_scalar();
+    test_ecdh_batch();
 }
 
 #endif /* SECP256K1_MODULE_ECDH_TESTS_H */
@@ -95,11 +95,63 @@ int rustsecp256k1zkp_v0_5_0_ecdsa_s2c_sign(const rustsecp256k1zkp_v0_5_0_context
     return ret;
 }
 
+/* Checks that the x coordinate of the commitment to data32 in the public nonce
+ * pubnonce is sigr (mod n). s2c_sha must contain the tagged hash midstate, which
+ * is copied rather than modified. The commitment is computed in jacobian
+ * coordinates and compared like in ecdsa_sig_verify, so no field inversion is
+ * needed, and only the tweak is multiplied, by G. */
+static int rustsecp256k1zkp_v0_5_0_ecdsa_s2c_commit_is_r(const rustsecp256k1zkp_v0_5_0_ecmult_context* ecmult_ctx, const rustsecp256k1zkp_v0_5_0_scalar *sigr, const rustsecp256k1zkp_v0_5_0_ge *pubnonce, const rustsecp256k1zkp_v0_5_0_sha256 *s2c_sha, const unsigned char *data32) {
+    rustsecp256k1zkp_v0_5_0_sha256 sha = *s2c_sha;
+    rustsecp256k1zkp_v0_5_0_ge pubnonce_ge = *pubnonce;
+    rustsecp256k1zkp_v0_5_0_gej infj;
+    rustsecp256k1zkp_v0_5_0_gej commitmentj;
+    rustsecp256k1zkp_v0_5_0_scalar tweak;
+    rustsecp256k1zkp_v0_5_0_fe xr;
+    unsigned char buf[32];
+    int overflow;
+
+    if (!rustsecp256k1zkp_v0_5_0_ec_commit_tweak(buf, &pubnonce_ge, &sha, data32, 32)) {
+        return 0;
+    }
+    rustsecp256k1zkp_v0_5_0_scalar_set_b32(&tweak, buf, &overflow);
+    if (overflow) {
+        return 0;
+    }
+    rustsecp256k1zkp_v0_5_0_gej_set_infinity(&infj);
+    rustsecp256k1zkp_v0_5_0_ecmult(ecmult_ctx, &commitmentj, &infj, &rustsecp256k1zkp_v0_5_0_scalar_zero, &tweak);
+    rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&commitmentj, &commitmentj, &pubnonce_ge, NULL);
+    if (rustsecp256k1zkp_v0_5_0_gej_is_infinity(&commitmentj)) {
+        return 0;
+    }
+
+    /* Check that sig_r == commitment_x (mod n)
+     * sig_r is the x coordinate of R represented by a scalar.
+     * commitment_x is the x coordinate of the commitment (field element).
+     *
+     * Note that we are only checking the x-coordinate -- this is because the y-coordinate
+     * is not part of the ECDSA signature (and therefore not part of the commitment!)
+     *
+     * Do not check that commitment_x is less than n; overflowing a scalar does not
+     * affect whether or not the R value is a cryptographic commitment, only whether it
+     * is a valid R value for an ECDSA signature. If users care about that they should
+     * use `ecdsa_verify` or `anti_exfil_host_verify`. In other words, this check would be
+     * (at best) unnecessary, and (at worst) insufficient. So commitment_x matches if it
+     * is either sig_r or sig_r + n. */
+    rustsecp256k1zkp_v0_5_0_scalar_get_b32(buf, sigr);
+    rustsecp256k1zkp_v0_5_0_fe_set_b32(&xr, buf);
+    if (rustsecp256k1zkp_v0_5_0_gej_eq_x_var(&xr, &commitmentj)) {
+        return 1;
+    }
+    if (rustsecp256k1zkp_v0_5_0_fe_cmp_var(&xr, &rustsecp256k1zkp_v0_5_0_ecdsa_const_p_minus_order) >= 0) {
+        return 0;
+    }
+    rustsecp256k1zkp_v0_5_0_fe_add(&xr, &rustsecp256k1zkp_v0_5_0_ecdsa_const_order_as_fe);
+    return rustsecp256k1zkp_v0_5_0_gej_eq_x_var(&xr, &commitmentj);
+}
+
 int rustsecp256k1zkp_v0_5_0_ecdsa_s2c_verify_commit(const rustsecp256k1zkp_v0_5_0_context* ctx, const rustsecp256k1zkp_v0_5_0_ecdsa_signature* sig, const unsigned char* data32, const rustsecp256k1zkp_v0_5_0_ecdsa_s2c_opening* opening) {
-    rustsecp256k1zkp_v0_5_0_ge commitment_ge;
     rustsecp256k1zkp_v0_5_0_ge original_pubnonce_ge;
-    unsigned char x_bytes[32];
-    rustsecp256k1zkp_v0_5_0_scalar sigr, sigs, x_scalar;
+    rustsecp256k1zkp_v0_5_0_scalar sigr, sigs;
     rustsecp256k1zkp_v0_5_0_sha256 s2c_sha;
 
     VERIFY_CHECK(ctx != NULL);
@@ -111,30 +163,37 @@ int rustsecp256k1zkp_v0_5_0_ecdsa_s2c_verify_commit(const rustsecp256k1zkp_v0_5_
     if (!rustsecp256k1zkp_v0_5_0_ecdsa_s2c_opening_load(ctx, &original_pubnonce_ge, opening)) {
         return 0;
     }
+    rustsecp256k1zkp_v0_5_0_ecdsa_signature_load(ctx, &sigr, &sigs, sig);
     rustsecp256k1zkp_v0_5_0_s2c_ecdsa_point_sha256_tagged(&s2c_sha);
-    if (!rustsecp256k1zkp_v0_5_0_ec_commit(&ctx->ecmult_ctx, &commitment_ge, &original_pubnonce_ge, &s2c_sha, data32, 32)) {
-        return 0;
-    }
+    return rustsecp256k1zkp_v0_5_0_ecdsa_s2c_commit_is_r(&ctx->ecmult_ctx, &sigr, &original_pubnonce_ge, &s2c_sha, data32);
+}
 
-    /* Check that sig_r == commitment_x (mod n)
-     * sig_r is the x coordinate of R represented by a scalar.
-     * commitment_x is the x coordinate of the commitment (field element).
-     *
-     * Note that we are only checking the x-coordinate -- this is because the y-coordinate
-     * is not part of the ECDSA signature (and therefore not part of the commitment!)
-     */
-    rustsecp256k1zkp_v0_5_0_ecdsa_signature_load(ctx, &sigr, &sigs, sig);
+int rustsecp256k1zkp_v0_5_0_ecdsa_s2c_verify_commit_batch(const rustsecp256k1zkp_v0_5_0_context* ctx, const rustsecp256k1zkp_v0_5_0_ecdsa_signature *const *sigs, const unsigned char *const *data32, const rustsecp256k1zkp_v0_5_0_ecdsa_s2c_opening *const *openings, size_t n_sigs) {
+    rustsecp256k1zkp_v0_5_0_ge original_pubnonce_ge;
+    rustsecp256k1zkp_v0_5_0_scalar sigr, sigs_scalar;
+    rustsecp256k1zkp_v0_5_0_sha256 s2c_sha;
+    size_t i;
 
-    rustsecp256k1zkp_v0_5_0_fe_normalize(&commitment_ge.x);
-    rustsecp256k1zkp_v0_5_0_fe_get_b32(x_bytes, &commitment_ge.x);
-    /* Do not check overflow; overflowing a scalar does not affect whether
-     * or not the R value is a cryptographic commitment, only whether it
-     * is a valid R value for an ECDSA signature. If users care about that
-     * they should use `ecdsa_verify` or `anti_exfil_host_verify`. In other
-     * words, this check would be (at best) unnecessary, and (at worst)
-     * insufficient. */
-    rustsecp256k1zkp_v0_5_0_scalar_set_b32(&x_scalar, x_bytes, NULL);
-    return rustsecp256k1zkp_v0_5_0_scalar_eq(&sigr, &x_scalar);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(rustsecp256k1zkp_v0_5_0_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(sigs != NULL || n_sigs == 0);
+    ARG_CHECK(data32 != NULL || n_sigs == 0);
+    ARG_CHECK(openings != NULL || n_sigs == 0);
+
+    rustsecp256k1zkp_v0_5_0_s2c_ecdsa_point_sha256_tagged(&s2c_sha);
+    for (i = 0; i < n_sigs; i++) {
+        ARG_CHECK(sigs[i] != NULL);
+        ARG_CHECK(data32[i] != NULL);
+        ARG_CHECK(openings[i] != NULL);
+        if (!rustsecp256k1zkp_v0_5_0_ecdsa_s2c_opening_load(ctx, &original_pubnonce_ge, openings[i])) {
+            return 0;
+        }
+        rustsecp256k1zkp_v0_5_0_ecdsa_signature_load(ctx, &sigr, &sigs_scalar, sigs[i]);
+        if (!rustsecp256k1zkp_v0_5_0_ecdsa_s2c_commit_is_r(&ctx->ecmult_ctx, &sigr, &original_pubnonce_ge, &s2c_sha, data32[i])) {
+            return 0;
+        }
+    }
+    return 1;
 }
 
 /*** anti-exfil ***/
@@ -195,4 +254,33 @@ int rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify(const rustsecp256k1zkp_v0_5_0
         rustsecp256k1zkp_v0_5_0_ecdsa_verify(ctx, sig, msg32, pubkey);
 }
 
+int rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify_batch(const rustsecp256k1zkp_v0_5_0_context* ctx, const rustsecp256k1zkp_v0_5_0_ecdsa_signature *const *sigs, const unsigned char *const *msg32, const rustsecp256k1zkp_v0_5_0_pubkey *const *pubkeys, const unsigned char *const *host_data32, const rustsecp256k1zkp_v0_5_0_ecdsa_s2c_opening *const *openings, size_t n_sigs) {
+    rustsecp256k1zkp_v0_5_0_ge q;
+    rustsecp256k1zkp_v0_5_0_scalar r, s;
+    rustsecp256k1zkp_v0_5_0_scalar m;
+    size_t i;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(msg32 != NULL || n_sigs == 0);
+    ARG_CHECK(pubkeys != NULL || n_sigs == 0);
+
+    /* The commitment checks are cheaper than signature verification, so a
+     * signer that did not use the host's randomness is caught first. */
+    if (!rustsecp256k1zkp_v0_5_0_ecdsa_s2c_verify_commit_batch(ctx, sigs, host_data32, openings, n_sigs)) {
+        return 0;
+    }
+    for (i = 0; i < n_sigs; i++) {
+        ARG_CHECK(msg32[i] != NULL);
+        ARG_CHECK(pubkeys[i] != NULL);
+        rustsecp256k1zkp_v0_5_0_scalar_set_b32(&m, msg32[i], NULL);
+        rustsecp256k1zkp_v0_5_0_ecdsa_signature_load(ctx, &r, &s, sigs[i]);
+        if (rustsecp256k1zkp_v0_5_0_scalar_is_high(&s)
+            || !rustsecp256k1zkp_v0_5_0_pubkey_load(ctx, &q, pubkeys[i])
+            || !rustsecp256k1zkp_v0_5_0_ecdsa_sig_verify(&ctx->ecmult_ctx, &r, &s, &q, &m)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
 #endif /* SECP256K1_ECDSA_S2C_MAIN_H */
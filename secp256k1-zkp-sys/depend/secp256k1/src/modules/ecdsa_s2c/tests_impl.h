@@ -402,6 +402,91 @@ static void test_ecdsa_anti_exfil(void) {
     }
 }
 
+/* This tests verifying the Anti-Exfil Protocol for many signatures at once */
+static void test_ecdsa_anti_exfil_batch(void) {
+    unsigned char signer_privkey[32];
+    unsigned char host_msg[10][32];
+    unsigned char host_commitment[32];
+    unsigned char host_nonce_contribution[10][32];
+    rustsecp256k1zkp_v0_5_0_pubkey signer_pubkey[10];
+    rustsecp256k1zkp_v0_5_0_ecdsa_signature signature[10];
+    rustsecp256k1zkp_v0_5_0_ecdsa_s2c_opening s2c_opening[10];
+    const rustsecp256k1zkp_v0_5_0_ecdsa_signature *sigs[10];
+    const unsigned char *msgs[10];
+    const rustsecp256k1zkp_v0_5_0_pubkey *pubkeys[10];
+    const unsigned char *host_data[10];
+    const rustsecp256k1zkp_v0_5_0_ecdsa_s2c_opening *openings[10];
+    rustsecp256k1zkp_v0_5_0_scalar key;
+    int ecount = 0;
+    size_t i;
+
+    for (i = 0; i < 10; i++) {
+        random_scalar_order_test(&key);
+        rustsecp256k1zkp_v0_5_0_scalar_get_b32(signer_privkey, &key);
+        CHECK(rustsecp256k1zkp_v0_5_0_ec_pubkey_create(ctx, &signer_pubkey[i], signer_privkey) == 1);
+        rustsecp256k1zkp_v0_5_0_testrand256_test(host_msg[i]);
+        rustsecp256k1zkp_v0_5_0_testrand256_test(host_nonce_contribution[i]);
+        CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_anti_exfil_host_commit(ctx, host_commitment, host_nonce_contribution[i]) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_anti_exfil_signer_commit(ctx, &s2c_opening[i], host_msg[i], signer_privkey, host_commitment) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_anti_exfil_sign(ctx, &signature[i], host_msg[i], signer_privkey, host_nonce_contribution[i]) == 1);
+        sigs[i] = &signature[i];
+        msgs[i] = host_msg[i];
+        pubkeys[i] = &signer_pubkey[i];
+        host_data[i] = host_nonce_contribution[i];
+        openings[i] = &s2c_opening[i];
+    }
+
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_s2c_verify_commit_batch(ctx, sigs, host_data, openings, 10) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify_batch(ctx, sigs, msgs, pubkeys, host_data, openings, 10) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_s2c_verify_commit_batch(ctx, NULL, NULL, NULL, 0) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify_batch(ctx, NULL, NULL, NULL, NULL, NULL, 0) == 1);
+
+    /* Message does not match: the commitments are still correct */
+    msgs[9] = host_msg[0];
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_s2c_verify_commit_batch(ctx, sigs, host_data, openings, 10) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify_batch(ctx, sigs, msgs, pubkeys, host_data, openings, 10) == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify_batch(ctx, sigs, msgs, pubkeys, host_data, openings, 9) == 1);
+    msgs[9] = host_msg[9];
+    /* Public key does not match */
+    pubkeys[3] = &signer_pubkey[4];
+    CHECK(rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify_batch(ctx, sigs, msgs, pubkeys, host_data, openings, 10) == 0);
+    pubkeys[3] = &signer_pubkey[3];
+    /* Host data does not match */
+    host_data[5] = host_nonce_contribution[6];
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_s2c_verify_commit_batch(ctx, sigs, host_data, openings, 10) == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify_batch(ctx, sigs, msgs, pubkeys, host_data, openings, 10) == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_s2c_verify_commit_batch(ctx, sigs, host_data, openings, 5) == 1);
+    host_data[5] = host_nonce_contribution[5];
+    /* Opening does not match */
+    openings[2] = &s2c_opening[1];
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_s2c_verify_commit_batch(ctx, sigs, host_data, openings, 10) == 0);
+    openings[2] = &s2c_opening[2];
+    CHECK(rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify_batch(ctx, sigs, msgs, pubkeys, host_data, openings, 10) == 1);
+
+    /* Illegal arguments */
+    rustsecp256k1zkp_v0_5_0_context_set_illegal_callback(ctx, counting_illegal_callback_fn, &ecount);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_s2c_verify_commit_batch(ctx, NULL, host_data, openings, 1) == 0);
+    CHECK(ecount == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_s2c_verify_commit_batch(ctx, sigs, NULL, openings, 1) == 0);
+    CHECK(ecount == 2);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_s2c_verify_commit_batch(ctx, sigs, host_data, NULL, 1) == 0);
+    CHECK(ecount == 3);
+    CHECK(rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify_batch(ctx, sigs, NULL, pubkeys, host_data, openings, 1) == 0);
+    CHECK(ecount == 4);
+    CHECK(rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify_batch(ctx, sigs, msgs, NULL, host_data, openings, 1) == 0);
+    CHECK(ecount == 5);
+    CHECK(rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify_batch(ctx, NULL, msgs, pubkeys, host_data, openings, 1) == 0);
+    CHECK(ecount == 6);
+    openings[1] = NULL;
+    CHECK(rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify_batch(ctx, sigs, msgs, pubkeys, host_data, openings, 2) == 0);
+    CHECK(ecount == 7);
+    openings[1] = &s2c_opening[1];
+    pubkeys[1] = NULL;
+    CHECK(rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify_batch(ctx, sigs, msgs, pubkeys, host_data, openings, 2) == 0);
+    CHECK(ecount == 8);
+    rustsecp256k1zkp_v0_5_0_context_set_illegal_callback(ctx, NULL, NULL);
+}
+
 static void run_ecdsa_s2c_tests(void) {
     run_s2c_opening_test();
     test_ecdsa_s2c_tagged_hash();
@@ -411,6 +496,7 @@ static void run_ecdsa_s2c_tests(void) {
 
     test_ecdsa_anti_exfil_signer_commit();
     test_ecdsa_anti_exfil();
+    test_ecdsa_anti_exfil_batch();
 }
 
 #endif /* SECP256K1_MODULE_ECDSA_S2C_TESTS_H */
@@ -128,6 +128,100 @@ int rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check(const rustsecp256k1zkp_
             && rustsecp256k1zkp_v0_5_0_fe_is_odd(&pk.y) == tweaked_pk_parity;
 }
 
+typedef struct {
+    const rustsecp256k1zkp_v0_5_0_context *ctx;
+    rustsecp256k1zkp_v0_5_0_scalar_randomizer randomizer;
+    const unsigned char *const *tweaked_pubkey32;
+    const int *tweaked_pk_parity;
+    const rustsecp256k1zkp_v0_5_0_xonly_pubkey *const *internal_pubkey;
+} rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch_ecmult_data;
+
+/* Callback for batch EC multiplication. Point 2*i is the internal pubkey P_i
+ * with scalar a_i and point 2*i + 1 is the tweaked pubkey Q_i with scalar -a_i. */
+static int rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch_ecmult_callback(rustsecp256k1zkp_v0_5_0_scalar *sc, rustsecp256k1zkp_v0_5_0_ge *pt, size_t idx, void *data) {
+    rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch_ecmult_data *ecmult_data = (rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch_ecmult_data *) data;
+    size_t i = idx / 2;
+
+    rustsecp256k1zkp_v0_5_0_scalar_randomizer_get(sc, &ecmult_data->randomizer, i);
+    if (idx % 2 == 0) {
+        return rustsecp256k1zkp_v0_5_0_xonly_pubkey_load(ecmult_data->ctx, pt, ecmult_data->internal_pubkey[i]);
+    } else {
+        rustsecp256k1zkp_v0_5_0_fe qx;
+        rustsecp256k1zkp_v0_5_0_scalar_negate(sc, sc);
+        if (!rustsecp256k1zkp_v0_5_0_fe_set_b32(&qx, ecmult_data->tweaked_pubkey32[i])) {
+            return 0;
+        }
+        return rustsecp256k1zkp_v0_5_0_ge_set_xo_var(pt, &qx, ecmult_data->tweaked_pk_parity[i]);
+    }
+}
+
+int rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_scratch_space *scratch, const unsigned char *const *tweaked_pubkey32, const int *tweaked_pk_parity, const rustsecp256k1zkp_v0_5_0_xonly_pubkey *const *internal_pubkey, const unsigned char *const *tweak32, size_t n_checks) {
+    rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch_ecmult_data ecmult_data;
+    rustsecp256k1zkp_v0_5_0_sha256 sha;
+    rustsecp256k1zkp_v0_5_0_scalar t_sum;
+    rustsecp256k1zkp_v0_5_0_gej rj;
+    unsigned char seed[32];
+    size_t i;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(rustsecp256k1zkp_v0_5_0_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(n_checks == 0 || tweaked_pubkey32 != NULL);
+    ARG_CHECK(n_checks == 0 || tweaked_pk_parity != NULL);
+    ARG_CHECK(n_checks == 0 || internal_pubkey != NULL);
+    ARG_CHECK(n_checks == 0 || tweak32 != NULL);
+    /* Each check contributes two points to the multi-multiplication. */
+    ARG_CHECK(n_checks <= SIZE_MAX / 2);
+
+    if (n_checks == 0) {
+        return 1;
+    }
+
+    /* Seed the randomizers with a hash of the whole batch, so that they are
+     * unpredictable to anyone who does not control every input. */
+    rustsecp256k1zkp_v0_5_0_sha256_initialize(&sha);
+    for (i = 0; i < n_checks; i++) {
+        unsigned char buf[33];
+        ARG_CHECK(tweaked_pubkey32[i] != NULL);
+        ARG_CHECK(tweaked_pk_parity[i] == 0 || tweaked_pk_parity[i] == 1);
+        ARG_CHECK(internal_pubkey[i] != NULL);
+        ARG_CHECK(tweak32[i] != NULL);
+        if (!rustsecp256k1zkp_v0_5_0_xonly_pubkey_serialize(ctx, buf, internal_pubkey[i])) {
+            return 0;
+        }
+        buf[32] = tweaked_pk_parity[i];
+        rustsecp256k1zkp_v0_5_0_sha256_write(&sha, buf, 33);
+        rustsecp256k1zkp_v0_5_0_sha256_write(&sha, tweaked_pubkey32[i], 32);
+        rustsecp256k1zkp_v0_5_0_sha256_write(&sha, tweak32[i], 32);
+    }
+    ecmult_data.ctx = ctx;
+    rustsecp256k1zkp_v0_5_0_sha256_finalize(&sha, seed);
+    rustsecp256k1zkp_v0_5_0_scalar_randomizer_init(&ecmult_data.randomizer, seed);
+    ecmult_data.tweaked_pubkey32 = tweaked_pubkey32;
+    ecmult_data.tweaked_pk_parity = tweaked_pk_parity;
+    ecmult_data.internal_pubkey = internal_pubkey;
+
+    /* Compute sum(a_i*t_i), the scalar for G. */
+    rustsecp256k1zkp_v0_5_0_scalar_clear(&t_sum);
+    for (i = 0; i < n_checks; i++) {
+        rustsecp256k1zkp_v0_5_0_scalar t;
+        rustsecp256k1zkp_v0_5_0_scalar a;
+        int overflow;
+        rustsecp256k1zkp_v0_5_0_scalar_set_b32(&t, tweak32[i], &overflow);
+        if (overflow) {
+            return 0;
+        }
+        rustsecp256k1zkp_v0_5_0_scalar_randomizer_get(&a, &ecmult_data.randomizer, i);
+        rustsecp256k1zkp_v0_5_0_scalar_mul(&t, &t, &a);
+        rustsecp256k1zkp_v0_5_0_scalar_add(&t_sum, &t_sum, &t);
+    }
+
+    /* Check sum(a_i*P_i) - sum(a_i*Q_i) + sum(a_i*t_i)*G = 0 */
+    if (!rustsecp256k1zkp_v0_5_0_ecmult_multi_var(&ctx->error_callback, &ctx->ecmult_ctx, scratch, &rj, &t_sum, rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch_ecmult_callback, (void *) &ecmult_data, 2 * n_checks)) {
+        return 0;
+    }
+    return rustsecp256k1zkp_v0_5_0_gej_is_infinity(&rj);
+}
+
 static void rustsecp256k1zkp_v0_5_0_keypair_save(rustsecp256k1zkp_v0_5_0_keypair *keypair, const rustsecp256k1zkp_v0_5_0_scalar *sk, rustsecp256k1zkp_v0_5_0_ge *pk) {
     rustsecp256k1zkp_v0_5_0_scalar_get_b32(&keypair->data[0], sk);
     rustsecp256k1zkp_v0_5_0_pubkey_save((rustsecp256k1zkp_v0_5_0_pubkey *)&keypair->data[32], pk);
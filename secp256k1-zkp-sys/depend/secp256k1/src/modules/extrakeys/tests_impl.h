@@ -276,6 +276,106 @@ void test_xonly_pubkey_tweak_check(void) {
     rustsecp256k1zkp_v0_5_0_context_destroy(verify);
 }
 
+#define N_TWEAK_CHECKS 16
+void test_xonly_pubkey_tweak_check_batch(void) {
+    unsigned char overflows[32];
+    rustsecp256k1zkp_v0_5_0_xonly_pubkey internal_pk[N_TWEAK_CHECKS];
+    unsigned char output_pk32[N_TWEAK_CHECKS][32];
+    unsigned char tweak[N_TWEAK_CHECKS][32];
+    int pk_parity[N_TWEAK_CHECKS];
+    const rustsecp256k1zkp_v0_5_0_xonly_pubkey *internal_pk_ptr[N_TWEAK_CHECKS];
+    const unsigned char *output_pk32_ptr[N_TWEAK_CHECKS];
+    const unsigned char *tweak_ptr[N_TWEAK_CHECKS];
+    rustsecp256k1zkp_v0_5_0_scratch_space *scratch;
+    size_t i;
+
+    int ecount;
+    rustsecp256k1zkp_v0_5_0_context *none = api_test_context(SECP256K1_CONTEXT_NONE, &ecount);
+    rustsecp256k1zkp_v0_5_0_context *sign = api_test_context(SECP256K1_CONTEXT_SIGN, &ecount);
+    rustsecp256k1zkp_v0_5_0_context *verify = api_test_context(SECP256K1_CONTEXT_VERIFY, &ecount);
+
+    memset(overflows, 0xff, sizeof(overflows));
+    for (i = 0; i < N_TWEAK_CHECKS; i++) {
+        unsigned char sk[32];
+        rustsecp256k1zkp_v0_5_0_pubkey pk;
+        rustsecp256k1zkp_v0_5_0_xonly_pubkey output_xonly_pk;
+
+        rustsecp256k1zkp_v0_5_0_testrand256(sk);
+        rustsecp256k1zkp_v0_5_0_testrand256(tweak[i]);
+        CHECK(rustsecp256k1zkp_v0_5_0_ec_pubkey_create(ctx, &pk, sk) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_from_pubkey(ctx, &internal_pk[i], NULL, &pk) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add(ctx, &pk, &internal_pk[i], tweak[i]) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_from_pubkey(ctx, &output_xonly_pk, &pk_parity[i], &pk) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_serialize(ctx, output_pk32[i], &output_xonly_pk) == 1);
+        internal_pk_ptr[i] = &internal_pk[i];
+        output_pk32_ptr[i] = output_pk32[i];
+        tweak_ptr[i] = tweak[i];
+    }
+    scratch = rustsecp256k1zkp_v0_5_0_scratch_space_create(ctx, 1 << 16);
+
+    /* Valid batches of every size, with and without scratch space */
+    for (i = 0; i <= N_TWEAK_CHECKS; i++) {
+        CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(ctx, scratch, output_pk32_ptr, pk_parity, internal_pk_ptr, tweak_ptr, i) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(ctx, NULL, output_pk32_ptr, pk_parity, internal_pk_ptr, tweak_ptr, i) == 1);
+    }
+
+    /* Wrong pk_parity */
+    pk_parity[3] = !pk_parity[3];
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(ctx, scratch, output_pk32_ptr, pk_parity, internal_pk_ptr, tweak_ptr, N_TWEAK_CHECKS) == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(ctx, scratch, output_pk32_ptr, pk_parity, internal_pk_ptr, tweak_ptr, 3) == 1);
+    pk_parity[3] = !pk_parity[3];
+    /* Wrong tweak */
+    tweak_ptr[N_TWEAK_CHECKS - 1] = tweak[0];
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(ctx, scratch, output_pk32_ptr, pk_parity, internal_pk_ptr, tweak_ptr, N_TWEAK_CHECKS) == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(ctx, NULL, output_pk32_ptr, pk_parity, internal_pk_ptr, tweak_ptr, N_TWEAK_CHECKS) == 0);
+    /* Overflowing tweak not allowed */
+    tweak_ptr[N_TWEAK_CHECKS - 1] = overflows;
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(ctx, scratch, output_pk32_ptr, pk_parity, internal_pk_ptr, tweak_ptr, N_TWEAK_CHECKS) == 0);
+    tweak_ptr[N_TWEAK_CHECKS - 1] = tweak[N_TWEAK_CHECKS - 1];
+    /* Two wrong output keys which would cancel out without randomizers */
+    output_pk32_ptr[1] = output_pk32[2];
+    output_pk32_ptr[2] = output_pk32[1];
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(ctx, scratch, output_pk32_ptr, pk_parity, internal_pk_ptr, tweak_ptr, N_TWEAK_CHECKS) == 0);
+    output_pk32_ptr[1] = output_pk32[1];
+    /* Output key which is not a valid x coordinate */
+    output_pk32_ptr[2] = overflows;
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(ctx, scratch, output_pk32_ptr, pk_parity, internal_pk_ptr, tweak_ptr, N_TWEAK_CHECKS) == 0);
+    output_pk32_ptr[2] = output_pk32[2];
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(ctx, scratch, output_pk32_ptr, pk_parity, internal_pk_ptr, tweak_ptr, N_TWEAK_CHECKS) == 1);
+
+    /* API */
+    ecount = 0;
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(none, scratch, output_pk32_ptr, pk_parity, internal_pk_ptr, tweak_ptr, N_TWEAK_CHECKS) == 0);
+    CHECK(ecount == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(sign, scratch, output_pk32_ptr, pk_parity, internal_pk_ptr, tweak_ptr, N_TWEAK_CHECKS) == 0);
+    CHECK(ecount == 2);
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(verify, scratch, output_pk32_ptr, pk_parity, internal_pk_ptr, tweak_ptr, N_TWEAK_CHECKS) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(verify, scratch, NULL, pk_parity, internal_pk_ptr, tweak_ptr, N_TWEAK_CHECKS) == 0);
+    CHECK(ecount == 3);
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(verify, scratch, output_pk32_ptr, NULL, internal_pk_ptr, tweak_ptr, N_TWEAK_CHECKS) == 0);
+    CHECK(ecount == 4);
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(verify, scratch, output_pk32_ptr, pk_parity, NULL, tweak_ptr, N_TWEAK_CHECKS) == 0);
+    CHECK(ecount == 5);
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(verify, scratch, output_pk32_ptr, pk_parity, internal_pk_ptr, NULL, N_TWEAK_CHECKS) == 0);
+    CHECK(ecount == 6);
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(verify, scratch, NULL, NULL, NULL, NULL, 0) == 1);
+    CHECK(ecount == 6);
+    tweak_ptr[5] = NULL;
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(verify, scratch, output_pk32_ptr, pk_parity, internal_pk_ptr, tweak_ptr, N_TWEAK_CHECKS) == 0);
+    CHECK(ecount == 7);
+    tweak_ptr[5] = tweak[5];
+    /* invalid pk_parity value */
+    pk_parity[5] = 2;
+    CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch(verify, scratch, output_pk32_ptr, pk_parity, internal_pk_ptr, tweak_ptr, N_TWEAK_CHECKS) == 0);
+    CHECK(ecount == 8);
+
+    rustsecp256k1zkp_v0_5_0_scratch_space_destroy(ctx, scratch);
+    rustsecp256k1zkp_v0_5_0_context_destroy(none);
+    rustsecp256k1zkp_v0_5_0_context_destroy(sign);
+    rustsecp256k1zkp_v0_5_0_context_destroy(verify);
+}
+#undef N_TWEAK_CHECKS
+
 /* Starts with an initial pubkey and recursively creates N_PUBKEYS - 1
  * additional pubkeys by calling tweak_add. Then verifies every tweak starting
  * from the last pubkey. */
@@ -539,6 +639,7 @@ void run_extrakeys_tests(void) {
     test_xonly_pubkey();
     test_xonly_pubkey_tweak();
     test_xonly_pubkey_tweak_check();
+    test_xonly_pubkey_tweak_check_batch();
     test_xonly_pubkey_tweak_recursive();
 
     /* keypair tests */
@@ -157,6 +157,89 @@ int rustsecp256k1zkp_v0_5_0_musig_pubkey_tweak_add(const rustsecp256k1zkp_v0_5_0
     return 1;
 }
 
+/* A musig_keyagg_signer consists of
+ *   - the 32-byte hash of all public keys (pk_hash of the pre_session),
+ *   - the 4-byte index of the signer, least significant byte first,
+ *   - the 32-byte MuSig coefficient of the signer,
+ *   - ECMULT_POINT_TABLE_SIZE odd multiples of the signer's public key, 64
+ *     bytes each. */
+static void rustsecp256k1zkp_v0_5_0_musig_keyagg_signer_save(rustsecp256k1zkp_v0_5_0_musig_keyagg_signer *entry, const unsigned char *ell, uint32_t index, const rustsecp256k1zkp_v0_5_0_scalar *mu, const rustsecp256k1zkp_v0_5_0_ge_storage *table) {
+    size_t i;
+
+    memcpy(&entry->data[0], ell, 32);
+    for (i = 0; i < sizeof(uint32_t); i++) {
+        entry->data[32 + i] = index >> (8 * i);
+    }
+    rustsecp256k1zkp_v0_5_0_scalar_get_b32(&entry->data[36], mu);
+    for (i = 0; i < ECMULT_POINT_TABLE_SIZE; i++) {
+        unsigned char *out = &entry->data[68 + 64 * i];
+        if (sizeof(rustsecp256k1zkp_v0_5_0_ge_storage) == 64) {
+            memcpy(out, &table[i], 64);
+        } else {
+            rustsecp256k1zkp_v0_5_0_ge p;
+            rustsecp256k1zkp_v0_5_0_ge_from_storage(&p, &table[i]);
+            rustsecp256k1zkp_v0_5_0_fe_normalize_var(&p.x);
+            rustsecp256k1zkp_v0_5_0_fe_normalize_var(&p.y);
+            rustsecp256k1zkp_v0_5_0_fe_get_b32(out, &p.x);
+            rustsecp256k1zkp_v0_5_0_fe_get_b32(out + 32, &p.y);
+        }
+    }
+}
+
+static uint32_t rustsecp256k1zkp_v0_5_0_musig_keyagg_signer_index(const rustsecp256k1zkp_v0_5_0_musig_keyagg_signer *entry) {
+    return (uint32_t) entry->data[32]
+        | (uint32_t) entry->data[33] << 8
+        | (uint32_t) entry->data[34] << 16
+        | (uint32_t) entry->data[35] << 24;
+}
+
+static void rustsecp256k1zkp_v0_5_0_musig_keyagg_signer_load(rustsecp256k1zkp_v0_5_0_scalar *mu, rustsecp256k1zkp_v0_5_0_ge_storage *table, const rustsecp256k1zkp_v0_5_0_musig_keyagg_signer *entry) {
+    size_t i;
+
+    rustsecp256k1zkp_v0_5_0_scalar_set_b32(mu, &entry->data[36], NULL);
+    for (i = 0; i < ECMULT_POINT_TABLE_SIZE; i++) {
+        const unsigned char *in = &entry->data[68 + 64 * i];
+        if (sizeof(rustsecp256k1zkp_v0_5_0_ge_storage) == 64) {
+            memcpy(&table[i], in, 64);
+        } else {
+            rustsecp256k1zkp_v0_5_0_fe x, y;
+            rustsecp256k1zkp_v0_5_0_ge p;
+            rustsecp256k1zkp_v0_5_0_fe_set_b32(&x, in);
+            rustsecp256k1zkp_v0_5_0_fe_set_b32(&y, in + 32);
+            rustsecp256k1zkp_v0_5_0_ge_set_xy(&p, &x, &y);
+            rustsecp256k1zkp_v0_5_0_ge_to_storage(&table[i], &p);
+        }
+    }
+}
+
+int rustsecp256k1zkp_v0_5_0_musig_keyagg_cache_init(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_scratch_space *scratch, rustsecp256k1zkp_v0_5_0_xonly_pubkey *combined_pk, rustsecp256k1zkp_v0_5_0_musig_pre_session *pre_session, rustsecp256k1zkp_v0_5_0_musig_keyagg_signer *signers, const rustsecp256k1zkp_v0_5_0_xonly_pubkey *pubkeys, size_t n_pubkeys) {
+    size_t i;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(pre_session != NULL);
+    ARG_CHECK(signers != NULL);
+    ARG_CHECK(n_pubkeys <= UINT32_MAX);
+
+    if (!rustsecp256k1zkp_v0_5_0_musig_pubkey_combine(ctx, scratch, combined_pk, pre_session, pubkeys, n_pubkeys)) {
+        return 0;
+    }
+    for (i = 0; i < n_pubkeys; i++) {
+        rustsecp256k1zkp_v0_5_0_ge_storage table[ECMULT_POINT_TABLE_SIZE];
+        rustsecp256k1zkp_v0_5_0_scalar mu;
+        rustsecp256k1zkp_v0_5_0_ge p;
+        rustsecp256k1zkp_v0_5_0_gej pj;
+
+        /* The keys were loaded successfully by musig_pubkey_combine. */
+        rustsecp256k1zkp_v0_5_0_xonly_pubkey_load(ctx, &p, &pubkeys[i]);
+        rustsecp256k1zkp_v0_5_0_gej_set_ge(&pj, &p);
+        memset(table, 0, sizeof(table));
+        rustsecp256k1zkp_v0_5_0_ecmult_point_table(table, &pj);
+        rustsecp256k1zkp_v0_5_0_musig_coefficient(&mu, pre_session->pk_hash, (uint32_t) i);
+        rustsecp256k1zkp_v0_5_0_musig_keyagg_signer_save(&signers[i], pre_session->pk_hash, (uint32_t) i, &mu, table);
+    }
+    return 1;
+}
+
 static const uint64_t session_magic = 0xd92e6fc1ee41b4cbUL;
 
 int rustsecp256k1zkp_v0_5_0_musig_session_init(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_musig_session *session, rustsecp256k1zkp_v0_5_0_musig_session_signer_data *signers, unsigned char *nonce_commitment32, const unsigned char *session_id32, const unsigned char *msg32, const rustsecp256k1zkp_v0_5_0_xonly_pubkey *combined_pk, const rustsecp256k1zkp_v0_5_0_musig_pre_session *pre_session, size_t n_signers, size_t my_index, const unsigned char *seckey) {
@@ -568,41 +651,27 @@ int rustsecp256k1zkp_v0_5_0_musig_partial_sig_combine(const rustsecp256k1zkp_v0_
     return 1;
 }
 
-int rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify(const rustsecp256k1zkp_v0_5_0_context* ctx, const rustsecp256k1zkp_v0_5_0_musig_session *session, const rustsecp256k1zkp_v0_5_0_musig_session_signer_data *signer, const rustsecp256k1zkp_v0_5_0_musig_partial_signature *partial_sig, const rustsecp256k1zkp_v0_5_0_xonly_pubkey *pubkey) {
+/* Computes the scalars of the partial signature verification equation
+ * s*G - e*mu*P = R, where e is negated as needed for the parities of the
+ * combined key, the internal key and the nonce. Sets rp to the nonce to add
+ * to s*G + (-e*mu)*P, which must result in infinity. */
+static int rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_prepare(const rustsecp256k1zkp_v0_5_0_context* ctx, const rustsecp256k1zkp_v0_5_0_musig_session *session, const rustsecp256k1zkp_v0_5_0_musig_session_signer_data *signer, const rustsecp256k1zkp_v0_5_0_musig_partial_signature *partial_sig, const rustsecp256k1zkp_v0_5_0_scalar *mu, rustsecp256k1zkp_v0_5_0_scalar *s, rustsecp256k1zkp_v0_5_0_scalar *e, rustsecp256k1zkp_v0_5_0_ge *rp) {
     unsigned char msghash[32];
-    rustsecp256k1zkp_v0_5_0_scalar s;
-    rustsecp256k1zkp_v0_5_0_scalar e;
-    rustsecp256k1zkp_v0_5_0_scalar mu;
-    rustsecp256k1zkp_v0_5_0_gej pkj;
-    rustsecp256k1zkp_v0_5_0_gej rj;
-    rustsecp256k1zkp_v0_5_0_ge pkp;
-    rustsecp256k1zkp_v0_5_0_ge rp;
     int overflow;
 
-    VERIFY_CHECK(ctx != NULL);
-    ARG_CHECK(rustsecp256k1zkp_v0_5_0_ecmult_context_is_built(&ctx->ecmult_ctx));
-    ARG_CHECK(session != NULL);
-    ARG_CHECK(signer != NULL);
-    ARG_CHECK(partial_sig != NULL);
-    ARG_CHECK(pubkey != NULL);
-    ARG_CHECK(session->magic == session_magic);
-    ARG_CHECK(session->round == 2);
-    ARG_CHECK(signer->present);
-
-    rustsecp256k1zkp_v0_5_0_scalar_set_b32(&s, partial_sig->data, &overflow);
+    rustsecp256k1zkp_v0_5_0_scalar_set_b32(s, partial_sig->data, &overflow);
     if (overflow) {
         return 0;
     }
     rustsecp256k1zkp_v0_5_0_musig_compute_messagehash(ctx, msghash, session);
-    rustsecp256k1zkp_v0_5_0_scalar_set_b32(&e, msghash, NULL);
+    rustsecp256k1zkp_v0_5_0_scalar_set_b32(e, msghash, NULL);
 
     /* Multiplying the messagehash by the musig coefficient is equivalent
      * to multiplying the signer's public key by the coefficient, except
      * much easier to do. */
-    rustsecp256k1zkp_v0_5_0_musig_coefficient(&mu, session->pre_session.pk_hash, signer->index);
-    rustsecp256k1zkp_v0_5_0_scalar_mul(&e, &e, &mu);
+    rustsecp256k1zkp_v0_5_0_scalar_mul(e, e, mu);
 
-    if (!rustsecp256k1zkp_v0_5_0_xonly_pubkey_load(ctx, &rp, &signer->nonce)) {
+    if (!rustsecp256k1zkp_v0_5_0_xonly_pubkey_load(ctx, rp, &signer->nonce)) {
         return 0;
     }
 
@@ -614,25 +683,251 @@ int rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify(const rustsecp256k1zkp_v0_5
     if (session->pre_session.pk_parity
             != (session->pre_session.is_tweaked
                 && session->pre_session.internal_key_parity)) {
-        rustsecp256k1zkp_v0_5_0_scalar_negate(&e, &e);
+        rustsecp256k1zkp_v0_5_0_scalar_negate(e, e);
     }
 
-    /* Compute rj =  s*G + (-e)*pkj */
-    rustsecp256k1zkp_v0_5_0_scalar_negate(&e, &e);
+    /* The caller computes rj =  s*G + (-e)*pkj */
+    rustsecp256k1zkp_v0_5_0_scalar_negate(e, e);
+
+    if (!session->combined_nonce_parity) {
+        rustsecp256k1zkp_v0_5_0_ge_neg(rp, rp);
+    }
+    return 1;
+}
+
+int rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify(const rustsecp256k1zkp_v0_5_0_context* ctx, const rustsecp256k1zkp_v0_5_0_musig_session *session, const rustsecp256k1zkp_v0_5_0_musig_session_signer_data *signer, const rustsecp256k1zkp_v0_5_0_musig_partial_signature *partial_sig, const rustsecp256k1zkp_v0_5_0_xonly_pubkey *pubkey) {
+    rustsecp256k1zkp_v0_5_0_scalar s;
+    rustsecp256k1zkp_v0_5_0_scalar e;
+    rustsecp256k1zkp_v0_5_0_scalar mu;
+    rustsecp256k1zkp_v0_5_0_gej pkj;
+    rustsecp256k1zkp_v0_5_0_gej rj;
+    rustsecp256k1zkp_v0_5_0_ge pkp;
+    rustsecp256k1zkp_v0_5_0_ge rp;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(rustsecp256k1zkp_v0_5_0_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(session != NULL);
+    ARG_CHECK(signer != NULL);
+    ARG_CHECK(partial_sig != NULL);
+    ARG_CHECK(pubkey != NULL);
+    ARG_CHECK(session->magic == session_magic);
+    ARG_CHECK(session->round == 2);
+    ARG_CHECK(signer->present);
+
+    rustsecp256k1zkp_v0_5_0_musig_coefficient(&mu, session->pre_session.pk_hash, signer->index);
+    if (!rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_prepare(ctx, session, signer, partial_sig, &mu, &s, &e, &rp)) {
+        return 0;
+    }
     if (!rustsecp256k1zkp_v0_5_0_xonly_pubkey_load(ctx, &pkp, pubkey)) {
         return 0;
     }
     rustsecp256k1zkp_v0_5_0_gej_set_ge(&pkj, &pkp);
     rustsecp256k1zkp_v0_5_0_ecmult(&ctx->ecmult_ctx, &rj, &pkj, &e, &s);
+    rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&rj, &rj, &rp, NULL);
 
-    if (!session->combined_nonce_parity) {
-        rustsecp256k1zkp_v0_5_0_ge_neg(&rp, &rp);
+    return rustsecp256k1zkp_v0_5_0_gej_is_infinity(&rj);
+}
+
+int rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(const rustsecp256k1zkp_v0_5_0_context* ctx, const rustsecp256k1zkp_v0_5_0_musig_session *session, const rustsecp256k1zkp_v0_5_0_musig_session_signer_data *signer, const rustsecp256k1zkp_v0_5_0_musig_partial_signature *partial_sig, const rustsecp256k1zkp_v0_5_0_musig_keyagg_signer *keyagg_signer) {
+    rustsecp256k1zkp_v0_5_0_ge_storage table[ECMULT_POINT_TABLE_SIZE];
+    rustsecp256k1zkp_v0_5_0_scalar s;
+    rustsecp256k1zkp_v0_5_0_scalar e;
+    rustsecp256k1zkp_v0_5_0_scalar mu;
+    rustsecp256k1zkp_v0_5_0_gej rj;
+    rustsecp256k1zkp_v0_5_0_ge rp;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(rustsecp256k1zkp_v0_5_0_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(session != NULL);
+    ARG_CHECK(signer != NULL);
+    ARG_CHECK(partial_sig != NULL);
+    ARG_CHECK(keyagg_signer != NULL);
+    ARG_CHECK(session->magic == session_magic);
+    ARG_CHECK(session->round == 2);
+    ARG_CHECK(signer->present);
+    /* The cache entry must belong to the same key set and signer. */
+    ARG_CHECK(memcmp(&keyagg_signer->data[0], session->pre_session.pk_hash, 32) == 0);
+    ARG_CHECK(rustsecp256k1zkp_v0_5_0_musig_keyagg_signer_index(keyagg_signer) == signer->index);
+
+    rustsecp256k1zkp_v0_5_0_musig_keyagg_signer_load(&mu, table, keyagg_signer);
+    if (!rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_prepare(ctx, session, signer, partial_sig, &mu, &s, &e, &rp)) {
+        return 0;
     }
+    rustsecp256k1zkp_v0_5_0_ecmult_with_table(&ctx->ecmult_ctx, &rj, table, &e, &s);
     rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&rj, &rj, &rp, NULL);
 
     return rustsecp256k1zkp_v0_5_0_gej_is_infinity(&rj);
 }
 
+/* Data for the ecmult_multi callback of musig_partial_sig_verify_batch. The
+ * scalar and nonce of the last prepared signature are cached because each
+ * signature contributes two points. */
+typedef struct {
+    const rustsecp256k1zkp_v0_5_0_context *ctx;
+    rustsecp256k1zkp_v0_5_0_scalar_randomizer randomizer;
+    size_t prepared_idx;
+    int prepared_valid;
+    rustsecp256k1zkp_v0_5_0_scalar prepared_e;
+    rustsecp256k1zkp_v0_5_0_ge prepared_pk;
+    rustsecp256k1zkp_v0_5_0_ge prepared_rp;
+    const rustsecp256k1zkp_v0_5_0_musig_session *const *sessions;
+    const rustsecp256k1zkp_v0_5_0_musig_session_signer_data *const *signers;
+    const rustsecp256k1zkp_v0_5_0_musig_partial_signature *const *partial_sigs;
+    const rustsecp256k1zkp_v0_5_0_xonly_pubkey *const *pubkeys;
+    const rustsecp256k1zkp_v0_5_0_musig_keyagg_signer *const *keyagg_signers;
+} rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch_ecmult_data;
+
+/* Loads the MuSig coefficient and public key of signature i. */
+static int rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch_load(rustsecp256k1zkp_v0_5_0_scalar *mu, rustsecp256k1zkp_v0_5_0_ge *pk, const rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch_ecmult_data *data, size_t i) {
+    if (data->keyagg_signers != NULL) {
+        rustsecp256k1zkp_v0_5_0_ge_storage table[ECMULT_POINT_TABLE_SIZE];
+        rustsecp256k1zkp_v0_5_0_musig_keyagg_signer_load(mu, table, data->keyagg_signers[i]);
+        rustsecp256k1zkp_v0_5_0_ge_from_storage(pk, &table[0]);
+        return 1;
+    }
+    rustsecp256k1zkp_v0_5_0_musig_coefficient(mu, data->sessions[i]->pre_session.pk_hash, data->signers[i]->index);
+    return rustsecp256k1zkp_v0_5_0_xonly_pubkey_load(data->ctx, pk, data->pubkeys[i]);
+}
+
+/* Callback for batch EC multiplication. Point 2*i is the public key of
+ * signature i with scalar a_i times the (negated) e_i*mu_i from
+ * musig_partial_sig_verify_prepare, and point 2*i + 1 is its nonce with
+ * scalar a_i. */
+static int rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch_ecmult_callback(rustsecp256k1zkp_v0_5_0_scalar *sc, rustsecp256k1zkp_v0_5_0_ge *pt, size_t idx, void *data) {
+    rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch_ecmult_data *ecmult_data = (rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch_ecmult_data *) data;
+    size_t i = idx / 2;
+    rustsecp256k1zkp_v0_5_0_scalar a;
+
+    if (!ecmult_data->prepared_valid || ecmult_data->prepared_idx != i) {
+        rustsecp256k1zkp_v0_5_0_scalar s;
+        rustsecp256k1zkp_v0_5_0_scalar mu;
+        if (!rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch_load(&mu, &ecmult_data->prepared_pk, ecmult_data, i)) {
+            return 0;
+        }
+        if (!rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_prepare(ecmult_data->ctx, ecmult_data->sessions[i], ecmult_data->signers[i], ecmult_data->partial_sigs[i], &mu, &s, &ecmult_data->prepared_e, &ecmult_data->prepared_rp)) {
+            return 0;
+        }
+        ecmult_data->prepared_idx = i;
+        ecmult_data->prepared_valid = 1;
+    }
+    rustsecp256k1zkp_v0_5_0_scalar_randomizer_get(&a, &ecmult_data->randomizer, i);
+    if (idx % 2 == 0) {
+        *pt = ecmult_data->prepared_pk;
+        rustsecp256k1zkp_v0_5_0_scalar_mul(sc, &a, &ecmult_data->prepared_e);
+    } else {
+        *pt = ecmult_data->prepared_rp;
+        *sc = a;
+    }
+    return 1;
+}
+
+static int rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch_single(const rustsecp256k1zkp_v0_5_0_context* ctx, const rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch_ecmult_data *data, size_t i) {
+    if (data->keyagg_signers != NULL) {
+        return rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(ctx, data->sessions[i], data->signers[i], data->partial_sigs[i], data->keyagg_signers[i]);
+    }
+    return rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify(ctx, data->sessions[i], data->signers[i], data->partial_sigs[i], data->pubkeys[i]);
+}
+
+int rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_scratch_space *scratch, size_t *invalid, size_t *n_invalid, const rustsecp256k1zkp_v0_5_0_musig_session *const *sessions, const rustsecp256k1zkp_v0_5_0_musig_session_signer_data *const *signers, const rustsecp256k1zkp_v0_5_0_musig_partial_signature *const *partial_sigs, const rustsecp256k1zkp_v0_5_0_xonly_pubkey *const *pubkeys, const rustsecp256k1zkp_v0_5_0_musig_keyagg_signer *const *keyagg_signers, size_t n_sigs) {
+    rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch_ecmult_data ecmult_data;
+    rustsecp256k1zkp_v0_5_0_sha256 sha;
+    rustsecp256k1zkp_v0_5_0_scalar s_sum;
+    rustsecp256k1zkp_v0_5_0_gej rj;
+    unsigned char seed[32];
+    size_t i;
+
+    VERIFY_CHECK(ctx != NULL);
+    if (n_invalid != NULL) {
+        *n_invalid = 0;
+    }
+    ARG_CHECK(rustsecp256k1zkp_v0_5_0_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(invalid == NULL || n_invalid != NULL);
+    ARG_CHECK(n_sigs == 0 || sessions != NULL);
+    ARG_CHECK(n_sigs == 0 || signers != NULL);
+    ARG_CHECK(n_sigs == 0 || partial_sigs != NULL);
+    /* Exactly one of pubkeys and keyagg_signers must be given. */
+    ARG_CHECK(n_sigs == 0 || (pubkeys == NULL) != (keyagg_signers == NULL));
+    ARG_CHECK(n_sigs <= SIZE_MAX / 2);
+
+    if (n_sigs == 0) {
+        return 1;
+    }
+
+    /* Seed the randomizers with a hash of everything the verification
+     * equations depend on. */
+    rustsecp256k1zkp_v0_5_0_sha256_initialize(&sha);
+    for (i = 0; i < n_sigs; i++) {
+        unsigned char buf[32];
+        ARG_CHECK(sessions[i] != NULL);
+        ARG_CHECK(signers[i] != NULL);
+        ARG_CHECK(partial_sigs[i] != NULL);
+        ARG_CHECK(sessions[i]->magic == session_magic);
+        ARG_CHECK(sessions[i]->round == 2);
+        ARG_CHECK(signers[i]->present);
+        if (keyagg_signers != NULL) {
+            ARG_CHECK(keyagg_signers[i] != NULL);
+            ARG_CHECK(memcmp(&keyagg_signers[i]->data[0], sessions[i]->pre_session.pk_hash, 32) == 0);
+            ARG_CHECK(rustsecp256k1zkp_v0_5_0_musig_keyagg_signer_index(keyagg_signers[i]) == signers[i]->index);
+            rustsecp256k1zkp_v0_5_0_sha256_write(&sha, keyagg_signers[i]->data, sizeof(keyagg_signers[i]->data));
+        } else {
+            ARG_CHECK(pubkeys[i] != NULL);
+            if (!rustsecp256k1zkp_v0_5_0_xonly_pubkey_serialize(ctx, buf, pubkeys[i])) {
+                return 0;
+            }
+            rustsecp256k1zkp_v0_5_0_sha256_write(&sha, buf, 32);
+        }
+        rustsecp256k1zkp_v0_5_0_musig_compute_messagehash(ctx, buf, sessions[i]);
+        rustsecp256k1zkp_v0_5_0_sha256_write(&sha, buf, 32);
+        rustsecp256k1zkp_v0_5_0_sha256_write(&sha, sessions[i]->pre_session.pk_hash, 32);
+        rustsecp256k1zkp_v0_5_0_xonly_pubkey_serialize(ctx, buf, &signers[i]->nonce);
+        rustsecp256k1zkp_v0_5_0_sha256_write(&sha, buf, 32);
+        rustsecp256k1zkp_v0_5_0_sha256_write(&sha, partial_sigs[i]->data, 32);
+    }
+    ecmult_data.ctx = ctx;
+    rustsecp256k1zkp_v0_5_0_sha256_finalize(&sha, seed);
+    rustsecp256k1zkp_v0_5_0_scalar_randomizer_init(&ecmult_data.randomizer, seed);
+    ecmult_data.prepared_idx = 0;
+    ecmult_data.prepared_valid = 0;
+    ecmult_data.sessions = sessions;
+    ecmult_data.signers = signers;
+    ecmult_data.partial_sigs = partial_sigs;
+    ecmult_data.pubkeys = pubkeys;
+    ecmult_data.keyagg_signers = keyagg_signers;
+
+    /* Compute sum(a_i*s_i), the scalar for G. */
+    rustsecp256k1zkp_v0_5_0_scalar_clear(&s_sum);
+    for (i = 0; i < n_sigs; i++) {
+        rustsecp256k1zkp_v0_5_0_scalar s;
+        rustsecp256k1zkp_v0_5_0_scalar a;
+        int overflow;
+        rustsecp256k1zkp_v0_5_0_scalar_set_b32(&s, partial_sigs[i]->data, &overflow);
+        if (overflow) {
+            break;
+        }
+        rustsecp256k1zkp_v0_5_0_scalar_randomizer_get(&a, &ecmult_data.randomizer, i);
+        rustsecp256k1zkp_v0_5_0_scalar_mul(&s, &s, &a);
+        rustsecp256k1zkp_v0_5_0_scalar_add(&s_sum, &s_sum, &s);
+    }
+
+    /* Check sum(a_i*(s_i*G + e_i*P_i + R_i)) = 0 with e_i and R_i as computed
+     * by musig_partial_sig_verify_prepare. */
+    if (i == n_sigs
+            && rustsecp256k1zkp_v0_5_0_ecmult_multi_var(&ctx->error_callback, &ctx->ecmult_ctx, scratch, &rj, &s_sum, rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch_ecmult_callback, (void *) &ecmult_data, 2 * n_sigs)
+            && rustsecp256k1zkp_v0_5_0_gej_is_infinity(&rj)) {
+        return 1;
+    }
+
+    /* Find the invalid signatures one by one. */
+    if (invalid != NULL) {
+        for (i = 0; i < n_sigs; i++) {
+            if (!rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch_single(ctx, &ecmult_data, i)) {
+                invalid[(*n_invalid)++] = i;
+            }
+        }
+    }
+    return 0;
+}
+
 int rustsecp256k1zkp_v0_5_0_musig_partial_sig_adapt(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_musig_partial_signature *adaptor_sig, const rustsecp256k1zkp_v0_5_0_musig_partial_signature *partial_sig, const unsigned char *sec_adaptor32, int nonce_parity) {
     rustsecp256k1zkp_v0_5_0_scalar s;
     rustsecp256k1zkp_v0_5_0_scalar t;
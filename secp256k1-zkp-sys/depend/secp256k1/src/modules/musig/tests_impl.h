@@ -34,6 +34,9 @@ void musig_simple_test(rustsecp256k1zkp_v0_5_0_scratch_space *scratch) {
     unsigned char public_nonce[3][32];
     rustsecp256k1zkp_v0_5_0_musig_partial_signature partial_sig[2];
     unsigned char final_sig[64];
+    rustsecp256k1zkp_v0_5_0_xonly_pubkey cached_combined_pk;
+    rustsecp256k1zkp_v0_5_0_musig_pre_session cached_pre_session;
+    rustsecp256k1zkp_v0_5_0_musig_keyagg_signer keyagg_signers[2];
 
     rustsecp256k1zkp_v0_5_0_testrand256(session_id[0]);
     rustsecp256k1zkp_v0_5_0_testrand256(session_id[1]);
@@ -45,6 +48,10 @@ void musig_simple_test(rustsecp256k1zkp_v0_5_0_scratch_space *scratch) {
     CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_create(&pk[1], sk[1]) == 1);
 
     CHECK(rustsecp256k1zkp_v0_5_0_musig_pubkey_combine(ctx, scratch, &combined_pk, &pre_session, pk, 2) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_keyagg_cache_init(ctx, scratch, &cached_combined_pk, &cached_pre_session, keyagg_signers, pk, 2) == 1);
+    CHECK(memcmp(&cached_combined_pk, &combined_pk, sizeof(combined_pk)) == 0);
+    CHECK(memcmp(cached_pre_session.pk_hash, pre_session.pk_hash, 32) == 0);
+    CHECK(cached_pre_session.pk_parity == pre_session.pk_parity);
     CHECK(rustsecp256k1zkp_v0_5_0_musig_session_init(ctx, &session[1], signer1, nonce_commitment[1], session_id[1], msg, &combined_pk, &pre_session, 2, 1, sk[1]) == 1);
     CHECK(rustsecp256k1zkp_v0_5_0_musig_session_init(ctx, &session[0], signer0, nonce_commitment[0], session_id[0], msg, &combined_pk, &pre_session, 2, 0, sk[0]) == 1);
 
@@ -67,6 +74,10 @@ void musig_simple_test(rustsecp256k1zkp_v0_5_0_scratch_space *scratch) {
     CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sign(ctx, &session[1], &partial_sig[1]) == 1);
     CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify(ctx, &session[0], &signer0[1], &partial_sig[1], &pk[1]) == 1);
     CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify(ctx, &session[1], &signer1[1], &partial_sig[1], &pk[1]) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(ctx, &session[0], &signer0[0], &partial_sig[0], &keyagg_signers[0]) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(ctx, &session[0], &signer0[1], &partial_sig[1], &keyagg_signers[1]) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(ctx, &session[1], &signer1[0], &partial_sig[0], &keyagg_signers[0]) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(ctx, &session[1], &signer1[1], &partial_sig[0], &keyagg_signers[1]) == 0);
 
     CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_combine(ctx, &session[0], final_sig, partial_sig, 2) == 1);
     CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify(ctx, final_sig, msg, &combined_pk) == 1);
@@ -98,6 +109,8 @@ void musig_api_tests(rustsecp256k1zkp_v0_5_0_scratch_space *scratch) {
     rustsecp256k1zkp_v0_5_0_musig_pre_session pre_session;
     rustsecp256k1zkp_v0_5_0_musig_pre_session pre_session_uninitialized;
     rustsecp256k1zkp_v0_5_0_xonly_pubkey pk[2];
+    rustsecp256k1zkp_v0_5_0_musig_keyagg_signer keyagg_signers[2];
+    rustsecp256k1zkp_v0_5_0_musig_keyagg_signer keyagg_signer_other;
     unsigned char tweak[32];
 
     unsigned char sec_adaptor[32];
@@ -170,6 +183,23 @@ void musig_api_tests(rustsecp256k1zkp_v0_5_0_scratch_space *scratch) {
     CHECK(rustsecp256k1zkp_v0_5_0_musig_pubkey_combine(vrfy, scratch, &combined_pk, &pre_session, pk, 2) == 1);
     CHECK(rustsecp256k1zkp_v0_5_0_musig_pubkey_combine(vrfy, scratch, &combined_pk, &pre_session, pk, 2) == 1);
 
+    /* Key aggregation cache */
+    ecount = 0;
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_keyagg_cache_init(none, scratch, &combined_pk, &pre_session, keyagg_signers, pk, 2) == 0);
+    CHECK(ecount == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_keyagg_cache_init(vrfy, scratch, &combined_pk, NULL, keyagg_signers, pk, 2) == 0);
+    CHECK(ecount == 2);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_keyagg_cache_init(vrfy, scratch, &combined_pk, &pre_session, NULL, pk, 2) == 0);
+    CHECK(ecount == 3);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_keyagg_cache_init(vrfy, scratch, &combined_pk, &pre_session, keyagg_signers, NULL, 2) == 0);
+    CHECK(ecount == 4);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_keyagg_cache_init(vrfy, scratch, &combined_pk, &pre_session, keyagg_signers, pk, 0) == 0);
+    CHECK(ecount == 5);
+    /* A cache for a different key set, i.e. only the first key */
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_keyagg_cache_init(vrfy, NULL, &combined_pk, &pre_session, &keyagg_signer_other, pk, 1) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_keyagg_cache_init(vrfy, NULL, &combined_pk, &pre_session, keyagg_signers, pk, 2) == 1);
+    CHECK(ecount == 5);
+
     /** Tweaking */
     ecount = 0;
     {
@@ -421,6 +451,35 @@ void musig_api_tests(rustsecp256k1zkp_v0_5_0_scratch_space *scratch) {
     CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify(vrfy, &verifier_session, &verifier_signer_data[1], &partial_sig[1], &pk[1]) == 1);
     CHECK(ecount == 7);
 
+    ecount = 0;
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(none, &session[0], &signer0[0], &partial_sig[0], &keyagg_signers[0]) == 0);
+    CHECK(ecount == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(vrfy, &session[0], &signer0[0], &partial_sig[0], &keyagg_signers[0]) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(vrfy, &session[0], &signer0[0], &partial_sig[1], &keyagg_signers[0]) == 0);
+    CHECK(ecount == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(vrfy, NULL, &signer0[0], &partial_sig[0], &keyagg_signers[0]) == 0);
+    CHECK(ecount == 2);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(vrfy, &session_uninitialized, &signer0[0], &partial_sig[0], &keyagg_signers[0]) == 0);
+    CHECK(ecount == 3);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(vrfy, &session[0], NULL, &partial_sig[0], &keyagg_signers[0]) == 0);
+    CHECK(ecount == 4);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(vrfy, &session[0], &signer0[0], NULL, &keyagg_signers[0]) == 0);
+    CHECK(ecount == 5);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(vrfy, &session[0], &signer0[0], &partial_sig_overflow, &keyagg_signers[0]) == 0);
+    CHECK(ecount == 5);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(vrfy, &session[0], &signer0[0], &partial_sig[0], NULL) == 0);
+    CHECK(ecount == 6);
+    /* Entry of another signer */
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(vrfy, &session[0], &signer0[0], &partial_sig[0], &keyagg_signers[1]) == 0);
+    CHECK(ecount == 7);
+    /* Entry of another key set */
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(vrfy, &session[0], &signer0[0], &partial_sig[0], &keyagg_signer_other) == 0);
+    CHECK(ecount == 8);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(vrfy, &session[1], &signer1[1], &partial_sig[1], &keyagg_signers[1]) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(vrfy, &verifier_session, &verifier_signer_data[0], &partial_sig[0], &keyagg_signers[0]) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(vrfy, &verifier_session, &verifier_signer_data[1], &partial_sig[1], &keyagg_signers[1]) == 1);
+    CHECK(ecount == 8);
+
     /** Adaptor signature verification */
     memcpy(&partial_sig_adapted[1], &partial_sig[1], sizeof(partial_sig_adapted[1]));
     ecount = 0;
@@ -859,6 +918,118 @@ void sha256_tag_test(void) {
     CHECK(memcmp(buf, buf2, 32) == 0);
 }
 
+/* Runs several sessions of the same signers and verifies all their partial
+ * signatures in one batch. */
+#define N_BATCH_SIGNERS 3
+#define N_BATCH_SESSIONS 2
+#define N_BATCH (N_BATCH_SIGNERS * N_BATCH_SESSIONS)
+void musig_batch_verify_test(rustsecp256k1zkp_v0_5_0_scratch_space *scratch) {
+    unsigned char sk[N_BATCH_SIGNERS][32];
+    rustsecp256k1zkp_v0_5_0_xonly_pubkey pk[N_BATCH_SIGNERS];
+    rustsecp256k1zkp_v0_5_0_xonly_pubkey combined_pk;
+    rustsecp256k1zkp_v0_5_0_musig_pre_session pre_session;
+    rustsecp256k1zkp_v0_5_0_musig_keyagg_signer keyagg_signers[N_BATCH_SIGNERS];
+    rustsecp256k1zkp_v0_5_0_musig_session session[N_BATCH_SESSIONS][N_BATCH_SIGNERS];
+    rustsecp256k1zkp_v0_5_0_musig_session_signer_data signer_data[N_BATCH_SESSIONS][N_BATCH_SIGNERS][N_BATCH_SIGNERS];
+    rustsecp256k1zkp_v0_5_0_musig_partial_signature partial_sig[N_BATCH];
+    rustsecp256k1zkp_v0_5_0_musig_partial_signature partial_sig_bad;
+    const rustsecp256k1zkp_v0_5_0_musig_session *sessions[N_BATCH];
+    const rustsecp256k1zkp_v0_5_0_musig_session_signer_data *signers[N_BATCH];
+    const rustsecp256k1zkp_v0_5_0_musig_partial_signature *partial_sigs[N_BATCH];
+    const rustsecp256k1zkp_v0_5_0_xonly_pubkey *pubkeys[N_BATCH];
+    const rustsecp256k1zkp_v0_5_0_musig_keyagg_signer *keyagg_signer_ptrs[N_BATCH];
+    size_t invalid[N_BATCH];
+    size_t n_invalid;
+    int ecount = 0;
+    size_t i, j, k;
+
+    rustsecp256k1zkp_v0_5_0_context_set_illegal_callback(ctx, counting_illegal_callback_fn, &ecount);
+    for (i = 0; i < N_BATCH_SIGNERS; i++) {
+        rustsecp256k1zkp_v0_5_0_testrand256(sk[i]);
+        CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_create(&pk[i], sk[i]) == 1);
+    }
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_keyagg_cache_init(ctx, scratch, &combined_pk, &pre_session, keyagg_signers, pk, N_BATCH_SIGNERS) == 1);
+
+    for (j = 0; j < N_BATCH_SESSIONS; j++) {
+        unsigned char msg[32];
+        unsigned char session_id[32];
+        unsigned char nonce_commitment[N_BATCH_SIGNERS][32];
+        unsigned char nonce[N_BATCH_SIGNERS][32];
+        const unsigned char *ncs[N_BATCH_SIGNERS];
+
+        rustsecp256k1zkp_v0_5_0_testrand256(msg);
+        for (i = 0; i < N_BATCH_SIGNERS; i++) {
+            rustsecp256k1zkp_v0_5_0_testrand256(session_id);
+            CHECK(rustsecp256k1zkp_v0_5_0_musig_session_init(ctx, &session[j][i], signer_data[j][i], nonce_commitment[i], session_id, msg, &combined_pk, &pre_session, N_BATCH_SIGNERS, i, sk[i]) == 1);
+            ncs[i] = nonce_commitment[i];
+        }
+        for (i = 0; i < N_BATCH_SIGNERS; i++) {
+            CHECK(rustsecp256k1zkp_v0_5_0_musig_session_get_public_nonce(ctx, &session[j][i], signer_data[j][i], nonce[i], ncs, N_BATCH_SIGNERS, NULL) == 1);
+        }
+        for (i = 0; i < N_BATCH_SIGNERS; i++) {
+            for (k = 0; k < N_BATCH_SIGNERS; k++) {
+                CHECK(rustsecp256k1zkp_v0_5_0_musig_set_nonce(ctx, &signer_data[j][i][k], nonce[k]) == 1);
+            }
+            CHECK(rustsecp256k1zkp_v0_5_0_musig_session_combine_nonces(ctx, &session[j][i], signer_data[j][i], N_BATCH_SIGNERS, NULL, NULL) == 1);
+        }
+        for (i = 0; i < N_BATCH_SIGNERS; i++) {
+            k = j * N_BATCH_SIGNERS + i;
+            CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sign(ctx, &session[j][i], &partial_sig[k]) == 1);
+            /* The coordinator is signer 0 */
+            sessions[k] = &session[j][0];
+            signers[k] = &signer_data[j][0][i];
+            partial_sigs[k] = &partial_sig[k];
+            pubkeys[k] = &pk[i];
+            keyagg_signer_ptrs[k] = &keyagg_signers[i];
+        }
+    }
+
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch(ctx, NULL, invalid, &n_invalid, sessions, signers, partial_sigs, pubkeys, NULL, N_BATCH) == 1);
+    CHECK(n_invalid == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch(ctx, scratch, invalid, &n_invalid, sessions, signers, partial_sigs, NULL, keyagg_signer_ptrs, N_BATCH) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch(ctx, scratch, NULL, NULL, sessions, signers, partial_sigs, pubkeys, NULL, N_BATCH) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch(ctx, scratch, NULL, NULL, NULL, NULL, NULL, NULL, NULL, 0) == 1);
+    CHECK(ecount == 0);
+
+    /* A partial signature of another session, and an overflowing one */
+    partial_sigs[1] = &partial_sig[1 + N_BATCH_SIGNERS];
+    memset(partial_sig_bad.data, 0xff, 32);
+    partial_sigs[N_BATCH - 1] = &partial_sig_bad;
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch(ctx, scratch, invalid, &n_invalid, sessions, signers, partial_sigs, pubkeys, NULL, N_BATCH) == 0);
+    CHECK(n_invalid == 2);
+    CHECK(invalid[0] == 1 && invalid[1] == N_BATCH - 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch(ctx, NULL, invalid, &n_invalid, sessions, signers, partial_sigs, NULL, keyagg_signer_ptrs, N_BATCH) == 0);
+    CHECK(n_invalid == 2);
+    CHECK(invalid[0] == 1 && invalid[1] == N_BATCH - 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch(ctx, NULL, NULL, NULL, sessions, signers, partial_sigs, pubkeys, NULL, N_BATCH) == 0);
+    partial_sigs[1] = &partial_sig[1];
+    partial_sigs[N_BATCH - 1] = &partial_sig[N_BATCH - 1];
+
+    /* Illegal arguments */
+    CHECK(ecount == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch(ctx, NULL, invalid, NULL, sessions, signers, partial_sigs, pubkeys, NULL, N_BATCH) == 0);
+    CHECK(ecount == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch(ctx, NULL, invalid, &n_invalid, NULL, signers, partial_sigs, pubkeys, NULL, N_BATCH) == 0);
+    CHECK(ecount == 2);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch(ctx, NULL, invalid, &n_invalid, sessions, NULL, partial_sigs, pubkeys, NULL, N_BATCH) == 0);
+    CHECK(ecount == 3);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch(ctx, NULL, invalid, &n_invalid, sessions, signers, NULL, pubkeys, NULL, N_BATCH) == 0);
+    CHECK(ecount == 4);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch(ctx, NULL, invalid, &n_invalid, sessions, signers, partial_sigs, NULL, NULL, N_BATCH) == 0);
+    CHECK(ecount == 5);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch(ctx, NULL, invalid, &n_invalid, sessions, signers, partial_sigs, pubkeys, keyagg_signer_ptrs, N_BATCH) == 0);
+    CHECK(ecount == 6);
+    /* Entry of another signer */
+    keyagg_signer_ptrs[0] = &keyagg_signers[1];
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_batch(ctx, NULL, invalid, &n_invalid, sessions, signers, partial_sigs, NULL, keyagg_signer_ptrs, N_BATCH) == 0);
+    CHECK(ecount == 7);
+    CHECK(n_invalid == 0);
+    rustsecp256k1zkp_v0_5_0_context_set_illegal_callback(ctx, NULL, NULL);
+}
+#undef N_BATCH
+#undef N_BATCH_SESSIONS
+#undef N_BATCH_SIGNERS
+
 /* Attempts to create a signature for the combined public key using given secret
  * keys and pre_session. */
 void musig_tweak_test_helper(const rustsecp256k1zkp_v0_5_0_xonly_pubkey* combined_pubkey, const unsigned char *sk0, const unsigned char *sk1, rustsecp256k1zkp_v0_5_0_musig_pre_session *pre_session) {
@@ -873,6 +1044,9 @@ void musig_tweak_test_helper(const rustsecp256k1zkp_v0_5_0_xonly_pubkey* combine
     const unsigned char *ncs[2];
     rustsecp256k1zkp_v0_5_0_musig_partial_signature partial_sig[2];
     unsigned char final_sig[64];
+    rustsecp256k1zkp_v0_5_0_xonly_pubkey untweaked_pk;
+    rustsecp256k1zkp_v0_5_0_musig_pre_session untweaked_pre_session;
+    rustsecp256k1zkp_v0_5_0_musig_keyagg_signer keyagg_signers[2];
 
     rustsecp256k1zkp_v0_5_0_testrand256(session_id[0]);
     rustsecp256k1zkp_v0_5_0_testrand256(session_id[1]);
@@ -880,6 +1054,8 @@ void musig_tweak_test_helper(const rustsecp256k1zkp_v0_5_0_xonly_pubkey* combine
 
     CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_create(&pk[0], sk0) == 1);
     CHECK(rustsecp256k1zkp_v0_5_0_xonly_pubkey_create(&pk[1], sk1) == 1);
+    /* The key aggregation cache does not depend on the tweak */
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_keyagg_cache_init(ctx, NULL, &untweaked_pk, &untweaked_pre_session, keyagg_signers, pk, 2) == 1);
 
     CHECK(rustsecp256k1zkp_v0_5_0_musig_session_init(ctx, &session[0], signers0, nonce_commitment[0], session_id[0], msg, combined_pubkey, pre_session, 2, 0, sk0) == 1);
     CHECK(rustsecp256k1zkp_v0_5_0_musig_session_init(ctx, &session[1], signers1, nonce_commitment[1], session_id[1], msg, combined_pubkey, pre_session, 2, 1, sk1) == 1);
@@ -899,6 +1075,8 @@ void musig_tweak_test_helper(const rustsecp256k1zkp_v0_5_0_xonly_pubkey* combine
     CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sign(ctx, &session[1], &partial_sig[1]) == 1);
     CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify(ctx, &session[0], &signers0[1], &partial_sig[1], &pk[1]) == 1);
     CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify(ctx, &session[1], &signers1[0], &partial_sig[0], &pk[0]) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(ctx, &session[0], &signers0[1], &partial_sig[1], &keyagg_signers[1]) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_verify_cached(ctx, &session[1], &signers1[0], &partial_sig[0], &keyagg_signers[0]) == 1);
     CHECK(rustsecp256k1zkp_v0_5_0_musig_partial_sig_combine(ctx, &session[0], final_sig, partial_sig, 2));
     CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify(ctx, final_sig, msg, combined_pubkey) == 1);
 }
@@ -959,6 +1137,7 @@ void run_musig_tests(void) {
     }
     musig_api_tests(scratch);
     musig_state_machine_tests(scratch);
+    musig_batch_verify_test(scratch);
     for (i = 0; i < count; i++) {
         /* Run multiple times to ensure that pk and nonce have different y
          * parities */
@@ -41,6 +41,9 @@ SECP256K1_INLINE static void rustsecp256k1zkp_v0_5_0_borromean_hash(unsigned cha
     rustsecp256k1zkp_v0_5_0_sha256_finalize(&sha256_en, hash);
 }
 
+/* Number of rings borromean_verify advances together. */
+#define SECP256K1_BORROMEAN_VERIFY_RINGS 16
+
 /**  "Borromean" ring signature.
  *   Verifies nrings concurrent ring signatures all sharing a challenge value.
  *   Signature is one s value per pubkey and a hash.
@@ -57,16 +60,22 @@ SECP256K1_INLINE static void rustsecp256k1zkp_v0_5_0_borromean_hash(unsigned cha
  */
 int rustsecp256k1zkp_v0_5_0_borromean_verify(const rustsecp256k1zkp_v0_5_0_ecmult_context* ecmult_ctx, rustsecp256k1zkp_v0_5_0_scalar *evalues, const unsigned char *e0,
  const rustsecp256k1zkp_v0_5_0_scalar *s, const rustsecp256k1zkp_v0_5_0_gej *pubs, const size_t *rsizes, size_t nrings, const unsigned char *m, size_t mlen) {
-    rustsecp256k1zkp_v0_5_0_gej rgej;
-    rustsecp256k1zkp_v0_5_0_ge rge;
-    rustsecp256k1zkp_v0_5_0_scalar ens;
+    rustsecp256k1zkp_v0_5_0_gej rgej[SECP256K1_BORROMEAN_VERIFY_RINGS];
+    rustsecp256k1zkp_v0_5_0_ge rge[SECP256K1_BORROMEAN_VERIFY_RINGS];
+    rustsecp256k1zkp_v0_5_0_scalar ens[SECP256K1_BORROMEAN_VERIFY_RINGS];
+    int overflow[SECP256K1_BORROMEAN_VERIFY_RINGS];
+    size_t offset[SECP256K1_BORROMEAN_VERIFY_RINGS];
+    unsigned char last[SECP256K1_BORROMEAN_VERIFY_RINGS][33];
     rustsecp256k1zkp_v0_5_0_sha256 sha256_e0;
     unsigned char tmp[33];
     size_t i;
     size_t j;
+    size_t k;
+    size_t n;
+    size_t n_active;
+    size_t max_rsize;
     size_t count;
     size_t size;
-    int overflow;
     VERIFY_CHECK(ecmult_ctx != NULL);
     VERIFY_CHECK(e0 != NULL);
     VERIFY_CHECK(s != NULL);
@@ -76,32 +85,62 @@ int rustsecp256k1zkp_v0_5_0_borromean_verify(const rustsecp256k1zkp_v0_5_0_ecmul
     VERIFY_CHECK(m != NULL);
     count = 0;
     rustsecp256k1zkp_v0_5_0_sha256_initialize(&sha256_e0);
-    for (i = 0; i < nrings; i++) {
-        VERIFY_CHECK(INT_MAX - count > rsizes[i]);
-        rustsecp256k1zkp_v0_5_0_borromean_hash(tmp, m, mlen, e0, 32, i, 0);
-        rustsecp256k1zkp_v0_5_0_scalar_set_b32(&ens, tmp, &overflow);
-        for (j = 0; j < rsizes[i]; j++) {
-            if (overflow || rustsecp256k1zkp_v0_5_0_scalar_is_zero(&s[count]) || rustsecp256k1zkp_v0_5_0_scalar_is_zero(&ens) || rustsecp256k1zkp_v0_5_0_gej_is_infinity(&pubs[count])) {
-                return 0;
+    /* The rings are independent until their last points are hashed together,
+     * so groups of rings are walked in lockstep: member j of every ring of the
+     * group is computed before member j + 1 of any, and the points of a step
+     * share one field inversion when they are converted to affine coordinates. */
+    for (i = 0; i < nrings; i += n) {
+        n = nrings - i < SECP256K1_BORROMEAN_VERIFY_RINGS ? nrings - i : SECP256K1_BORROMEAN_VERIFY_RINGS;
+        max_rsize = 0;
+        for (k = 0; k < n; k++) {
+            VERIFY_CHECK(INT_MAX - count > rsizes[i + k]);
+            offset[k] = count;
+            count += rsizes[i + k];
+            if (rsizes[i + k] > max_rsize) {
+                max_rsize = rsizes[i + k];
             }
-            if (evalues) {
-                /*If requested, save the challenges for proof rewind.*/
-                evalues[count] = ens;
+            rustsecp256k1zkp_v0_5_0_borromean_hash(tmp, m, mlen, e0, 32, i + k, 0);
+            rustsecp256k1zkp_v0_5_0_scalar_set_b32(&ens[k], tmp, &overflow[k]);
+        }
+        for (j = 0; j < max_rsize; j++) {
+            n_active = 0;
+            for (k = 0; k < n; k++) {
+                size_t idx = offset[k] + j;
+                if (j >= rsizes[i + k]) {
+                    continue;
+                }
+                if (overflow[k] || rustsecp256k1zkp_v0_5_0_scalar_is_zero(&s[idx]) || rustsecp256k1zkp_v0_5_0_scalar_is_zero(&ens[k]) || rustsecp256k1zkp_v0_5_0_gej_is_infinity(&pubs[idx])) {
+                    return 0;
+                }
+                if (evalues) {
+                    /*If requested, save the challenges for proof rewind.*/
+                    evalues[idx] = ens[k];
+                }
+                rustsecp256k1zkp_v0_5_0_ecmult(ecmult_ctx, &rgej[n_active], &pubs[idx], &ens[k], &s[idx]);
+                if (rustsecp256k1zkp_v0_5_0_gej_is_infinity(&rgej[n_active])) {
+                    return 0;
+                }
+                n_active++;
             }
-            rustsecp256k1zkp_v0_5_0_ecmult(ecmult_ctx, &rgej, &pubs[count], &ens, &s[count]);
-            if (rustsecp256k1zkp_v0_5_0_gej_is_infinity(&rgej)) {
-                return 0;
+            rustsecp256k1zkp_v0_5_0_ge_set_all_gej_var(rge, rgej, n_active);
+            n_active = 0;
+            for (k = 0; k < n; k++) {
+                if (j >= rsizes[i + k]) {
+                    continue;
+                }
+                rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(&rge[n_active++], tmp, &size, 1);
+                if (j != rsizes[i + k] - 1) {
+                    rustsecp256k1zkp_v0_5_0_borromean_hash(tmp, m, mlen, tmp, 33, i + k, j + 1);
+                    rustsecp256k1zkp_v0_5_0_scalar_set_b32(&ens[k], tmp, &overflow[k]);
+                } else {
+                    memcpy(last[k], tmp, 33);
+                }
             }
-            /* OPT: loop can be hoisted and split to use batch inversion across all the rings; this would make it much faster. */
-            rustsecp256k1zkp_v0_5_0_ge_set_gej_var(&rge, &rgej);
-            rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(&rge, tmp, &size, 1);
-            if (j != rsizes[i] - 1) {
-                rustsecp256k1zkp_v0_5_0_borromean_hash(tmp, m, mlen, tmp, 33, i, j + 1);
-                rustsecp256k1zkp_v0_5_0_scalar_set_b32(&ens, tmp, &overflow);
-            } else {
-                rustsecp256k1zkp_v0_5_0_sha256_write(&sha256_e0, tmp, size);
+        }
+        for (k = 0; k < n; k++) {
+            if (rsizes[i + k] > 0) {
+                rustsecp256k1zkp_v0_5_0_sha256_write(&sha256_e0, last[k], 33);
             }
-            count++;
         }
     }
     rustsecp256k1zkp_v0_5_0_sha256_write(&sha256_e0, m, mlen);
@@ -42,6 +42,23 @@ static void rustsecp256k1zkp_v0_5_0_pedersen_commitment_load(rustsecp256k1zkp_v0
     }
 }
 
+/* Loads n <= 8 commitments, computing their square roots together. */
+static void rustsecp256k1zkp_v0_5_0_pedersen_commitment_load_all(rustsecp256k1zkp_v0_5_0_ge* ge, const rustsecp256k1zkp_v0_5_0_pedersen_commitment * const* commits, size_t n, int vec) {
+    rustsecp256k1zkp_v0_5_0_fe fe[8];
+    size_t i;
+    VERIFY_CHECK(n >= 1 && n <= 8);
+    for (i = 0; i < 8; i++) {
+        /* The unused entries are set as well to keep compilers from warning. */
+        rustsecp256k1zkp_v0_5_0_fe_set_b32(&fe[i], &commits[i < n ? i : 0]->data[1]);
+    }
+    rustsecp256k1zkp_v0_5_0_ge_set_xquad_all(ge, fe, n, vec);
+    for (i = 0; i < n; i++) {
+        if (commits[i]->data[0] & 1) {
+            rustsecp256k1zkp_v0_5_0_ge_neg(&ge[i], &ge[i]);
+        }
+    }
+}
+
 static void rustsecp256k1zkp_v0_5_0_pedersen_commitment_save(rustsecp256k1zkp_v0_5_0_pedersen_commitment* commit, rustsecp256k1zkp_v0_5_0_ge* ge) {
     rustsecp256k1zkp_v0_5_0_fe_normalize(&ge->x);
     rustsecp256k1zkp_v0_5_0_fe_get_b32(&commit->data[1], &ge->x);
@@ -100,7 +117,7 @@ int rustsecp256k1zkp_v0_5_0_pedersen_commit(const rustsecp256k1zkp_v0_5_0_contex
     rustsecp256k1zkp_v0_5_0_generator_load(&genp, gen);
     rustsecp256k1zkp_v0_5_0_scalar_set_b32(&sec, blind, &overflow);
     if (!overflow) {
-        rustsecp256k1zkp_v0_5_0_pedersen_ecmult(&ctx->ecmult_gen_ctx, &rj, &sec, value, &genp);
+        rustsecp256k1zkp_v0_5_0_pedersen_ecmult(&ctx->ecmult_gen_ctx, &rj, &sec, value, 64, &genp);
         if (!rustsecp256k1zkp_v0_5_0_gej_is_infinity(&rj)) {
             rustsecp256k1zkp_v0_5_0_ge_set_gej(&r, &rj);
             rustsecp256k1zkp_v0_5_0_pedersen_commitment_save(commit, &r);
@@ -146,21 +163,29 @@ int rustsecp256k1zkp_v0_5_0_pedersen_blind_sum(const rustsecp256k1zkp_v0_5_0_con
 /* Takes two lists of commitments and sums the first set and subtracts the second and verifies that they sum to excess. */
 int rustsecp256k1zkp_v0_5_0_pedersen_verify_tally(const rustsecp256k1zkp_v0_5_0_context* ctx, const rustsecp256k1zkp_v0_5_0_pedersen_commitment * const* commits, size_t pcnt, const rustsecp256k1zkp_v0_5_0_pedersen_commitment * const* ncommits, size_t ncnt) {
     rustsecp256k1zkp_v0_5_0_gej accj;
-    rustsecp256k1zkp_v0_5_0_ge add;
-    size_t i;
+    rustsecp256k1zkp_v0_5_0_ge add[8];
+    size_t i, j, n;
+    int vec;
     VERIFY_CHECK(ctx != NULL);
     ARG_CHECK(!pcnt || (commits != NULL));
     ARG_CHECK(!ncnt || (ncommits != NULL));
     (void) ctx;
+    vec = (pcnt >= 8 || ncnt >= 8) && rustsecp256k1zkp_v0_5_0_fe_vec_available();
     rustsecp256k1zkp_v0_5_0_gej_set_infinity(&accj);
-    for (i = 0; i < ncnt; i++) {
-        rustsecp256k1zkp_v0_5_0_pedersen_commitment_load(&add, ncommits[i]);
-        rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&accj, &accj, &add, NULL);
+    for (i = 0; i < ncnt; i += n) {
+        n = ncnt - i < 8 ? ncnt - i : 8;
+        rustsecp256k1zkp_v0_5_0_pedersen_commitment_load_all(add, &ncommits[i], n, vec);
+        for (j = 0; j < n; j++) {
+            rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&accj, &accj, &add[j], NULL);
+        }
     }
     rustsecp256k1zkp_v0_5_0_gej_neg(&accj, &accj);
-    for (i = 0; i < pcnt; i++) {
-        rustsecp256k1zkp_v0_5_0_pedersen_commitment_load(&add, commits[i]);
-        rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&accj, &accj, &add, NULL);
+    for (i = 0; i < pcnt; i += n) {
+        n = pcnt - i < 8 ? pcnt - i : 8;
+        rustsecp256k1zkp_v0_5_0_pedersen_commitment_load_all(add, &commits[i], n, vec);
+        for (j = 0; j < n; j++) {
+            rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&accj, &accj, &add[j], NULL);
+        }
     }
     return rustsecp256k1zkp_v0_5_0_gej_is_infinity(&accj);
 }
@@ -257,6 +282,109 @@ int rustsecp256k1zkp_v0_5_0_rangeproof_rewind(const rustsecp256k1zkp_v0_5_0_cont
      blind_out, value_out, message_out, outlen, nonce, min_value, max_value, &commitp, proof, plen, extra_commit, extra_commit_len, &genp);
 }
 
+int rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_only(const rustsecp256k1zkp_v0_5_0_context* ctx,
+ unsigned char *blind_out, uint64_t *value_out, const unsigned char *nonce,
+ uint64_t *min_value, uint64_t *max_value,
+ const rustsecp256k1zkp_v0_5_0_pedersen_commitment *commit, const unsigned char *proof, size_t plen, const unsigned char *extra_commit, size_t extra_commit_len, const rustsecp256k1zkp_v0_5_0_generator* gen) {
+    rustsecp256k1zkp_v0_5_0_ge commitp;
+    rustsecp256k1zkp_v0_5_0_ge genp;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(commit != NULL);
+    ARG_CHECK(proof != NULL);
+    ARG_CHECK(min_value != NULL);
+    ARG_CHECK(max_value != NULL);
+    ARG_CHECK(nonce != NULL);
+    ARG_CHECK(extra_commit != NULL || extra_commit_len == 0);
+    ARG_CHECK(gen != NULL);
+    ARG_CHECK(rustsecp256k1zkp_v0_5_0_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(rustsecp256k1zkp_v0_5_0_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+    rustsecp256k1zkp_v0_5_0_pedersen_commitment_load(&commitp, commit);
+    rustsecp256k1zkp_v0_5_0_generator_load(&genp, gen);
+    return rustsecp256k1zkp_v0_5_0_rangeproof_verify_impl(&ctx->ecmult_ctx, &ctx->ecmult_gen_ctx,
+     blind_out, value_out, NULL, NULL, nonce, min_value, max_value, &commitp, proof, plen, extra_commit, extra_commit_len, &genp);
+}
+
+/* Number of shared points converted to affine coordinates with each field inversion. */
+#define RANGEPROOF_ECDH_NONCE_BATCH 32
+
+int rustsecp256k1zkp_v0_5_0_rangeproof_ecdh_nonces(const rustsecp256k1zkp_v0_5_0_context* ctx, unsigned char *nonces,
+ const unsigned char *scan_key, const rustsecp256k1zkp_v0_5_0_pubkey *pubkeys, size_t n_pubkeys) {
+    rustsecp256k1zkp_v0_5_0_gej shared[RANGEPROOF_ECDH_NONCE_BATCH];
+    rustsecp256k1zkp_v0_5_0_ge shared_ge[RANGEPROOF_ECDH_NONCE_BATCH];
+    rustsecp256k1zkp_v0_5_0_ge pt;
+    rustsecp256k1zkp_v0_5_0_scalar s;
+    rustsecp256k1zkp_v0_5_0_sha256 sha;
+    unsigned char buf[33];
+    size_t i;
+    size_t j;
+    size_t n;
+    int overflow;
+    int ret = 1;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(nonces != NULL);
+    ARG_CHECK(scan_key != NULL);
+    ARG_CHECK(pubkeys != NULL || n_pubkeys == 0);
+
+    rustsecp256k1zkp_v0_5_0_scalar_set_b32(&s, scan_key, &overflow);
+    if (overflow || rustsecp256k1zkp_v0_5_0_scalar_is_zero(&s)) {
+        rustsecp256k1zkp_v0_5_0_scalar_clear(&s);
+        memset(nonces, 0, 32 * n_pubkeys);
+        return 0;
+    }
+    for (i = 0; i < n_pubkeys; i += n) {
+        n = n_pubkeys - i;
+        if (n > RANGEPROOF_ECDH_NONCE_BATCH) {
+            n = RANGEPROOF_ECDH_NONCE_BATCH;
+        }
+        for (j = 0; j < n; j++) {
+            if (!rustsecp256k1zkp_v0_5_0_pubkey_load(ctx, &pt, &pubkeys[i + j])) {
+                ret = 0;
+                break;
+            }
+            rustsecp256k1zkp_v0_5_0_ecmult_const(&shared[j], &pt, &s, 256);
+        }
+        if (!ret) {
+            break;
+        }
+        rustsecp256k1zkp_v0_5_0_ge_set_all_gej(shared_ge, shared, n);
+        for (j = 0; j < n; j++) {
+            /* SHA256 of the default ECDH hash of the shared point. */
+            rustsecp256k1zkp_v0_5_0_fe_normalize(&shared_ge[j].x);
+            rustsecp256k1zkp_v0_5_0_fe_normalize(&shared_ge[j].y);
+            buf[0] = 0x02 | rustsecp256k1zkp_v0_5_0_fe_is_odd(&shared_ge[j].y);
+            rustsecp256k1zkp_v0_5_0_fe_get_b32(&buf[1], &shared_ge[j].x);
+            rustsecp256k1zkp_v0_5_0_sha256_initialize(&sha);
+            rustsecp256k1zkp_v0_5_0_sha256_write(&sha, buf, 33);
+            rustsecp256k1zkp_v0_5_0_sha256_finalize(&sha, &nonces[(i + j) * 32]);
+            rustsecp256k1zkp_v0_5_0_sha256_initialize(&sha);
+            rustsecp256k1zkp_v0_5_0_sha256_write(&sha, &nonces[(i + j) * 32], 32);
+            rustsecp256k1zkp_v0_5_0_sha256_finalize(&sha, &nonces[(i + j) * 32]);
+        }
+    }
+    if (!ret) {
+        memset(nonces, 0, 32 * n_pubkeys);
+    }
+    memset(buf, 0, sizeof(buf));
+    memset(shared, 0, sizeof(shared));
+    memset(shared_ge, 0, sizeof(shared_ge));
+    rustsecp256k1zkp_v0_5_0_scalar_clear(&s);
+    return ret;
+}
+
+int rustsecp256k1zkp_v0_5_0_rangeproof_rewind_precheck(const rustsecp256k1zkp_v0_5_0_context* ctx, const unsigned char *nonce,
+ const rustsecp256k1zkp_v0_5_0_pedersen_commitment *commit, const unsigned char *proof, size_t plen, const rustsecp256k1zkp_v0_5_0_generator* gen) {
+    rustsecp256k1zkp_v0_5_0_ge commitp;
+    rustsecp256k1zkp_v0_5_0_ge genp;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(nonce != NULL);
+    ARG_CHECK(commit != NULL);
+    ARG_CHECK(proof != NULL);
+    ARG_CHECK(gen != NULL);
+    rustsecp256k1zkp_v0_5_0_pedersen_commitment_load(&commitp, commit);
+    rustsecp256k1zkp_v0_5_0_generator_load(&genp, gen);
+    return rustsecp256k1zkp_v0_5_0_rangeproof_rewind_precheck_impl(nonce, &commitp, proof, plen, &genp);
+}
+
 int rustsecp256k1zkp_v0_5_0_rangeproof_verify(const rustsecp256k1zkp_v0_5_0_context* ctx, uint64_t *min_value, uint64_t *max_value,
  const rustsecp256k1zkp_v0_5_0_pedersen_commitment *commit, const unsigned char *proof, size_t plen, const unsigned char *extra_commit, size_t extra_commit_len, const rustsecp256k1zkp_v0_5_0_generator* gen) {
     rustsecp256k1zkp_v0_5_0_ge commitp;
@@ -13,10 +13,14 @@
 
 #include <stdint.h>
 
-/** Multiply a small number with the generator: r = gn*G2 */
-static void rustsecp256k1zkp_v0_5_0_pedersen_ecmult_small(rustsecp256k1zkp_v0_5_0_gej *r, uint64_t gn, const rustsecp256k1zkp_v0_5_0_ge* genp);
+/** The bit length of value, at least 1. Runs in variable time, so value must be public. */
+static int rustsecp256k1zkp_v0_5_0_pedersen_value_bits_var(uint64_t value);
 
-/* sec * G + value * G2. */
-static void rustsecp256k1zkp_v0_5_0_pedersen_ecmult(const rustsecp256k1zkp_v0_5_0_ecmult_gen_context *ecmult_gen_ctx, rustsecp256k1zkp_v0_5_0_gej *rj, const rustsecp256k1zkp_v0_5_0_scalar *sec, uint64_t value, const rustsecp256k1zkp_v0_5_0_ge* genp);
+/** Multiply a small number with the generator: r = gn*G2. gn must be below
+ *  2^bits, where bits is public and between 1 and 64. Takes bits + 1 doublings. */
+static void rustsecp256k1zkp_v0_5_0_pedersen_ecmult_small(rustsecp256k1zkp_v0_5_0_gej *r, uint64_t gn, int bits, const rustsecp256k1zkp_v0_5_0_ge* genp);
+
+/* sec * G + value * G2, where value is below 2^bits. */
+static void rustsecp256k1zkp_v0_5_0_pedersen_ecmult(const rustsecp256k1zkp_v0_5_0_ecmult_gen_context *ecmult_gen_ctx, rustsecp256k1zkp_v0_5_0_gej *rj, const rustsecp256k1zkp_v0_5_0_scalar *sec, uint64_t value, int bits, const rustsecp256k1zkp_v0_5_0_ge* genp);
 
 #endif
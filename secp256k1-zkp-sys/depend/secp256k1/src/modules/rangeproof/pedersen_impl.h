@@ -31,18 +31,31 @@ static void rustsecp256k1zkp_v0_5_0_pedersen_scalar_set_u64(rustsecp256k1zkp_v0_
     memset(data, 0, 32);
 }
 
-static void rustsecp256k1zkp_v0_5_0_pedersen_ecmult_small(rustsecp256k1zkp_v0_5_0_gej *r, uint64_t gn, const rustsecp256k1zkp_v0_5_0_ge* genp) {
+static int rustsecp256k1zkp_v0_5_0_pedersen_value_bits_var(uint64_t value) {
+    int bits = 1;
+    while (bits < 64 && (value >> bits) != 0) {
+        bits++;
+    }
+    return bits;
+}
+
+static void rustsecp256k1zkp_v0_5_0_pedersen_ecmult_small(rustsecp256k1zkp_v0_5_0_gej *r, uint64_t gn, int bits, const rustsecp256k1zkp_v0_5_0_ge* genp) {
     rustsecp256k1zkp_v0_5_0_scalar s;
+    VERIFY_CHECK(bits >= 1 && bits <= 64);
+    VERIFY_CHECK(bits == 64 || (gn >> bits) == 0);
     rustsecp256k1zkp_v0_5_0_pedersen_scalar_set_u64(&s, gn);
-    rustsecp256k1zkp_v0_5_0_ecmult_const(r, genp, &s, 64);
+    /* ecmult_const wants one bit more than the value has, and does not split
+     * scalars of up to 128 bits with the endomorphism, so this takes bits + 1
+     * doublings. */
+    rustsecp256k1zkp_v0_5_0_ecmult_const(r, genp, &s, bits + 1);
     rustsecp256k1zkp_v0_5_0_scalar_clear(&s);
 }
 
-/* sec * G + value * G2. */
-SECP256K1_INLINE static void rustsecp256k1zkp_v0_5_0_pedersen_ecmult(const rustsecp256k1zkp_v0_5_0_ecmult_gen_context *ecmult_gen_ctx, rustsecp256k1zkp_v0_5_0_gej *rj, const rustsecp256k1zkp_v0_5_0_scalar *sec, uint64_t value, const rustsecp256k1zkp_v0_5_0_ge* genp) {
+/* sec * G + value * G2, where value is below 2^bits. */
+SECP256K1_INLINE static void rustsecp256k1zkp_v0_5_0_pedersen_ecmult(const rustsecp256k1zkp_v0_5_0_ecmult_gen_context *ecmult_gen_ctx, rustsecp256k1zkp_v0_5_0_gej *rj, const rustsecp256k1zkp_v0_5_0_scalar *sec, uint64_t value, int bits, const rustsecp256k1zkp_v0_5_0_ge* genp) {
     rustsecp256k1zkp_v0_5_0_gej vj;
     rustsecp256k1zkp_v0_5_0_ecmult_gen(ecmult_gen_ctx, rj, sec);
-    rustsecp256k1zkp_v0_5_0_pedersen_ecmult_small(&vj, value, genp);
+    rustsecp256k1zkp_v0_5_0_pedersen_ecmult_small(&vj, value, bits, genp);
     /* FIXME: constant time. */
     rustsecp256k1zkp_v0_5_0_gej_add_var(rj, rj, &vj, NULL);
     rustsecp256k1zkp_v0_5_0_gej_clear(&vj);
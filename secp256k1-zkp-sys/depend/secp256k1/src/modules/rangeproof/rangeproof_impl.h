@@ -296,8 +296,14 @@ SECP256K1_INLINE static int rustsecp256k1zkp_v0_5_0_rangeproof_sign_impl(const r
     }
     npub = 0;
     for (i = 0; i < rings; i++) {
+        /* The digit is secret, but the number of bits of its largest value is
+         * not, and bounds the doublings of the multiplication. */
+        int bits = rustsecp256k1zkp_v0_5_0_pedersen_value_bits_var((uint64_t)(rsizes[i] - 1) * scale) + i * 2;
+        if (bits > 64) {
+            bits = 64;
+        }
         /*OPT: Use the precomputed gen2 basis?*/
-        rustsecp256k1zkp_v0_5_0_pedersen_ecmult(ecmult_gen_ctx, &pubs[npub], &sec[i], ((uint64_t)secidx[i] * scale) << (i*2), genp);
+        rustsecp256k1zkp_v0_5_0_pedersen_ecmult(ecmult_gen_ctx, &pubs[npub], &sec[i], ((uint64_t)secidx[i] * scale) << (i*2), bits, genp);
         if (rustsecp256k1zkp_v0_5_0_gej_is_infinity(&pubs[npub])) {
             return 0;
         }
@@ -484,6 +490,132 @@ SECP256K1_INLINE static int rustsecp256k1zkp_v0_5_0_rangeproof_rewind_inner(rust
     return 1;
 }
 
+/* Like rangeproof_genrand with no message, but only keeps the secret of the last ring and the random
+ * bytes of its members (the keystream the prover XORs into their s values). Everything else the
+ * generator produces is discarded, which is all that rewinding the value and blinding factor needs. */
+SECP256K1_INLINE static void rustsecp256k1zkp_v0_5_0_rangeproof_genrand_last_ring(rustsecp256k1zkp_v0_5_0_scalar *sec, unsigned char *stream,
+ const size_t *rsizes, size_t rings, const unsigned char *nonce, const rustsecp256k1zkp_v0_5_0_ge *commit, const unsigned char *proof, size_t len, const rustsecp256k1zkp_v0_5_0_ge* genp) {
+    unsigned char tmp[32];
+    unsigned char rngseed[32 + 33 + 33 + 10];
+    rustsecp256k1zkp_v0_5_0_rfc6979_hmac_sha256 rng;
+    rustsecp256k1zkp_v0_5_0_scalar acc;
+    int overflow;
+    size_t i;
+    size_t j;
+    VERIFY_CHECK(len <= 10);
+    memcpy(rngseed, nonce, 32);
+    rustsecp256k1zkp_v0_5_0_rangeproof_serialize_point(rngseed + 32, commit);
+    rustsecp256k1zkp_v0_5_0_rangeproof_serialize_point(rngseed + 32 + 33, genp);
+    memcpy(rngseed + 33 + 33 + 32, proof, len);
+    rustsecp256k1zkp_v0_5_0_rfc6979_hmac_sha256_initialize(&rng, rngseed, 32 + 33 + 33 + len);
+    rustsecp256k1zkp_v0_5_0_scalar_clear(&acc);
+    for (i = 0; i < rings - 1; i++) {
+        rustsecp256k1zkp_v0_5_0_rfc6979_hmac_sha256_generate(&rng, tmp, 32);
+        do {
+            rustsecp256k1zkp_v0_5_0_rfc6979_hmac_sha256_generate(&rng, tmp, 32);
+            rustsecp256k1zkp_v0_5_0_scalar_set_b32(sec, tmp, &overflow);
+        } while (overflow || rustsecp256k1zkp_v0_5_0_scalar_is_zero(sec));
+        rustsecp256k1zkp_v0_5_0_scalar_add(&acc, &acc, sec);
+        for (j = 0; j < rsizes[i]; j++) {
+            rustsecp256k1zkp_v0_5_0_rfc6979_hmac_sha256_generate(&rng, tmp, 32);
+        }
+    }
+    rustsecp256k1zkp_v0_5_0_scalar_negate(sec, &acc);
+    for (j = 0; j < rsizes[rings - 1]; j++) {
+        rustsecp256k1zkp_v0_5_0_rfc6979_hmac_sha256_generate(&rng, &stream[j * 32], 32);
+    }
+    rustsecp256k1zkp_v0_5_0_rfc6979_hmac_sha256_finalize(&rng);
+    rustsecp256k1zkp_v0_5_0_scalar_clear(&acc);
+    memset(tmp, 0, 32);
+}
+
+/* Looks for the value the prover encoded into one of the last two members of the last ring, given the
+ * serialized s values of that ring and the keystream they were XORed with. On success *skip2 is the
+ * position of the ring member that was actually signed for. */
+SECP256K1_INLINE static int rustsecp256k1zkp_v0_5_0_rangeproof_decode_value(uint64_t *v, size_t *skip2, const unsigned char *s_last,
+ const unsigned char *stream, size_t rsize, size_t rings) {
+    unsigned char tmp[32];
+    uint64_t value;
+    size_t i;
+    size_t j;
+    size_t skip1;
+    VERIFY_CHECK(rsize >= 2 && rsize <= 4);
+    value = 0;
+    for (j = 0; j < 2; j++) {
+        size_t idx;
+        idx = rsize - 1 - j;
+        memcpy(tmp, &s_last[idx * 32], 32);
+        rustsecp256k1zkp_v0_5_0_rangeproof_ch32xor(tmp, &stream[idx * 32]);
+        if ((tmp[0] & 128) && (memcmp(&tmp[16], &tmp[24], 8) == 0) && (memcmp(&tmp[8], &tmp[16], 8) == 0)) {
+            for (i = 0; i < 8; i++) {
+                value = (value << 8) + tmp[24 + i];
+            }
+            break;
+        }
+    }
+    memset(tmp, 0, 32);
+    if (j > 1) {
+        /* Couldn't extract a value. */
+        return 0;
+    }
+    skip1 = rsize - 1 - j;
+    *skip2 = ((value >> ((rings - 1) << 1)) & 3);
+    if (skip1 == *skip2) {
+        /*Value is in wrong position.*/
+        return 0;
+    }
+    *v = value;
+    return 1;
+}
+
+/* Recovers only the value and blinding factor, like rangeproof_rewind_inner when no message is requested.
+ * Only the last ring is regenerated and nothing is written for the other ring members. */
+SECP256K1_INLINE static int rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_inner(rustsecp256k1zkp_v0_5_0_scalar *blind, uint64_t *v,
+ const rustsecp256k1zkp_v0_5_0_scalar *ev, const rustsecp256k1zkp_v0_5_0_scalar *s,
+ const size_t *rsizes, size_t rings, const unsigned char *nonce, const rustsecp256k1zkp_v0_5_0_ge *commit, const unsigned char *proof, size_t len, const rustsecp256k1zkp_v0_5_0_ge *genp) {
+    rustsecp256k1zkp_v0_5_0_scalar sec;
+    rustsecp256k1zkp_v0_5_0_scalar s_orig;
+    rustsecp256k1zkp_v0_5_0_scalar stmp;
+    unsigned char stream[4 * 32];
+    unsigned char s_last[4 * 32];
+    size_t j;
+    size_t skip2;
+    size_t npub;
+    VERIFY_CHECK(rings >= 1 && rings <= 32);
+    VERIFY_CHECK(rsizes[rings - 1] >= 1 && rsizes[rings - 1] <= 4);
+    rustsecp256k1zkp_v0_5_0_rangeproof_genrand_last_ring(&sec, stream, rsizes, rings, nonce, commit, proof, len, genp);
+    *v = UINT64_MAX;
+    rustsecp256k1zkp_v0_5_0_scalar_clear(blind);
+    if (rings == 1 && rsizes[0] == 1) {
+        /* With only a single proof, we can only recover the blinding factor. */
+        rustsecp256k1zkp_v0_5_0_scalar_set_b32(&s_orig, stream, NULL);
+        rustsecp256k1zkp_v0_5_0_rangeproof_recover_x(blind, &s_orig, &ev[0], &s[0]);
+        *v = 0;
+        memset(stream, 0, sizeof(stream));
+        rustsecp256k1zkp_v0_5_0_scalar_clear(&s_orig);
+        return 1;
+    }
+    npub = (rings - 1) << 2;
+    for (j = 0; j < rsizes[rings - 1]; j++) {
+        rustsecp256k1zkp_v0_5_0_scalar_get_b32(&s_last[j * 32], &s[npub + j]);
+    }
+    if (!rustsecp256k1zkp_v0_5_0_rangeproof_decode_value(v, &skip2, s_last, stream, rsizes[rings - 1], rings)) {
+        memset(stream, 0, sizeof(stream));
+        rustsecp256k1zkp_v0_5_0_scalar_clear(&sec);
+        return 0;
+    }
+    /* Having figured out which s is the one which was not forged, recover the blinding factor. */
+    rustsecp256k1zkp_v0_5_0_scalar_set_b32(&s_orig, &stream[skip2 * 32], NULL);
+    rustsecp256k1zkp_v0_5_0_rangeproof_recover_x(&stmp, &s_orig, &ev[npub + skip2], &s[npub + skip2]);
+    rustsecp256k1zkp_v0_5_0_scalar_negate(&sec, &sec);
+    rustsecp256k1zkp_v0_5_0_scalar_add(blind, &stmp, &sec);
+    memset(stream, 0, sizeof(stream));
+    rustsecp256k1zkp_v0_5_0_scalar_clear(&sec);
+    rustsecp256k1zkp_v0_5_0_scalar_clear(&s_orig);
+    rustsecp256k1zkp_v0_5_0_scalar_clear(&stmp);
+    return 1;
+}
+
 SECP256K1_INLINE static int rustsecp256k1zkp_v0_5_0_rangeproof_getheader_impl(size_t *offset, int *exp, int *mantissa, uint64_t *scale,
  uint64_t *min_value, uint64_t *max_value, const unsigned char *proof, size_t plen) {
     int i;
@@ -537,6 +669,65 @@ SECP256K1_INLINE static int rustsecp256k1zkp_v0_5_0_rangeproof_getheader_impl(si
     return 1;
 }
 
+/* Computes the ring structure of a proof from the mantissa in its header. */
+SECP256K1_INLINE static void rustsecp256k1zkp_v0_5_0_rangeproof_rings(size_t *rings, size_t *rsizes, size_t *npub, int mantissa) {
+    size_t i;
+    *rings = 1;
+    rsizes[0] = 1;
+    *npub = 1;
+    if (mantissa != 0) {
+        *rings = (mantissa >> 1);
+        for (i = 0; i < *rings; i++) {
+            rsizes[i] = 4;
+        }
+        *npub = (mantissa >> 1) << 2;
+        if (mantissa & 1) {
+            rsizes[*rings] = 2;
+            *npub += rsizes[*rings];
+            (*rings)++;
+        }
+    }
+    VERIFY_CHECK(*rings <= 32);
+}
+
+/* Returns 0 if the proof certainly does not rewind with nonce, by looking for the value encoding in the
+ * last ring before any of the proof's points are decompressed. Proofs without a value encoding pass. */
+SECP256K1_INLINE static int rustsecp256k1zkp_v0_5_0_rangeproof_rewind_precheck_impl(const unsigned char *nonce,
+ const rustsecp256k1zkp_v0_5_0_ge *commit, const unsigned char *proof, size_t plen, const rustsecp256k1zkp_v0_5_0_ge* genp) {
+    rustsecp256k1zkp_v0_5_0_scalar sec;
+    unsigned char stream[4 * 32];
+    size_t rsizes[32];
+    size_t rings;
+    size_t npub;
+    size_t offset;
+    size_t offset_post_header;
+    size_t skip2;
+    int exp;
+    int mantissa;
+    int ret;
+    uint64_t scale;
+    uint64_t min_value;
+    uint64_t max_value;
+    uint64_t v;
+    offset = 0;
+    if (!rustsecp256k1zkp_v0_5_0_rangeproof_getheader_impl(&offset, &exp, &mantissa, &scale, &min_value, &max_value, proof, plen)) {
+        return 0;
+    }
+    offset_post_header = offset;
+    rustsecp256k1zkp_v0_5_0_rangeproof_rings(&rings, rsizes, &npub, mantissa);
+    if (plen - offset != 32 * (npub + rings - 1) + 32 + ((rings+6) >> 3)) {
+        return 0;
+    }
+    if (rings == 1 && rsizes[0] == 1) {
+        return 1;
+    }
+    rustsecp256k1zkp_v0_5_0_rangeproof_genrand_last_ring(&sec, stream, rsizes, rings, nonce, commit, proof, offset_post_header, genp);
+    ret = rustsecp256k1zkp_v0_5_0_rangeproof_decode_value(&v, &skip2, &proof[plen - 32 * rsizes[rings - 1]], stream, rsizes[rings - 1], rings);
+    memset(stream, 0, sizeof(stream));
+    rustsecp256k1zkp_v0_5_0_scalar_clear(&sec);
+    return ret;
+}
+
 /* Verifies range proof (len plen) for commit, the min/max values proven are put in the min/max arguments; returns 0 on failure 1 on success.*/
 SECP256K1_INLINE static int rustsecp256k1zkp_v0_5_0_rangeproof_verify_impl(const rustsecp256k1zkp_v0_5_0_ecmult_context* ecmult_ctx,
  const rustsecp256k1zkp_v0_5_0_ecmult_gen_context* ecmult_gen_ctx,
@@ -544,7 +735,8 @@ SECP256K1_INLINE static int rustsecp256k1zkp_v0_5_0_rangeproof_verify_impl(const
  uint64_t *min_value, uint64_t *max_value, const rustsecp256k1zkp_v0_5_0_ge *commit, const unsigned char *proof, size_t plen, const unsigned char *extra_commit, size_t extra_commit_len, const rustsecp256k1zkp_v0_5_0_ge* genp) {
     rustsecp256k1zkp_v0_5_0_gej accj;
     rustsecp256k1zkp_v0_5_0_gej pubs[128];
-    rustsecp256k1zkp_v0_5_0_ge c;
+    rustsecp256k1zkp_v0_5_0_ge c[31];
+    rustsecp256k1zkp_v0_5_0_fe cx[31];
     rustsecp256k1zkp_v0_5_0_scalar s[128];
     rustsecp256k1zkp_v0_5_0_scalar evalues[128]; /* Challenges, only used during proof rewind. */
     rustsecp256k1zkp_v0_5_0_sha256 sha256_m;
@@ -567,22 +759,7 @@ SECP256K1_INLINE static int rustsecp256k1zkp_v0_5_0_rangeproof_verify_impl(const
         return 0;
     }
     offset_post_header = offset;
-    rings = 1;
-    rsizes[0] = 1;
-    npub = 1;
-    if (mantissa != 0) {
-        rings = (mantissa >> 1);
-        for (i = 0; i < rings; i++) {
-            rsizes[i] = 4;
-        }
-        npub = (mantissa >> 1) << 2;
-        if (mantissa & 1) {
-            rsizes[rings] = 2;
-            npub += rsizes[rings];
-            rings++;
-        }
-    }
-    VERIFY_CHECK(rings <= 32);
+    rustsecp256k1zkp_v0_5_0_rangeproof_rings(&rings, rsizes, &npub, mantissa);
     if (plen - offset < 32 * (npub + rings - 1) + 32 + ((rings+6) >> 3)) {
         return 0;
     }
@@ -605,23 +782,30 @@ SECP256K1_INLINE static int rustsecp256k1zkp_v0_5_0_rangeproof_verify_impl(const
     npub = 0;
     rustsecp256k1zkp_v0_5_0_gej_set_infinity(&accj);
     if (*min_value) {
-        rustsecp256k1zkp_v0_5_0_pedersen_ecmult_small(&accj, *min_value, genp);
+        rustsecp256k1zkp_v0_5_0_pedersen_ecmult_small(&accj, *min_value, rustsecp256k1zkp_v0_5_0_pedersen_value_bits_var(*min_value), genp);
     }
+    /* Decompress the digit commitments together, which lets their square roots
+     * be computed in parallel. With a single ring none is set, which compilers
+     * warn about when the array is passed on, so clear the first one. */
+    rustsecp256k1zkp_v0_5_0_fe_clear(&cx[0]);
     for(i = 0; i < rings - 1; i++) {
-        rustsecp256k1zkp_v0_5_0_fe fe;
-        if (!rustsecp256k1zkp_v0_5_0_fe_set_b32(&fe, &proof[offset]) ||
-            !rustsecp256k1zkp_v0_5_0_ge_set_xquad(&c, &fe)) {
+        if (!rustsecp256k1zkp_v0_5_0_fe_set_b32(&cx[i], &proof[offset + 32 * i])) {
             return 0;
         }
+    }
+    if (!rustsecp256k1zkp_v0_5_0_ge_set_xquad_all(c, cx, rings - 1, rings > 8 && rustsecp256k1zkp_v0_5_0_fe_vec_available())) {
+        return 0;
+    }
+    for(i = 0; i < rings - 1; i++) {
         if (signs[i]) {
-            rustsecp256k1zkp_v0_5_0_ge_neg(&c, &c);
+            rustsecp256k1zkp_v0_5_0_ge_neg(&c[i], &c[i]);
         }
         /* Not using rustsecp256k1zkp_v0_5_0_rangeproof_serialize_point as we almost have it
          * serialized form already. */
         rustsecp256k1zkp_v0_5_0_sha256_write(&sha256_m, &signs[i], 1);
         rustsecp256k1zkp_v0_5_0_sha256_write(&sha256_m, &proof[offset], 32);
-        rustsecp256k1zkp_v0_5_0_gej_set_ge(&pubs[npub], &c);
-        rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&accj, &accj, &c, NULL);
+        rustsecp256k1zkp_v0_5_0_gej_set_ge(&pubs[npub], &c[i]);
+        rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&accj, &accj, &c[i], NULL);
         offset += 32;
         npub += rsizes[i];
     }
@@ -657,13 +841,23 @@ SECP256K1_INLINE static int rustsecp256k1zkp_v0_5_0_rangeproof_verify_impl(const
         if (!ecmult_gen_ctx) {
             return 0;
         }
-        if (!rustsecp256k1zkp_v0_5_0_rangeproof_rewind_inner(&blind, &vv, message_out, outlen, evalues, s, rsizes, rings, nonce, commit, proof, offset_post_header, genp)) {
-            return 0;
+        if (message_out != NULL && outlen != NULL && *outlen != 0) {
+            if (!rustsecp256k1zkp_v0_5_0_rangeproof_rewind_inner(&blind, &vv, message_out, outlen, evalues, s, rsizes, rings, nonce, commit, proof, offset_post_header, genp)) {
+                return 0;
+            }
+        } else {
+            /* Without a message to recover, only the last ring has to be regenerated. */
+            if (outlen != NULL) {
+                *outlen = 0;
+            }
+            if (!rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_inner(&blind, &vv, evalues, s, rsizes, rings, nonce, commit, proof, offset_post_header, genp)) {
+                return 0;
+            }
         }
         /* Unwind apparently successful, see if the commitment can be reconstructed. */
         /* FIXME: should check vv is in the mantissa's range. */
         vv = (vv * scale) + *min_value;
-        rustsecp256k1zkp_v0_5_0_pedersen_ecmult(ecmult_gen_ctx, &accj, &blind, vv, genp);
+        rustsecp256k1zkp_v0_5_0_pedersen_ecmult(ecmult_gen_ctx, &accj, &blind, vv, 64, genp);
         if (rustsecp256k1zkp_v0_5_0_gej_is_infinity(&accj)) {
             return 0;
         }
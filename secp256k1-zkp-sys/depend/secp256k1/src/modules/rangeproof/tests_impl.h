@@ -226,6 +226,45 @@ static void test_rangeproof_api(const rustsecp256k1zkp_v0_5_0_context *none, con
         CHECK(*ecount == 34);
         CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind(both, blind_out, &value_out, NULL, 0, commit.data, &min_value, &max_value, &commit, proof, len, NULL, 0, NULL) == 0);
         CHECK(*ecount == 35);
+
+        memset(blind_out, 0, sizeof(blind_out));
+        value_out = 0;
+        CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_only(vrfy, blind_out, &value_out, commit.data, &min_value, &max_value, &commit, proof, len, ext_commit, ext_commit_len, rustsecp256k1zkp_v0_5_0_generator_h) == 0);
+        CHECK(*ecount == 36);
+        CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_only(both, blind_out, &value_out, commit.data, &min_value, &max_value, &commit, proof, len, ext_commit, ext_commit_len, rustsecp256k1zkp_v0_5_0_generator_h) != 0);
+        CHECK(*ecount == 36);
+        CHECK(min_value == vmin);
+        CHECK(max_value >= val);
+        CHECK(value_out == val);
+        CHECK(memcmp(blind_out, blind, 32) == 0);
+        CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_only(both, NULL, NULL, commit.data, &min_value, &max_value, &commit, proof, len, ext_commit, ext_commit_len, rustsecp256k1zkp_v0_5_0_generator_h) != 0);
+        CHECK(*ecount == 36);
+        CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_only(both, blind_out, &value_out, NULL, &min_value, &max_value, &commit, proof, len, ext_commit, ext_commit_len, rustsecp256k1zkp_v0_5_0_generator_h) == 0);
+        CHECK(*ecount == 37);
+        CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_only(both, blind_out, &value_out, commit.data, NULL, &max_value, &commit, proof, len, ext_commit, ext_commit_len, rustsecp256k1zkp_v0_5_0_generator_h) == 0);
+        CHECK(*ecount == 38);
+        CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_only(both, blind_out, &value_out, commit.data, &min_value, NULL, &commit, proof, len, ext_commit, ext_commit_len, rustsecp256k1zkp_v0_5_0_generator_h) == 0);
+        CHECK(*ecount == 39);
+        CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_only(both, blind_out, &value_out, commit.data, &min_value, &max_value, NULL, proof, len, ext_commit, ext_commit_len, rustsecp256k1zkp_v0_5_0_generator_h) == 0);
+        CHECK(*ecount == 40);
+        CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_only(both, blind_out, &value_out, commit.data, &min_value, &max_value, &commit, NULL, len, ext_commit, ext_commit_len, rustsecp256k1zkp_v0_5_0_generator_h) == 0);
+        CHECK(*ecount == 41);
+        CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_only(both, blind_out, &value_out, commit.data, &min_value, &max_value, &commit, proof, len, NULL, ext_commit_len, rustsecp256k1zkp_v0_5_0_generator_h) == 0);
+        CHECK(*ecount == 42);
+        CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_only(both, blind_out, &value_out, commit.data, &min_value, &max_value, &commit, proof, len, NULL, 0, rustsecp256k1zkp_v0_5_0_generator_h) == 0);
+        CHECK(*ecount == 42);
+        CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_only(both, blind_out, &value_out, commit.data, &min_value, &max_value, &commit, proof, len, ext_commit, ext_commit_len, NULL) == 0);
+        CHECK(*ecount == 43);
+
+        CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_precheck(none, commit.data, &commit, proof, len, rustsecp256k1zkp_v0_5_0_generator_h) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_precheck(none, NULL, &commit, proof, len, rustsecp256k1zkp_v0_5_0_generator_h) == 0);
+        CHECK(*ecount == 44);
+        CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_precheck(none, commit.data, NULL, proof, len, rustsecp256k1zkp_v0_5_0_generator_h) == 0);
+        CHECK(*ecount == 45);
+        CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_precheck(none, commit.data, &commit, NULL, len, rustsecp256k1zkp_v0_5_0_generator_h) == 0);
+        CHECK(*ecount == 46);
+        CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_precheck(none, commit.data, &commit, proof, len, NULL) == 0);
+        CHECK(*ecount == 47);
     }
 }
 
@@ -316,6 +355,36 @@ static void test_pedersen(void) {
     CHECK(rustsecp256k1zkp_v0_5_0_pedersen_verify_tally(ctx, &cptr[1], 1, &cptr[1], 1));
 }
 
+static void test_pedersen_ecmult_small(void) {
+    rustsecp256k1zkp_v0_5_0_ge genp, res;
+    rustsecp256k1zkp_v0_5_0_gej expected, r;
+    uint64_t value;
+    int bits, i;
+
+    CHECK(rustsecp256k1zkp_v0_5_0_pedersen_value_bits_var(0) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_pedersen_value_bits_var(1) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_pedersen_value_bits_var(2) == 2);
+    CHECK(rustsecp256k1zkp_v0_5_0_pedersen_value_bits_var(255) == 8);
+    CHECK(rustsecp256k1zkp_v0_5_0_pedersen_value_bits_var(256) == 9);
+    CHECK(rustsecp256k1zkp_v0_5_0_pedersen_value_bits_var(UINT64_MAX) == 64);
+
+    random_group_element_test(&genp);
+    for (bits = 1; bits <= 64; bits++) {
+        for (i = 0; i < 3; i++) {
+            /* The largest value of this many bits, and random ones */
+            value = UINT64_MAX >> (64 - bits);
+            if (i > 0) {
+                value &= ((uint64_t)rustsecp256k1zkp_v0_5_0_testrand32() << 32) | rustsecp256k1zkp_v0_5_0_testrand32();
+            }
+            CHECK(rustsecp256k1zkp_v0_5_0_pedersen_value_bits_var(value) <= bits);
+            rustsecp256k1zkp_v0_5_0_pedersen_ecmult_small(&expected, value, 64, &genp);
+            rustsecp256k1zkp_v0_5_0_pedersen_ecmult_small(&r, value, bits, &genp);
+            rustsecp256k1zkp_v0_5_0_ge_set_gej(&res, &r);
+            ge_equals_gej(&res, &expected);
+        }
+    }
+}
+
 static void test_borromean(void) {
     unsigned char e0[32];
     rustsecp256k1zkp_v0_5_0_scalar s[64];
@@ -442,9 +511,24 @@ static void test_rangeproof(void) {
             CHECK(vout == v);
             CHECK(minv <= v);
             CHECK(maxv >= v);
+            memset(blindout, 0, sizeof(blindout));
+            vout = 0;
+            CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_only(ctx, blindout, &vout, commit.data, &minv, &maxv, &commit, proof, len, NULL, 0, rustsecp256k1zkp_v0_5_0_generator_h));
+            CHECK(memcmp(blindout, blind, 32) == 0);
+            CHECK(vout == v);
+            CHECK(minv <= v);
+            CHECK(maxv >= v);
+            /* A different nonce does not rewind */
+            CHECK(!rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_only(ctx, blindout, &vout, blind, &minv, &maxv, &commit, proof, len, NULL, 0, rustsecp256k1zkp_v0_5_0_generator_h));
+            /* The precheck accepts the right nonce and rejects a different one */
+            CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_precheck(ctx, commit.data, &commit, proof, len, rustsecp256k1zkp_v0_5_0_generator_h));
+            CHECK(!rustsecp256k1zkp_v0_5_0_rangeproof_rewind_precheck(ctx, blind, &commit, proof, len, rustsecp256k1zkp_v0_5_0_generator_h));
+            CHECK(!rustsecp256k1zkp_v0_5_0_rangeproof_rewind_precheck(ctx, commit.data, &commit, proof, len - 1, rustsecp256k1zkp_v0_5_0_generator_h));
             len = 5134;
             CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_sign(ctx, proof, &len, v, &commit, blind, commit.data, -1, 64, v, NULL, 0, NULL, 0, rustsecp256k1zkp_v0_5_0_generator_h));
             CHECK(len <= 73);
+            /* Exact value proofs carry no value encoding, so the precheck cannot reject them */
+            CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind_precheck(ctx, blind, &commit, proof, len, rustsecp256k1zkp_v0_5_0_generator_h));
             CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_rewind(ctx, blindout, &vout, NULL, NULL, commit.data, &minv, &maxv, &commit, proof, len, NULL, 0, rustsecp256k1zkp_v0_5_0_generator_h));
             CHECK(memcmp(blindout, blind, 32) == 0);
             CHECK(vout == v);
@@ -691,6 +775,68 @@ void test_pedersen_commitment_fixed_vector(void) {
     CHECK(!rustsecp256k1zkp_v0_5_0_pedersen_commitment_parse(ctx, &parse, result));
 }
 
+static void test_rangeproof_ecdh_nonces(void) {
+    rustsecp256k1zkp_v0_5_0_pubkey pubkeys[40];
+    unsigned char seckey[32];
+    unsigned char scan_key[32];
+    unsigned char nonces[40 * 32];
+    unsigned char expected[32];
+    unsigned char ser[33];
+    size_t serlen;
+    rustsecp256k1zkp_v0_5_0_sha256 sha;
+    rustsecp256k1zkp_v0_5_0_pubkey shared;
+    size_t i;
+    int32_t ecount = 0;
+
+    rustsecp256k1zkp_v0_5_0_context_set_illegal_callback(ctx, counting_illegal_callback_fn, &ecount);
+    for (i = 0; i < 40; i++) {
+        random_scalar_order_b32(seckey);
+        CHECK(rustsecp256k1zkp_v0_5_0_ec_pubkey_create(ctx, &pubkeys[i], seckey));
+    }
+    random_scalar_order_b32(scan_key);
+    /* Covers more than one batch */
+    CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_ecdh_nonces(ctx, nonces, scan_key, pubkeys, 40));
+    for (i = 0; i < 40; i++) {
+        shared = pubkeys[i];
+        CHECK(rustsecp256k1zkp_v0_5_0_ec_pubkey_tweak_mul(ctx, &shared, scan_key));
+        serlen = sizeof(ser);
+        CHECK(rustsecp256k1zkp_v0_5_0_ec_pubkey_serialize(ctx, ser, &serlen, &shared, SECP256K1_EC_COMPRESSED));
+        rustsecp256k1zkp_v0_5_0_sha256_initialize(&sha);
+        rustsecp256k1zkp_v0_5_0_sha256_write(&sha, ser, serlen);
+        rustsecp256k1zkp_v0_5_0_sha256_finalize(&sha, expected);
+        rustsecp256k1zkp_v0_5_0_sha256_initialize(&sha);
+        rustsecp256k1zkp_v0_5_0_sha256_write(&sha, expected, 32);
+        rustsecp256k1zkp_v0_5_0_sha256_finalize(&sha, expected);
+        CHECK(memcmp(&nonces[i * 32], expected, 32) == 0);
+    }
+    CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_ecdh_nonces(ctx, nonces, scan_key, pubkeys, 0));
+    CHECK(rustsecp256k1zkp_v0_5_0_rangeproof_ecdh_nonces(ctx, nonces, scan_key, NULL, 0));
+    CHECK(ecount == 0);
+
+    /* An invalid scan key or public key zeroes the output */
+    memset(scan_key, 0, 32);
+    CHECK(!rustsecp256k1zkp_v0_5_0_rangeproof_ecdh_nonces(ctx, nonces, scan_key, pubkeys, 40));
+    memset(expected, 0, 32);
+    for (i = 0; i < 40; i++) {
+        CHECK(memcmp(&nonces[i * 32], expected, 32) == 0);
+    }
+    random_scalar_order_b32(scan_key);
+    memset(&pubkeys[35], 0, sizeof(pubkeys[35]));
+    CHECK(!rustsecp256k1zkp_v0_5_0_rangeproof_ecdh_nonces(ctx, nonces, scan_key, pubkeys, 40));
+    CHECK(ecount == 1);
+    for (i = 0; i < 40; i++) {
+        CHECK(memcmp(&nonces[i * 32], expected, 32) == 0);
+    }
+
+    CHECK(!rustsecp256k1zkp_v0_5_0_rangeproof_ecdh_nonces(ctx, NULL, scan_key, pubkeys, 1));
+    CHECK(ecount == 2);
+    CHECK(!rustsecp256k1zkp_v0_5_0_rangeproof_ecdh_nonces(ctx, nonces, NULL, pubkeys, 1));
+    CHECK(ecount == 3);
+    CHECK(!rustsecp256k1zkp_v0_5_0_rangeproof_ecdh_nonces(ctx, nonces, scan_key, NULL, 1));
+    CHECK(ecount == 4);
+    rustsecp256k1zkp_v0_5_0_context_set_illegal_callback(ctx, NULL, NULL);
+}
+
 void run_rangeproof_tests(void) {
     int i;
     test_api();
@@ -699,10 +845,12 @@ void run_rangeproof_tests(void) {
     for (i = 0; i < count / 2 + 1; i++) {
         test_pedersen();
     }
+    test_pedersen_ecmult_small();
     for (i = 0; i < count / 2 + 1; i++) {
         test_borromean();
     }
     test_rangeproof();
+    test_rangeproof_ecdh_nonces();
     test_multiple_generators();
 }
 
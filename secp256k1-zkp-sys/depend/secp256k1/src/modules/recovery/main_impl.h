@@ -84,13 +84,11 @@ int rustsecp256k1zkp_v0_5_0_ecdsa_recoverable_signature_convert(const rustsecp25
     return 1;
 }
 
-static int rustsecp256k1zkp_v0_5_0_ecdsa_sig_recover(const rustsecp256k1zkp_v0_5_0_ecmult_context *ctx, const rustsecp256k1zkp_v0_5_0_scalar *sigr, const rustsecp256k1zkp_v0_5_0_scalar* sigs, rustsecp256k1zkp_v0_5_0_ge *pubkey, const rustsecp256k1zkp_v0_5_0_scalar *message, int recid) {
+/* Computes the point R of a signature, which the public key is recovered from. */
+static int rustsecp256k1zkp_v0_5_0_ecdsa_sig_recover_r(rustsecp256k1zkp_v0_5_0_gej *xj, const rustsecp256k1zkp_v0_5_0_scalar *sigr, const rustsecp256k1zkp_v0_5_0_scalar* sigs, int recid) {
     unsigned char brx[32];
     rustsecp256k1zkp_v0_5_0_fe fx;
     rustsecp256k1zkp_v0_5_0_ge x;
-    rustsecp256k1zkp_v0_5_0_gej xj;
-    rustsecp256k1zkp_v0_5_0_scalar rn, u1, u2;
-    rustsecp256k1zkp_v0_5_0_gej qj;
     int r;
 
     if (rustsecp256k1zkp_v0_5_0_scalar_is_zero(sigr) || rustsecp256k1zkp_v0_5_0_scalar_is_zero(sigs)) {
@@ -110,7 +108,18 @@ static int rustsecp256k1zkp_v0_5_0_ecdsa_sig_recover(const rustsecp256k1zkp_v0_5
     if (!rustsecp256k1zkp_v0_5_0_ge_set_xo_var(&x, &fx, recid & 1)) {
         return 0;
     }
-    rustsecp256k1zkp_v0_5_0_gej_set_ge(&xj, &x);
+    rustsecp256k1zkp_v0_5_0_gej_set_ge(xj, &x);
+    return 1;
+}
+
+static int rustsecp256k1zkp_v0_5_0_ecdsa_sig_recover(const rustsecp256k1zkp_v0_5_0_ecmult_context *ctx, const rustsecp256k1zkp_v0_5_0_scalar *sigr, const rustsecp256k1zkp_v0_5_0_scalar* sigs, rustsecp256k1zkp_v0_5_0_ge *pubkey, const rustsecp256k1zkp_v0_5_0_scalar *message, int recid) {
+    rustsecp256k1zkp_v0_5_0_gej xj;
+    rustsecp256k1zkp_v0_5_0_scalar rn, u1, u2;
+    rustsecp256k1zkp_v0_5_0_gej qj;
+
+    if (!rustsecp256k1zkp_v0_5_0_ecdsa_sig_recover_r(&xj, sigr, sigs, recid)) {
+        return 0;
+    }
     rustsecp256k1zkp_v0_5_0_scalar_inverse_var(&rn, sigr);
     rustsecp256k1zkp_v0_5_0_scalar_mul(&u1, &rn, message);
     rustsecp256k1zkp_v0_5_0_scalar_negate(&u1, &u1);
@@ -157,4 +166,98 @@ int rustsecp256k1zkp_v0_5_0_ecdsa_recover(const rustsecp256k1zkp_v0_5_0_context*
     }
 }
 
+/* Number of signatures whose r values share a scalar inversion, and whose public keys
+ * share a field inversion. */
+#define ECDSA_RECOVER_BATCH_SIZE 32
+
+int rustsecp256k1zkp_v0_5_0_ecdsa_recover_batch(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_pubkey *pubkeys, size_t *invalid, size_t *n_invalid, const rustsecp256k1zkp_v0_5_0_ecdsa_recoverable_signature *const *sigs, const unsigned char *const *msghash32, size_t n_sigs) {
+    rustsecp256k1zkp_v0_5_0_scalar r[ECDSA_RECOVER_BATCH_SIZE];
+    rustsecp256k1zkp_v0_5_0_scalar s[ECDSA_RECOVER_BATCH_SIZE];
+    rustsecp256k1zkp_v0_5_0_scalar m[ECDSA_RECOVER_BATCH_SIZE];
+    rustsecp256k1zkp_v0_5_0_scalar acc[ECDSA_RECOVER_BATCH_SIZE];
+    rustsecp256k1zkp_v0_5_0_gej xj[ECDSA_RECOVER_BATCH_SIZE];
+    rustsecp256k1zkp_v0_5_0_gej qj[ECDSA_RECOVER_BATCH_SIZE];
+    rustsecp256k1zkp_v0_5_0_ge q[ECDSA_RECOVER_BATCH_SIZE];
+    size_t idx[ECDSA_RECOVER_BATCH_SIZE];
+    rustsecp256k1zkp_v0_5_0_scalar u, u1, u2;
+    size_t i, j, k, n, t;
+    int recid;
+    int ret = 1;
+
+    VERIFY_CHECK(ctx != NULL);
+    if (n_invalid != NULL) {
+        *n_invalid = 0;
+    }
+    ARG_CHECK(rustsecp256k1zkp_v0_5_0_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(pubkeys != NULL || n_sigs == 0);
+    ARG_CHECK(invalid == NULL || n_invalid != NULL);
+    ARG_CHECK(sigs != NULL || n_sigs == 0);
+    ARG_CHECK(msghash32 != NULL || n_sigs == 0);
+
+    for (i = 0; i < n_sigs; i += n) {
+        n = n_sigs - i;
+        if (n > ECDSA_RECOVER_BATCH_SIZE) {
+            n = ECDSA_RECOVER_BATCH_SIZE;
+        }
+        /* Compute the points R and the running products of the r values of the
+         * signatures that have one. */
+        k = 0;
+        for (j = 0; j < n; j++) {
+            ARG_CHECK(sigs[i + j] != NULL);
+            ARG_CHECK(msghash32[i + j] != NULL);
+            rustsecp256k1zkp_v0_5_0_ecdsa_recoverable_signature_load(ctx, &r[j], &s[j], &recid, sigs[i + j]);
+            VERIFY_CHECK(recid >= 0 && recid < 4);  /* should have been caught in parse_compact */
+            rustsecp256k1zkp_v0_5_0_scalar_set_b32(&m[j], msghash32[i + j], NULL);
+            if (rustsecp256k1zkp_v0_5_0_ecdsa_sig_recover_r(&xj[j], &r[j], &s[j], recid)) {
+                if (k == 0) {
+                    acc[0] = r[j];
+                } else {
+                    rustsecp256k1zkp_v0_5_0_scalar_mul(&acc[k], &acc[k - 1], &r[j]);
+                }
+                idx[k++] = j;
+            } else {
+                rustsecp256k1zkp_v0_5_0_gej_set_infinity(&xj[j]);
+            }
+        }
+
+        /* Invert all of them at once, replacing each r by its inverse. */
+        if (k > 0) {
+            rustsecp256k1zkp_v0_5_0_scalar_inverse_var(&u, &acc[k - 1]);
+            for (t = k - 1; t > 0; t--) {
+                rustsecp256k1zkp_v0_5_0_scalar_mul(&acc[t], &acc[t - 1], &u);
+                rustsecp256k1zkp_v0_5_0_scalar_mul(&u, &u, &r[idx[t]]);
+                r[idx[t]] = acc[t];
+            }
+            r[idx[0]] = u;
+        }
+
+        for (j = 0; j < n; j++) {
+            if (rustsecp256k1zkp_v0_5_0_gej_is_infinity(&xj[j])) {
+                rustsecp256k1zkp_v0_5_0_gej_set_infinity(&qj[j]);
+                continue;
+            }
+            rustsecp256k1zkp_v0_5_0_scalar_mul(&u1, &r[j], &m[j]);
+            rustsecp256k1zkp_v0_5_0_scalar_negate(&u1, &u1);
+            rustsecp256k1zkp_v0_5_0_scalar_mul(&u2, &r[j], &s[j]);
+            rustsecp256k1zkp_v0_5_0_ecmult(&ctx->ecmult_ctx, &qj[j], &xj[j], &u2, &u1);
+        }
+        rustsecp256k1zkp_v0_5_0_ge_set_all_gej_var(q, qj, n);
+
+        for (j = 0; j < n; j++) {
+            if (rustsecp256k1zkp_v0_5_0_gej_is_infinity(&qj[j])) {
+                if (invalid != NULL) {
+                    invalid[*n_invalid] = i + j;
+                }
+                if (n_invalid != NULL) {
+                    (*n_invalid)++;
+                }
+                ret = 0;
+            } else {
+                rustsecp256k1zkp_v0_5_0_pubkey_save(&pubkeys[i + j], &q[j]);
+            }
+        }
+    }
+    return ret;
+}
+
 #endif /* SECP256K1_MODULE_RECOVERY_MAIN_H */
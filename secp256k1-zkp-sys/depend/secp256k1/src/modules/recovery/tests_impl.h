@@ -379,6 +379,79 @@ void test_ecdsa_recovery_edge_cases(void) {
     }
 }
 
+void test_ecdsa_recover_batch(void) {
+    unsigned char privkey[32];
+    unsigned char message[70][32];
+    unsigned char zero_sig[64] = { 0 };
+    rustsecp256k1zkp_v0_5_0_ecdsa_recoverable_signature rsignature[70];
+    const rustsecp256k1zkp_v0_5_0_ecdsa_recoverable_signature *sigs[70];
+    const unsigned char *msgs[70];
+    rustsecp256k1zkp_v0_5_0_pubkey pubkey[70];
+    rustsecp256k1zkp_v0_5_0_pubkey recpubkey[70];
+    rustsecp256k1zkp_v0_5_0_pubkey recpubkey_single;
+    rustsecp256k1zkp_v0_5_0_scalar tmp;
+    size_t invalid[70];
+    size_t n_invalid;
+    int ecount = 0;
+    size_t i;
+
+    for (i = 0; i < 70; i++) {
+        random_scalar_order_test(&tmp);
+        rustsecp256k1zkp_v0_5_0_scalar_get_b32(privkey, &tmp);
+        random_scalar_order_test(&tmp);
+        rustsecp256k1zkp_v0_5_0_scalar_get_b32(message[i], &tmp);
+        CHECK(rustsecp256k1zkp_v0_5_0_ec_pubkey_create(ctx, &pubkey[i], privkey) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_sign_recoverable(ctx, &rsignature[i], message[i], privkey, NULL, NULL) == 1);
+        sigs[i] = &rsignature[i];
+        msgs[i] = message[i];
+    }
+
+    /* Batches that do and do not fill the last chunk */
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_recover_batch(ctx, recpubkey, invalid, &n_invalid, sigs, msgs, 70) == 1);
+    CHECK(n_invalid == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_memcmp_var(recpubkey, pubkey, sizeof(recpubkey)) == 0);
+    memset(recpubkey, 0, sizeof(recpubkey));
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_recover_batch(ctx, recpubkey, NULL, NULL, sigs, msgs, 64) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_memcmp_var(recpubkey, pubkey, 64 * sizeof(recpubkey[0])) == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_recover_batch(ctx, NULL, NULL, NULL, NULL, NULL, 0) == 1);
+
+    /* Unrecoverable signatures leave their public keys unchanged, and recovering with
+     * another message gives another key */
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_recoverable_signature_parse_compact(ctx, &rsignature[5], zero_sig, 0) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_recoverable_signature_parse_compact(ctx, &rsignature[40], zero_sig, 1) == 1);
+    msgs[66] = message[0];
+    memset(recpubkey, 0, sizeof(recpubkey));
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_recover_batch(ctx, recpubkey, invalid, &n_invalid, sigs, msgs, 70) == 0);
+    CHECK(n_invalid == 2);
+    CHECK(invalid[0] == 5 && invalid[1] == 40);
+    for (i = 0; i < 70; i++) {
+        if (i == 5 || i == 40) {
+            CHECK(rustsecp256k1zkp_v0_5_0_memcmp_var(&recpubkey[i], zero_sig, 64) == 0);
+            continue;
+        }
+        CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_recover(ctx, &recpubkey_single, sigs[i], msgs[i]) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_memcmp_var(&recpubkey[i], &recpubkey_single, sizeof(recpubkey_single)) == 0);
+        CHECK((rustsecp256k1zkp_v0_5_0_memcmp_var(&recpubkey[i], &pubkey[i], sizeof(pubkey[i])) == 0) == (i != 66));
+    }
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_recover_batch(ctx, recpubkey, NULL, &n_invalid, sigs, msgs, 70) == 0);
+    CHECK(n_invalid == 2);
+
+    /* Illegal arguments */
+    rustsecp256k1zkp_v0_5_0_context_set_illegal_callback(ctx, counting_illegal_callback_fn, &ecount);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_recover_batch(ctx, NULL, NULL, NULL, sigs, msgs, 1) == 0);
+    CHECK(ecount == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_recover_batch(ctx, recpubkey, invalid, NULL, sigs, msgs, 1) == 0);
+    CHECK(ecount == 2);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_recover_batch(ctx, recpubkey, NULL, NULL, NULL, msgs, 1) == 0);
+    CHECK(ecount == 3);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_recover_batch(ctx, recpubkey, NULL, NULL, sigs, NULL, 1) == 0);
+    CHECK(ecount == 4);
+    sigs[1] = NULL;
+    CHECK(rustsecp256k1zkp_v0_5_0_ecdsa_recover_batch(ctx, recpubkey, NULL, NULL, sigs, msgs, 2) == 0);
+    CHECK(ecount == 5);
+    rustsecp256k1zkp_v0_5_0_context_set_illegal_callback(ctx, NULL, NULL);
+}
+
 void run_recovery_tests(void) {
     int i;
     for (i = 0; i < count; i++) {
@@ -388,6 +461,7 @@ void run_recovery_tests(void) {
         test_ecdsa_recovery_end_to_end();
     }
     test_ecdsa_recovery_edge_cases();
+    test_ecdsa_recover_batch();
 }
 
 #endif /* SECP256K1_MODULE_RECOVERY_TESTS_H */
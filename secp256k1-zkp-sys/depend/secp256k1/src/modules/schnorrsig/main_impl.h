@@ -236,4 +236,212 @@ int rustsecp256k1zkp_v0_5_0_schnorrsig_verify(const rustsecp256k1zkp_v0_5_0_cont
            rustsecp256k1zkp_v0_5_0_fe_equal_var(&rx, &r.x);
 }
 
+/* Data for the ecmult_multi callback of schnorrsig_verify_batch. The R points
+ * are decompressed eight at a time, so that their square roots can be computed
+ * in parallel, and cached. */
+typedef struct {
+    const rustsecp256k1zkp_v0_5_0_context *ctx;
+    rustsecp256k1zkp_v0_5_0_scalar_randomizer randomizer;
+    size_t r_cache_idx;
+    size_t r_cache_len;
+    rustsecp256k1zkp_v0_5_0_ge r_cache[8];
+    int fe_vec;
+    size_t n_sigs;
+    const unsigned char *const *sig64;
+    const unsigned char *const *msg32;
+    const rustsecp256k1zkp_v0_5_0_xonly_pubkey *const *pk;
+} rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_ecmult_data;
+
+/* Decompresses R_i to R_{i+7} into the cache. Returns 0, leaving the cache
+ * empty, if any of them is invalid. */
+static int rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_load_r(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_ecmult_data *data, size_t i) {
+    rustsecp256k1zkp_v0_5_0_fe rx[8];
+    size_t j;
+    size_t n = data->n_sigs - i < 8 ? data->n_sigs - i : 8;
+
+    data->r_cache_len = 0;
+    for (j = 0; j < 8; j++) {
+        /* The unused entries are set as well to keep compilers from warning. */
+        if (!rustsecp256k1zkp_v0_5_0_fe_set_b32(&rx[j], &data->sig64[i + (j < n ? j : 0)][0])) {
+            return 0;
+        }
+    }
+    if (!rustsecp256k1zkp_v0_5_0_ge_set_xquad_all(data->r_cache, rx, n, data->fe_vec)) {
+        return 0;
+    }
+    /* Pick the even y, as ge_set_xo_var(.., 0) does. */
+    for (j = 0; j < n; j++) {
+        rustsecp256k1zkp_v0_5_0_fe_normalize_var(&data->r_cache[j].y);
+        if (rustsecp256k1zkp_v0_5_0_fe_is_odd(&data->r_cache[j].y)) {
+            rustsecp256k1zkp_v0_5_0_fe_negate(&data->r_cache[j].y, &data->r_cache[j].y, 1);
+        }
+    }
+    data->r_cache_idx = i;
+    data->r_cache_len = n;
+    return 1;
+}
+
+/* Callback for batch EC multiplication. Point 2*i is R_i with scalar a_i and
+ * point 2*i + 1 is P_i with scalar a_i*e_i. */
+static int rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_ecmult_callback(rustsecp256k1zkp_v0_5_0_scalar *sc, rustsecp256k1zkp_v0_5_0_ge *pt, size_t idx, void *data) {
+    rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_ecmult_data *ecmult_data = (rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_ecmult_data *) data;
+    size_t i = idx / 2;
+
+    rustsecp256k1zkp_v0_5_0_scalar_randomizer_get(sc, &ecmult_data->randomizer, i);
+    if (idx % 2 == 0) {
+        if (i - ecmult_data->r_cache_idx >= ecmult_data->r_cache_len
+            && !rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_load_r(ecmult_data, i)) {
+            /* Some R of the group is invalid, check this one alone. */
+            rustsecp256k1zkp_v0_5_0_fe rx;
+            if (!rustsecp256k1zkp_v0_5_0_fe_set_b32(&rx, &ecmult_data->sig64[i][0])) {
+                return 0;
+            }
+            return rustsecp256k1zkp_v0_5_0_ge_set_xo_var(pt, &rx, 0);
+        }
+        *pt = ecmult_data->r_cache[i - ecmult_data->r_cache_idx];
+        return 1;
+    } else {
+        rustsecp256k1zkp_v0_5_0_scalar e;
+        unsigned char buf[32];
+        if (!rustsecp256k1zkp_v0_5_0_xonly_pubkey_load(ecmult_data->ctx, pt, ecmult_data->pk[i])) {
+            return 0;
+        }
+        rustsecp256k1zkp_v0_5_0_fe_get_b32(buf, &pt->x);
+        rustsecp256k1zkp_v0_5_0_schnorrsig_challenge(&e, &ecmult_data->sig64[i][0], ecmult_data->msg32[i], buf);
+        rustsecp256k1zkp_v0_5_0_scalar_mul(sc, sc, &e);
+        return 1;
+    }
+}
+
+/* Checks the arguments of a batch verification, sets up the ecmult_multi
+ * callback data and computes the scalar for G. Returns 0 if the batch is
+ * invalid, or if an argument is invalid after calling the illegal callback. */
+static int rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_init(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_ecmult_data *ecmult_data, rustsecp256k1zkp_v0_5_0_scalar *s_sum, const unsigned char *const *sig64, const unsigned char *const *msg32, const rustsecp256k1zkp_v0_5_0_xonly_pubkey *const *pk, size_t n_sigs) {
+    rustsecp256k1zkp_v0_5_0_sha256 sha;
+    unsigned char seed[32];
+    size_t i;
+
+    /* Seed the randomizers with a hash of the whole batch, so that they are
+     * unpredictable to anyone who does not control every input. */
+    rustsecp256k1zkp_v0_5_0_sha256_initialize(&sha);
+    for (i = 0; i < n_sigs; i++) {
+        unsigned char buf[32];
+        ARG_CHECK(sig64[i] != NULL);
+        ARG_CHECK(msg32[i] != NULL);
+        ARG_CHECK(pk[i] != NULL);
+        if (!rustsecp256k1zkp_v0_5_0_xonly_pubkey_serialize(ctx, buf, pk[i])) {
+            return 0;
+        }
+        rustsecp256k1zkp_v0_5_0_sha256_write(&sha, sig64[i], 64);
+        rustsecp256k1zkp_v0_5_0_sha256_write(&sha, msg32[i], 32);
+        rustsecp256k1zkp_v0_5_0_sha256_write(&sha, buf, 32);
+    }
+    ecmult_data->ctx = ctx;
+    rustsecp256k1zkp_v0_5_0_sha256_finalize(&sha, seed);
+    rustsecp256k1zkp_v0_5_0_scalar_randomizer_init(&ecmult_data->randomizer, seed);
+    ecmult_data->r_cache_idx = 0;
+    ecmult_data->r_cache_len = 0;
+    ecmult_data->fe_vec = n_sigs >= 8 && rustsecp256k1zkp_v0_5_0_fe_vec_available();
+    ecmult_data->n_sigs = n_sigs;
+    ecmult_data->sig64 = sig64;
+    ecmult_data->msg32 = msg32;
+    ecmult_data->pk = pk;
+
+    /* Compute -sum(a_i*s_i), the scalar for G. */
+    rustsecp256k1zkp_v0_5_0_scalar_clear(s_sum);
+    for (i = 0; i < n_sigs; i++) {
+        rustsecp256k1zkp_v0_5_0_scalar s;
+        rustsecp256k1zkp_v0_5_0_scalar a;
+        int overflow;
+        rustsecp256k1zkp_v0_5_0_scalar_set_b32(&s, &sig64[i][32], &overflow);
+        if (overflow) {
+            return 0;
+        }
+        rustsecp256k1zkp_v0_5_0_scalar_randomizer_get(&a, &ecmult_data->randomizer, i);
+        rustsecp256k1zkp_v0_5_0_scalar_mul(&s, &s, &a);
+        rustsecp256k1zkp_v0_5_0_scalar_add(s_sum, s_sum, &s);
+    }
+    rustsecp256k1zkp_v0_5_0_scalar_negate(s_sum, s_sum);
+    return 1;
+}
+
+int rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_scratch_space *scratch, const unsigned char *const *sig64, const unsigned char *const *msg32, const rustsecp256k1zkp_v0_5_0_xonly_pubkey *const *pk, size_t n_sigs) {
+    rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_ecmult_data ecmult_data;
+    rustsecp256k1zkp_v0_5_0_scalar s_sum;
+    rustsecp256k1zkp_v0_5_0_gej rj;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(rustsecp256k1zkp_v0_5_0_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(n_sigs == 0 || sig64 != NULL);
+    ARG_CHECK(n_sigs == 0 || msg32 != NULL);
+    ARG_CHECK(n_sigs == 0 || pk != NULL);
+    /* Each signature contributes two points to the multi-multiplication. */
+    ARG_CHECK(n_sigs <= SIZE_MAX / 2);
+
+    if (n_sigs == 0) {
+        return 1;
+    }
+    if (!rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_init(ctx, &ecmult_data, &s_sum, sig64, msg32, pk, n_sigs)) {
+        return 0;
+    }
+
+    /* Check sum(a_i*R_i) + sum(a_i*e_i*P_i) - sum(a_i*s_i)*G = 0 */
+    if (!rustsecp256k1zkp_v0_5_0_ecmult_multi_var(&ctx->error_callback, &ctx->ecmult_ctx, scratch, &rj, &s_sum, rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_ecmult_callback, (void *) &ecmult_data, 2 * n_sigs)) {
+        return 0;
+    }
+    return rustsecp256k1zkp_v0_5_0_gej_is_infinity(&rj);
+}
+
+int rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_parallel(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_scratch_space *const *scratch, size_t n_workers, rustsecp256k1zkp_v0_5_0_task_runner runner, void *runner_data, const unsigned char *const *sig64, const unsigned char *const *msg32, const rustsecp256k1zkp_v0_5_0_xonly_pubkey *const *pk, size_t n_sigs) {
+    rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_ecmult_data *ecmult_data;
+    void **cbdata;
+    rustsecp256k1zkp_v0_5_0_scalar s_sum;
+    rustsecp256k1zkp_v0_5_0_gej rj;
+    size_t scratch_checkpoint;
+    size_t i;
+    int ret = 0;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(rustsecp256k1zkp_v0_5_0_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(scratch != NULL);
+    ARG_CHECK(n_workers > 0);
+    ARG_CHECK(runner != NULL);
+    ARG_CHECK(n_sigs == 0 || sig64 != NULL);
+    ARG_CHECK(n_sigs == 0 || msg32 != NULL);
+    ARG_CHECK(n_sigs == 0 || pk != NULL);
+    ARG_CHECK(n_sigs <= SIZE_MAX / 2);
+    for (i = 0; i < n_workers; i++) {
+        ARG_CHECK(scratch[i] != NULL);
+    }
+
+    if (n_sigs == 0) {
+        return 1;
+    }
+
+    /* ecmult_multi_var_parallel would leave the surplus workers idle anyway. */
+    if (n_workers > 1 + (2 * n_sigs - 1) / ECMULT_MIN_POINTS_PER_WORKER) {
+        n_workers = 1 + (2 * n_sigs - 1) / ECMULT_MIN_POINTS_PER_WORKER;
+    }
+    /* The callback caches randomizers, so every worker gets its own copy of
+     * the callback data. */
+    scratch_checkpoint = rustsecp256k1zkp_v0_5_0_scratch_checkpoint(&ctx->error_callback, scratch[0]);
+    ecmult_data = (rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_ecmult_data *) rustsecp256k1zkp_v0_5_0_scratch_alloc(&ctx->error_callback, scratch[0], n_workers * sizeof(*ecmult_data));
+    cbdata = (void **) rustsecp256k1zkp_v0_5_0_scratch_alloc(&ctx->error_callback, scratch[0], n_workers * sizeof(*cbdata));
+    if (ecmult_data == NULL || cbdata == NULL) {
+        rustsecp256k1zkp_v0_5_0_scratch_apply_checkpoint(&ctx->error_callback, scratch[0], scratch_checkpoint);
+        return rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(ctx, scratch[0], sig64, msg32, pk, n_sigs);
+    }
+    if (rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_init(ctx, &ecmult_data[0], &s_sum, sig64, msg32, pk, n_sigs)) {
+        for (i = 0; i < n_workers; i++) {
+            ecmult_data[i] = ecmult_data[0];
+            cbdata[i] = &ecmult_data[i];
+        }
+        /* Check sum(a_i*R_i) + sum(a_i*e_i*P_i) - sum(a_i*s_i)*G = 0 */
+        ret = rustsecp256k1zkp_v0_5_0_ecmult_multi_var_parallel(&ctx->error_callback, &ctx->ecmult_ctx, scratch, n_workers, runner, runner_data, &rj, &s_sum, rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_ecmult_callback, cbdata, 2 * n_sigs)
+              && rustsecp256k1zkp_v0_5_0_gej_is_infinity(&rj);
+    }
+    rustsecp256k1zkp_v0_5_0_scratch_apply_checkpoint(&ctx->error_callback, scratch[0], scratch_checkpoint);
+    return ret;
+}
+
 #endif
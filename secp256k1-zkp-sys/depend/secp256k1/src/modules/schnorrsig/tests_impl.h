@@ -170,6 +170,33 @@ void test_schnorrsig_api(void) {
     CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify(vrfy, sig, msg, &zero_pk) == 0);
     CHECK(ecount == 6);
 
+    {
+        const unsigned char *sigptr = sig;
+        const unsigned char *msgptr = msg;
+        const rustsecp256k1zkp_v0_5_0_xonly_pubkey *pkptr = &pk[0];
+        const rustsecp256k1zkp_v0_5_0_xonly_pubkey *zero_pkptr = &zero_pk;
+
+        ecount = 0;
+        CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(none, NULL, &sigptr, &msgptr, &pkptr, 1) == 0);
+        CHECK(ecount == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(sign, NULL, &sigptr, &msgptr, &pkptr, 1) == 0);
+        CHECK(ecount == 2);
+        CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(vrfy, NULL, &sigptr, &msgptr, &pkptr, 1) == 1);
+        CHECK(ecount == 2);
+        CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(vrfy, NULL, NULL, NULL, NULL, 0) == 1);
+        CHECK(ecount == 2);
+        CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(vrfy, NULL, NULL, &msgptr, &pkptr, 1) == 0);
+        CHECK(ecount == 3);
+        CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(vrfy, NULL, &sigptr, NULL, &pkptr, 1) == 0);
+        CHECK(ecount == 4);
+        CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(vrfy, NULL, &sigptr, &msgptr, NULL, 1) == 0);
+        CHECK(ecount == 5);
+        CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(vrfy, NULL, &sigptr, &msgptr, &zero_pkptr, 1) == 0);
+        CHECK(ecount == 6);
+        CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(vrfy, NULL, &sigptr, &msgptr, &pkptr, SIZE_MAX) == 0);
+        CHECK(ecount == 7);
+    }
+
     rustsecp256k1zkp_v0_5_0_context_destroy(none);
     rustsecp256k1zkp_v0_5_0_context_destroy(sign);
     rustsecp256k1zkp_v0_5_0_context_destroy(vrfy);
@@ -698,6 +725,9 @@ void test_schnorrsig_sign_verify(void) {
     unsigned char sk[32];
     unsigned char msg[N_SIGS][32];
     unsigned char sig[N_SIGS][64];
+    const unsigned char *sig_arr[N_SIGS];
+    const unsigned char *msg_arr[N_SIGS];
+    const rustsecp256k1zkp_v0_5_0_xonly_pubkey *pk_arr[N_SIGS];
     size_t i;
     rustsecp256k1zkp_v0_5_0_keypair keypair;
     rustsecp256k1zkp_v0_5_0_xonly_pubkey pk;
@@ -711,30 +741,38 @@ void test_schnorrsig_sign_verify(void) {
         rustsecp256k1zkp_v0_5_0_testrand256(msg[i]);
         CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_sign(ctx, sig[i], msg[i], &keypair, NULL, NULL));
         CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify(ctx, sig[i], msg[i], &pk));
+        sig_arr[i] = sig[i];
+        msg_arr[i] = msg[i];
+        pk_arr[i] = &pk;
     }
+    CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(ctx, NULL, sig_arr, msg_arr, pk_arr, N_SIGS));
 
     {
         /* Flip a few bits in the signature and in the message and check that
-         * verify and verify_batch (TODO) fail */
+         * verify and verify_batch fail */
         size_t sig_idx = rustsecp256k1zkp_v0_5_0_testrand_int(N_SIGS);
         size_t byte_idx = rustsecp256k1zkp_v0_5_0_testrand_int(32);
         unsigned char xorbyte = rustsecp256k1zkp_v0_5_0_testrand_int(254)+1;
         sig[sig_idx][byte_idx] ^= xorbyte;
         CHECK(!rustsecp256k1zkp_v0_5_0_schnorrsig_verify(ctx, sig[sig_idx], msg[sig_idx], &pk));
+        CHECK(!rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(ctx, NULL, sig_arr, msg_arr, pk_arr, N_SIGS));
         sig[sig_idx][byte_idx] ^= xorbyte;
 
         byte_idx = rustsecp256k1zkp_v0_5_0_testrand_int(32);
         sig[sig_idx][32+byte_idx] ^= xorbyte;
         CHECK(!rustsecp256k1zkp_v0_5_0_schnorrsig_verify(ctx, sig[sig_idx], msg[sig_idx], &pk));
+        CHECK(!rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(ctx, NULL, sig_arr, msg_arr, pk_arr, N_SIGS));
         sig[sig_idx][32+byte_idx] ^= xorbyte;
 
         byte_idx = rustsecp256k1zkp_v0_5_0_testrand_int(32);
         msg[sig_idx][byte_idx] ^= xorbyte;
         CHECK(!rustsecp256k1zkp_v0_5_0_schnorrsig_verify(ctx, sig[sig_idx], msg[sig_idx], &pk));
+        CHECK(!rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(ctx, NULL, sig_arr, msg_arr, pk_arr, N_SIGS));
         msg[sig_idx][byte_idx] ^= xorbyte;
 
         /* Check that above bitflips have been reversed correctly */
         CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify(ctx, sig[sig_idx], msg[sig_idx], &pk));
+        CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(ctx, NULL, sig_arr, msg_arr, pk_arr, N_SIGS));
     }
 
     /* Test overflowing s */
@@ -742,6 +780,7 @@ void test_schnorrsig_sign_verify(void) {
     CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify(ctx, sig[0], msg[0], &pk));
     memset(&sig[0][32], 0xFF, 32);
     CHECK(!rustsecp256k1zkp_v0_5_0_schnorrsig_verify(ctx, sig[0], msg[0], &pk));
+    CHECK(!rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(ctx, NULL, sig_arr, msg_arr, pk_arr, N_SIGS));
 
     /* Test negative s */
     CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_sign(ctx, sig[0], msg[0], &keypair, NULL, NULL));
@@ -750,9 +789,154 @@ void test_schnorrsig_sign_verify(void) {
     rustsecp256k1zkp_v0_5_0_scalar_negate(&s, &s);
     rustsecp256k1zkp_v0_5_0_scalar_get_b32(&sig[0][32], &s);
     CHECK(!rustsecp256k1zkp_v0_5_0_schnorrsig_verify(ctx, sig[0], msg[0], &pk));
+    CHECK(!rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(ctx, NULL, sig_arr, msg_arr, pk_arr, N_SIGS));
 }
 #undef N_SIGS
 
+/* Verifies batches of signatures under distinct keys, with and without
+ * scratch space, and checks that a single bad signature or an R that is not
+ * on the curve makes the batch fail. */
+void test_schnorrsig_verify_batch(void) {
+    enum { N_BATCH = 100 };
+    unsigned char sig[N_BATCH][64];
+    unsigned char msg[N_BATCH][32];
+    rustsecp256k1zkp_v0_5_0_xonly_pubkey pk[N_BATCH];
+    const unsigned char *sig_arr[N_BATCH];
+    const unsigned char *msg_arr[N_BATCH];
+    const rustsecp256k1zkp_v0_5_0_xonly_pubkey *pk_arr[N_BATCH];
+    rustsecp256k1zkp_v0_5_0_scratch_space *scratch = rustsecp256k1zkp_v0_5_0_scratch_space_create(ctx, 1024 * 1024);
+    unsigned char saved[32];
+    size_t i;
+    size_t n;
+
+    for (i = 0; i < N_BATCH; i++) {
+        unsigned char sk[32];
+        rustsecp256k1zkp_v0_5_0_keypair keypair;
+        rustsecp256k1zkp_v0_5_0_testrand256(sk);
+        rustsecp256k1zkp_v0_5_0_testrand256(msg[i]);
+        CHECK(rustsecp256k1zkp_v0_5_0_keypair_create(ctx, &keypair, sk));
+        CHECK(rustsecp256k1zkp_v0_5_0_keypair_xonly_pub(ctx, &pk[i], NULL, &keypair));
+        CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_sign(ctx, sig[i], msg[i], &keypair, NULL, NULL));
+        sig_arr[i] = sig[i];
+        msg_arr[i] = msg[i];
+        pk_arr[i] = &pk[i];
+    }
+
+    for (n = 1; n <= N_BATCH; n += 1 + rustsecp256k1zkp_v0_5_0_testrand_int(N_BATCH / 4)) {
+        size_t bad = rustsecp256k1zkp_v0_5_0_testrand_int(n);
+        CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(ctx, NULL, sig_arr, msg_arr, pk_arr, n));
+        CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(ctx, scratch, sig_arr, msg_arr, pk_arr, n));
+
+        /* Signature of another message */
+        msg_arr[bad] = msg[(bad + 1) % N_BATCH];
+        CHECK(!rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(ctx, scratch, sig_arr, msg_arr, pk_arr, n));
+        msg_arr[bad] = msg[bad];
+
+        /* R is not a valid x coordinate */
+        memcpy(saved, sig[bad], 32);
+        memset(sig[bad], 0xFF, 32);
+        CHECK(!rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(ctx, scratch, sig_arr, msg_arr, pk_arr, n));
+        memcpy(sig[bad], saved, 32);
+
+        /* Swapping two signatures between their messages */
+        if (n > 1) {
+            size_t other = (bad + 1) % n;
+            sig_arr[bad] = sig[other];
+            sig_arr[other] = sig[bad];
+            CHECK(!rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(ctx, scratch, sig_arr, msg_arr, pk_arr, n));
+            sig_arr[bad] = sig[bad];
+            sig_arr[other] = sig[other];
+        }
+        CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch(ctx, scratch, sig_arr, msg_arr, pk_arr, n));
+    }
+    rustsecp256k1zkp_v0_5_0_scratch_space_destroy(ctx, scratch);
+}
+
+/* Runs the tasks one after another, in reverse order, and records their number. */
+static void schnorrsig_test_task_runner(void (*task)(void *task_data, size_t i), void *task_data, size_t n_tasks, void *data) {
+    size_t i;
+    for (i = n_tasks; i > 0; i--) {
+        task(task_data, i - 1);
+    }
+    *(size_t *) data = n_tasks;
+}
+
+void test_schnorrsig_verify_batch_parallel(void) {
+    /* Enough signatures for three workers */
+    enum { N_BATCH = ECMULT_MIN_POINTS_PER_WORKER + 1 };
+    static unsigned char sig[N_BATCH][64];
+    static unsigned char msg[N_BATCH][32];
+    static rustsecp256k1zkp_v0_5_0_xonly_pubkey pk[N_BATCH];
+    static const unsigned char *sig_arr[N_BATCH];
+    static const unsigned char *msg_arr[N_BATCH];
+    static const rustsecp256k1zkp_v0_5_0_xonly_pubkey *pk_arr[N_BATCH];
+    rustsecp256k1zkp_v0_5_0_scratch_space *scratch[4];
+    size_t n_tasks;
+    size_t i;
+    int ecount;
+    rustsecp256k1zkp_v0_5_0_context *vrfy = rustsecp256k1zkp_v0_5_0_context_create(SECP256K1_CONTEXT_VERIFY);
+
+    rustsecp256k1zkp_v0_5_0_context_set_illegal_callback(vrfy, counting_illegal_callback_fn, &ecount);
+    for (i = 0; i < N_BATCH; i++) {
+        unsigned char sk[32];
+        rustsecp256k1zkp_v0_5_0_keypair keypair;
+        rustsecp256k1zkp_v0_5_0_testrand256(sk);
+        rustsecp256k1zkp_v0_5_0_testrand256(msg[i]);
+        CHECK(rustsecp256k1zkp_v0_5_0_keypair_create(ctx, &keypair, sk));
+        CHECK(rustsecp256k1zkp_v0_5_0_keypair_xonly_pub(ctx, &pk[i], NULL, &keypair));
+        CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_sign(ctx, sig[i], msg[i], &keypair, NULL, NULL));
+        sig_arr[i] = sig[i];
+        msg_arr[i] = msg[i];
+        pk_arr[i] = &pk[i];
+    }
+    for (i = 0; i < 4; i++) {
+        scratch[i] = rustsecp256k1zkp_v0_5_0_scratch_space_create(ctx, 1024 * 1024);
+    }
+
+    n_tasks = 0;
+    CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_parallel(ctx, scratch, 4, schnorrsig_test_task_runner, &n_tasks, sig_arr, msg_arr, pk_arr, N_BATCH));
+    CHECK(n_tasks == 3);
+    CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_parallel(ctx, scratch, 2, schnorrsig_test_task_runner, &n_tasks, sig_arr, msg_arr, pk_arr, N_BATCH));
+    CHECK(n_tasks == 2);
+    n_tasks = 0;
+    CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_parallel(ctx, scratch, 4, schnorrsig_test_task_runner, &n_tasks, sig_arr, msg_arr, pk_arr, 10));
+    CHECK(n_tasks == 0);
+
+    /* Invalid signatures in the range of the first and of the last worker */
+    msg_arr[0] = msg[1];
+    CHECK(!rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_parallel(ctx, scratch, 4, schnorrsig_test_task_runner, &n_tasks, sig_arr, msg_arr, pk_arr, N_BATCH));
+    msg_arr[0] = msg[0];
+    msg_arr[N_BATCH - 1] = msg[0];
+    CHECK(!rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_parallel(ctx, scratch, 4, schnorrsig_test_task_runner, &n_tasks, sig_arr, msg_arr, pk_arr, N_BATCH));
+    msg_arr[N_BATCH - 1] = msg[N_BATCH - 1];
+    CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_parallel(ctx, scratch, 4, schnorrsig_test_task_runner, &n_tasks, sig_arr, msg_arr, pk_arr, N_BATCH));
+
+    ecount = 0;
+    CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_parallel(vrfy, NULL, 4, schnorrsig_test_task_runner, &n_tasks, sig_arr, msg_arr, pk_arr, N_BATCH) == 0);
+    CHECK(ecount == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_parallel(vrfy, scratch, 0, schnorrsig_test_task_runner, &n_tasks, sig_arr, msg_arr, pk_arr, N_BATCH) == 0);
+    CHECK(ecount == 2);
+    CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_parallel(vrfy, scratch, 4, NULL, &n_tasks, sig_arr, msg_arr, pk_arr, N_BATCH) == 0);
+    CHECK(ecount == 3);
+    CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_parallel(vrfy, scratch, 4, schnorrsig_test_task_runner, NULL, NULL, NULL, NULL, 0) == 1);
+    CHECK(ecount == 3);
+    CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_parallel(vrfy, scratch, 4, schnorrsig_test_task_runner, &n_tasks, NULL, msg_arr, pk_arr, N_BATCH) == 0);
+    CHECK(ecount == 4);
+    CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_parallel(vrfy, scratch, 4, schnorrsig_test_task_runner, &n_tasks, sig_arr, msg_arr, pk_arr, SIZE_MAX) == 0);
+    CHECK(ecount == 5);
+    rustsecp256k1zkp_v0_5_0_scratch_space_destroy(ctx, scratch[3]);
+    scratch[3] = NULL;
+    CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_parallel(vrfy, scratch, 4, schnorrsig_test_task_runner, &n_tasks, sig_arr, msg_arr, pk_arr, N_BATCH) == 0);
+    CHECK(ecount == 6);
+    CHECK(rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch_parallel(vrfy, scratch, 3, schnorrsig_test_task_runner, &n_tasks, sig_arr, msg_arr, pk_arr, N_BATCH) == 1);
+    CHECK(ecount == 6);
+
+    for (i = 0; i < 3; i++) {
+        rustsecp256k1zkp_v0_5_0_scratch_space_destroy(ctx, scratch[i]);
+    }
+    rustsecp256k1zkp_v0_5_0_context_destroy(vrfy);
+}
+
 void test_schnorrsig_taproot(void) {
     unsigned char sk[32];
     rustsecp256k1zkp_v0_5_0_keypair keypair;
@@ -800,6 +984,8 @@ void run_schnorrsig_tests(void) {
         test_schnorrsig_sign();
         test_schnorrsig_sign_verify();
     }
+    test_schnorrsig_verify_batch();
+    test_schnorrsig_verify_batch_parallel();
     test_schnorrsig_taproot();
 }
 
@@ -43,45 +43,52 @@ static size_t rustsecp256k1zkp_v0_5_0_count_bits_set(const unsigned char* data,
     return ret;
 }
 
-#ifdef USE_REDUCED_SURJECTION_PROOF_SIZE
-static
-#endif
-int rustsecp256k1zkp_v0_5_0_surjectionproof_parse(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_surjectionproof *proof, const unsigned char *input, size_t inputlen) {
-    size_t n_inputs;
+/* Checks that `input` is a well-formed serialized surjection proof (see
+ * surjectionproof_parse) and returns its total number of inputs in `n_inputs`. */
+static int rustsecp256k1zkp_v0_5_0_surjectionproof_check_serialization(size_t *n_inputs, const unsigned char *input, size_t inputlen) {
     size_t signature_len;
 
-    VERIFY_CHECK(ctx != NULL);
-    ARG_CHECK(proof != NULL);
-    ARG_CHECK(input != NULL);
-    (void) ctx;
-
     if (inputlen < 2) {
         return 0;
     }
-    n_inputs = ((size_t) (input[1] << 8)) + input[0];
-    if (n_inputs > SECP256K1_SURJECTIONPROOF_MAX_N_INPUTS) {
+    *n_inputs = ((size_t) (input[1] << 8)) + input[0];
+    if (*n_inputs > SECP256K1_SURJECTIONPROOF_MAX_N_INPUTS) {
         return 0;
     }
-    if (inputlen < 2 + (n_inputs + 7) / 8) {
+    if (inputlen < 2 + (*n_inputs + 7) / 8) {
         return 0;
     }
 
     /* Check that the bitvector of used inputs is of the claimed
      * length; i.e. the final byte has no "padding bits" set */
-    if (n_inputs % 8 != 0) {
-        const unsigned char padding_mask = (~0U) << (n_inputs % 8);
-        if ((input[2 + (n_inputs + 7) / 8 - 1] & padding_mask) != 0) {
+    if (*n_inputs % 8 != 0) {
+        const unsigned char padding_mask = (~0U) << (*n_inputs % 8);
+        if ((input[2 + (*n_inputs + 7) / 8 - 1] & padding_mask) != 0) {
             return 0;
         }
     }
 
-    signature_len = 32 * (1 + rustsecp256k1zkp_v0_5_0_count_bits_set(&input[2], (n_inputs + 7) / 8));
-    if (inputlen != 2 + (n_inputs + 7) / 8 + signature_len) {
+    signature_len = 32 * (1 + rustsecp256k1zkp_v0_5_0_count_bits_set(&input[2], (*n_inputs + 7) / 8));
+    return inputlen == 2 + (*n_inputs + 7) / 8 + signature_len;
+}
+
+#ifdef USE_REDUCED_SURJECTION_PROOF_SIZE
+static
+#endif
+int rustsecp256k1zkp_v0_5_0_surjectionproof_parse(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_surjectionproof *proof, const unsigned char *input, size_t inputlen) {
+    size_t n_inputs;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(proof != NULL);
+    ARG_CHECK(input != NULL);
+    (void) ctx;
+
+    if (!rustsecp256k1zkp_v0_5_0_surjectionproof_check_serialization(&n_inputs, input, inputlen)) {
         return 0;
     }
     proof->n_inputs = n_inputs;
     memcpy(proof->used_inputs, &input[2], (n_inputs + 7) / 8);
-    memcpy(proof->data, &input[2 + (n_inputs + 7) / 8], signature_len);
+    memcpy(proof->data, &input[2 + (n_inputs + 7) / 8], inputlen - 2 - (n_inputs + 7) / 8);
 
     return 1;
 }
@@ -229,6 +236,141 @@ int rustsecp256k1zkp_v0_5_0_surjectionproof_initialize(const rustsecp256k1zkp_v0
     }
 }
 
+/* Sets row[j] to the binomial coefficient (n choose j) for all j <= k by walking down Pascal's
+ * triangle. Binomial coefficients of at most SECP256K1_SURJECTIONPROOF_MAX_N_INPUTS elements are
+ * smaller than 2^252, so scalars hold them, and all sums and products used below, exactly. */
+static void rustsecp256k1zkp_v0_5_0_surjectionproof_binomials(rustsecp256k1zkp_v0_5_0_scalar *row, size_t n, size_t k) {
+    size_t i;
+    size_t j;
+    rustsecp256k1zkp_v0_5_0_scalar_set_int(&row[0], 1);
+    for (j = 1; j <= k; j++) {
+        rustsecp256k1zkp_v0_5_0_scalar_clear(&row[j]);
+    }
+    for (i = 1; i <= n; i++) {
+        for (j = i < k ? i : k; j > 0; j--) {
+            rustsecp256k1zkp_v0_5_0_scalar_add(&row[j], &row[j], &row[j - 1]);
+        }
+    }
+}
+
+/* Draws a uniformly random integer below the nonzero integer `bound`. */
+static void rustsecp256k1zkp_v0_5_0_surjectionproof_csprng_below(rustsecp256k1zkp_v0_5_0_surjectionproof_csprng *csprng, unsigned char *r32, const unsigned char *bound32) {
+    size_t top = 0;
+    unsigned char mask = 0xff;
+    size_t i;
+
+    while (bound32[top] == 0) {
+        top++;
+    }
+    while ((mask >> 1) >= bound32[top]) {
+        mask >>= 1;
+    }
+    do {
+        memset(r32, 0, top);
+        for (i = top; i < 32; i++) {
+            r32[i] = rustsecp256k1zkp_v0_5_0_surjectionproof_csprng_next(csprng, 256);
+        }
+        r32[top] &= mask;
+    } while (memcmp(r32, bound32, 32) >= 0);
+}
+
+/* Marks `n_select` uniformly random entries of `indices` as used, in a random order. */
+static void rustsecp256k1zkp_v0_5_0_surjectionproof_select(rustsecp256k1zkp_v0_5_0_surjectionproof *proof, rustsecp256k1zkp_v0_5_0_surjectionproof_csprng *csprng, size_t *indices, size_t n_indices, size_t n_select) {
+    size_t i;
+    for (i = 0; i < n_select; i++) {
+        size_t j = i + rustsecp256k1zkp_v0_5_0_surjectionproof_csprng_next(csprng, n_indices - i);
+        size_t tmp = indices[i];
+        indices[i] = indices[j];
+        indices[j] = tmp;
+        proof->used_inputs[indices[i] / 8] |= (1 << (indices[i] % 8));
+    }
+}
+
+int rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_surjectionproof* proof, size_t *input_index, const rustsecp256k1zkp_v0_5_0_fixed_asset_tag* fixed_input_tags, const size_t n_input_tags, const size_t n_input_tags_to_use, const rustsecp256k1zkp_v0_5_0_fixed_asset_tag* fixed_output_tag, const unsigned char *random_seed32) {
+    rustsecp256k1zkp_v0_5_0_surjectionproof_csprng csprng;
+    /* Indices of inputs matching the output tag, and of all other inputs */
+    size_t matching[SECP256K1_SURJECTIONPROOF_MAX_N_INPUTS];
+    size_t others[SECP256K1_SURJECTIONPROOF_MAX_N_INPUTS];
+    size_t n_matching = 0;
+    size_t n_others = 0;
+    rustsecp256k1zkp_v0_5_0_scalar binom_matching[SECP256K1_SURJECTIONPROOF_MAX_USED_INPUTS + 1];
+    rustsecp256k1zkp_v0_5_0_scalar binom_others[SECP256K1_SURJECTIONPROOF_MAX_USED_INPUTS + 1];
+    rustsecp256k1zkp_v0_5_0_scalar weight;
+    rustsecp256k1zkp_v0_5_0_scalar total;
+    unsigned char weight32[32];
+    unsigned char total32[32];
+    unsigned char r32[32];
+    size_t n_used_matching;
+    size_t i;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(proof != NULL);
+    ARG_CHECK(input_index != NULL);
+    ARG_CHECK(fixed_input_tags != NULL);
+    ARG_CHECK(fixed_output_tag != NULL);
+    ARG_CHECK(random_seed32 != NULL);
+    ARG_CHECK(n_input_tags <= SECP256K1_SURJECTIONPROOF_MAX_N_INPUTS);
+    ARG_CHECK(n_input_tags_to_use <= SECP256K1_SURJECTIONPROOF_MAX_USED_INPUTS);
+    ARG_CHECK(n_input_tags_to_use <= n_input_tags);
+    (void) ctx;
+
+    rustsecp256k1zkp_v0_5_0_surjectionproof_csprng_init(&csprng, random_seed32);
+    memset(proof->data, 0, sizeof(proof->data));
+    memset(proof->used_inputs, 0, sizeof(proof->used_inputs));
+    proof->n_inputs = n_input_tags;
+#ifdef VERIFY
+    proof->initialized = 0;
+#endif
+
+    for (i = 0; i < n_input_tags; i++) {
+        if (memcmp(&fixed_input_tags[i], fixed_output_tag, sizeof(*fixed_output_tag)) == 0) {
+            matching[n_matching++] = i;
+        } else {
+            others[n_others++] = i;
+        }
+    }
+    if (n_matching == 0 || n_input_tags_to_use == 0) {
+        return 0;
+    }
+
+    /* Among the sets of n_input_tags_to_use inputs, exactly
+     * (n_matching choose j) * (n_others choose n_input_tags_to_use - j) contain j matching
+     * inputs. Draw j with probability proportional to that count, for j >= 1, and then draw
+     * the matching and other inputs uniformly. This results in the same uniform distribution
+     * over all sets with at least one matching input that retrying random sets would. */
+    rustsecp256k1zkp_v0_5_0_surjectionproof_binomials(binom_matching, n_matching, n_input_tags_to_use);
+    rustsecp256k1zkp_v0_5_0_surjectionproof_binomials(binom_others, n_others, n_input_tags_to_use);
+    rustsecp256k1zkp_v0_5_0_scalar_clear(&total);
+    for (i = 1; i <= n_input_tags_to_use; i++) {
+        rustsecp256k1zkp_v0_5_0_scalar_mul(&weight, &binom_matching[i], &binom_others[n_input_tags_to_use - i]);
+        rustsecp256k1zkp_v0_5_0_scalar_add(&total, &total, &weight);
+    }
+    rustsecp256k1zkp_v0_5_0_scalar_get_b32(total32, &total);
+    rustsecp256k1zkp_v0_5_0_surjectionproof_csprng_below(&csprng, r32, total32);
+    rustsecp256k1zkp_v0_5_0_scalar_set_b32(&total, r32, NULL);
+    for (n_used_matching = 1; ; n_used_matching++) {
+        rustsecp256k1zkp_v0_5_0_scalar_mul(&weight, &binom_matching[n_used_matching], &binom_others[n_input_tags_to_use - n_used_matching]);
+        rustsecp256k1zkp_v0_5_0_scalar_get_b32(weight32, &weight);
+        rustsecp256k1zkp_v0_5_0_scalar_get_b32(r32, &total);
+        if (memcmp(r32, weight32, 32) < 0) {
+            break;
+        }
+        rustsecp256k1zkp_v0_5_0_scalar_negate(&weight, &weight);
+        rustsecp256k1zkp_v0_5_0_scalar_add(&total, &total, &weight);
+    }
+    VERIFY_CHECK(n_used_matching <= n_matching);
+    VERIFY_CHECK(n_input_tags_to_use - n_used_matching <= n_others);
+
+    rustsecp256k1zkp_v0_5_0_surjectionproof_select(proof, &csprng, matching, n_matching, n_used_matching);
+    rustsecp256k1zkp_v0_5_0_surjectionproof_select(proof, &csprng, others, n_others, n_input_tags_to_use - n_used_matching);
+    /* The first matching input was drawn uniformly among the selected matching inputs */
+    *input_index = matching[0];
+#ifdef VERIFY
+    proof->initialized = 1;
+#endif
+    return 1;
+}
+
 int rustsecp256k1zkp_v0_5_0_surjectionproof_generate(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_surjectionproof* proof, const rustsecp256k1zkp_v0_5_0_generator* ephemeral_input_tags, size_t n_ephemeral_input_tags, const rustsecp256k1zkp_v0_5_0_generator* ephemeral_output_tag, size_t input_index, const unsigned char *input_blinding_key, const unsigned char *output_blinding_key) {
     rustsecp256k1zkp_v0_5_0_scalar blinding_key;
     rustsecp256k1zkp_v0_5_0_scalar tmps;
@@ -305,10 +447,9 @@ int rustsecp256k1zkp_v0_5_0_surjectionproof_generate(const rustsecp256k1zkp_v0_5
     return 1;
 }
 
-#ifdef USE_REDUCED_SURJECTION_PROOF_SIZE
-static
-#endif
-int rustsecp256k1zkp_v0_5_0_surjectionproof_verify(const rustsecp256k1zkp_v0_5_0_context* ctx, const rustsecp256k1zkp_v0_5_0_surjectionproof* proof, const rustsecp256k1zkp_v0_5_0_generator* ephemeral_input_tags, size_t n_ephemeral_input_tags, const rustsecp256k1zkp_v0_5_0_generator* ephemeral_output_tag) {
+/* Verifies a proof over n_inputs inputs, given its bitmap of used inputs and its Borromean
+ * signature (e0 followed by one s value per used input), both in serialized form. */
+static int rustsecp256k1zkp_v0_5_0_surjectionproof_verify_impl(const rustsecp256k1zkp_v0_5_0_context* ctx, size_t n_inputs, const unsigned char *used_inputs, const unsigned char *data, const rustsecp256k1zkp_v0_5_0_generator* ephemeral_input_tags, size_t n_ephemeral_input_tags, const rustsecp256k1zkp_v0_5_0_generator* ephemeral_output_tag) {
     size_t rsizes[1];    /* array needed for borromean sig API */
     size_t i;
     size_t n_total_pubkeys;
@@ -317,15 +458,9 @@ int rustsecp256k1zkp_v0_5_0_surjectionproof_verify(const rustsecp256k1zkp_v0_5_0
     rustsecp256k1zkp_v0_5_0_scalar borromean_s[SECP256K1_SURJECTIONPROOF_MAX_USED_INPUTS];
     unsigned char msg32[32];
 
-    VERIFY_CHECK(ctx != NULL);
-    ARG_CHECK(rustsecp256k1zkp_v0_5_0_ecmult_context_is_built(&ctx->ecmult_ctx));
-    ARG_CHECK(proof != NULL);
-    ARG_CHECK(ephemeral_input_tags != NULL);
-    ARG_CHECK(ephemeral_output_tag != NULL);
-
     /* Compute public keys */
-    n_total_pubkeys = rustsecp256k1zkp_v0_5_0_surjectionproof_n_total_inputs(ctx, proof);
-    n_used_pubkeys = rustsecp256k1zkp_v0_5_0_surjectionproof_n_used_inputs(ctx, proof);
+    n_total_pubkeys = n_inputs;
+    n_used_pubkeys = rustsecp256k1zkp_v0_5_0_count_bits_set(used_inputs, (n_inputs + 7) / 8);
     if (n_used_pubkeys == 0 || n_used_pubkeys > n_total_pubkeys || n_total_pubkeys != n_ephemeral_input_tags) {
         return 0;
     }
@@ -335,7 +470,7 @@ int rustsecp256k1zkp_v0_5_0_surjectionproof_verify(const rustsecp256k1zkp_v0_5_0
         return 0;
     }
 
-    if (rustsecp256k1zkp_v0_5_0_surjection_compute_public_keys(ring_pubkeys, n_used_pubkeys, ephemeral_input_tags, n_total_pubkeys, proof->used_inputs, ephemeral_output_tag, 0, NULL) == 0) {
+    if (rustsecp256k1zkp_v0_5_0_surjection_compute_public_keys(ring_pubkeys, n_used_pubkeys, ephemeral_input_tags, n_total_pubkeys, used_inputs, ephemeral_output_tag, 0, NULL) == 0) {
         return 0;
     }
 
@@ -343,13 +478,44 @@ int rustsecp256k1zkp_v0_5_0_surjectionproof_verify(const rustsecp256k1zkp_v0_5_0
     rsizes[0] = (int) n_used_pubkeys;
     for (i = 0; i < n_used_pubkeys; i++) {
         int overflow = 0;
-        rustsecp256k1zkp_v0_5_0_scalar_set_b32(&borromean_s[i], &proof->data[32 + 32 * i], &overflow);
+        rustsecp256k1zkp_v0_5_0_scalar_set_b32(&borromean_s[i], &data[32 + 32 * i], &overflow);
         if (overflow == 1) {
             return 0;
         }
     }
     rustsecp256k1zkp_v0_5_0_surjection_genmessage(msg32, ephemeral_input_tags, n_total_pubkeys, ephemeral_output_tag);
-    return rustsecp256k1zkp_v0_5_0_borromean_verify(&ctx->ecmult_ctx, NULL, &proof->data[0], borromean_s, ring_pubkeys, rsizes, 1, msg32, 32);
+    return rustsecp256k1zkp_v0_5_0_borromean_verify(&ctx->ecmult_ctx, NULL, &data[0], borromean_s, ring_pubkeys, rsizes, 1, msg32, 32);
+}
+
+#ifdef USE_REDUCED_SURJECTION_PROOF_SIZE
+static
+#endif
+int rustsecp256k1zkp_v0_5_0_surjectionproof_verify(const rustsecp256k1zkp_v0_5_0_context* ctx, const rustsecp256k1zkp_v0_5_0_surjectionproof* proof, const rustsecp256k1zkp_v0_5_0_generator* ephemeral_input_tags, size_t n_ephemeral_input_tags, const rustsecp256k1zkp_v0_5_0_generator* ephemeral_output_tag) {
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(rustsecp256k1zkp_v0_5_0_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(proof != NULL);
+    ARG_CHECK(ephemeral_input_tags != NULL);
+    ARG_CHECK(ephemeral_output_tag != NULL);
+
+    return rustsecp256k1zkp_v0_5_0_surjectionproof_verify_impl(ctx, proof->n_inputs, proof->used_inputs, proof->data, ephemeral_input_tags, n_ephemeral_input_tags, ephemeral_output_tag);
+}
+
+#ifdef USE_REDUCED_SURJECTION_PROOF_SIZE
+static
+#endif
+int rustsecp256k1zkp_v0_5_0_surjectionproof_verify_serialized(const rustsecp256k1zkp_v0_5_0_context* ctx, const unsigned char *input, size_t inputlen, const rustsecp256k1zkp_v0_5_0_generator* ephemeral_input_tags, size_t n_ephemeral_input_tags, const rustsecp256k1zkp_v0_5_0_generator* ephemeral_output_tag) {
+    size_t n_inputs;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(rustsecp256k1zkp_v0_5_0_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(input != NULL);
+    ARG_CHECK(ephemeral_input_tags != NULL);
+    ARG_CHECK(ephemeral_output_tag != NULL);
+
+    if (!rustsecp256k1zkp_v0_5_0_surjectionproof_check_serialization(&n_inputs, input, inputlen)) {
+        return 0;
+    }
+    return rustsecp256k1zkp_v0_5_0_surjectionproof_verify_impl(ctx, n_inputs, &input[2], &input[2 + (n_inputs + 7) / 8], ephemeral_input_tags, n_ephemeral_input_tags, ephemeral_output_tag);
 }
 
 #endif
@@ -117,6 +117,29 @@ static void test_surjectionproof_api(void) {
     CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize(none, &proof, &input_index, fixed_input_tags, n_inputs, 0, &fixed_input_tags[0], 100, NULL) == 0);
     CHECK(ecount == 7);
 
+    /* check initialize_direct */
+    ecount = 0;
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(none, &proof, &input_index, fixed_input_tags, n_inputs, 0, &fixed_input_tags[0], seed) == 0);
+    CHECK(ecount == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(none, &proof, &input_index, fixed_input_tags, n_inputs, 3, &fixed_input_tags[0], seed) == 1);
+    CHECK(ecount == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(none, NULL, &input_index, fixed_input_tags, n_inputs, 3, &fixed_input_tags[0], seed) == 0);
+    CHECK(ecount == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(none, &proof, NULL, fixed_input_tags, n_inputs, 3, &fixed_input_tags[0], seed) == 0);
+    CHECK(ecount == 2);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(none, &proof, &input_index, NULL, n_inputs, 3, &fixed_input_tags[0], seed) == 0);
+    CHECK(ecount == 3);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(none, &proof, &input_index, fixed_input_tags, SECP256K1_SURJECTIONPROOF_MAX_N_INPUTS + 1, 3, &fixed_input_tags[0], seed) == 0);
+    CHECK(ecount == 4);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(none, &proof, &input_index, fixed_input_tags, n_inputs, n_inputs, &fixed_input_tags[0], seed) == 1);
+    CHECK(ecount == 4);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(none, &proof, &input_index, fixed_input_tags, n_inputs, n_inputs + 1, &fixed_input_tags[0], seed) == 0);
+    CHECK(ecount == 5);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(none, &proof, &input_index, fixed_input_tags, n_inputs, 3, NULL, seed) == 0);
+    CHECK(ecount == 6);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(none, &proof, &input_index, fixed_input_tags, n_inputs, 3, &fixed_input_tags[0], NULL) == 0);
+    CHECK(ecount == 7);
+
     CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize(none, &proof, &input_index, fixed_input_tags, n_inputs, 3, &fixed_input_tags[0], 100, seed) != 0);
     /* check generate */
     CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_generate(none, &proof, ephemeral_input_tags, n_inputs, &ephemeral_output_tag, 0, input_blinding_key[0], output_blinding_key) == 0);
@@ -196,6 +219,22 @@ static void test_surjectionproof_api(void) {
     CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_parse(none, &proof, serialized_proof, 0) == 0);
     CHECK(ecount == 25);
 
+    /* Check verify_serialized */
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_verify_serialized(none, serialized_proof, serialized_len, ephemeral_input_tags, n_inputs, &ephemeral_output_tag) == 0);
+    CHECK(ecount == 26);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_verify_serialized(vrfy, serialized_proof, serialized_len, ephemeral_input_tags, n_inputs, &ephemeral_output_tag) != 0);
+    CHECK(ecount == 26);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_verify_serialized(vrfy, NULL, serialized_len, ephemeral_input_tags, n_inputs, &ephemeral_output_tag) == 0);
+    CHECK(ecount == 27);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_verify_serialized(vrfy, serialized_proof, serialized_len - 1, ephemeral_input_tags, n_inputs, &ephemeral_output_tag) == 0);
+    CHECK(ecount == 27);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_verify_serialized(vrfy, serialized_proof, serialized_len, NULL, n_inputs, &ephemeral_output_tag) == 0);
+    CHECK(ecount == 28);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_verify_serialized(vrfy, serialized_proof, serialized_len, ephemeral_input_tags, n_inputs - 1, &ephemeral_output_tag) == 0);
+    CHECK(ecount == 28);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_verify_serialized(vrfy, serialized_proof, serialized_len, ephemeral_input_tags, n_inputs, NULL) == 0);
+    CHECK(ecount == 29);
+
     rustsecp256k1zkp_v0_5_0_context_destroy(none);
     rustsecp256k1zkp_v0_5_0_context_destroy(sign);
     rustsecp256k1zkp_v0_5_0_context_destroy(vrfy);
@@ -268,9 +307,60 @@ static void test_input_selection(size_t n_inputs) {
     }
 }
 
-/** Runs surjectionproof_initilize multiple times and records the number of times each input was used.
+static void test_input_selection_direct(size_t n_inputs) {
+    unsigned char seed[32];
+    size_t i;
+    size_t input_index;
+    rustsecp256k1zkp_v0_5_0_surjectionproof proof;
+    rustsecp256k1zkp_v0_5_0_fixed_asset_tag fixed_input_tags[1000];
+    const size_t max_n_inputs = sizeof(fixed_input_tags) / sizeof(fixed_input_tags[0]) - 1;
+
+    CHECK(n_inputs < max_n_inputs);
+    rustsecp256k1zkp_v0_5_0_testrand256(seed);
+
+    for (i = 0; i < n_inputs + 1; i++) {
+        rustsecp256k1zkp_v0_5_0_testrand256(fixed_input_tags[i].data);
+    }
+
+    /* cannot match output when told to use zero keys */
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(ctx, &proof, &input_index, fixed_input_tags, n_inputs, 0, &fixed_input_tags[0], seed) == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_n_used_inputs(ctx, &proof) == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_n_total_inputs(ctx, &proof) == n_inputs);
+    if (n_inputs > 0) {
+        CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(ctx, &proof, &input_index, fixed_input_tags, n_inputs, 1, &fixed_input_tags[0], seed) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_n_used_inputs(ctx, &proof) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_n_total_inputs(ctx, &proof) == n_inputs);
+        CHECK(input_index == 0);
+    }
+
+    if (n_inputs >= 3) {
+        CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(ctx, &proof, &input_index, fixed_input_tags, n_inputs, 3, &fixed_input_tags[1], seed) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_n_used_inputs(ctx, &proof) == 3);
+        CHECK(proof.used_inputs[0] & 2);
+        CHECK(input_index == 1);
+
+        /* fail, key not found */
+        CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(ctx, &proof, &input_index, fixed_input_tags, n_inputs, 3, &fixed_input_tags[n_inputs], seed) == 0);
+
+        CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(ctx, &proof, &input_index, fixed_input_tags, n_inputs, n_inputs, &fixed_input_tags[0], seed) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_n_used_inputs(ctx, &proof) == n_inputs);
+        CHECK(input_index == 0);
+
+        /* the same selection succeeds when every input matches the output */
+        for (i = 1; i < n_inputs; i++) {
+            memcpy(&fixed_input_tags[i], &fixed_input_tags[0], sizeof(fixed_input_tags[i]));
+        }
+        CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(ctx, &proof, &input_index, fixed_input_tags, n_inputs, n_inputs / 2, &fixed_input_tags[0], seed) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_n_used_inputs(ctx, &proof) == n_inputs / 2);
+        CHECK(input_index < n_inputs);
+        CHECK(proof.used_inputs[input_index / 8] & (1 << (input_index % 8)));
+    }
+}
+
+/** Runs surjectionproof_initilize (or surjectionproof_initialize_direct) multiple times and
+ * records the number of times each input was used.
  */
-static void test_input_selection_distribution_helper(const rustsecp256k1zkp_v0_5_0_fixed_asset_tag* fixed_input_tags, const size_t n_input_tags, const size_t n_input_tags_to_use, size_t *used_inputs) {
+static void test_input_selection_distribution_helper(const rustsecp256k1zkp_v0_5_0_fixed_asset_tag* fixed_input_tags, const size_t n_input_tags, const size_t n_input_tags_to_use, size_t *used_inputs, int direct) {
     rustsecp256k1zkp_v0_5_0_surjectionproof proof;
     size_t input_index;
     size_t i;
@@ -282,8 +372,14 @@ static void test_input_selection_distribution_helper(const rustsecp256k1zkp_v0_5
     }
     for(j = 0; j < 10000; j++) {
         rustsecp256k1zkp_v0_5_0_testrand256(seed);
-        result = rustsecp256k1zkp_v0_5_0_surjectionproof_initialize(ctx, &proof, &input_index, fixed_input_tags, n_input_tags, n_input_tags_to_use, &fixed_input_tags[0], 64, seed);
+        if (direct) {
+            result = rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct(ctx, &proof, &input_index, fixed_input_tags, n_input_tags, n_input_tags_to_use, &fixed_input_tags[0], seed);
+        } else {
+            result = rustsecp256k1zkp_v0_5_0_surjectionproof_initialize(ctx, &proof, &input_index, fixed_input_tags, n_input_tags, n_input_tags_to_use, &fixed_input_tags[0], 64, seed);
+        }
         CHECK(result > 0);
+        CHECK(memcmp(&fixed_input_tags[input_index], &fixed_input_tags[0], sizeof(fixed_input_tags[0])) == 0);
+        CHECK(proof.used_inputs[input_index / 8] & (1 << (input_index % 8)));
 
         for (i = 0; i < n_input_tags; i++) {
             if (proof.used_inputs[i / 8] & (1 << (i % 8))) {
@@ -293,10 +389,11 @@ static void test_input_selection_distribution_helper(const rustsecp256k1zkp_v0_5
     }
 }
 
-/** Probabilistic test of the distribution of used_inputs after surjectionproof_initialize.
+/** Probabilistic test of the distribution of used_inputs after surjectionproof_initialize, or
+ * surjectionproof_initialize_direct if `direct` is set.
  * Each confidence interval assertion fails incorrectly with a probability of 2^-128.
  */
-static void test_input_selection_distribution(void) {
+static void test_input_selection_distribution(int direct) {
     size_t i;
     size_t n_input_tags_to_use;
     const size_t n_inputs = 4;
@@ -309,7 +406,7 @@ static void test_input_selection_distribution(void) {
 
     /* If there is one input tag to use, initialize must choose the one equal to fixed_output_tag. */
     n_input_tags_to_use = 1;
-    test_input_selection_distribution_helper(fixed_input_tags, n_inputs, n_input_tags_to_use, used_inputs);
+    test_input_selection_distribution_helper(fixed_input_tags, n_inputs, n_input_tags_to_use, used_inputs, direct);
     CHECK(used_inputs[0] == 10000);
     CHECK(used_inputs[1] == 0);
     CHECK(used_inputs[2] == 0);
@@ -320,7 +417,7 @@ static void test_input_selection_distribution(void) {
      * For each fixed_input_tag != fixed_output_tag the probability that it's included
      * in the used_inputs set is P(used_input|not fixed_output_tag) = 1/3.
      */
-    test_input_selection_distribution_helper(fixed_input_tags, n_inputs, n_input_tags_to_use, used_inputs);
+    test_input_selection_distribution_helper(fixed_input_tags, n_inputs, n_input_tags_to_use, used_inputs, direct);
     CHECK(used_inputs[0] == 10000);
     CHECK(used_inputs[1] > 2725 && used_inputs[1] < 3961);
     CHECK(used_inputs[2] > 2725 && used_inputs[2] < 3961);
@@ -328,7 +425,7 @@ static void test_input_selection_distribution(void) {
 
     n_input_tags_to_use = 3;
     /* P(used_input|not fixed_output_tag) = 2/3 */
-    test_input_selection_distribution_helper(fixed_input_tags, n_inputs, n_input_tags_to_use, used_inputs);
+    test_input_selection_distribution_helper(fixed_input_tags, n_inputs, n_input_tags_to_use, used_inputs, direct);
     CHECK(used_inputs[0] == 10000);
     CHECK(used_inputs[1] > 6039 && used_inputs[1] < 7275);
     CHECK(used_inputs[2] > 6039 && used_inputs[2] < 7275);
@@ -340,7 +437,7 @@ static void test_input_selection_distribution(void) {
      * one input we have P(used_input|fixed_output_tag) = 1/2 and P(used_input|not fixed_output_tag) = 0
      */
     memcpy(fixed_input_tags[0].data, fixed_input_tags[1].data, 32);
-    test_input_selection_distribution_helper(fixed_input_tags, n_inputs, n_input_tags_to_use, used_inputs);
+    test_input_selection_distribution_helper(fixed_input_tags, n_inputs, n_input_tags_to_use, used_inputs, direct);
     CHECK(used_inputs[0] > 4345 && used_inputs[0] < 5655);
     CHECK(used_inputs[1] > 4345 && used_inputs[1] < 5655);
     CHECK(used_inputs[2] == 0);
@@ -351,7 +448,7 @@ static void test_input_selection_distribution(void) {
      * input indexes {(0, 1), (1, 2), (0, 3), (1, 3), (0, 2)}. Therefore we have
      * P(used_input|fixed_output_tag) = 3/5 and P(used_input|not fixed_output_tag) = 2/5.
      */
-    test_input_selection_distribution_helper(fixed_input_tags, n_inputs, n_input_tags_to_use, used_inputs);
+    test_input_selection_distribution_helper(fixed_input_tags, n_inputs, n_input_tags_to_use, used_inputs, direct);
     CHECK(used_inputs[0] > 5352 && used_inputs[0] < 6637);
     CHECK(used_inputs[1] > 5352 && used_inputs[1] < 6637);
     CHECK(used_inputs[2] > 3363 && used_inputs[2] < 4648);
@@ -361,7 +458,7 @@ static void test_input_selection_distribution(void) {
     /* There are 4 combinations, each with all inputs except one. Therefore we have
      * P(used_input|fixed_output_tag) = 3/4 and P(used_input|not fixed_output_tag) = 3/4.
      */
-    test_input_selection_distribution_helper(fixed_input_tags, n_inputs, n_input_tags_to_use, used_inputs);
+    test_input_selection_distribution_helper(fixed_input_tags, n_inputs, n_input_tags_to_use, used_inputs, direct);
     CHECK(used_inputs[0] > 6918 && used_inputs[0] < 8053);
     CHECK(used_inputs[1] > 6918 && used_inputs[1] < 8053);
     CHECK(used_inputs[2] > 6918 && used_inputs[2] < 8053);
@@ -423,10 +520,19 @@ static void test_gen_verify(size_t n_inputs, size_t n_used) {
     memcpy(&serialized_proof_trailing, &serialized_proof, serialized_len);
     serialized_proof_trailing[serialized_len] = seed[0];
     CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_parse(ctx, &proof, serialized_proof_trailing, serialized_len + 1) == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_verify_serialized(ctx, serialized_proof_trailing, serialized_len + 1, ephemeral_input_tags, n_inputs, &ephemeral_input_tags[n_inputs]) == 0);
 
     CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_parse(ctx, &proof, serialized_proof, serialized_len));
     result = rustsecp256k1zkp_v0_5_0_surjectionproof_verify(ctx, &proof, ephemeral_input_tags, n_inputs, &ephemeral_input_tags[n_inputs]);
     CHECK(result == 1);
+    result = rustsecp256k1zkp_v0_5_0_surjectionproof_verify_serialized(ctx, serialized_proof, serialized_len, ephemeral_input_tags, n_inputs, &ephemeral_input_tags[n_inputs]);
+    CHECK(result == 1);
+
+    /* flip a bit of the signature */
+    serialized_proof[serialized_len - 1] ^= 1;
+    result = rustsecp256k1zkp_v0_5_0_surjectionproof_verify_serialized(ctx, serialized_proof, serialized_len, ephemeral_input_tags, n_inputs, &ephemeral_input_tags[n_inputs]);
+    CHECK(result == 0);
+    serialized_proof[serialized_len - 1] ^= 1;
 
     /* various fail cases */
     if (n_inputs > 1) {
@@ -518,6 +624,10 @@ void test_bad_parse(void) {
     CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_parse(ctx, &proof, serialized_proof1, sizeof(serialized_proof1)) == 0);
     /* Missing e0 value */
     CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_parse(ctx, &proof, serialized_proof2, sizeof(serialized_proof2)) == 0);
+
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_verify_serialized(ctx, serialized_proof0, sizeof(serialized_proof0), rustsecp256k1zkp_v0_5_0_generator_h, 1, rustsecp256k1zkp_v0_5_0_generator_h) == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_verify_serialized(ctx, serialized_proof1, sizeof(serialized_proof1), rustsecp256k1zkp_v0_5_0_generator_h, 1, rustsecp256k1zkp_v0_5_0_generator_h) == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_surjectionproof_verify_serialized(ctx, serialized_proof2, sizeof(serialized_proof2), rustsecp256k1zkp_v0_5_0_generator_h, 1, rustsecp256k1zkp_v0_5_0_generator_h) == 0);
 }
 
 void test_fixed_vectors(void) {
@@ -675,7 +785,13 @@ void run_surjection_tests(void) {
     test_input_selection(5);
     test_input_selection(SECP256K1_SURJECTIONPROOF_MAX_USED_INPUTS);
 
-    test_input_selection_distribution();
+    test_input_selection_direct(0);
+    test_input_selection_direct(1);
+    test_input_selection_direct(5);
+    test_input_selection_direct(SECP256K1_SURJECTIONPROOF_MAX_USED_INPUTS);
+
+    test_input_selection_distribution(0);
+    test_input_selection_distribution(1);
     test_gen_verify(10, 3);
     test_gen_verify(SECP256K1_SURJECTIONPROOF_MAX_N_INPUTS, SECP256K1_SURJECTIONPROOF_MAX_USED_INPUTS);
     test_no_used_inputs_verify();
@@ -13,7 +13,9 @@
 #define MAX_KEYS SECP256K1_WHITELIST_MAX_N_KEYS  /* shorter alias */
 
 int rustsecp256k1zkp_v0_5_0_whitelist_sign(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_whitelist_signature *sig, const rustsecp256k1zkp_v0_5_0_pubkey *online_pubkeys, const rustsecp256k1zkp_v0_5_0_pubkey *offline_pubkeys, const size_t n_keys, const rustsecp256k1zkp_v0_5_0_pubkey *sub_pubkey, const unsigned char *online_seckey, const unsigned char *summed_seckey, const size_t index, rustsecp256k1zkp_v0_5_0_nonce_function noncefp, const void *noncedata) {
-    rustsecp256k1zkp_v0_5_0_gej pubs[MAX_KEYS];
+    rustsecp256k1zkp_v0_5_0_ge online_ge[MAX_KEYS];
+    rustsecp256k1zkp_v0_5_0_ge summed_ge[MAX_KEYS];
+    rustsecp256k1zkp_v0_5_0_scalar tweaks[MAX_KEYS];
     rustsecp256k1zkp_v0_5_0_scalar s[MAX_KEYS];
     rustsecp256k1zkp_v0_5_0_scalar sec, non;
     unsigned char msg32[32];
@@ -36,8 +38,8 @@ int rustsecp256k1zkp_v0_5_0_whitelist_sign(const rustsecp256k1zkp_v0_5_0_context
     ARG_CHECK(summed_seckey != NULL);
     ARG_CHECK(index < n_keys);
 
-    /* Compute pubkeys: online_pubkey + tweaked(offline_pubkey + address), and message */
-    ret = rustsecp256k1zkp_v0_5_0_whitelist_compute_keys_and_message(ctx, msg32, pubs, online_pubkeys, offline_pubkeys, n_keys, sub_pubkey);
+    /* Compute ring keys: online_pubkey + tweaked(offline_pubkey + address), and message */
+    ret = rustsecp256k1zkp_v0_5_0_whitelist_compute_keys_and_message(ctx, msg32, online_ge, summed_ge, tweaks, online_pubkeys, offline_pubkeys, n_keys, sub_pubkey);
 
     /* Compute signing key: online_seckey + tweaked(summed_seckey) */
     if (ret) {
@@ -90,7 +92,7 @@ int rustsecp256k1zkp_v0_5_0_whitelist_sign(const rustsecp256k1zkp_v0_5_0_context
     /* Actually sign */
     if (ret) {
         sig->n_keys = n_keys;
-        ret = rustsecp256k1zkp_v0_5_0_borromean_sign(&ctx->ecmult_ctx, &ctx->ecmult_gen_ctx, &sig->data[0], s, pubs, &non, &sec, &n_keys, &index, 1, msg32, 32);
+        ret = rustsecp256k1zkp_v0_5_0_whitelist_ring_sign(&ctx->ecmult_ctx, &ctx->ecmult_gen_ctx, &sig->data[0], s, online_ge, summed_ge, tweaks, n_keys, &non, &sec, index, msg32);
         /* Signing will change s[index], so update in the sig structure */
         rustsecp256k1zkp_v0_5_0_scalar_get_b32(&sig->data[32 * (index + 1)], &s[index]);
     }
@@ -100,11 +102,25 @@ int rustsecp256k1zkp_v0_5_0_whitelist_sign(const rustsecp256k1zkp_v0_5_0_context
     return ret;
 }
 
+static int rustsecp256k1zkp_v0_5_0_whitelist_signature_load_s(rustsecp256k1zkp_v0_5_0_scalar *s, const rustsecp256k1zkp_v0_5_0_whitelist_signature *sig) {
+    size_t i;
+
+    for (i = 0; i < sig->n_keys; i++) {
+        int overflow = 0;
+        rustsecp256k1zkp_v0_5_0_scalar_set_b32(&s[i], &sig->data[32 * (i + 1)], &overflow);
+        if (overflow || rustsecp256k1zkp_v0_5_0_scalar_is_zero(&s[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
 int rustsecp256k1zkp_v0_5_0_whitelist_verify(const rustsecp256k1zkp_v0_5_0_context* ctx, const rustsecp256k1zkp_v0_5_0_whitelist_signature *sig, const rustsecp256k1zkp_v0_5_0_pubkey *online_pubkeys, const rustsecp256k1zkp_v0_5_0_pubkey *offline_pubkeys, const size_t n_keys, const rustsecp256k1zkp_v0_5_0_pubkey *sub_pubkey) {
     rustsecp256k1zkp_v0_5_0_scalar s[MAX_KEYS];
-    rustsecp256k1zkp_v0_5_0_gej pubs[MAX_KEYS];
+    rustsecp256k1zkp_v0_5_0_ge online_ge[MAX_KEYS];
+    rustsecp256k1zkp_v0_5_0_ge summed_ge[MAX_KEYS];
+    rustsecp256k1zkp_v0_5_0_scalar tweaks[MAX_KEYS];
     unsigned char msg32[32];
-    size_t i;
 
     VERIFY_CHECK(ctx != NULL);
     ARG_CHECK(rustsecp256k1zkp_v0_5_0_ecmult_context_is_built(&ctx->ecmult_ctx));
@@ -116,20 +132,63 @@ int rustsecp256k1zkp_v0_5_0_whitelist_verify(const rustsecp256k1zkp_v0_5_0_conte
     if (sig->n_keys > MAX_KEYS || sig->n_keys != n_keys) {
         return 0;
     }
-    for (i = 0; i < sig->n_keys; i++) {
-        int overflow = 0;
-        rustsecp256k1zkp_v0_5_0_scalar_set_b32(&s[i], &sig->data[32 * (i + 1)], &overflow);
-        if (overflow || rustsecp256k1zkp_v0_5_0_scalar_is_zero(&s[i])) {
+    if (!rustsecp256k1zkp_v0_5_0_whitelist_signature_load_s(s, sig)) {
+        return 0;
+    }
+
+    /* Compute ring keys: online_pubkey + tweaked(offline_pubkey + address), and message */
+    if (!rustsecp256k1zkp_v0_5_0_whitelist_compute_keys_and_message(ctx, msg32, online_ge, summed_ge, tweaks, online_pubkeys, offline_pubkeys, sig->n_keys, sub_pubkey)) {
+        return 0;
+    }
+    /* Do verification */
+    return rustsecp256k1zkp_v0_5_0_whitelist_ring_verify(&ctx->ecmult_ctx, &sig->data[0], s, online_ge, summed_ge, tweaks, sig->n_keys, msg32);
+}
+
+int rustsecp256k1zkp_v0_5_0_whitelist_keyset_create(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_whitelist_keyset *keyset, const rustsecp256k1zkp_v0_5_0_pubkey *online_pubkeys, const rustsecp256k1zkp_v0_5_0_pubkey *offline_pubkeys, const size_t n_keys) {
+    size_t i;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(keyset != NULL);
+    keyset->n_keys = 0;
+    ARG_CHECK(online_pubkeys != NULL);
+    ARG_CHECK(offline_pubkeys != NULL);
+    ARG_CHECK(n_keys <= MAX_KEYS);
+
+    for (i = 0; i < n_keys; i++) {
+        if (!rustsecp256k1zkp_v0_5_0_whitelist_keyset_entry_save(ctx, &keyset->data[WHITELIST_KEYSET_ENTRY_SIZE * i], &online_pubkeys[i], &offline_pubkeys[i])) {
             return 0;
         }
     }
+    keyset->n_keys = n_keys;
+    return 1;
+}
+
+int rustsecp256k1zkp_v0_5_0_whitelist_verify_keyset(const rustsecp256k1zkp_v0_5_0_context* ctx, const rustsecp256k1zkp_v0_5_0_whitelist_signature *sig, const rustsecp256k1zkp_v0_5_0_whitelist_keyset *keyset, const rustsecp256k1zkp_v0_5_0_pubkey *sub_pubkey) {
+    rustsecp256k1zkp_v0_5_0_scalar s[MAX_KEYS];
+    rustsecp256k1zkp_v0_5_0_ge online_ge[MAX_KEYS];
+    rustsecp256k1zkp_v0_5_0_ge summed_ge[MAX_KEYS];
+    rustsecp256k1zkp_v0_5_0_scalar tweaks[MAX_KEYS];
+    unsigned char msg32[32];
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(rustsecp256k1zkp_v0_5_0_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(sig != NULL);
+    ARG_CHECK(keyset != NULL);
+    ARG_CHECK(sub_pubkey != NULL);
+
+    if (sig->n_keys > MAX_KEYS || sig->n_keys != keyset->n_keys) {
+        return 0;
+    }
+    if (!rustsecp256k1zkp_v0_5_0_whitelist_signature_load_s(s, sig)) {
+        return 0;
+    }
 
-    /* Compute pubkeys: online_pubkey + tweaked(offline_pubkey + address), and message */
-    if (!rustsecp256k1zkp_v0_5_0_whitelist_compute_keys_and_message(ctx, msg32, pubs, online_pubkeys, offline_pubkeys, sig->n_keys, sub_pubkey)) {
+    /* Compute pubkeys from the cached keys and the sub-key, and message */
+    if (!rustsecp256k1zkp_v0_5_0_whitelist_compute_keys_and_message_keyset(ctx, msg32, online_ge, summed_ge, tweaks, keyset, sub_pubkey)) {
         return 0;
     }
     /* Do verification */
-    return rustsecp256k1zkp_v0_5_0_borromean_verify(&ctx->ecmult_ctx, NULL, &sig->data[0], s, pubs, &sig->n_keys, 1, msg32, 32);
+    return rustsecp256k1zkp_v0_5_0_whitelist_ring_verify(&ctx->ecmult_ctx, &sig->data[0], s, online_ge, summed_ge, tweaks, sig->n_keys, msg32);
 }
 
 size_t rustsecp256k1zkp_v0_5_0_whitelist_signature_n_keys(const rustsecp256k1zkp_v0_5_0_whitelist_signature *sig) {
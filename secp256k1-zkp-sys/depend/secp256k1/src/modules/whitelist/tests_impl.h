@@ -9,11 +9,51 @@
 
 #include "include/secp256k1_whitelist.h"
 
+/* Computes the ring keys and message of a whitelist signature the
+ * straightforward way, one tweak multiplication per key, for checking
+ * signatures with the generic Borromean verifier. */
+static void test_whitelist_reference_keys(unsigned char *msg32, rustsecp256k1zkp_v0_5_0_gej *pubs, const rustsecp256k1zkp_v0_5_0_pubkey *online_pubkeys, const rustsecp256k1zkp_v0_5_0_pubkey *offline_pubkeys, size_t n_keys, const rustsecp256k1zkp_v0_5_0_pubkey *sub_pubkey) {
+    unsigned char c[33];
+    size_t size = 33;
+    rustsecp256k1zkp_v0_5_0_sha256 sha;
+    rustsecp256k1zkp_v0_5_0_ge subkey_ge;
+    rustsecp256k1zkp_v0_5_0_scalar zero;
+    size_t i;
+
+    rustsecp256k1zkp_v0_5_0_scalar_set_int(&zero, 0);
+    rustsecp256k1zkp_v0_5_0_sha256_initialize(&sha);
+    CHECK(rustsecp256k1zkp_v0_5_0_pubkey_load(ctx, &subkey_ge, sub_pubkey));
+    CHECK(rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(&subkey_ge, c, &size, SECP256K1_EC_COMPRESSED));
+    rustsecp256k1zkp_v0_5_0_sha256_write(&sha, c, size);
+    for (i = 0; i < n_keys; i++) {
+        rustsecp256k1zkp_v0_5_0_ge offline_ge, online_ge, summed_ge;
+        rustsecp256k1zkp_v0_5_0_gej summed_gej;
+        rustsecp256k1zkp_v0_5_0_scalar tweak;
+
+        CHECK(rustsecp256k1zkp_v0_5_0_pubkey_load(ctx, &offline_ge, &offline_pubkeys[i]));
+        CHECK(rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(&offline_ge, c, &size, SECP256K1_EC_COMPRESSED));
+        rustsecp256k1zkp_v0_5_0_sha256_write(&sha, c, size);
+        CHECK(rustsecp256k1zkp_v0_5_0_pubkey_load(ctx, &online_ge, &online_pubkeys[i]));
+        CHECK(rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(&online_ge, c, &size, SECP256K1_EC_COMPRESSED));
+        rustsecp256k1zkp_v0_5_0_sha256_write(&sha, c, size);
+
+        rustsecp256k1zkp_v0_5_0_gej_set_ge(&summed_gej, &offline_ge);
+        rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&summed_gej, &summed_gej, &subkey_ge, NULL);
+        rustsecp256k1zkp_v0_5_0_ge_set_gej(&summed_ge, &summed_gej);
+        CHECK(rustsecp256k1zkp_v0_5_0_whitelist_hash_pubkey(&tweak, &summed_ge));
+        rustsecp256k1zkp_v0_5_0_ecmult(&ctx->ecmult_ctx, &summed_gej, &summed_gej, &tweak, &zero);
+        rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&pubs[i], &summed_gej, &online_ge, NULL);
+    }
+    rustsecp256k1zkp_v0_5_0_sha256_finalize(&sha, msg32);
+}
+
 void test_whitelist_end_to_end(const size_t n_keys) {
     unsigned char **online_seckey = (unsigned char **) malloc(n_keys * sizeof(*online_seckey));
     unsigned char **summed_seckey = (unsigned char **) malloc(n_keys * sizeof(*summed_seckey));
     rustsecp256k1zkp_v0_5_0_pubkey *online_pubkeys = (rustsecp256k1zkp_v0_5_0_pubkey *) malloc(n_keys * sizeof(*online_pubkeys));
     rustsecp256k1zkp_v0_5_0_pubkey *offline_pubkeys = (rustsecp256k1zkp_v0_5_0_pubkey *) malloc(n_keys * sizeof(*offline_pubkeys));
+    rustsecp256k1zkp_v0_5_0_whitelist_keyset *keyset = (rustsecp256k1zkp_v0_5_0_whitelist_keyset *) malloc(sizeof(*keyset));
+    rustsecp256k1zkp_v0_5_0_whitelist_keyset *swapped_keyset = (rustsecp256k1zkp_v0_5_0_whitelist_keyset *) malloc(sizeof(*swapped_keyset));
 
     rustsecp256k1zkp_v0_5_0_scalar ssub;
     unsigned char csub[32];
@@ -50,6 +90,9 @@ void test_whitelist_end_to_end(const size_t n_keys) {
         CHECK(rustsecp256k1zkp_v0_5_0_ec_seckey_verify(ctx, summed_seckey[i]) == 1);
     }
 
+    CHECK(rustsecp256k1zkp_v0_5_0_whitelist_keyset_create(ctx, keyset, online_pubkeys, offline_pubkeys, n_keys) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_whitelist_keyset_create(ctx, swapped_keyset, offline_pubkeys, online_pubkeys, n_keys) == 1);
+
     /* Sign/verify with each one */
     for (i = 0; i < n_keys; i++) {
         unsigned char serialized[32 + 4 + 32 * SECP256K1_WHITELIST_MAX_N_KEYS] = {0};
@@ -61,6 +104,23 @@ void test_whitelist_end_to_end(const size_t n_keys) {
         CHECK(rustsecp256k1zkp_v0_5_0_whitelist_verify(ctx, &sig, online_pubkeys, offline_pubkeys, n_keys, &sub_pubkey) == 1);
         /* Check that exchanging keys causes a failure */
         CHECK(rustsecp256k1zkp_v0_5_0_whitelist_verify(ctx, &sig, offline_pubkeys, online_pubkeys, n_keys, &sub_pubkey) != 1);
+        /* The signature is a Borromean ring signature over the tweaked keys */
+        {
+            rustsecp256k1zkp_v0_5_0_gej pubs[SECP256K1_WHITELIST_MAX_N_KEYS];
+            rustsecp256k1zkp_v0_5_0_scalar s[SECP256K1_WHITELIST_MAX_N_KEYS];
+            unsigned char msg32[32];
+            size_t j;
+
+            test_whitelist_reference_keys(msg32, pubs, online_pubkeys, offline_pubkeys, n_keys, &sub_pubkey);
+            for (j = 0; j < n_keys; j++) {
+                rustsecp256k1zkp_v0_5_0_scalar_set_b32(&s[j], &sig.data[32 * (j + 1)], NULL);
+            }
+            CHECK(rustsecp256k1zkp_v0_5_0_borromean_verify(&ctx->ecmult_ctx, NULL, &sig.data[0], s, pubs, &n_keys, 1, msg32, 32));
+        }
+        /* Same with precomputed key sets */
+        CHECK(rustsecp256k1zkp_v0_5_0_whitelist_verify_keyset(ctx, &sig, keyset, &sub_pubkey) == 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_whitelist_verify_keyset(ctx, &sig, swapped_keyset, &sub_pubkey) != 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_whitelist_verify_keyset(ctx, &sig, keyset, &online_pubkeys[0]) != 1);
         /* Serialization round trip */
         CHECK(rustsecp256k1zkp_v0_5_0_whitelist_signature_serialize(ctx, serialized, &slen, &sig) == 1);
         CHECK(slen == 33 + 32 * n_keys);
@@ -80,6 +140,7 @@ void test_whitelist_end_to_end(const size_t n_keys) {
         /* Test bad number of keys in signature */
         sig.n_keys = n_keys + 1;
         CHECK(rustsecp256k1zkp_v0_5_0_whitelist_verify(ctx, &sig, offline_pubkeys, online_pubkeys, n_keys, &sub_pubkey) != 1);
+        CHECK(rustsecp256k1zkp_v0_5_0_whitelist_verify_keyset(ctx, &sig, keyset, &sub_pubkey) != 1);
         sig.n_keys = n_keys;
     }
 
@@ -91,6 +152,8 @@ void test_whitelist_end_to_end(const size_t n_keys) {
     free(summed_seckey);
     free(online_pubkeys);
     free(offline_pubkeys);
+    free(keyset);
+    free(swapped_keyset);
 }
 
 void test_whitelist_bad_parse(void) {
@@ -137,10 +200,63 @@ void test_whitelist_bad_serialize(void) {
     CHECK(rustsecp256k1zkp_v0_5_0_whitelist_signature_serialize(ctx, serialized, &serialized_len, &sig) == 0);
 }
 
+/* A ring key online_pubkey + tweak * (offline_pubkey + sub_pubkey) at infinity
+ * contributes nothing to its ring commitment, so anybody can sign for it. */
+void test_whitelist_infinite_key(void) {
+    rustsecp256k1zkp_v0_5_0_pubkey online_pubkey, offline_pubkey, sub_pubkey;
+    rustsecp256k1zkp_v0_5_0_whitelist_keyset *keyset = (rustsecp256k1zkp_v0_5_0_whitelist_keyset *) malloc(sizeof(*keyset));
+    rustsecp256k1zkp_v0_5_0_whitelist_signature sig;
+    rustsecp256k1zkp_v0_5_0_scalar sk, tweak;
+    rustsecp256k1zkp_v0_5_0_gej summed_gej, pubj;
+    rustsecp256k1zkp_v0_5_0_ge ge;
+    rustsecp256k1zkp_v0_5_0_sha256 sha;
+    unsigned char msg32[32];
+    unsigned char c[33];
+    size_t size = 33;
+
+    random_scalar_order_test(&sk);
+    rustsecp256k1zkp_v0_5_0_ecmult_gen(&ctx->ecmult_gen_ctx, &summed_gej, &sk);
+    rustsecp256k1zkp_v0_5_0_ge_set_gej(&ge, &summed_gej);
+    rustsecp256k1zkp_v0_5_0_pubkey_save(&offline_pubkey, &ge);
+    random_scalar_order_test(&sk);
+    rustsecp256k1zkp_v0_5_0_ecmult_gen(&ctx->ecmult_gen_ctx, &pubj, &sk);
+    rustsecp256k1zkp_v0_5_0_ge_set_gej(&ge, &pubj);
+    rustsecp256k1zkp_v0_5_0_pubkey_save(&sub_pubkey, &ge);
+    rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&summed_gej, &summed_gej, &ge, NULL);
+
+    /* online_pubkey = -tweak * (offline_pubkey + sub_pubkey) */
+    rustsecp256k1zkp_v0_5_0_ge_set_gej(&ge, &summed_gej);
+    CHECK(rustsecp256k1zkp_v0_5_0_whitelist_hash_pubkey(&tweak, &ge));
+    rustsecp256k1zkp_v0_5_0_scalar_negate(&tweak, &tweak);
+    rustsecp256k1zkp_v0_5_0_ecmult(&ctx->ecmult_ctx, &pubj, &summed_gej, &tweak, NULL);
+    rustsecp256k1zkp_v0_5_0_ge_set_gej(&ge, &pubj);
+    rustsecp256k1zkp_v0_5_0_pubkey_save(&online_pubkey, &ge);
+    test_whitelist_reference_keys(msg32, &pubj, &online_pubkey, &offline_pubkey, 1, &sub_pubkey);
+    CHECK(rustsecp256k1zkp_v0_5_0_gej_is_infinity(&pubj));
+
+    /* Forge e0 = H(s*G || m) for a random s */
+    random_scalar_order_test(&sk);
+    rustsecp256k1zkp_v0_5_0_ecmult_gen(&ctx->ecmult_gen_ctx, &pubj, &sk);
+    rustsecp256k1zkp_v0_5_0_ge_set_gej(&ge, &pubj);
+    CHECK(rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(&ge, c, &size, SECP256K1_EC_COMPRESSED));
+    rustsecp256k1zkp_v0_5_0_sha256_initialize(&sha);
+    rustsecp256k1zkp_v0_5_0_sha256_write(&sha, c, size);
+    rustsecp256k1zkp_v0_5_0_sha256_write(&sha, msg32, 32);
+    rustsecp256k1zkp_v0_5_0_sha256_finalize(&sha, &sig.data[0]);
+    rustsecp256k1zkp_v0_5_0_scalar_get_b32(&sig.data[32], &sk);
+    sig.n_keys = 1;
+
+    CHECK(rustsecp256k1zkp_v0_5_0_whitelist_verify(ctx, &sig, &online_pubkey, &offline_pubkey, 1, &sub_pubkey) == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_whitelist_keyset_create(ctx, keyset, &online_pubkey, &offline_pubkey, 1) == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_whitelist_verify_keyset(ctx, &sig, keyset, &sub_pubkey) == 0);
+    free(keyset);
+}
+
 void run_whitelist_tests(void) {
     int i;
     test_whitelist_bad_parse();
     test_whitelist_bad_serialize();
+    test_whitelist_infinite_key();
     for (i = 0; i < count; i++) {
         test_whitelist_end_to_end(1);
         test_whitelist_end_to_end(10);
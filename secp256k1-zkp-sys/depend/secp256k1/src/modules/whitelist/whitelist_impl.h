@@ -7,18 +7,15 @@
 #ifndef _SECP256K1_WHITELIST_IMPL_H_
 #define _SECP256K1_WHITELIST_IMPL_H_
 
-static int rustsecp256k1zkp_v0_5_0_whitelist_hash_pubkey(rustsecp256k1zkp_v0_5_0_scalar* output, rustsecp256k1zkp_v0_5_0_gej* pubkey) {
+static int rustsecp256k1zkp_v0_5_0_whitelist_hash_pubkey(rustsecp256k1zkp_v0_5_0_scalar* output, rustsecp256k1zkp_v0_5_0_ge* pubkey) {
     unsigned char h[32];
     unsigned char c[33];
     rustsecp256k1zkp_v0_5_0_sha256 sha;
     int overflow = 0;
     size_t size = 33;
-    rustsecp256k1zkp_v0_5_0_ge ge;
-
-    rustsecp256k1zkp_v0_5_0_ge_set_gej(&ge, pubkey);
 
     rustsecp256k1zkp_v0_5_0_sha256_initialize(&sha);
-    if (!rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(&ge, c, &size, SECP256K1_EC_COMPRESSED)) {
+    if (!rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(pubkey, c, &size, SECP256K1_EC_COMPRESSED)) {
         return 0;
     }
     rustsecp256k1zkp_v0_5_0_sha256_write(&sha, c, size);
@@ -33,20 +30,6 @@ static int rustsecp256k1zkp_v0_5_0_whitelist_hash_pubkey(rustsecp256k1zkp_v0_5_0
     return 1;
 }
 
-static int rustsecp256k1zkp_v0_5_0_whitelist_tweak_pubkey(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_gej* pub_tweaked) {
-    rustsecp256k1zkp_v0_5_0_scalar tweak;
-    rustsecp256k1zkp_v0_5_0_scalar zero;
-    int ret;
-
-    rustsecp256k1zkp_v0_5_0_scalar_set_int(&zero, 0);
-
-    ret = rustsecp256k1zkp_v0_5_0_whitelist_hash_pubkey(&tweak, pub_tweaked);
-    if (ret) {
-        rustsecp256k1zkp_v0_5_0_ecmult(&ctx->ecmult_ctx, pub_tweaked, pub_tweaked, &tweak, &zero);
-    }
-    return ret;
-}
-
 static int rustsecp256k1zkp_v0_5_0_whitelist_compute_tweaked_privkey(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_scalar* skey, const unsigned char *online_key, const unsigned char *summed_key) {
     rustsecp256k1zkp_v0_5_0_scalar tweak;
     int ret = 1;
@@ -58,8 +41,10 @@ static int rustsecp256k1zkp_v0_5_0_whitelist_compute_tweaked_privkey(const rusts
     }
     if (ret) {
         rustsecp256k1zkp_v0_5_0_gej pkeyj;
+        rustsecp256k1zkp_v0_5_0_ge pkey;
         rustsecp256k1zkp_v0_5_0_ecmult_gen(&ctx->ecmult_gen_ctx, &pkeyj, skey);
-        ret = rustsecp256k1zkp_v0_5_0_whitelist_hash_pubkey(&tweak, &pkeyj);
+        rustsecp256k1zkp_v0_5_0_ge_set_gej(&pkey, &pkeyj);
+        ret = rustsecp256k1zkp_v0_5_0_whitelist_hash_pubkey(&tweak, &pkey);
     }
     if (ret) {
         rustsecp256k1zkp_v0_5_0_scalar sonline;
@@ -80,50 +65,273 @@ static int rustsecp256k1zkp_v0_5_0_whitelist_compute_tweaked_privkey(const rusts
     return ret;
 }
 
-/* Takes a list of pubkeys and combines them to form the public keys needed
- * for the ring signature; also produce a commitment to every one that will
- * be our "message". */
-static int rustsecp256k1zkp_v0_5_0_whitelist_compute_keys_and_message(const rustsecp256k1zkp_v0_5_0_context* ctx, unsigned char *msg32, rustsecp256k1zkp_v0_5_0_gej *keys, const rustsecp256k1zkp_v0_5_0_pubkey *online_pubkeys, const rustsecp256k1zkp_v0_5_0_pubkey *offline_pubkeys, const int n_keys, const rustsecp256k1zkp_v0_5_0_pubkey *sub_pubkey) {
+/* Layout of one key set entry: the online and offline keys in their pubkey
+ * representation, followed by the 66 bytes (offline, online) they contribute
+ * to the message commitment. */
+#define WHITELIST_KEYSET_ENTRY_SIZE (64 + 64 + 33 + 33)
+
+static int rustsecp256k1zkp_v0_5_0_whitelist_keyset_entry_save(const rustsecp256k1zkp_v0_5_0_context* ctx, unsigned char *entry, const rustsecp256k1zkp_v0_5_0_pubkey *online_pubkey, const rustsecp256k1zkp_v0_5_0_pubkey *offline_pubkey) {
+    rustsecp256k1zkp_v0_5_0_ge offline_ge;
+    rustsecp256k1zkp_v0_5_0_ge online_ge;
+    size_t size = 33;
+
+    if (!rustsecp256k1zkp_v0_5_0_pubkey_load(ctx, &offline_ge, offline_pubkey) ||
+        !rustsecp256k1zkp_v0_5_0_pubkey_load(ctx, &online_ge, online_pubkey)) {
+        return 0;
+    }
+    if (!rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(&offline_ge, &entry[128], &size, SECP256K1_EC_COMPRESSED)) {
+        return 0;
+    }
+    if (!rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(&online_ge, &entry[161], &size, SECP256K1_EC_COMPRESSED)) {
+        return 0;
+    }
+    memcpy(&entry[0], online_pubkey->data, 64);
+    memcpy(&entry[64], offline_pubkey->data, 64);
+    return 1;
+}
+
+static void rustsecp256k1zkp_v0_5_0_whitelist_keyset_entry_load(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_ge *online_ge, rustsecp256k1zkp_v0_5_0_ge *offline_ge, const unsigned char *entry) {
+    rustsecp256k1zkp_v0_5_0_pubkey pubkey;
+
+    memcpy(pubkey.data, &entry[0], 64);
+    rustsecp256k1zkp_v0_5_0_pubkey_load(ctx, online_ge, &pubkey);
+    memcpy(pubkey.data, &entry[64], 64);
+    rustsecp256k1zkp_v0_5_0_pubkey_load(ctx, offline_ge, &pubkey);
+}
+
+/* Commits to the sub-key, which comes first in the message, and loads it. */
+static int rustsecp256k1zkp_v0_5_0_whitelist_message_init(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_sha256 *sha, rustsecp256k1zkp_v0_5_0_ge *subkey_ge, const rustsecp256k1zkp_v0_5_0_pubkey *sub_pubkey) {
     unsigned char c[33];
     size_t size = 33;
+
+    rustsecp256k1zkp_v0_5_0_sha256_initialize(sha);
+    if (!rustsecp256k1zkp_v0_5_0_pubkey_load(ctx, subkey_ge, sub_pubkey)) {
+        return 0;
+    }
+    if (!rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(subkey_ge, c, &size, SECP256K1_EC_COMPRESSED)) {
+        return 0;
+    }
+    rustsecp256k1zkp_v0_5_0_sha256_write(sha, c, size);
+    return 1;
+}
+
+/* Commits to one key set entry, loads its online key and computes the
+ * untweaked offline_pubkey + sub_pubkey. */
+static void rustsecp256k1zkp_v0_5_0_whitelist_keyset_entry_commit(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_sha256 *sha, rustsecp256k1zkp_v0_5_0_ge *online_ge, rustsecp256k1zkp_v0_5_0_gej *summed_gej, const unsigned char *entry, const rustsecp256k1zkp_v0_5_0_ge *subkey_ge) {
+    rustsecp256k1zkp_v0_5_0_ge offline_ge;
+
+    /* commit to fixed keys */
+    rustsecp256k1zkp_v0_5_0_sha256_write(sha, &entry[128], 66);
+
+    rustsecp256k1zkp_v0_5_0_whitelist_keyset_entry_load(ctx, online_ge, &offline_ge, entry);
+    rustsecp256k1zkp_v0_5_0_gej_set_ge(summed_gej, &offline_ge);
+    rustsecp256k1zkp_v0_5_0_gej_add_ge_var(summed_gej, summed_gej, subkey_ge, NULL);
+}
+
+/* Brings all offline_pubkey + sub_pubkey sums to affine coordinates with a
+ * single inversion and hashes them to obtain their tweaks. When the hash can
+ * not be computed, the sum is used untweaked, i.e. with a tweak of 1. */
+static void rustsecp256k1zkp_v0_5_0_whitelist_compute_tweaks(rustsecp256k1zkp_v0_5_0_ge *summed_ge, rustsecp256k1zkp_v0_5_0_scalar *tweaks, const rustsecp256k1zkp_v0_5_0_gej *summed_gej, size_t n_keys) {
+    size_t i;
+
+    /* Without keys summed_gej is never written, and compilers warn about
+     * passing it on even though nothing is read. */
+    if (n_keys == 0) {
+        return;
+    }
+    rustsecp256k1zkp_v0_5_0_ge_set_all_gej_var(summed_ge, summed_gej, n_keys);
+    for (i = 0; i < n_keys; i++) {
+        if (!rustsecp256k1zkp_v0_5_0_whitelist_hash_pubkey(&tweaks[i], &summed_ge[i])) {
+            rustsecp256k1zkp_v0_5_0_scalar_set_int(&tweaks[i], 1);
+        }
+    }
+}
+
+/* Takes a list of pubkeys and combines them to form the data needed for the
+ * ring signature, whose public keys are
+ *     online_pubkey + tweak * (offline_pubkey + sub_pubkey);
+ * also produce a commitment to every one that will be our "message". */
+static int rustsecp256k1zkp_v0_5_0_whitelist_compute_keys_and_message(const rustsecp256k1zkp_v0_5_0_context* ctx, unsigned char *msg32, rustsecp256k1zkp_v0_5_0_ge *online_ge, rustsecp256k1zkp_v0_5_0_ge *summed_ge, rustsecp256k1zkp_v0_5_0_scalar *tweaks, const rustsecp256k1zkp_v0_5_0_pubkey *online_pubkeys, const rustsecp256k1zkp_v0_5_0_pubkey *offline_pubkeys, const size_t n_keys, const rustsecp256k1zkp_v0_5_0_pubkey *sub_pubkey) {
+    unsigned char entry[WHITELIST_KEYSET_ENTRY_SIZE];
+    rustsecp256k1zkp_v0_5_0_gej summed_gej[SECP256K1_WHITELIST_MAX_N_KEYS];
     rustsecp256k1zkp_v0_5_0_sha256 sha;
-    int i;
+    size_t i;
     rustsecp256k1zkp_v0_5_0_ge subkey_ge;
 
-    rustsecp256k1zkp_v0_5_0_sha256_initialize(&sha);
-    rustsecp256k1zkp_v0_5_0_pubkey_load(ctx, &subkey_ge, sub_pubkey);
-
-    /* commit to sub-key */
-    if (!rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(&subkey_ge, c, &size, SECP256K1_EC_COMPRESSED)) {
+    if (!rustsecp256k1zkp_v0_5_0_whitelist_message_init(ctx, &sha, &subkey_ge, sub_pubkey)) {
         return 0;
     }
-    rustsecp256k1zkp_v0_5_0_sha256_write(&sha, c, size);
     for (i = 0; i < n_keys; i++) {
-        rustsecp256k1zkp_v0_5_0_ge offline_ge;
-        rustsecp256k1zkp_v0_5_0_ge online_ge;
-        rustsecp256k1zkp_v0_5_0_gej tweaked_gej;
+        if (!rustsecp256k1zkp_v0_5_0_whitelist_keyset_entry_save(ctx, entry, &online_pubkeys[i], &offline_pubkeys[i])) {
+            return 0;
+        }
+        rustsecp256k1zkp_v0_5_0_whitelist_keyset_entry_commit(ctx, &sha, &online_ge[i], &summed_gej[i], entry, &subkey_ge);
+    }
+    rustsecp256k1zkp_v0_5_0_sha256_finalize(&sha, msg32);
+    rustsecp256k1zkp_v0_5_0_whitelist_compute_tweaks(summed_ge, tweaks, summed_gej, n_keys);
+    return 1;
+}
+
+/* Same as rustsecp256k1zkp_v0_5_0_whitelist_compute_keys_and_message, but with the online
+ * and offline keys taken from a precomputed key set. */
+static int rustsecp256k1zkp_v0_5_0_whitelist_compute_keys_and_message_keyset(const rustsecp256k1zkp_v0_5_0_context* ctx, unsigned char *msg32, rustsecp256k1zkp_v0_5_0_ge *online_ge, rustsecp256k1zkp_v0_5_0_ge *summed_ge, rustsecp256k1zkp_v0_5_0_scalar *tweaks, const rustsecp256k1zkp_v0_5_0_whitelist_keyset *keyset, const rustsecp256k1zkp_v0_5_0_pubkey *sub_pubkey) {
+    rustsecp256k1zkp_v0_5_0_gej summed_gej[SECP256K1_WHITELIST_MAX_N_KEYS];
+    rustsecp256k1zkp_v0_5_0_sha256 sha;
+    size_t i;
+    rustsecp256k1zkp_v0_5_0_ge subkey_ge;
+
+    if (!rustsecp256k1zkp_v0_5_0_whitelist_message_init(ctx, &sha, &subkey_ge, sub_pubkey)) {
+        return 0;
+    }
+    for (i = 0; i < keyset->n_keys; i++) {
+        rustsecp256k1zkp_v0_5_0_whitelist_keyset_entry_commit(ctx, &sha, &online_ge[i], &summed_gej[i], &keyset->data[WHITELIST_KEYSET_ENTRY_SIZE * i], &subkey_ge);
+    }
+    rustsecp256k1zkp_v0_5_0_sha256_finalize(&sha, msg32);
+    rustsecp256k1zkp_v0_5_0_whitelist_compute_tweaks(summed_ge, tweaks, summed_gej, keyset->n_keys);
+    return 1;
+}
+
+/* Computes the ring commitment s*G + e*(online + tweak*summed) of one ring
+ * member as a single Strauss multi-multiplication over G and the two points,
+ * rather than tweaking the key with a separate multiplication first. */
+static void rustsecp256k1zkp_v0_5_0_whitelist_ring_commitment(const rustsecp256k1zkp_v0_5_0_ecmult_context *ecmult_ctx, rustsecp256k1zkp_v0_5_0_gej *r, const rustsecp256k1zkp_v0_5_0_ge *online_ge, const rustsecp256k1zkp_v0_5_0_ge *summed_ge, const rustsecp256k1zkp_v0_5_0_scalar *tweak, const rustsecp256k1zkp_v0_5_0_scalar *e, const rustsecp256k1zkp_v0_5_0_scalar *s) {
+    rustsecp256k1zkp_v0_5_0_gej prej[2 * ECMULT_TABLE_SIZE(WINDOW_A)];
+    rustsecp256k1zkp_v0_5_0_fe zr[2 * ECMULT_TABLE_SIZE(WINDOW_A)];
+    rustsecp256k1zkp_v0_5_0_ge pre_a[2 * ECMULT_TABLE_SIZE(WINDOW_A)];
+    rustsecp256k1zkp_v0_5_0_ge pre_a_lam[2 * ECMULT_TABLE_SIZE(WINDOW_A)];
+    struct rustsecp256k1zkp_v0_5_0_strauss_point_state ps[2];
+    struct rustsecp256k1zkp_v0_5_0_strauss_state state;
+    rustsecp256k1zkp_v0_5_0_gej points[2];
+    rustsecp256k1zkp_v0_5_0_scalar scalars[2];
+
+    state.prej = prej;
+    state.zr = zr;
+    state.pre_a = pre_a;
+    state.pre_a_lam = pre_a_lam;
+    state.ps = ps;
 
-        /* commit to fixed keys */
-        rustsecp256k1zkp_v0_5_0_pubkey_load(ctx, &offline_ge, &offline_pubkeys[i]);
-        if (!rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(&offline_ge, c, &size, SECP256K1_EC_COMPRESSED)) {
+    rustsecp256k1zkp_v0_5_0_gej_set_ge(&points[0], online_ge);
+    rustsecp256k1zkp_v0_5_0_gej_set_ge(&points[1], summed_ge);
+    scalars[0] = *e;
+    rustsecp256k1zkp_v0_5_0_scalar_mul(&scalars[1], e, tweak);
+    rustsecp256k1zkp_v0_5_0_ecmult_strauss_wnaf(ecmult_ctx, &state, r, 2, points, scalars, s);
+}
+
+/* Single-ring Borromean verification over the whitelist ring keys. This is
+ * rustsecp256k1zkp_v0_5_0_borromean_verify with nrings = 1, with each ring commitment computed
+ * by rustsecp256k1zkp_v0_5_0_whitelist_ring_commitment. A ring key at infinity is rejected as
+ * there: with e nonzero, it is infinity exactly when the commitment is s*G. */
+static int rustsecp256k1zkp_v0_5_0_whitelist_ring_verify(const rustsecp256k1zkp_v0_5_0_ecmult_context *ecmult_ctx, const unsigned char *e0, const rustsecp256k1zkp_v0_5_0_scalar *s, const rustsecp256k1zkp_v0_5_0_ge *online_ge, const rustsecp256k1zkp_v0_5_0_ge *summed_ge, const rustsecp256k1zkp_v0_5_0_scalar *tweaks, size_t n_keys, const unsigned char *m) {
+    rustsecp256k1zkp_v0_5_0_gej rgej;
+    rustsecp256k1zkp_v0_5_0_gej sgj;
+    rustsecp256k1zkp_v0_5_0_gej infj;
+    rustsecp256k1zkp_v0_5_0_ge rge;
+    rustsecp256k1zkp_v0_5_0_scalar ens;
+    rustsecp256k1zkp_v0_5_0_scalar zero;
+    rustsecp256k1zkp_v0_5_0_sha256 sha256_e0;
+    unsigned char tmp[33];
+    size_t j;
+    size_t size;
+    int overflow;
+
+    rustsecp256k1zkp_v0_5_0_gej_set_infinity(&infj);
+    rustsecp256k1zkp_v0_5_0_scalar_set_int(&zero, 0);
+    rustsecp256k1zkp_v0_5_0_sha256_initialize(&sha256_e0);
+    rustsecp256k1zkp_v0_5_0_borromean_hash(tmp, m, 32, e0, 32, 0, 0);
+    rustsecp256k1zkp_v0_5_0_scalar_set_b32(&ens, tmp, &overflow);
+    for (j = 0; j < n_keys; j++) {
+        if (overflow || rustsecp256k1zkp_v0_5_0_scalar_is_zero(&s[j]) || rustsecp256k1zkp_v0_5_0_scalar_is_zero(&ens)) {
             return 0;
         }
-        rustsecp256k1zkp_v0_5_0_sha256_write(&sha, c, size);
-        rustsecp256k1zkp_v0_5_0_pubkey_load(ctx, &online_ge, &online_pubkeys[i]);
-        if (!rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(&online_ge, c, &size, SECP256K1_EC_COMPRESSED)) {
+        rustsecp256k1zkp_v0_5_0_whitelist_ring_commitment(ecmult_ctx, &rgej, &online_ge[j], &summed_ge[j], &tweaks[j], &ens, &s[j]);
+        if (rustsecp256k1zkp_v0_5_0_gej_is_infinity(&rgej)) {
             return 0;
         }
-        rustsecp256k1zkp_v0_5_0_sha256_write(&sha, c, size);
+        rustsecp256k1zkp_v0_5_0_ecmult(ecmult_ctx, &sgj, &infj, &zero, &s[j]);
+        rustsecp256k1zkp_v0_5_0_gej_neg(&sgj, &sgj);
+        rustsecp256k1zkp_v0_5_0_gej_add_var(&sgj, &sgj, &rgej, NULL);
+        if (rustsecp256k1zkp_v0_5_0_gej_is_infinity(&sgj)) {
+            return 0;
+        }
+        rustsecp256k1zkp_v0_5_0_ge_set_gej_var(&rge, &rgej);
+        rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(&rge, tmp, &size, 1);
+        if (j != n_keys - 1) {
+            rustsecp256k1zkp_v0_5_0_borromean_hash(tmp, m, 32, tmp, 33, 0, j + 1);
+            rustsecp256k1zkp_v0_5_0_scalar_set_b32(&ens, tmp, &overflow);
+        } else {
+            rustsecp256k1zkp_v0_5_0_sha256_write(&sha256_e0, tmp, size);
+        }
+    }
+    rustsecp256k1zkp_v0_5_0_sha256_write(&sha256_e0, m, 32);
+    rustsecp256k1zkp_v0_5_0_sha256_finalize(&sha256_e0, tmp);
+    return memcmp(e0, tmp, 32) == 0;
+}
+
+/* Single-ring Borromean signing over the whitelist ring keys, producing the
+ * same signature as rustsecp256k1zkp_v0_5_0_borromean_sign would for the tweaked keys. */
+static int rustsecp256k1zkp_v0_5_0_whitelist_ring_sign(const rustsecp256k1zkp_v0_5_0_ecmult_context *ecmult_ctx, const rustsecp256k1zkp_v0_5_0_ecmult_gen_context *ecmult_gen_ctx, unsigned char *e0, rustsecp256k1zkp_v0_5_0_scalar *s, const rustsecp256k1zkp_v0_5_0_ge *online_ge, const rustsecp256k1zkp_v0_5_0_ge *summed_ge, const rustsecp256k1zkp_v0_5_0_scalar *tweaks, size_t n_keys, const rustsecp256k1zkp_v0_5_0_scalar *k, const rustsecp256k1zkp_v0_5_0_scalar *sec, size_t secidx, const unsigned char *m) {
+    rustsecp256k1zkp_v0_5_0_gej rgej;
+    rustsecp256k1zkp_v0_5_0_ge rge;
+    rustsecp256k1zkp_v0_5_0_scalar ens;
+    rustsecp256k1zkp_v0_5_0_sha256 sha256_e0;
+    unsigned char tmp[33];
+    size_t j;
+    size_t size;
+    int overflow;
 
-        /* compute tweaked keys */
-        rustsecp256k1zkp_v0_5_0_gej_set_ge(&tweaked_gej, &offline_ge);
-        rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&tweaked_gej, &tweaked_gej, &subkey_ge, NULL);
-        rustsecp256k1zkp_v0_5_0_whitelist_tweak_pubkey(ctx, &tweaked_gej);
-        rustsecp256k1zkp_v0_5_0_gej_add_ge_var(&keys[i], &tweaked_gej, &online_ge, NULL);
+    rustsecp256k1zkp_v0_5_0_ecmult_gen(ecmult_gen_ctx, &rgej, k);
+    rustsecp256k1zkp_v0_5_0_ge_set_gej(&rge, &rgej);
+    if (rustsecp256k1zkp_v0_5_0_gej_is_infinity(&rgej)) {
+        return 0;
     }
-    rustsecp256k1zkp_v0_5_0_sha256_finalize(&sha, msg32);
+    rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(&rge, tmp, &size, 1);
+    for (j = secidx + 1; j < n_keys; j++) {
+        rustsecp256k1zkp_v0_5_0_borromean_hash(tmp, m, 32, tmp, 33, 0, j);
+        rustsecp256k1zkp_v0_5_0_scalar_set_b32(&ens, tmp, &overflow);
+        if (overflow || rustsecp256k1zkp_v0_5_0_scalar_is_zero(&ens)) {
+            return 0;
+        }
+        rustsecp256k1zkp_v0_5_0_whitelist_ring_commitment(ecmult_ctx, &rgej, &online_ge[j], &summed_ge[j], &tweaks[j], &ens, &s[j]);
+        if (rustsecp256k1zkp_v0_5_0_gej_is_infinity(&rgej)) {
+            return 0;
+        }
+        rustsecp256k1zkp_v0_5_0_ge_set_gej_var(&rge, &rgej);
+        rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(&rge, tmp, &size, 1);
+    }
+    rustsecp256k1zkp_v0_5_0_sha256_initialize(&sha256_e0);
+    rustsecp256k1zkp_v0_5_0_sha256_write(&sha256_e0, tmp, size);
+    rustsecp256k1zkp_v0_5_0_sha256_write(&sha256_e0, m, 32);
+    rustsecp256k1zkp_v0_5_0_sha256_finalize(&sha256_e0, e0);
+
+    rustsecp256k1zkp_v0_5_0_borromean_hash(tmp, m, 32, e0, 32, 0, 0);
+    rustsecp256k1zkp_v0_5_0_scalar_set_b32(&ens, tmp, &overflow);
+    if (overflow || rustsecp256k1zkp_v0_5_0_scalar_is_zero(&ens)) {
+        return 0;
+    }
+    for (j = 0; j < secidx; j++) {
+        rustsecp256k1zkp_v0_5_0_whitelist_ring_commitment(ecmult_ctx, &rgej, &online_ge[j], &summed_ge[j], &tweaks[j], &ens, &s[j]);
+        if (rustsecp256k1zkp_v0_5_0_gej_is_infinity(&rgej)) {
+            return 0;
+        }
+        rustsecp256k1zkp_v0_5_0_ge_set_gej_var(&rge, &rgej);
+        rustsecp256k1zkp_v0_5_0_eckey_pubkey_serialize(&rge, tmp, &size, 1);
+        rustsecp256k1zkp_v0_5_0_borromean_hash(tmp, m, 32, tmp, 33, 0, j + 1);
+        rustsecp256k1zkp_v0_5_0_scalar_set_b32(&ens, tmp, &overflow);
+        if (overflow || rustsecp256k1zkp_v0_5_0_scalar_is_zero(&ens)) {
+            return 0;
+        }
+    }
+    rustsecp256k1zkp_v0_5_0_scalar_mul(&s[secidx], &ens, sec);
+    rustsecp256k1zkp_v0_5_0_scalar_negate(&s[secidx], &s[secidx]);
+    rustsecp256k1zkp_v0_5_0_scalar_add(&s[secidx], &s[secidx], k);
+    if (rustsecp256k1zkp_v0_5_0_scalar_is_zero(&s[secidx])) {
+        return 0;
+    }
+    rustsecp256k1zkp_v0_5_0_scalar_clear(&ens);
+    rustsecp256k1zkp_v0_5_0_ge_clear(&rge);
+    rustsecp256k1zkp_v0_5_0_gej_clear(&rgej);
+    memset(tmp, 0, 33);
     return 1;
 }
 
-
 #endif
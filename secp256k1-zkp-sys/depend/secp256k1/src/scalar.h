@@ -120,4 +120,20 @@ static void rustsecp256k1zkp_v0_5_0_scalar_cmov(rustsecp256k1zkp_v0_5_0_scalar *
 /** Generate two scalars from a 32-byte seed and an integer using the chacha20 stream cipher */
 static void rustsecp256k1zkp_v0_5_0_scalar_chacha20(rustsecp256k1zkp_v0_5_0_scalar *r1, rustsecp256k1zkp_v0_5_0_scalar *r2, const unsigned char *seed, uint64_t idx);
 
+/** Randomizers for batch verification. They are derived from a seed with
+ *  rustsecp256k1zkp_v0_5_0_scalar_chacha20 in pairs, so the last pair is cached. */
+typedef struct {
+    unsigned char seed[32];
+    uint64_t cache_idx;
+    int cache_valid;
+    rustsecp256k1zkp_v0_5_0_scalar cache[2];
+} rustsecp256k1zkp_v0_5_0_scalar_randomizer;
+
+/** Initialize the randomizers from a 32-byte seed. */
+static void rustsecp256k1zkp_v0_5_0_scalar_randomizer_init(rustsecp256k1zkp_v0_5_0_scalar_randomizer *r, const unsigned char *seed32);
+
+/** Set a to randomizer i. The first randomizer is 1, which saves a
+ *  multiplication and does not weaken the batch check. */
+static void rustsecp256k1zkp_v0_5_0_scalar_randomizer_get(rustsecp256k1zkp_v0_5_0_scalar *a, rustsecp256k1zkp_v0_5_0_scalar_randomizer *r, size_t i);
+
 #endif /* SECP256K1_SCALAR_H */
@@ -65,6 +65,31 @@ static int rustsecp256k1zkp_v0_5_0_scalar_set_b32_seckey(rustsecp256k1zkp_v0_5_0
     return (!overflow) & (!rustsecp256k1zkp_v0_5_0_scalar_is_zero(r));
 }
 
+static void rustsecp256k1zkp_v0_5_0_scalar_randomizer_init(rustsecp256k1zkp_v0_5_0_scalar_randomizer *r, const unsigned char *seed32) {
+    int i;
+    for (i = 0; i < 32; i++) {
+        r->seed[i] = seed32[i];
+    }
+    r->cache_idx = 0;
+    r->cache_valid = 0;
+}
+
+static void rustsecp256k1zkp_v0_5_0_scalar_randomizer_get(rustsecp256k1zkp_v0_5_0_scalar *a, rustsecp256k1zkp_v0_5_0_scalar_randomizer *r, size_t i) {
+    uint64_t idx;
+
+    if (i == 0) {
+        rustsecp256k1zkp_v0_5_0_scalar_set_int(a, 1);
+        return;
+    }
+    idx = (uint64_t) (i - 1) / 2;
+    if (!r->cache_valid || r->cache_idx != idx) {
+        rustsecp256k1zkp_v0_5_0_scalar_chacha20(&r->cache[0], &r->cache[1], r->seed, idx);
+        r->cache_idx = idx;
+        r->cache_valid = 1;
+    }
+    *a = r->cache[(i - 1) % 2];
+}
+
 static void rustsecp256k1zkp_v0_5_0_scalar_inverse(rustsecp256k1zkp_v0_5_0_scalar *r, const rustsecp256k1zkp_v0_5_0_scalar *x) {
 #if defined(EXHAUSTIVE_TEST_ORDER)
     int i;
@@ -7,6 +7,25 @@
 #ifndef SECP256K1_SCRATCH_H
 #define SECP256K1_SCRATCH_H
 
+/** The number of bucket windows of Pippenger's algorithm, must match
+ *  PIPPENGER_MAX_BUCKET_WINDOW */
+#define SCRATCH_TUNING_WINDOWS 12
+
+/** How ecmult_multi_var chooses its algorithm for the number of points per
+ *  batch, as measured by ecmult_multi_calibrate */
+typedef struct {
+    /** 0 to use the built-in defaults instead of the fields below */
+    int calibrated;
+    /** minimum number of points for pippenger_batch */
+    size_t pippenger_threshold;
+    /** minimum number of points for pippenger_affine_batch */
+    size_t pippenger_affine_threshold;
+    /** maximum number of points for which bucket_window is optimal, at
+     *  [0][bucket_window - 1] for pippenger_batch and at [1][bucket_window - 1]
+     *  for pippenger_affine_batch */
+    size_t window_max_points[2][SCRATCH_TUNING_WINDOWS];
+} rustsecp256k1zkp_v0_5_0_ecmult_multi_tuning;
+
 /* The typedef is used internally; the struct name is used in the public API
  * (where it is exposed as a different typedef) */
 typedef struct rustsecp256k1zkp_v0_5_0_scratch_space_struct {
@@ -19,12 +38,19 @@ typedef struct rustsecp256k1zkp_v0_5_0_scratch_space_struct {
     size_t alloc_size;
     /** maximum size available to allocate */
     size_t max_size;
+    /** algorithm choice of multi-scalar multiplications using this space */
+    rustsecp256k1zkp_v0_5_0_ecmult_multi_tuning tuning;
 } rustsecp256k1zkp_v0_5_0_scratch;
 
 static rustsecp256k1zkp_v0_5_0_scratch* rustsecp256k1zkp_v0_5_0_scratch_create(const rustsecp256k1zkp_v0_5_0_callback* error_callback, size_t max_size);
 
 static void rustsecp256k1zkp_v0_5_0_scratch_destroy(const rustsecp256k1zkp_v0_5_0_callback* error_callback, rustsecp256k1zkp_v0_5_0_scratch* scratch);
 
+/** Initializes a scratch space in caller-provided memory of at least ROUND_TO_ALIGN(sizeof(scratch)) + max_size bytes */
+static rustsecp256k1zkp_v0_5_0_scratch* rustsecp256k1zkp_v0_5_0_scratch_preallocated_create(void *prealloc, size_t max_size);
+
+static void rustsecp256k1zkp_v0_5_0_scratch_preallocated_destroy(const rustsecp256k1zkp_v0_5_0_callback* error_callback, rustsecp256k1zkp_v0_5_0_scratch* scratch);
+
 /** Returns an opaque object used to "checkpoint" a scratch space. Used
  *  with `rustsecp256k1zkp_v0_5_0_scratch_apply_checkpoint` to undo allocations. */
 static size_t rustsecp256k1zkp_v0_5_0_scratch_checkpoint(const rustsecp256k1zkp_v0_5_0_callback* error_callback, const rustsecp256k1zkp_v0_5_0_scratch* scratch);
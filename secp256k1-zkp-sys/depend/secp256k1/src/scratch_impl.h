@@ -71,4 +71,25 @@ static void *rustsecp256k1zkp_v0_5_0_scratch_alloc(const rustsecp256k1zkp_v0_5_0
     return ret;
 }
 
+static rustsecp256k1zkp_v0_5_0_scratch* rustsecp256k1zkp_v0_5_0_scratch_preallocated_create(void *prealloc, size_t max_size) {
+    const size_t base_alloc = ROUND_TO_ALIGN(sizeof(rustsecp256k1zkp_v0_5_0_scratch));
+    rustsecp256k1zkp_v0_5_0_scratch* ret = (rustsecp256k1zkp_v0_5_0_scratch *)prealloc;
+    memset(ret, 0, sizeof(*ret));
+    memcpy(ret->magic, "scratch", 8);
+    ret->data = (void *) ((char *) prealloc + base_alloc);
+    ret->max_size = max_size;
+    return ret;
+}
+
+static void rustsecp256k1zkp_v0_5_0_scratch_preallocated_destroy(const rustsecp256k1zkp_v0_5_0_callback* error_callback, rustsecp256k1zkp_v0_5_0_scratch* scratch) {
+    if (scratch != NULL) {
+        VERIFY_CHECK(scratch->alloc_size == 0); /* all checkpoints should be applied */
+        if (rustsecp256k1zkp_v0_5_0_memcmp_var(scratch->magic, "scratch", 8) != 0) {
+            rustsecp256k1zkp_v0_5_0_callback_call(error_callback, "invalid scratch space");
+            return;
+        }
+        memset(scratch->magic, 0, sizeof(scratch->magic));
+    }
+}
+
 #endif
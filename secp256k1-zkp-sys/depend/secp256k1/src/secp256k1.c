@@ -213,6 +213,29 @@ void rustsecp256k1zkp_v0_5_0_context_set_error_callback(rustsecp256k1zkp_v0_5_0_
     ctx->error_callback.data = data;
 }
 
+size_t rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_size(size_t size) {
+    return ROUND_TO_ALIGN(sizeof(rustsecp256k1zkp_v0_5_0_scratch)) + size;
+}
+
+rustsecp256k1zkp_v0_5_0_scratch_space* rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_create(const rustsecp256k1zkp_v0_5_0_context* ctx, void* prealloc, size_t size) {
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(prealloc != NULL);
+    return rustsecp256k1zkp_v0_5_0_scratch_preallocated_create(prealloc, size);
+}
+
+void rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_destroy(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_scratch_space* scratch) {
+    VERIFY_CHECK(ctx != NULL);
+    rustsecp256k1zkp_v0_5_0_scratch_preallocated_destroy(&ctx->error_callback, scratch);
+}
+
+int rustsecp256k1zkp_v0_5_0_scratch_space_calibrate(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_scratch_space* scratch, rustsecp256k1zkp_v0_5_0_timer timer, void *timer_data) {
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(rustsecp256k1zkp_v0_5_0_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(scratch != NULL);
+    ARG_CHECK(timer != NULL);
+    return rustsecp256k1zkp_v0_5_0_ecmult_multi_calibrate(&ctx->error_callback, &ctx->ecmult_ctx, scratch, timer, timer_data);
+}
+
 /* Mark memory as no-longer-secret for the purpose of analysing constant-time behaviour
  *  of the software. This is setup for use with valgrind but could be substituted with
  *  the appropriate instrumentation for other analysis tools.
@@ -740,6 +763,79 @@ int rustsecp256k1zkp_v0_5_0_ec_pubkey_tweak_mul(const rustsecp256k1zkp_v0_5_0_co
     return ret;
 }
 
+struct rustsecp256k1zkp_v0_5_0_point_table_struct {
+    int bits;
+    rustsecp256k1zkp_v0_5_0_ge_storage *pre;
+};
+
+size_t rustsecp256k1zkp_v0_5_0_point_table_preallocated_size(unsigned int bits) {
+    if (bits < 1 || bits > ECMULT_FIXED_MAX_BITS) {
+        return 0;
+    }
+    return ROUND_TO_ALIGN(sizeof(rustsecp256k1zkp_v0_5_0_point_table)) + ECMULT_FIXED_TABLE_SIZE(bits) * sizeof(rustsecp256k1zkp_v0_5_0_ge_storage);
+}
+
+rustsecp256k1zkp_v0_5_0_point_table* rustsecp256k1zkp_v0_5_0_point_table_preallocated_create(const rustsecp256k1zkp_v0_5_0_context* ctx, void* prealloc, const rustsecp256k1zkp_v0_5_0_pubkey* pubkey, unsigned int bits) {
+    rustsecp256k1zkp_v0_5_0_point_table* table = (rustsecp256k1zkp_v0_5_0_point_table*) prealloc;
+    rustsecp256k1zkp_v0_5_0_ge p;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(prealloc != NULL);
+    ARG_CHECK(pubkey != NULL);
+    ARG_CHECK(bits >= 1 && bits <= ECMULT_FIXED_MAX_BITS);
+
+    if (!rustsecp256k1zkp_v0_5_0_pubkey_load(ctx, &p, pubkey)) {
+        return NULL;
+    }
+    table->bits = bits;
+    table->pre = (rustsecp256k1zkp_v0_5_0_ge_storage*) (void*) ((unsigned char*) prealloc + ROUND_TO_ALIGN(sizeof(*table)));
+    rustsecp256k1zkp_v0_5_0_ecmult_fixed_table(table->pre, &p, bits);
+    return table;
+}
+
+static int rustsecp256k1zkp_v0_5_0_point_table_mul_impl(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_pubkey *pubkey, const rustsecp256k1zkp_v0_5_0_point_table *table, const unsigned char *scalar32, int var) {
+    rustsecp256k1zkp_v0_5_0_scalar factor;
+    rustsecp256k1zkp_v0_5_0_gej pj;
+    rustsecp256k1zkp_v0_5_0_ge p;
+    int overflow = 0;
+    int ret;
+
+    rustsecp256k1zkp_v0_5_0_scalar_set_b32(&factor, scalar32, &overflow);
+    ret = !overflow & !rustsecp256k1zkp_v0_5_0_scalar_is_zero(&factor);
+    memset(pubkey, 0, sizeof(*pubkey));
+    if (var) {
+        if (!ret) {
+            return 0;
+        }
+        rustsecp256k1zkp_v0_5_0_ecmult_fixed_var(&pj, table->pre, table->bits, &factor);
+    } else {
+        rustsecp256k1zkp_v0_5_0_scalar_cmov(&factor, &rustsecp256k1zkp_v0_5_0_scalar_one, !ret);
+        rustsecp256k1zkp_v0_5_0_ecmult_fixed(&pj, table->pre, table->bits, &factor);
+        rustsecp256k1zkp_v0_5_0_scalar_clear(&factor);
+    }
+    rustsecp256k1zkp_v0_5_0_ge_set_gej(&p, &pj);
+    rustsecp256k1zkp_v0_5_0_declassify(ctx, &ret, sizeof(ret));
+    if (ret) {
+        rustsecp256k1zkp_v0_5_0_pubkey_save(pubkey, &p);
+    }
+    return ret;
+}
+
+int rustsecp256k1zkp_v0_5_0_point_table_mul(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_pubkey *pubkey, const rustsecp256k1zkp_v0_5_0_point_table *table, const unsigned char *scalar32) {
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(pubkey != NULL);
+    ARG_CHECK(table != NULL);
+    ARG_CHECK(scalar32 != NULL);
+    return rustsecp256k1zkp_v0_5_0_point_table_mul_impl(ctx, pubkey, table, scalar32, 0);
+}
+
+int rustsecp256k1zkp_v0_5_0_point_table_mul_var(const rustsecp256k1zkp_v0_5_0_context* ctx, rustsecp256k1zkp_v0_5_0_pubkey *pubkey, const rustsecp256k1zkp_v0_5_0_point_table *table, const unsigned char *scalar32) {
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(pubkey != NULL);
+    ARG_CHECK(table != NULL);
+    ARG_CHECK(scalar32 != NULL);
+    return rustsecp256k1zkp_v0_5_0_point_table_mul_impl(ctx, pubkey, table, scalar32, 1);
+}
+
 int rustsecp256k1zkp_v0_5_0_context_randomize(rustsecp256k1zkp_v0_5_0_context* ctx, const unsigned char *seed32) {
     VERIFY_CHECK(ctx != NULL);
     if (rustsecp256k1zkp_v0_5_0_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx)) {
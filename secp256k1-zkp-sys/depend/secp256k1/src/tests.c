@@ -150,6 +150,10 @@ void run_util_tests(void) {
     CHECK(rustsecp256k1zkp_v0_5_0_clz64_var((~0ULL) - 1) == 0);
     CHECK(rustsecp256k1zkp_v0_5_0_clz64_var((~0ULL) >> 1) == 1);
     CHECK(rustsecp256k1zkp_v0_5_0_clz64_var((~0ULL) >> 2) == 2);
+    for (i = 0; i < 64; i++) {
+        CHECK(rustsecp256k1zkp_v0_5_0_ctz64_var(1ULL << i) == i);
+        CHECK(rustsecp256k1zkp_v0_5_0_ctz64_var((~0ULL) << i) == i);
+    }
     CHECK(rustsecp256k1zkp_v0_5_0_sign_and_abs64(&r, INT64_MAX) == 0);
     CHECK(r == INT64_MAX);
     CHECK(rustsecp256k1zkp_v0_5_0_sign_and_abs64(&r, INT64_MAX - 1) == 0);
@@ -457,6 +461,29 @@ void run_scratch_tests(void) {
     CHECK(rustsecp256k1zkp_v0_5_0_scratch_alloc(&none->error_callback, scratch, SIZE_MAX) == NULL);
     rustsecp256k1zkp_v0_5_0_scratch_space_destroy(none, scratch);
 
+    /* Test scratch space in caller-provided memory */
+    {
+        void *prealloc = malloc(rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_size(1000));
+        scratch = rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_create(none, prealloc, 1000);
+        CHECK(scratch == prealloc);
+        CHECK(rustsecp256k1zkp_v0_5_0_scratch_max_allocation(&none->error_callback, scratch, 0) == 1000);
+        checkpoint = rustsecp256k1zkp_v0_5_0_scratch_checkpoint(&none->error_callback, scratch);
+        CHECK(rustsecp256k1zkp_v0_5_0_scratch_alloc(&none->error_callback, scratch, 1000 - ALIGNMENT + 1) != NULL);
+        CHECK((char *) scratch->data + scratch->alloc_size <= (char *) prealloc + rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_size(1000));
+        CHECK(rustsecp256k1zkp_v0_5_0_scratch_alloc(&none->error_callback, scratch, 1) == NULL);
+        rustsecp256k1zkp_v0_5_0_scratch_apply_checkpoint(&none->error_callback, scratch, checkpoint);
+        rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_destroy(none, scratch);
+        CHECK(ecount == 5);
+        /* The memory can be reused once the scratch space is destroyed */
+        scratch = rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_create(none, prealloc, 1000);
+        CHECK(rustsecp256k1zkp_v0_5_0_scratch_alloc(&none->error_callback, scratch, 500) != NULL);
+        rustsecp256k1zkp_v0_5_0_scratch_apply_checkpoint(&none->error_callback, scratch, 0);
+        rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_destroy(none, scratch);
+        CHECK(rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_create(none, NULL, 1000) == NULL);
+        CHECK(ecount == 6);
+        free(prealloc);
+    }
+
     /* cleanup */
     rustsecp256k1zkp_v0_5_0_scratch_space_destroy(none, NULL); /* no-op */
     rustsecp256k1zkp_v0_5_0_context_destroy(none);
@@ -2120,6 +2147,56 @@ void run_field_inv_var(void) {
     }
 }
 
+void run_field_batch(void) {
+    rustsecp256k1zkp_v0_5_0_fe a[40], b[40], r[40], s;
+    int i, j, vec, len, res;
+    for (i = 0; i < count; i++) {
+        len = rustsecp256k1zkp_v0_5_0_testrand_int(41);
+        for (j = 0; j < len; j++) {
+            random_fe_non_zero(&a[j]);
+            random_field_element_magnitude(&a[j]);
+            random_fe(&b[j]);
+            random_field_element_magnitude(&b[j]);
+        }
+        /* Both the scalar and, if available, the vectorized implementation. */
+        for (vec = 0; vec <= rustsecp256k1zkp_v0_5_0_fe_vec_available(); vec++) {
+            rustsecp256k1zkp_v0_5_0_fe_mul_all(r, a, b, len, vec);
+            for (j = 0; j < len; j++) {
+                rustsecp256k1zkp_v0_5_0_fe_mul(&s, &a[j], &b[j]);
+                CHECK(check_fe_equal(&r[j], &s));
+            }
+            rustsecp256k1zkp_v0_5_0_fe_sqr_all(r, a, len, vec);
+            for (j = 0; j < len; j++) {
+                rustsecp256k1zkp_v0_5_0_fe_sqr(&s, &a[j]);
+                CHECK(check_fe_equal(&r[j], &s));
+            }
+            /* In place: r = r*b = a^2*b */
+            rustsecp256k1zkp_v0_5_0_fe_mul_all(r, r, b, len, vec);
+            for (j = 0; j < len; j++) {
+                rustsecp256k1zkp_v0_5_0_fe_sqr(&s, &a[j]);
+                rustsecp256k1zkp_v0_5_0_fe_mul(&s, &s, &b[j]);
+                CHECK(check_fe_equal(&r[j], &s));
+            }
+            rustsecp256k1zkp_v0_5_0_fe_inv_all_var(r, a, len, vec);
+            for (j = 0; j < len; j++) {
+                CHECK(check_fe_inverse(&a[j], &r[j]));
+            }
+            /* About half of the a[j] are squares. */
+            res = 1;
+            for (j = 0; j < len; j++) {
+                res &= rustsecp256k1zkp_v0_5_0_fe_sqrt(&s, &a[j]);
+                b[j] = s;
+            }
+            CHECK(rustsecp256k1zkp_v0_5_0_fe_sqrt_all(r, a, len, vec) == res);
+            for (j = 0; j < len; j++) {
+                CHECK(check_fe_equal(&r[j], &b[j]));
+            }
+            rustsecp256k1zkp_v0_5_0_fe_sqr_all(b, b, len, vec);
+            CHECK(rustsecp256k1zkp_v0_5_0_fe_sqrt_all(r, b, len, vec));
+        }
+    }
+}
+
 void run_sqr(void) {
     rustsecp256k1zkp_v0_5_0_fe x, s;
 
@@ -2140,6 +2217,7 @@ void test_sqrt(const rustsecp256k1zkp_v0_5_0_fe *a, const rustsecp256k1zkp_v0_5_
     rustsecp256k1zkp_v0_5_0_fe r1, r2;
     int v = rustsecp256k1zkp_v0_5_0_fe_sqrt(&r1, a);
     CHECK((v == 0) == (k == NULL));
+    CHECK(rustsecp256k1zkp_v0_5_0_fe_is_quad_var(a) == v);
 
     if (k != NULL) {
         /* Check that the returned root is +/- the given known answer */
@@ -2182,6 +2260,52 @@ void run_sqrt(void) {
             test_sqrt(&t, NULL);
         }
     }
+
+#ifdef USE_NUM_NONE
+    /* Check the Jacobi symbol against Euler's criterion for small primes, spread over two limbs */
+    for (i = 3; i < 200; i += 2) {
+        uint64_t a[2], n[2];
+        int j, k, e;
+        for (j = 3; j * j <= i && i % j != 0; j += 2);
+        if (j * j <= i) {
+            continue;
+        }
+        for (j = 0; j < i; j++) {
+            for (e = 1, k = 0; k < (i - 1) / 2; k++) {
+                e = e * j % i;
+            }
+            a[0] = j; a[1] = 0;
+            n[0] = i; n[1] = 0;
+            CHECK(rustsecp256k1zkp_v0_5_0_jacobi64_var(a, n, 2) == (e == i - 1 ? -1 : e));
+        }
+    }
+#ifdef SECP256K1_WIDEMUL_INT128
+    /* Check the batched Jacobi symbol against the plain one for random odd moduli */
+    for (i = 0; i < 16 * count; i++) {
+        uint64_t a[2][5], n[2][5];
+        unsigned char b[64];
+        int j;
+        rustsecp256k1zkp_v0_5_0_testrand256(b);
+        rustsecp256k1zkp_v0_5_0_testrand256(b + 32);
+        for (j = 0; j < 4; j++) {
+            memcpy(&a[0][j], b + 8 * j, 8);
+            memcpy(&n[0][j], b + 32 + 8 * j, 8);
+        }
+        /* Also cover short and common factors */
+        a[0][4] = n[0][4] = 0;
+        a[0][3] >>= rustsecp256k1zkp_v0_5_0_testrand_int(64);
+        n[0][0] |= 1;
+        if (i % 8 == 0) {
+            a[0][0] = (a[0][0] >> 1) * 3;
+            memset(n[0], 0, sizeof(n[0]));
+            n[0][0] = 3;
+        }
+        memcpy(a[1], a[0], sizeof(a[0]));
+        memcpy(n[1], n[0], sizeof(n[0]));
+        CHECK(rustsecp256k1zkp_v0_5_0_jacobi64_posdivsteps_var(a[0], n[0]) == rustsecp256k1zkp_v0_5_0_jacobi64_var(a[1], n[1], 5));
+    }
+#endif
+#endif
 }
 
 /***** GROUP TESTS *****/
@@ -2701,6 +2825,37 @@ void test_group_decompress(const rustsecp256k1zkp_v0_5_0_fe* x) {
     }
 }
 
+void test_group_decompress_all(void) {
+    rustsecp256k1zkp_v0_5_0_fe x[20];
+    rustsecp256k1zkp_v0_5_0_ge r[20], ge;
+    int res, res_all, vec, valid = rustsecp256k1zkp_v0_5_0_testrand_bits(1);
+    size_t j, len = rustsecp256k1zkp_v0_5_0_testrand_int(21);
+
+    for (j = 0; j < 20; j++) {
+        if (valid) {
+            random_group_element_test(&ge);
+            x[j] = ge.x;
+        } else {
+            random_fe_test(&x[j]);
+        }
+        random_field_element_magnitude(&x[j]);
+    }
+    for (vec = 0; vec <= rustsecp256k1zkp_v0_5_0_fe_vec_available(); vec++) {
+        res_all = rustsecp256k1zkp_v0_5_0_ge_set_xquad_all(r, x, len, vec);
+        res = 1;
+        for (j = 0; j < len; j++) {
+            res &= rustsecp256k1zkp_v0_5_0_ge_set_xquad(&ge, &x[j]);
+            CHECK(!r[j].infinity);
+            CHECK(check_fe_equal(&r[j].x, &x[j]));
+            CHECK(check_fe_equal(&r[j].y, &ge.y));
+        }
+        CHECK(res_all == res);
+        if (valid) {
+            CHECK(res_all);
+        }
+    }
+}
+
 void run_group_decompress(void) {
     int i;
     for (i = 0; i < count * 4; i++) {
@@ -2708,6 +2863,9 @@ void run_group_decompress(void) {
         random_fe_test(&fe);
         test_group_decompress(&fe);
     }
+    for (i = 0; i < count; i++) {
+        test_group_decompress_all();
+    }
 }
 
 /***** ECMULT TESTS *****/
@@ -2891,6 +3049,41 @@ void run_ecmult_near_split_bound(void) {
     }
 }
 
+void run_ecmult_with_table(void) {
+    int i;
+    for (i = 0; i < count; i++) {
+        rustsecp256k1zkp_v0_5_0_ge_storage table[ECMULT_POINT_TABLE_SIZE];
+        rustsecp256k1zkp_v0_5_0_ge a;
+        rustsecp256k1zkp_v0_5_0_gej aj, r, expected;
+        rustsecp256k1zkp_v0_5_0_scalar na, ng, zero;
+
+        random_group_element_test(&a);
+        rustsecp256k1zkp_v0_5_0_gej_set_ge(&aj, &a);
+        random_scalar_order_test(&na);
+        random_scalar_order_test(&ng);
+        rustsecp256k1zkp_v0_5_0_scalar_set_int(&zero, 0);
+        rustsecp256k1zkp_v0_5_0_ecmult_point_table(table, &aj);
+
+        rustsecp256k1zkp_v0_5_0_ecmult(&ctx->ecmult_ctx, &expected, &aj, &na, &ng);
+        rustsecp256k1zkp_v0_5_0_ecmult_with_table(&ctx->ecmult_ctx, &r, table, &na, &ng);
+        rustsecp256k1zkp_v0_5_0_gej_neg(&expected, &expected);
+        rustsecp256k1zkp_v0_5_0_gej_add_var(&r, &r, &expected, NULL);
+        CHECK(rustsecp256k1zkp_v0_5_0_gej_is_infinity(&r));
+
+        /* Without G, and with a zero scalar for A */
+        rustsecp256k1zkp_v0_5_0_ecmult(&ctx->ecmult_ctx, &expected, &aj, &na, NULL);
+        rustsecp256k1zkp_v0_5_0_ecmult_with_table(&ctx->ecmult_ctx, &r, table, &na, NULL);
+        rustsecp256k1zkp_v0_5_0_gej_neg(&expected, &expected);
+        rustsecp256k1zkp_v0_5_0_gej_add_var(&r, &r, &expected, NULL);
+        CHECK(rustsecp256k1zkp_v0_5_0_gej_is_infinity(&r));
+        rustsecp256k1zkp_v0_5_0_ecmult(&ctx->ecmult_ctx, &expected, &aj, &zero, &ng);
+        rustsecp256k1zkp_v0_5_0_ecmult_with_table(&ctx->ecmult_ctx, &r, table, &zero, &ng);
+        rustsecp256k1zkp_v0_5_0_gej_neg(&expected, &expected);
+        rustsecp256k1zkp_v0_5_0_gej_add_var(&r, &r, &expected, NULL);
+        CHECK(rustsecp256k1zkp_v0_5_0_gej_is_infinity(&r));
+    }
+}
+
 void run_point_times_order(void) {
     int i;
     rustsecp256k1zkp_v0_5_0_fe x = SECP256K1_FE_CONST(0, 0, 0, 0, 0, 0, 0, 2);
@@ -3008,11 +3201,120 @@ void ecmult_const_chain_multiply(void) {
     ge_equals_gej(&res, &expected_point);
 }
 
+void ecmult_const_windows(void) {
+    /* Both configured window sizes give the same results as ecmult, for long
+     * and short scalars, and for even and odd ones (which are corrected
+     * differently). Build with other ECMULT_CONST_WINDOW and
+     * ECMULT_CONST_SHORT_WINDOW values to test other sizes. */
+    rustsecp256k1zkp_v0_5_0_scalar zero, q;
+    rustsecp256k1zkp_v0_5_0_ge a, res;
+    rustsecp256k1zkp_v0_5_0_gej aj, expected, r;
+    unsigned char b32[32];
+    int i, w, size;
+
+    rustsecp256k1zkp_v0_5_0_scalar_set_int(&zero, 0);
+    random_group_element_test(&a);
+    rustsecp256k1zkp_v0_5_0_gej_set_ge(&aj, &a);
+    for (i = 0; i < 12; i++) {
+        if (i < 4) {
+            /* 1, 2, -1, -2 */
+            rustsecp256k1zkp_v0_5_0_scalar_set_int(&q, 1 + (i & 1));
+            rustsecp256k1zkp_v0_5_0_scalar_cond_negate(&q, i >> 1);
+            size = 256;
+        } else if (i < 8) {
+            random_scalar_order_test(&q);
+            size = 256;
+        } else {
+            /* Pedersen values, up to 2^64 - 1 */
+            random_scalar_order_test(&q);
+            rustsecp256k1zkp_v0_5_0_scalar_get_b32(b32, &q);
+            memset(b32, 0, 24);
+            if (i == 8) {
+                memset(b32 + 24, 0xFF, 8);
+            }
+            rustsecp256k1zkp_v0_5_0_scalar_set_b32(&q, b32, NULL);
+            size = 64;
+        }
+        rustsecp256k1zkp_v0_5_0_ecmult(&ctx->ecmult_ctx, &expected, &aj, &q, &zero);
+        for (w = 0; w < 2; w++) {
+            rustsecp256k1zkp_v0_5_0_ecmult_const_window(&r, &a, &q, size, w ? ECMULT_CONST_SHORT_WINDOW : ECMULT_CONST_WINDOW);
+            rustsecp256k1zkp_v0_5_0_ge_set_gej(&res, &r);
+            ge_equals_gej(&res, &expected);
+        }
+        rustsecp256k1zkp_v0_5_0_ecmult_const(&r, &a, &q, size);
+        rustsecp256k1zkp_v0_5_0_ge_set_gej(&res, &r);
+        ge_equals_gej(&res, &expected);
+    }
+}
+
+void ecmult_fixed_random_mult(int bits) {
+    rustsecp256k1zkp_v0_5_0_ge_storage *pre = (rustsecp256k1zkp_v0_5_0_ge_storage*)checked_malloc(&ctx->error_callback, ECMULT_FIXED_TABLE_SIZE(bits) * sizeof(rustsecp256k1zkp_v0_5_0_ge_storage));
+    rustsecp256k1zkp_v0_5_0_ge a, res;
+    rustsecp256k1zkp_v0_5_0_gej expected, r;
+    rustsecp256k1zkp_v0_5_0_scalar q;
+    int i;
+
+    random_group_element_test(&a);
+    rustsecp256k1zkp_v0_5_0_ecmult_fixed_table(pre, &a, bits);
+    for (i = 0; i < 4; i++) {
+        if (i == 0) {
+            rustsecp256k1zkp_v0_5_0_scalar_set_int(&q, 1);
+        } else if (i == 1) {
+            rustsecp256k1zkp_v0_5_0_scalar_negate(&q, &rustsecp256k1zkp_v0_5_0_scalar_one);
+        } else {
+            random_scalar_order_test(&q);
+        }
+        rustsecp256k1zkp_v0_5_0_ecmult_const(&expected, &a, &q, 256);
+        rustsecp256k1zkp_v0_5_0_ecmult_fixed(&r, pre, bits, &q);
+        rustsecp256k1zkp_v0_5_0_ge_set_gej(&res, &r);
+        ge_equals_gej(&res, &expected);
+        rustsecp256k1zkp_v0_5_0_ecmult_fixed_var(&r, pre, bits, &q);
+        rustsecp256k1zkp_v0_5_0_ge_set_gej(&res, &r);
+        ge_equals_gej(&res, &expected);
+    }
+    /* Zero gives infinity */
+    rustsecp256k1zkp_v0_5_0_scalar_set_int(&q, 0);
+    rustsecp256k1zkp_v0_5_0_ecmult_fixed(&r, pre, bits, &q);
+    CHECK(rustsecp256k1zkp_v0_5_0_gej_is_infinity(&r));
+    rustsecp256k1zkp_v0_5_0_ecmult_fixed_var(&r, pre, bits, &q);
+    CHECK(rustsecp256k1zkp_v0_5_0_gej_is_infinity(&r));
+    free(pre);
+}
+
+void ecmult_fixed_malicious_point(void) {
+    /* A point chosen to make the first table entry after the offset infinity
+     * must still give correct results. */
+    static const unsigned char nums_b32[33] = "The scalar for this x is unknown";
+    rustsecp256k1zkp_v0_5_0_ge_storage pre[ECMULT_FIXED_TABLE_SIZE(4)];
+    rustsecp256k1zkp_v0_5_0_fe nums_x;
+    rustsecp256k1zkp_v0_5_0_ge a, res;
+    rustsecp256k1zkp_v0_5_0_gej nums, expected, r;
+    rustsecp256k1zkp_v0_5_0_scalar q;
+
+    CHECK(rustsecp256k1zkp_v0_5_0_fe_set_b32(&nums_x, nums_b32));
+    CHECK(rustsecp256k1zkp_v0_5_0_ge_set_xo_var(&a, &nums_x, 0));
+    rustsecp256k1zkp_v0_5_0_gej_set_ge(&nums, &a);
+    rustsecp256k1zkp_v0_5_0_ge_neg(&a, &a);
+    CHECK(!rustsecp256k1zkp_v0_5_0_ecmult_fixed_table_try(pre, &a, 4, &nums));
+    rustsecp256k1zkp_v0_5_0_ecmult_fixed_table(pre, &a, 4);
+    random_scalar_order_test(&q);
+    rustsecp256k1zkp_v0_5_0_ecmult_const(&expected, &a, &q, 256);
+    rustsecp256k1zkp_v0_5_0_ecmult_fixed(&r, pre, 4, &q);
+    rustsecp256k1zkp_v0_5_0_ge_set_gej(&res, &r);
+    ge_equals_gej(&res, &expected);
+}
+
 void run_ecmult_const_tests(void) {
+    int bits;
     ecmult_const_mult_zero_one();
     ecmult_const_random_mult();
     ecmult_const_commutativity();
     ecmult_const_chain_multiply();
+    ecmult_const_windows();
+    for (bits = 1; bits <= ECMULT_FIXED_MAX_BITS; bits++) {
+        ecmult_fixed_random_mult(bits);
+    }
+    ecmult_fixed_malicious_point();
 }
 
 typedef struct {
@@ -3310,6 +3612,18 @@ void test_rustsecp256k1zkp_v0_5_0_pippenger_bucket_window_inv(void) {
     }
 }
 
+void test_rustsecp256k1zkp_v0_5_0_pippenger_affine_bucket_window_inv(void) {
+    int i;
+
+    CHECK(rustsecp256k1zkp_v0_5_0_pippenger_affine_bucket_window_inv(0) == 0);
+    for(i = 1; i <= PIPPENGER_MAX_BUCKET_WINDOW; i++) {
+        CHECK(rustsecp256k1zkp_v0_5_0_pippenger_affine_bucket_window(rustsecp256k1zkp_v0_5_0_pippenger_affine_bucket_window_inv(i)) == i);
+        if (i != PIPPENGER_MAX_BUCKET_WINDOW) {
+            CHECK(rustsecp256k1zkp_v0_5_0_pippenger_affine_bucket_window(rustsecp256k1zkp_v0_5_0_pippenger_affine_bucket_window_inv(i)+1) > i);
+        }
+    }
+}
+
 /**
  * Probabilistically test the function returning the maximum number of possible points
  * for a given scratch space.
@@ -3347,6 +3661,105 @@ void test_ecmult_multi_pippenger_max_points(void) {
     CHECK(bucket_window == PIPPENGER_MAX_BUCKET_WINDOW);
 }
 
+void test_ecmult_multi_pippenger_affine_max_points(void) {
+    size_t scratch_size = rustsecp256k1zkp_v0_5_0_testrand_int(1024);
+    size_t max_size = rustsecp256k1zkp_v0_5_0_pippenger_affine_scratch_size(rustsecp256k1zkp_v0_5_0_pippenger_affine_bucket_window_inv(PIPPENGER_MAX_BUCKET_WINDOW-1)+512, 12);
+    rustsecp256k1zkp_v0_5_0_scratch *scratch;
+    size_t n_points_supported;
+    int bucket_window = 0;
+
+    for(; scratch_size < max_size; scratch_size+=1024) {
+        size_t i;
+        size_t total_alloc;
+        size_t checkpoint;
+        scratch = rustsecp256k1zkp_v0_5_0_scratch_create(&ctx->error_callback, scratch_size);
+        CHECK(scratch != NULL);
+        checkpoint = rustsecp256k1zkp_v0_5_0_scratch_checkpoint(&ctx->error_callback, scratch);
+        n_points_supported = rustsecp256k1zkp_v0_5_0_pippenger_affine_max_points(&ctx->error_callback, scratch);
+        if (n_points_supported == 0) {
+            rustsecp256k1zkp_v0_5_0_scratch_destroy(&ctx->error_callback, scratch);
+            continue;
+        }
+        bucket_window = rustsecp256k1zkp_v0_5_0_pippenger_affine_bucket_window(n_points_supported);
+        /* allocate `total_alloc` bytes over `PIPPENGER_AFFINE_SCRATCH_OBJECTS` many allocations */
+        total_alloc = rustsecp256k1zkp_v0_5_0_pippenger_affine_scratch_size(n_points_supported, bucket_window);
+        for (i = 0; i < PIPPENGER_AFFINE_SCRATCH_OBJECTS - 1; i++) {
+            CHECK(rustsecp256k1zkp_v0_5_0_scratch_alloc(&ctx->error_callback, scratch, 1));
+            total_alloc--;
+        }
+        CHECK(rustsecp256k1zkp_v0_5_0_scratch_alloc(&ctx->error_callback, scratch, total_alloc));
+        rustsecp256k1zkp_v0_5_0_scratch_apply_checkpoint(&ctx->error_callback, scratch, checkpoint);
+        rustsecp256k1zkp_v0_5_0_scratch_destroy(&ctx->error_callback, scratch);
+    }
+    CHECK(bucket_window == PIPPENGER_MAX_BUCKET_WINDOW);
+}
+
+/* A clock that advances by a random amount on every reading, which makes
+ * ecmult_multi_calibrate come up with arbitrary choices of algorithms. */
+static uint64_t test_calibration_timer(void *data) {
+    uint64_t *now = (uint64_t *) data;
+    *now += 1 + rustsecp256k1zkp_v0_5_0_testrand_int(1000000);
+    return *now;
+}
+
+void test_ecmult_multi_calibrate(void) {
+    rustsecp256k1zkp_v0_5_0_context *none = rustsecp256k1zkp_v0_5_0_context_create(SECP256K1_CONTEXT_NONE);
+    rustsecp256k1zkp_v0_5_0_scratch_space *scratch;
+    uint64_t now = 0;
+    int32_t ecount = 0;
+    int affine, w;
+
+    rustsecp256k1zkp_v0_5_0_context_set_illegal_callback(none, counting_illegal_callback_fn, &ecount);
+    rustsecp256k1zkp_v0_5_0_context_set_illegal_callback(ctx, counting_illegal_callback_fn, &ecount);
+
+    /* Too small for pippenger_batch */
+    scratch = rustsecp256k1zkp_v0_5_0_scratch_space_create(ctx, 64);
+    CHECK(rustsecp256k1zkp_v0_5_0_scratch_space_calibrate(ctx, scratch, test_calibration_timer, &now) == 0);
+    CHECK(scratch->tuning.calibrated == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_scratch_space_calibrate(none, scratch, test_calibration_timer, &now) == 0);
+    CHECK(ecount == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_scratch_space_calibrate(ctx, NULL, test_calibration_timer, &now) == 0);
+    CHECK(ecount == 2);
+    CHECK(rustsecp256k1zkp_v0_5_0_scratch_space_calibrate(ctx, scratch, NULL, &now) == 0);
+    CHECK(ecount == 3);
+    rustsecp256k1zkp_v0_5_0_scratch_space_destroy(ctx, scratch);
+
+    /* Large enough for the first few bucket windows only */
+    scratch = rustsecp256k1zkp_v0_5_0_scratch_space_create(ctx, 1 << 18);
+    CHECK(rustsecp256k1zkp_v0_5_0_scratch_space_calibrate(ctx, scratch, test_calibration_timer, &now) == 1);
+    CHECK(ecount == 3);
+    CHECK(scratch->tuning.calibrated == 1);
+    CHECK(scratch->tuning.pippenger_threshold >= 1);
+    CHECK(scratch->tuning.pippenger_affine_threshold >= 1);
+    for (affine = 0; affine < 2; affine++) {
+        size_t n_points;
+        size_t checkpoint;
+        size_t total_alloc;
+        for (w = 1; w < PIPPENGER_MAX_BUCKET_WINDOW; w++) {
+            CHECK(scratch->tuning.window_max_points[affine][w - 1] <= scratch->tuning.window_max_points[affine][w]);
+        }
+        CHECK(scratch->tuning.window_max_points[affine][PIPPENGER_MAX_BUCKET_WINDOW - 1] == SIZE_MAX);
+
+        /* The maximum number of points still fits with the chosen window */
+        n_points = affine ? rustsecp256k1zkp_v0_5_0_pippenger_affine_max_points(&ctx->error_callback, scratch) : rustsecp256k1zkp_v0_5_0_pippenger_max_points(&ctx->error_callback, scratch);
+        if (n_points == 0) {
+            continue;
+        }
+        w = rustsecp256k1zkp_v0_5_0_pippenger_scratch_window(scratch, n_points, affine);
+        checkpoint = rustsecp256k1zkp_v0_5_0_scratch_checkpoint(&ctx->error_callback, scratch);
+        total_alloc = affine ? rustsecp256k1zkp_v0_5_0_pippenger_affine_scratch_size(n_points, w) : rustsecp256k1zkp_v0_5_0_pippenger_scratch_size(n_points, w);
+        CHECK(rustsecp256k1zkp_v0_5_0_scratch_alloc(&ctx->error_callback, scratch, total_alloc));
+        rustsecp256k1zkp_v0_5_0_scratch_apply_checkpoint(&ctx->error_callback, scratch, checkpoint);
+    }
+    test_ecmult_multi(scratch, rustsecp256k1zkp_v0_5_0_ecmult_multi_var);
+    test_ecmult_multi(scratch, rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch_single);
+    test_ecmult_multi(scratch, rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_batch_single);
+    rustsecp256k1zkp_v0_5_0_scratch_space_destroy(ctx, scratch);
+
+    rustsecp256k1zkp_v0_5_0_context_set_illegal_callback(ctx, NULL, NULL);
+    rustsecp256k1zkp_v0_5_0_context_destroy(none);
+}
+
 void test_ecmult_multi_batch_size_helper(void) {
     size_t n_batches, n_batch_points, max_n_batch_points, n;
 
@@ -3462,16 +3875,101 @@ void test_ecmult_multi_batching(void) {
     free(pt);
 }
 
+/* Runs the tasks one after another, in reverse order, and records their number. */
+static void test_task_runner(void (*task)(void *task_data, size_t i), void *task_data, size_t n_tasks, void *data) {
+    size_t i;
+    for (i = n_tasks; i > 0; i--) {
+        task(task_data, i - 1);
+    }
+    *(size_t *) data = n_tasks;
+}
+
+static int ecmult_multi_parallel_false_callback(rustsecp256k1zkp_v0_5_0_scalar *sc, rustsecp256k1zkp_v0_5_0_ge *pt, size_t idx, void *cbdata) {
+    return idx != 2000 && ecmult_multi_callback(sc, pt, idx, cbdata);
+}
+
+void test_ecmult_multi_parallel(void) {
+    static const size_t n_points = 3*ECMULT_MIN_POINTS_PER_WORKER + 5;
+    rustsecp256k1zkp_v0_5_0_scalar scG;
+    rustsecp256k1zkp_v0_5_0_scalar szero;
+    rustsecp256k1zkp_v0_5_0_scalar *sc = (rustsecp256k1zkp_v0_5_0_scalar *)checked_malloc(&ctx->error_callback, sizeof(rustsecp256k1zkp_v0_5_0_scalar) * n_points);
+    rustsecp256k1zkp_v0_5_0_ge *pt = (rustsecp256k1zkp_v0_5_0_ge *)checked_malloc(&ctx->error_callback, sizeof(rustsecp256k1zkp_v0_5_0_ge) * n_points);
+    rustsecp256k1zkp_v0_5_0_gej r;
+    rustsecp256k1zkp_v0_5_0_gej r2;
+    ecmult_multi_data data;
+    void *cbdata[4];
+    rustsecp256k1zkp_v0_5_0_scratch *scratch[4];
+    size_t n_tasks;
+    size_t i;
+
+    rustsecp256k1zkp_v0_5_0_gej_set_infinity(&r2);
+    rustsecp256k1zkp_v0_5_0_scalar_set_int(&szero, 0);
+    random_scalar_order(&scG);
+    rustsecp256k1zkp_v0_5_0_ecmult(&ctx->ecmult_ctx, &r2, &r2, &szero, &scG);
+    for (i = 0; i < n_points; i++) {
+        rustsecp256k1zkp_v0_5_0_gej ptgj;
+        random_group_element_test(&pt[i]);
+        random_scalar_order(&sc[i]);
+        rustsecp256k1zkp_v0_5_0_gej_set_ge(&ptgj, &pt[i]);
+        rustsecp256k1zkp_v0_5_0_ecmult(&ctx->ecmult_ctx, &ptgj, &ptgj, &sc[i], NULL);
+        rustsecp256k1zkp_v0_5_0_gej_add_var(&r2, &r2, &ptgj, NULL);
+    }
+    rustsecp256k1zkp_v0_5_0_gej_neg(&r2, &r2);
+    data.sc = sc;
+    data.pt = pt;
+    for (i = 0; i < 4; i++) {
+        cbdata[i] = &data;
+        scratch[i] = rustsecp256k1zkp_v0_5_0_scratch_create(&ctx->error_callback, 1 << 20);
+    }
+
+    /* Every worker count. Two workers are enough for 2*ECMULT_MIN_POINTS_PER_WORKER points. */
+    for (i = 1; i <= 4; i++) {
+        n_tasks = 0;
+        CHECK(rustsecp256k1zkp_v0_5_0_ecmult_multi_var_parallel(&ctx->error_callback, &ctx->ecmult_ctx, scratch, i, test_task_runner, &n_tasks, &r, &scG, ecmult_multi_callback, cbdata, n_points));
+        CHECK(n_tasks == (i == 1 ? 0 : i));
+        rustsecp256k1zkp_v0_5_0_gej_add_var(&r, &r, &r2, NULL);
+        CHECK(rustsecp256k1zkp_v0_5_0_gej_is_infinity(&r));
+    }
+    n_tasks = 0;
+    CHECK(rustsecp256k1zkp_v0_5_0_ecmult_multi_var_parallel(&ctx->error_callback, &ctx->ecmult_ctx, scratch, 4, test_task_runner, &n_tasks, &r, NULL, ecmult_multi_callback, cbdata, 2*ECMULT_MIN_POINTS_PER_WORKER));
+    CHECK(n_tasks == 2);
+    CHECK(rustsecp256k1zkp_v0_5_0_ecmult_multi_var_parallel(&ctx->error_callback, &ctx->ecmult_ctx, scratch, 4, test_task_runner, &n_tasks, &r, NULL, ecmult_multi_callback, cbdata, 0));
+    CHECK(rustsecp256k1zkp_v0_5_0_gej_is_infinity(&r));
+
+    /* A failing callback in any worker fails the multiplication */
+    CHECK(!rustsecp256k1zkp_v0_5_0_ecmult_multi_var_parallel(&ctx->error_callback, &ctx->ecmult_ctx, scratch, 4, test_task_runner, &n_tasks, &r, &scG, ecmult_multi_parallel_false_callback, cbdata, n_points));
+
+    /* Without room for the workers in the first scratch space everything is
+     * done by the first worker. */
+    rustsecp256k1zkp_v0_5_0_scratch_destroy(&ctx->error_callback, scratch[0]);
+    scratch[0] = rustsecp256k1zkp_v0_5_0_scratch_create(&ctx->error_callback, 0);
+    n_tasks = 0;
+    CHECK(rustsecp256k1zkp_v0_5_0_ecmult_multi_var_parallel(&ctx->error_callback, &ctx->ecmult_ctx, scratch, 4, test_task_runner, &n_tasks, &r, &scG, ecmult_multi_callback, cbdata, n_points));
+    CHECK(n_tasks == 0);
+    rustsecp256k1zkp_v0_5_0_gej_add_var(&r, &r, &r2, NULL);
+    CHECK(rustsecp256k1zkp_v0_5_0_gej_is_infinity(&r));
+
+    for (i = 0; i < 4; i++) {
+        rustsecp256k1zkp_v0_5_0_scratch_destroy(&ctx->error_callback, scratch[i]);
+    }
+    free(sc);
+    free(pt);
+}
+
 void run_ecmult_multi_tests(void) {
     rustsecp256k1zkp_v0_5_0_scratch *scratch;
 
     test_rustsecp256k1zkp_v0_5_0_pippenger_bucket_window_inv();
     test_ecmult_multi_pippenger_max_points();
+    test_rustsecp256k1zkp_v0_5_0_pippenger_affine_bucket_window_inv();
+    test_ecmult_multi_pippenger_affine_max_points();
     scratch = rustsecp256k1zkp_v0_5_0_scratch_create(&ctx->error_callback, 819200);
     test_ecmult_multi(scratch, rustsecp256k1zkp_v0_5_0_ecmult_multi_var);
     test_ecmult_multi(NULL, rustsecp256k1zkp_v0_5_0_ecmult_multi_var);
     test_ecmult_multi(scratch, rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch_single);
     test_ecmult_multi_batch_single(rustsecp256k1zkp_v0_5_0_ecmult_pippenger_batch_single);
+    test_ecmult_multi(scratch, rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_batch_single);
+    test_ecmult_multi_batch_single(rustsecp256k1zkp_v0_5_0_ecmult_pippenger_affine_batch_single);
     test_ecmult_multi(scratch, rustsecp256k1zkp_v0_5_0_ecmult_strauss_batch_single);
     test_ecmult_multi_batch_single(rustsecp256k1zkp_v0_5_0_ecmult_strauss_batch_single);
     rustsecp256k1zkp_v0_5_0_scratch_destroy(&ctx->error_callback, scratch);
@@ -3483,6 +3981,8 @@ void run_ecmult_multi_tests(void) {
 
     test_ecmult_multi_batch_size_helper();
     test_ecmult_multi_batching();
+    test_ecmult_multi_parallel();
+    test_ecmult_multi_calibrate();
 }
 
 void test_wnaf(const rustsecp256k1zkp_v0_5_0_scalar *number, int w) {
@@ -4509,6 +5009,77 @@ void run_eckey_edge_case_test(void) {
     rustsecp256k1zkp_v0_5_0_context_set_illegal_callback(ctx, NULL, NULL);
 }
 
+void run_point_table_tests(void) {
+    unsigned char seckey[32];
+    unsigned char scalar[32];
+    rustsecp256k1zkp_v0_5_0_pubkey pubkey, expected, out, zero_pubkey;
+    rustsecp256k1zkp_v0_5_0_point_table *table;
+    rustsecp256k1zkp_v0_5_0_scalar q;
+    void *mem;
+    int32_t ecount = 0;
+    unsigned int bits;
+    int i;
+
+    CHECK(rustsecp256k1zkp_v0_5_0_point_table_preallocated_size(0) == 0);
+    CHECK(rustsecp256k1zkp_v0_5_0_point_table_preallocated_size(ECMULT_FIXED_MAX_BITS + 1) == 0);
+    memset(&zero_pubkey, 0, sizeof(zero_pubkey));
+    rustsecp256k1zkp_v0_5_0_context_set_illegal_callback(ctx, counting_illegal_callback_fn, &ecount);
+    for (bits = 1; bits <= ECMULT_FIXED_MAX_BITS; bits++) {
+        size_t size = rustsecp256k1zkp_v0_5_0_point_table_preallocated_size(bits);
+        CHECK(size >= ECMULT_FIXED_TABLE_SIZE(bits) * sizeof(rustsecp256k1zkp_v0_5_0_ge_storage));
+        mem = checked_malloc(&ctx->error_callback, size);
+        rustsecp256k1zkp_v0_5_0_testrand256(seckey);
+        CHECK(rustsecp256k1zkp_v0_5_0_ec_pubkey_create(ctx, &pubkey, seckey) == 1);
+        table = rustsecp256k1zkp_v0_5_0_point_table_preallocated_create(ctx, mem, &pubkey, bits);
+        CHECK(table == mem);
+        for (i = 0; i < 4; i++) {
+            random_scalar_order_test(&q);
+            rustsecp256k1zkp_v0_5_0_scalar_get_b32(scalar, &q);
+            expected = pubkey;
+            CHECK(rustsecp256k1zkp_v0_5_0_ec_pubkey_tweak_mul(ctx, &expected, scalar) == 1);
+            CHECK(rustsecp256k1zkp_v0_5_0_point_table_mul(ctx, &out, table, scalar) == 1);
+            CHECK(rustsecp256k1zkp_v0_5_0_memcmp_var(&out, &expected, sizeof(out)) == 0);
+            memset(&out, 0, sizeof(out));
+            CHECK(rustsecp256k1zkp_v0_5_0_point_table_mul_var(ctx, &out, table, scalar) == 1);
+            CHECK(rustsecp256k1zkp_v0_5_0_memcmp_var(&out, &expected, sizeof(out)) == 0);
+        }
+        /* Zero and overflowing scalars are rejected */
+        memset(scalar, 0, 32);
+        CHECK(rustsecp256k1zkp_v0_5_0_point_table_mul(ctx, &out, table, scalar) == 0);
+        CHECK(rustsecp256k1zkp_v0_5_0_memcmp_var(&out, &zero_pubkey, sizeof(out)) == 0);
+        CHECK(rustsecp256k1zkp_v0_5_0_point_table_mul_var(ctx, &out, table, scalar) == 0);
+        CHECK(rustsecp256k1zkp_v0_5_0_memcmp_var(&out, &zero_pubkey, sizeof(out)) == 0);
+        memset(scalar, 0xFF, 32);
+        CHECK(rustsecp256k1zkp_v0_5_0_point_table_mul(ctx, &out, table, scalar) == 0);
+        CHECK(rustsecp256k1zkp_v0_5_0_memcmp_var(&out, &zero_pubkey, sizeof(out)) == 0);
+        CHECK(rustsecp256k1zkp_v0_5_0_point_table_mul_var(ctx, &out, table, scalar) == 0);
+        CHECK(rustsecp256k1zkp_v0_5_0_memcmp_var(&out, &zero_pubkey, sizeof(out)) == 0);
+        free(mem);
+    }
+    CHECK(ecount == 0);
+
+    mem = checked_malloc(&ctx->error_callback, rustsecp256k1zkp_v0_5_0_point_table_preallocated_size(1));
+    CHECK(rustsecp256k1zkp_v0_5_0_point_table_preallocated_create(ctx, mem, &pubkey, 0) == NULL);
+    CHECK(ecount == 1);
+    CHECK(rustsecp256k1zkp_v0_5_0_point_table_preallocated_create(ctx, NULL, &pubkey, 1) == NULL);
+    CHECK(ecount == 2);
+    CHECK(rustsecp256k1zkp_v0_5_0_point_table_preallocated_create(ctx, mem, NULL, 1) == NULL);
+    CHECK(ecount == 3);
+    CHECK(rustsecp256k1zkp_v0_5_0_point_table_preallocated_create(ctx, mem, &zero_pubkey, 1) == NULL);
+    CHECK(ecount == 4);
+    table = rustsecp256k1zkp_v0_5_0_point_table_preallocated_create(ctx, mem, &pubkey, 1);
+    CHECK(table != NULL);
+    rustsecp256k1zkp_v0_5_0_testrand256_test(scalar);
+    CHECK(rustsecp256k1zkp_v0_5_0_point_table_mul(ctx, NULL, table, scalar) == 0);
+    CHECK(ecount == 5);
+    CHECK(rustsecp256k1zkp_v0_5_0_point_table_mul(ctx, &out, NULL, scalar) == 0);
+    CHECK(ecount == 6);
+    CHECK(rustsecp256k1zkp_v0_5_0_point_table_mul_var(ctx, &out, table, NULL) == 0);
+    CHECK(ecount == 7);
+    free(mem);
+    rustsecp256k1zkp_v0_5_0_context_set_illegal_callback(ctx, NULL, NULL);
+}
+
 void run_eckey_negate_test(void) {
     unsigned char seckey[32];
     unsigned char seckey_tmp[32];
@@ -5883,6 +6454,7 @@ int main(int argc, char **argv) {
     /* field tests */
     run_field_inv();
     run_field_inv_var();
+    run_field_batch();
     run_field_misc();
     run_field_convert();
     run_sqr();
@@ -5896,6 +6468,7 @@ int main(int argc, char **argv) {
     run_wnaf();
     run_point_times_order();
     run_ecmult_near_split_bound();
+    run_ecmult_with_table();
     run_ecmult_chain();
     run_ecmult_constants();
     run_ecmult_gen_blind();
@@ -5912,6 +6485,7 @@ int main(int argc, char **argv) {
 
     /* EC key edge cases */
     run_eckey_edge_case_test();
+    run_point_table_tests();
 
     /* EC key arithmetic test */
     run_eckey_negate_test();
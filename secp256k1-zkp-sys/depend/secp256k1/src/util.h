@@ -146,7 +146,7 @@ SECP256K1_INLINE static int rustsecp256k1zkp_v0_5_0_clz64_var(uint64_t x) {
     if (!x) {
         return 64;
     }
-# if defined(HAVE_BUILTIN_CLZLL)
+# if defined(HAVE_BUILTIN_CLZLL) || SECP256K1_GNUC_PREREQ(3,4)
     ret = __builtin_clzll(x);
 # else
     /*FIXME: debruijn fallback. */
@@ -155,6 +155,25 @@ SECP256K1_INLINE static int rustsecp256k1zkp_v0_5_0_clz64_var(uint64_t x) {
     return ret;
 }
 
+/* Returns the number of trailing zero bits of x, which must be nonzero. */
+SECP256K1_INLINE static int rustsecp256k1zkp_v0_5_0_ctz64_var(uint64_t x) {
+    VERIFY_CHECK(x != 0);
+#if SECP256K1_GNUC_PREREQ(3,4)
+    return __builtin_ctzll(x);
+#else
+    {
+        /* De Bruijn sequence lookup of the lowest set bit. */
+        static const uint8_t debruijn[64] = {
+            0, 1, 2, 53, 3, 7, 54, 27, 4, 38, 41, 8, 34, 55, 48, 28,
+            62, 5, 39, 46, 44, 42, 22, 9, 24, 35, 59, 56, 49, 18, 29, 11,
+            63, 52, 6, 26, 37, 40, 33, 47, 61, 45, 43, 21, 23, 58, 17, 10,
+            51, 25, 36, 32, 60, 20, 57, 16, 50, 31, 19, 15, 30, 14, 13, 12
+        };
+        return debruijn[((x & -x) * 0x022FDD63CC95386DULL) >> 58];
+    }
+#endif
+}
+
 /* Macro for restrict, when available and not in a VERIFY build. */
 #if defined(SECP256K1_BUILD) && defined(VERIFY)
 # define SECP256K1_RESTRICT
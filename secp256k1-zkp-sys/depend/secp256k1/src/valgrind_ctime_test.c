@@ -80,6 +80,10 @@ void run_tests(rustsecp256k1zkp_v0_5_0_context *ctx, unsigned char *key) {
     unsigned char msg[32];
     unsigned char sig[74];
     unsigned char spubkey[33];
+#ifdef ENABLE_MODULE_ECDH
+    rustsecp256k1zkp_v0_5_0_pubkey ecdh_batch_pubkeys[3];
+    unsigned char ecdh_batch_output[3 * 32];
+#endif
 #ifdef ENABLE_MODULE_RECOVERY
     rustsecp256k1zkp_v0_5_0_ecdsa_recoverable_signature recoverable_signature;
     int recid;
@@ -114,6 +118,15 @@ void run_tests(rustsecp256k1zkp_v0_5_0_context *ctx, unsigned char *key) {
     ret = rustsecp256k1zkp_v0_5_0_ecdh(ctx, msg, &pubkey, key, NULL, NULL);
     VALGRIND_MAKE_MEM_DEFINED(&ret, sizeof(ret));
     CHECK(ret == 1);
+
+    /* Test batch ECDH. */
+    for (i = 0; i < 3; i++) {
+        ecdh_batch_pubkeys[i] = pubkey;
+    }
+    VALGRIND_MAKE_MEM_UNDEFINED(key, 32);
+    ret = rustsecp256k1zkp_v0_5_0_ecdh_batch(ctx, ecdh_batch_output, 32, ecdh_batch_pubkeys, 3, key, NULL, NULL);
+    VALGRIND_MAKE_MEM_DEFINED(&ret, sizeof(ret));
+    CHECK(ret == 1);
 #endif
 
 #ifdef ENABLE_MODULE_RECOVERY
@@ -1,13 +1,23 @@
 use core::{fmt, hash};
-use {types::*, Context, NonceFn, PublicKey, Signature};
+#[cfg(feature = "recovery")]
+use recovery::RecoverableSignature;
+use {types::*, Context, EcdhHashFn, NonceFn, PublicKey, Signature, XOnlyPublicKey};
 
 /// Rangeproof maximum length
 pub const RANGEPROOF_MAX_LENGTH: size_t = 5134;
 pub const ECDSA_ADAPTOR_SIGNATURE_LENGTH: size_t = 162;
 
+/// The maximum number of inputs a surjection proof may be over.
+pub const SURJECTIONPROOF_MAX_N_INPUTS: size_t = 256;
+/// The maximum number of inputs a surjection proof may use.
+pub const SURJECTIONPROOF_MAX_USED_INPUTS: size_t = 256;
+
 /// The maximum number of whitelist keys.
 pub const WHITELIST_MAX_N_KEYS: size_t = 255;
 
+/// Size of a single online/offline key pair entry in a [`WhitelistKeySet`].
+pub const WHITELIST_KEYSET_ENTRY_SIZE: size_t = 64 + 64 + 33 + 33;
+
 extern "C" {
     #[cfg_attr(
         not(feature = "external-symbols"),
@@ -138,6 +148,53 @@ extern "C" {
         gen: *const PublicKey,
     ) -> c_int;
 
+    #[cfg(feature = "std")]
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_rangeproof_rewind_value_only"
+    )]
+    pub fn secp256k1_rangeproof_rewind_value_only(
+        ctx: *const Context,
+        blind_out: *mut c_uchar,
+        value_out: *mut u64,
+        nonce: *const c_uchar,
+        min_value: *mut u64,
+        max_value: *mut u64,
+        commit: *const PedersenCommitment,
+        proof: *const c_uchar,
+        plen: size_t,
+        extra_commit: *const c_uchar,
+        extra_commit_len: size_t,
+        gen: *const PublicKey,
+    ) -> c_int;
+
+    #[cfg(feature = "std")]
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_rangeproof_ecdh_nonces"
+    )]
+    pub fn secp256k1_rangeproof_ecdh_nonces(
+        ctx: *const Context,
+        nonces: *mut c_uchar,
+        scan_key: *const c_uchar,
+        pubkeys: *const PublicKey,
+        n_pubkeys: size_t,
+    ) -> c_int;
+
+    #[cfg(feature = "std")]
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_rangeproof_rewind_precheck"
+    )]
+    pub fn secp256k1_rangeproof_rewind_precheck(
+        ctx: *const Context,
+        nonce: *const c_uchar,
+        commit: *const PedersenCommitment,
+        proof: *const c_uchar,
+        plen: size_t,
+        gen: *const PublicKey,
+    ) -> c_int;
+
     #[cfg(feature = "std")]
     #[cfg_attr(
         not(feature = "external-symbols"),
@@ -194,6 +251,21 @@ extern "C" {
         random_seed32: *const c_uchar,
     ) -> c_int;
 
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_surjectionproof_initialize_direct"
+    )]
+    pub fn secp256k1_surjectionproof_initialize_direct(
+        ctx: *const Context,
+        proof: *mut SurjectionProof,
+        input_index: *mut size_t,
+        fixed_input_tags: *const Tag,
+        n_input_tags: size_t,
+        n_input_tags_to_use: size_t,
+        fixed_output_tag: *const Tag,
+        random_seed32: *const c_uchar,
+    ) -> c_int;
+
     #[cfg_attr(
         not(feature = "external-symbols"),
         link_name = "rustsecp256k1zkp_v0_5_0_surjectionproof_serialize"
@@ -252,6 +324,19 @@ extern "C" {
         ephemeral_output_tag: *const PublicKey,
     ) -> c_int;
 
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_surjectionproof_verify_serialized"
+    )]
+    pub fn secp256k1_surjectionproof_verify_serialized(
+        ctx: *const Context,
+        input: *const c_uchar,
+        inputlen: size_t,
+        ephemeral_input_tags: *const PublicKey,
+        n_ephemeral_input_tags: size_t,
+        ephemeral_output_tag: *const PublicKey,
+    ) -> c_int;
+
     #[cfg_attr(
         not(feature = "external-symbols"),
         link_name = "rustsecp256k1zkp_v0_5_0_generator_generate_blinded"
@@ -390,6 +475,29 @@ extern "C" {
         n_keys: size_t,
         sub_pubkey: *const PublicKey,
     ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_whitelist_keyset_create"
+    )]
+    pub fn secp256k1_whitelist_keyset_create(
+        ctx: *const Context,
+        keyset: *mut WhitelistKeySet,
+        online_keys: *const PublicKey,
+        offline_keys: *const PublicKey,
+        n_keys: size_t,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_whitelist_verify_keyset"
+    )]
+    pub fn secp256k1_whitelist_verify_keyset(
+        ctx: *const Context,
+        sig: *const WhitelistSignature,
+        keyset: *const WhitelistKeySet,
+        sub_pubkey: *const PublicKey,
+    ) -> c_int;
 }
 
 #[repr(C)]
@@ -468,6 +576,10 @@ impl RangeProof {
         self.0.as_ptr()
     }
 
+    pub fn as_slice(&self) -> &[c_uchar] {
+        &self.0
+    }
+
     pub fn to_bytes(&self) -> Vec<u8> {
         self.0.to_vec()
     }
@@ -532,6 +644,371 @@ impl hash::Hash for PedersenCommitment {
     }
 }
 
+extern "C" {
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_size"
+    )]
+    pub fn secp256k1_scratch_space_preallocated_size(size: size_t) -> size_t;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_create"
+    )]
+    pub fn secp256k1_scratch_space_preallocated_create(
+        ctx: *const Context,
+        prealloc: *mut c_void,
+        size: size_t,
+    ) -> *mut ScratchSpace;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_scratch_space_preallocated_destroy"
+    )]
+    pub fn secp256k1_scratch_space_preallocated_destroy(
+        ctx: *const Context,
+        scratch: *mut ScratchSpace,
+    );
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_scratch_space_calibrate"
+    )]
+    pub fn secp256k1_scratch_space_calibrate(
+        ctx: *const Context,
+        scratch: *mut ScratchSpace,
+        timer: TimerFn,
+        timer_data: *mut c_void,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_point_table_preallocated_size"
+    )]
+    pub fn secp256k1_point_table_preallocated_size(bits: c_uint) -> size_t;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_point_table_preallocated_create"
+    )]
+    pub fn secp256k1_point_table_preallocated_create(
+        ctx: *const Context,
+        prealloc: *mut c_void,
+        pubkey: *const PublicKey,
+        bits: c_uint,
+    ) -> *mut PointTable;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_point_table_mul"
+    )]
+    pub fn secp256k1_point_table_mul(
+        ctx: *const Context,
+        pubkey: *mut PublicKey,
+        table: *const PointTable,
+        scalar32: *const c_uchar,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_point_table_mul_var"
+    )]
+    pub fn secp256k1_point_table_mul_var(
+        ctx: *const Context,
+        pubkey: *mut PublicKey,
+        table: *const PointTable,
+        scalar32: *const c_uchar,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_musig_pubkey_combine"
+    )]
+    pub fn secp256k1_musig_pubkey_combine(
+        ctx: *const Context,
+        scratch: *mut ScratchSpace,
+        combined_pk: *mut XOnlyPublicKey,
+        pre_session: *mut MusigPreSession,
+        pubkeys: *const XOnlyPublicKey,
+        n_pubkeys: size_t,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_musig_pubkey_tweak_add"
+    )]
+    pub fn secp256k1_musig_pubkey_tweak_add(
+        ctx: *const Context,
+        pre_session: *mut MusigPreSession,
+        output_pubkey: *mut PublicKey,
+        internal_pubkey: *const XOnlyPublicKey,
+        tweak32: *const c_uchar,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_musig_keyagg_cache_init"
+    )]
+    pub fn secp256k1_musig_keyagg_cache_init(
+        ctx: *const Context,
+        scratch: *mut ScratchSpace,
+        combined_pk: *mut XOnlyPublicKey,
+        pre_session: *mut MusigPreSession,
+        signers: *mut MusigKeyaggSigner,
+        pubkeys: *const XOnlyPublicKey,
+        n_pubkeys: size_t,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_schnorrsig_verify_batch"
+    )]
+    pub fn secp256k1_schnorrsig_verify_batch(
+        ctx: *const Context,
+        scratch: *mut ScratchSpace,
+        sig64: *const *const c_uchar,
+        msg32: *const *const c_uchar,
+        pubkeys: *const *const XOnlyPublicKey,
+        n_sigs: size_t,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_xonly_pubkey_tweak_add_check_batch"
+    )]
+    pub fn secp256k1_xonly_pubkey_tweak_add_check_batch(
+        ctx: *const Context,
+        scratch: *mut ScratchSpace,
+        tweaked_pubkey32: *const *const c_uchar,
+        tweaked_pk_parity: *const c_int,
+        internal_pubkey: *const *const XOnlyPublicKey,
+        tweak32: *const *const c_uchar,
+        n_checks: size_t,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_ecdh_batch"
+    )]
+    pub fn secp256k1_ecdh_batch(
+        ctx: *const Context,
+        output: *mut c_uchar,
+        outputlen: size_t,
+        pubkeys: *const PublicKey,
+        n_pubkeys: size_t,
+        seckey: *const c_uchar,
+        hashfp: Option<EcdhHashFn>,
+        data: *mut c_void,
+    ) -> c_int;
+
+    #[cfg(feature = "recovery")]
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_ecdsa_recover_batch"
+    )]
+    pub fn secp256k1_ecdsa_recover_batch(
+        ctx: *const Context,
+        pubkeys: *mut PublicKey,
+        invalid: *mut size_t,
+        n_invalid: *mut size_t,
+        sigs: *const *const RecoverableSignature,
+        msghash32: *const *const c_uchar,
+        n_sigs: size_t,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_ecdsa_s2c_opening_parse"
+    )]
+    pub fn secp256k1_ecdsa_s2c_opening_parse(
+        ctx: *const Context,
+        opening: *mut EcdsaS2cOpening,
+        input33: *const c_uchar,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_ecdsa_s2c_opening_serialize"
+    )]
+    pub fn secp256k1_ecdsa_s2c_opening_serialize(
+        ctx: *const Context,
+        output33: *mut c_uchar,
+        opening: *const EcdsaS2cOpening,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_ecdsa_s2c_sign"
+    )]
+    pub fn secp256k1_ecdsa_s2c_sign(
+        ctx: *const Context,
+        sig: *mut Signature,
+        s2c_opening: *mut EcdsaS2cOpening,
+        msg32: *const c_uchar,
+        seckey: *const c_uchar,
+        s2c_data32: *const c_uchar,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_ecdsa_s2c_verify_commit"
+    )]
+    pub fn secp256k1_ecdsa_s2c_verify_commit(
+        ctx: *const Context,
+        sig: *const Signature,
+        data32: *const c_uchar,
+        opening: *const EcdsaS2cOpening,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_ecdsa_s2c_verify_commit_batch"
+    )]
+    pub fn secp256k1_ecdsa_s2c_verify_commit_batch(
+        ctx: *const Context,
+        sigs: *const *const Signature,
+        data32: *const *const c_uchar,
+        openings: *const *const EcdsaS2cOpening,
+        n_sigs: size_t,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_ecdsa_anti_exfil_host_commit"
+    )]
+    pub fn secp256k1_ecdsa_anti_exfil_host_commit(
+        ctx: *const Context,
+        rand_commitment32: *mut c_uchar,
+        rand32: *const c_uchar,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_ecdsa_anti_exfil_signer_commit"
+    )]
+    pub fn secp256k1_ecdsa_anti_exfil_signer_commit(
+        ctx: *const Context,
+        opening: *mut EcdsaS2cOpening,
+        msg32: *const c_uchar,
+        seckey32: *const c_uchar,
+        rand_commitment32: *const c_uchar,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_anti_exfil_sign"
+    )]
+    pub fn secp256k1_anti_exfil_sign(
+        ctx: *const Context,
+        sig: *mut Signature,
+        msg32: *const c_uchar,
+        seckey: *const c_uchar,
+        host_data32: *const c_uchar,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify"
+    )]
+    pub fn secp256k1_anti_exfil_host_verify(
+        ctx: *const Context,
+        sig: *const Signature,
+        msg32: *const c_uchar,
+        pubkey: *const PublicKey,
+        host_data32: *const c_uchar,
+        opening: *const EcdsaS2cOpening,
+    ) -> c_int;
+
+    #[cfg_attr(
+        not(feature = "external-symbols"),
+        link_name = "rustsecp256k1zkp_v0_5_0_anti_exfil_host_verify_batch"
+    )]
+    pub fn secp256k1_anti_exfil_host_verify_batch(
+        ctx: *const Context,
+        sigs: *const *const Signature,
+        msghash32: *const *const c_uchar,
+        pubkeys: *const *const PublicKey,
+        host_data32: *const *const c_uchar,
+        openings: *const *const EcdsaS2cOpening,
+        n_sigs: size_t,
+    ) -> c_int;
+}
+
+/// Opening of a sign-to-contract commitment, i.e. the original public nonce of the signature.
+#[repr(C)]
+pub struct EcdsaS2cOpening([c_uchar; 64]);
+impl_array_newtype!(EcdsaS2cOpening, c_uchar, 64);
+impl_raw_debug!(EcdsaS2cOpening);
+
+impl EcdsaS2cOpening {
+    /// Creates an opening with all bytes set to zero, to be filled by the library.
+    pub fn new() -> Self {
+        EcdsaS2cOpening([0; 64])
+    }
+}
+
+impl Default for EcdsaS2cOpening {
+    fn default() -> Self {
+        EcdsaS2cOpening::new()
+    }
+}
+
+/// Cached MuSig key aggregation data of one signer, see `secp256k1_musig_keyagg_cache_init`.
+#[repr(C)]
+pub struct MusigKeyaggSigner([c_uchar; 580]);
+impl_array_newtype!(MusigKeyaggSigner, c_uchar, 580);
+impl_raw_debug!(MusigKeyaggSigner);
+
+impl MusigKeyaggSigner {
+    /// Creates an entry with all bytes set to zero, to be filled by `secp256k1_musig_keyagg_cache_init`.
+    pub fn new() -> Self {
+        MusigKeyaggSigner([0; 580])
+    }
+}
+
+impl Default for MusigKeyaggSigner {
+    fn default() -> Self {
+        MusigKeyaggSigner::new()
+    }
+}
+
+/// Opaque scratch space handed out by `secp256k1_scratch_space_preallocated_create`.
+#[repr(C)]
+pub struct ScratchSpace {
+    _private: [u8; 0],
+}
+
+/// Opaque table of multiples of a public key handed out by `secp256k1_point_table_preallocated_create`.
+#[repr(C)]
+pub struct PointTable {
+    _private: [u8; 0],
+}
+
+/// Auxiliary data produced by `secp256k1_musig_pubkey_combine`.
+#[repr(C)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Hash)]
+pub struct MusigPreSession {
+    pub magic: u64,
+    pub pk_hash: [c_uchar; 32],
+    pub pk_parity: c_int,
+    pub is_tweaked: c_int,
+    pub tweak: [c_uchar; 32],
+    pub internal_key_parity: c_int,
+}
+
+impl MusigPreSession {
+    pub fn new() -> Self {
+        Self {
+            magic: 0,
+            pk_hash: [0; 32],
+            pk_parity: 0,
+            is_tweaked: 0,
+            tweak: [0; 32],
+            internal_key_parity: 0,
+        }
+    }
+}
+
 /// A ring signature for the "whitelist" scheme.
 #[repr(C)]
 #[derive(Clone)]
@@ -565,6 +1042,25 @@ impl Default for WhitelistSignature {
     }
 }
 
+/// A parsed list of online/offline whitelist keys, see `secp256k1_whitelist_keyset_create`.
+#[repr(C)]
+#[derive(Clone)]
+pub struct WhitelistKeySet {
+    /// The number of keys.
+    pub n_keys: size_t,
+    /// One entry per key pair. The C array is sized for 256 keys.
+    pub data: [u8; WHITELIST_KEYSET_ENTRY_SIZE * (WHITELIST_MAX_N_KEYS + 1)],
+}
+
+impl Default for WhitelistKeySet {
+    fn default() -> WhitelistKeySet {
+        WhitelistKeySet {
+            n_keys: 0,
+            data: [0; WHITELIST_KEYSET_ENTRY_SIZE * (WHITELIST_MAX_N_KEYS + 1)],
+        }
+    }
+}
+
 /// Same as secp256k1_nonce_function_hardened with the exception of using the
 /// compressed 33-byte encoding for the pubkey argument.
 pub type EcdsaAdaptorNonceFn = Option<
@@ -579,6 +1075,10 @@ pub type EcdsaAdaptorNonceFn = Option<
     ) -> c_int,
 >;
 
+/// Reads a clock in any fixed unit not coarser than a microsecond, used to measure
+/// how long computations take.
+pub type TimerFn = unsafe extern "C" fn(data: *mut c_void) -> u64;
+
 #[repr(C)]
 pub struct EcdsaAdaptorSignature([u8; ECDSA_ADAPTOR_SIGNATURE_LENGTH]);
 impl_array_newtype!(EcdsaAdaptorSignature, u8, ECDSA_ADAPTOR_SIGNATURE_LENGTH);
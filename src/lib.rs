@@ -118,6 +118,12 @@ pub enum Error {
     CannotCreateWhitelistSignature,
     /// The given whitelist signature doesn't correctly prove inclusion in the whitelist.
     InvalidWhitelistProof,
+    /// Failed to aggregate public keys with MuSig, e.g. because none were given
+    CannotCombineMusigPublicKeys,
+    /// The MuSig aggregate key is already tweaked, or tweaking it resulted in an invalid key
+    InvalidMusigTweak,
+    /// Given bytes don't represent a valid sign-to-contract opening
+    InvalidEcdsaS2cOpening,
 }
 
 // Passthrough Debug to Display, since errors should be user-visible
@@ -145,6 +151,9 @@ impl fmt::Display for Error {
             Error::InvalidWhitelistProof => {
                 "given whitelist signature doesn't correctly prove inclusion in the whitelist"
             }
+            Error::CannotCombineMusigPublicKeys => "failed to aggregate MuSig public keys",
+            Error::InvalidMusigTweak => "failed to tweak MuSig aggregate public key",
+            Error::InvalidEcdsaS2cOpening => "malformed sign-to-contract opening",
         };
 
         f.write_str(str)
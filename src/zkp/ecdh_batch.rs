@@ -0,0 +1,66 @@
+//! Elliptic curve Diffie-Hellman with many public keys at once.
+//!
+//! Wallets derive one shared secret per output when creating or scanning transactions. Computing them in one batch
+//! shares the conversion of the shared points to affine coordinates, which saves a field inversion per key.
+
+use ffi;
+use {PublicKey, Secp256k1, SecretKey, Signing};
+
+use core::ptr;
+
+/// Computes the ECDH shared secret of `sk` with each of `pubkeys`, in constant time.
+///
+/// The secrets are the same as those of [`ecdh::SharedSecret::new`](::ecdh::SharedSecret::new), i.e. the SHA256 of
+/// the compressed shared point, and are returned in the order of `pubkeys`.
+pub fn ecdh_batch<C: Signing>(
+    secp: &Secp256k1<C>,
+    sk: &SecretKey,
+    pubkeys: &[PublicKey],
+) -> Vec<[u8; 32]> {
+    let mut secrets = vec![[0u8; 32]; pubkeys.len()];
+
+    let ret = unsafe {
+        ffi::secp256k1_ecdh_batch(
+            *secp.ctx(),
+            secrets.as_mut_ptr() as *mut u8,
+            32,
+            // This cast is legit because PublicKey has repr(transparent).
+            pubkeys.as_ptr() as *const ffi::PublicKey,
+            pubkeys.len(),
+            sk.as_ptr(),
+            None,
+            ptr::null_mut(),
+        )
+    };
+    // Both the secret key and the public keys are valid by construction.
+    debug_assert_eq!(ret, 1);
+
+    secrets
+}
+
+#[cfg(all(test, feature = "global-context"))] // use global context for convenience
+mod tests {
+    use super::*;
+    use ecdh::SharedSecret;
+    use rand::thread_rng;
+    use SECP256K1;
+
+    #[cfg(target_arch = "wasm32")]
+    use wasm_bindgen_test::wasm_bindgen_test as test;
+
+    #[test]
+    fn ecdh_batch_matches_shared_secret() {
+        let (sk, _) = SECP256K1.generate_keypair(&mut thread_rng());
+        let pubkeys = (0..70)
+            .map(|_| SECP256K1.generate_keypair(&mut thread_rng()).1)
+            .collect::<Vec<_>>();
+
+        let secrets = ecdh_batch(SECP256K1, &sk, &pubkeys);
+
+        assert_eq!(secrets.len(), pubkeys.len());
+        for (secret, pk) in secrets.iter().zip(pubkeys.iter()) {
+            assert_eq!(&secret[..], &SharedSecret::new(pk, &sk)[..]);
+        }
+        assert!(ecdh_batch(SECP256K1, &sk, &[]).is_empty());
+    }
+}
@@ -0,0 +1,372 @@
+//! # ECDSA Sign-to-Contract
+//! Support for ECDSA signatures whose nonce commits to data, and for the ECDSA Anti-Exfil Protocol built on them,
+//! in which a host makes sure that a signing device did not choose its nonce to leak the secret key.
+//!
+//! The host of a hardware wallet verifies one anti-exfil signature per input of a transaction, which can be done in
+//! one call with [`anti_exfil_host_verify_batch`].
+
+use ffi::{self, CPtr};
+use {Error, Message, PublicKey, Secp256k1, SecretKey, Signature, Signing, Verification};
+
+/// The opening of a sign-to-contract commitment, i.e. the public nonce the signature's nonce was derived from.
+#[derive(Debug, PartialEq, Clone, Copy, Eq)]
+pub struct EcdsaS2cOpening(ffi::EcdsaS2cOpening);
+
+impl EcdsaS2cOpening {
+    /// Parses an opening from its 33-byte serialization.
+    pub fn from_slice(data: &[u8]) -> Result<EcdsaS2cOpening, Error> {
+        if data.len() != 33 {
+            return Err(Error::InvalidEcdsaS2cOpening);
+        }
+        let mut opening = ffi::EcdsaS2cOpening::new();
+
+        let ret = unsafe {
+            ffi::secp256k1_ecdsa_s2c_opening_parse(
+                ffi::secp256k1_context_no_precomp,
+                &mut opening,
+                data.as_ptr(),
+            )
+        };
+        if ret == 0 {
+            return Err(Error::InvalidEcdsaS2cOpening);
+        }
+
+        Ok(EcdsaS2cOpening(opening))
+    }
+
+    /// Serializes the opening into 33 bytes.
+    pub fn serialize(&self) -> [u8; 33] {
+        let mut bytes = [0u8; 33];
+
+        let ret = unsafe {
+            ffi::secp256k1_ecdsa_s2c_opening_serialize(
+                ffi::secp256k1_context_no_precomp,
+                bytes.as_mut_ptr(),
+                &self.0,
+            )
+        };
+        debug_assert_eq!(ret, 1);
+
+        bytes
+    }
+}
+
+impl CPtr for EcdsaS2cOpening {
+    type Target = ffi::EcdsaS2cOpening;
+    fn as_c_ptr(&self) -> *const Self::Target {
+        &self.0
+    }
+
+    fn as_mut_c_ptr(&mut self) -> *mut Self::Target {
+        &mut self.0
+    }
+}
+
+/// Creates an ECDSA signature of `msg` whose nonce commits to `data`, along with the opening of the commitment.
+pub fn ecdsa_s2c_sign<C: Signing>(
+    secp: &Secp256k1<C>,
+    msg: &Message,
+    sk: &SecretKey,
+    data: &[u8; 32],
+) -> (Signature, EcdsaS2cOpening) {
+    let mut sig = ffi::Signature::new();
+    let mut opening = ffi::EcdsaS2cOpening::new();
+
+    let ret = unsafe {
+        ffi::secp256k1_ecdsa_s2c_sign(
+            *secp.ctx(),
+            &mut sig,
+            &mut opening,
+            msg.as_c_ptr(),
+            sk.as_ptr(),
+            data.as_ptr(),
+        )
+    };
+    // The secret key is valid by construction.
+    debug_assert_eq!(ret, 1);
+
+    (Signature::from(sig), EcdsaS2cOpening(opening))
+}
+
+/// Step 1 of the Anti-Exfil Protocol: the host commits to the randomness `host_data` it contributes to the nonce,
+/// and sends the commitment to the signing device.
+pub fn anti_exfil_host_commit<C: Signing>(secp: &Secp256k1<C>, host_data: &[u8; 32]) -> [u8; 32] {
+    let mut commitment = [0u8; 32];
+
+    let ret = unsafe {
+        ffi::secp256k1_ecdsa_anti_exfil_host_commit(
+            *secp.ctx(),
+            commitment.as_mut_ptr(),
+            host_data.as_ptr(),
+        )
+    };
+    debug_assert_eq!(ret, 1);
+
+    commitment
+}
+
+/// Step 2 of the Anti-Exfil Protocol: the signing device derives its public nonce from the host's commitment and
+/// sends it to the host as an opening.
+pub fn anti_exfil_signer_commit<C: Signing>(
+    secp: &Secp256k1<C>,
+    msg: &Message,
+    sk: &SecretKey,
+    host_commitment: &[u8; 32],
+) -> EcdsaS2cOpening {
+    let mut opening = ffi::EcdsaS2cOpening::new();
+
+    let ret = unsafe {
+        ffi::secp256k1_ecdsa_anti_exfil_signer_commit(
+            *secp.ctx(),
+            &mut opening,
+            msg.as_c_ptr(),
+            sk.as_ptr(),
+            host_commitment.as_ptr(),
+        )
+    };
+    debug_assert_eq!(ret, 1);
+
+    EcdsaS2cOpening(opening)
+}
+
+/// Step 4 of the Anti-Exfil Protocol: after the host revealed `host_data`, the signing device signs with a nonce
+/// that commits to it.
+pub fn anti_exfil_sign<C: Signing>(
+    secp: &Secp256k1<C>,
+    msg: &Message,
+    sk: &SecretKey,
+    host_data: &[u8; 32],
+) -> Signature {
+    let mut sig = ffi::Signature::new();
+
+    let ret = unsafe {
+        ffi::secp256k1_anti_exfil_sign(
+            *secp.ctx(),
+            &mut sig,
+            msg.as_c_ptr(),
+            sk.as_ptr(),
+            host_data.as_ptr(),
+        )
+    };
+    // The secret key is valid by construction.
+    debug_assert_eq!(ret, 1);
+
+    Signature::from(sig)
+}
+
+/// Verifies a batch of sign-to-contract commitments, each given as the signature, the data it commits to and the
+/// opening of the commitment.
+///
+/// If the batch does not verify, the indices of the invalid commitments are returned, in ascending order.
+#[cfg(feature = "std")]
+pub fn verify_s2c_commit_batch<C: Verification>(
+    secp: &Secp256k1<C>,
+    batch: &[(&Signature, &[u8; 32], &EcdsaS2cOpening)],
+) -> Result<(), Vec<usize>> {
+    let sigs = batch
+        .iter()
+        .map(|&(sig, _, _)| sig.as_c_ptr())
+        .collect::<Vec<_>>();
+    let data = batch
+        .iter()
+        .map(|&(_, data, _)| data.as_ptr())
+        .collect::<Vec<_>>();
+    let openings = batch
+        .iter()
+        .map(|&(_, _, opening)| opening.as_c_ptr())
+        .collect::<Vec<_>>();
+
+    let ret = unsafe {
+        ffi::secp256k1_ecdsa_s2c_verify_commit_batch(
+            *secp.ctx(),
+            sigs.as_ptr(),
+            data.as_ptr(),
+            openings.as_ptr(),
+            batch.len(),
+        )
+    };
+    if ret == 1 {
+        return Ok(());
+    }
+
+    let invalid = (0..batch.len())
+        .filter(|&i| unsafe {
+            ffi::secp256k1_ecdsa_s2c_verify_commit(*secp.ctx(), sigs[i], data[i], openings[i]) == 0
+        })
+        .collect::<Vec<_>>();
+    Err(invalid)
+}
+
+/// Step 5 of the Anti-Exfil Protocol for many signatures at once: verifies that each signature is valid for its
+/// message and public key, and that its nonce commits to the host's randomness.
+///
+/// If the batch does not verify, the indices of the invalid signatures are returned, in ascending order.
+#[cfg(feature = "std")]
+pub fn anti_exfil_host_verify_batch<C: Verification>(
+    secp: &Secp256k1<C>,
+    batch: &[(
+        &Signature,
+        &Message,
+        &PublicKey,
+        &[u8; 32],
+        &EcdsaS2cOpening,
+    )],
+) -> Result<(), Vec<usize>> {
+    let sigs = batch
+        .iter()
+        .map(|&(sig, _, _, _, _)| sig.as_c_ptr())
+        .collect::<Vec<_>>();
+    let msgs = batch
+        .iter()
+        .map(|&(_, msg, _, _, _)| msg.as_c_ptr())
+        .collect::<Vec<_>>();
+    let pubkeys = batch
+        .iter()
+        .map(|&(_, _, pk, _, _)| pk.as_c_ptr())
+        .collect::<Vec<_>>();
+    let host_data = batch
+        .iter()
+        .map(|&(_, _, _, data, _)| data.as_ptr())
+        .collect::<Vec<_>>();
+    let openings = batch
+        .iter()
+        .map(|&(_, _, _, _, opening)| opening.as_c_ptr())
+        .collect::<Vec<_>>();
+
+    let ret = unsafe {
+        ffi::secp256k1_anti_exfil_host_verify_batch(
+            *secp.ctx(),
+            sigs.as_ptr(),
+            msgs.as_ptr(),
+            pubkeys.as_ptr(),
+            host_data.as_ptr(),
+            openings.as_ptr(),
+            batch.len(),
+        )
+    };
+    if ret == 1 {
+        return Ok(());
+    }
+
+    let invalid = (0..batch.len())
+        .filter(|&i| unsafe {
+            ffi::secp256k1_anti_exfil_host_verify(
+                *secp.ctx(),
+                sigs[i],
+                msgs[i],
+                pubkeys[i],
+                host_data[i],
+                openings[i],
+            ) == 0
+        })
+        .collect::<Vec<_>>();
+    Err(invalid)
+}
+
+#[cfg(all(test, feature = "global-context"))] // use global context for convenience
+mod tests {
+    use super::*;
+    use rand::{thread_rng, RngCore};
+    use SECP256K1;
+
+    #[cfg(target_arch = "wasm32")]
+    use wasm_bindgen_test::wasm_bindgen_test as test;
+
+    struct AntiExfil {
+        sig: Signature,
+        msg: Message,
+        pk: PublicKey,
+        host_data: [u8; 32],
+        opening: EcdsaS2cOpening,
+    }
+
+    fn anti_exfil_batch(n: usize) -> Vec<AntiExfil> {
+        (0..n)
+            .map(|_| {
+                let (sk, pk) = SECP256K1.generate_keypair(&mut thread_rng());
+                let mut buf = [0u8; 32];
+                thread_rng().fill_bytes(&mut buf);
+                let msg = Message::from_slice(&buf).unwrap();
+                let mut host_data = [0u8; 32];
+                thread_rng().fill_bytes(&mut host_data);
+
+                let host_commitment = anti_exfil_host_commit(SECP256K1, &host_data);
+                let opening = anti_exfil_signer_commit(SECP256K1, &msg, &sk, &host_commitment);
+                let sig = anti_exfil_sign(SECP256K1, &msg, &sk, &host_data);
+
+                AntiExfil {
+                    sig,
+                    msg,
+                    pk,
+                    host_data,
+                    opening,
+                }
+            })
+            .collect()
+    }
+
+    #[test]
+    fn opening_roundtrip() {
+        let (sk, _) = SECP256K1.generate_keypair(&mut thread_rng());
+        let msg = Message::from_slice(&[1; 32]).unwrap();
+        let (_, opening) = ecdsa_s2c_sign(SECP256K1, &msg, &sk, &[2; 32]);
+
+        assert_eq!(
+            EcdsaS2cOpening::from_slice(&opening.serialize()),
+            Ok(opening)
+        );
+        assert_eq!(
+            EcdsaS2cOpening::from_slice(&[0; 33]),
+            Err(Error::InvalidEcdsaS2cOpening)
+        );
+        assert_eq!(
+            EcdsaS2cOpening::from_slice(&[2; 32]),
+            Err(Error::InvalidEcdsaS2cOpening)
+        );
+    }
+
+    #[test]
+    fn s2c_commit_batch() {
+        let (sk, pk) = SECP256K1.generate_keypair(&mut thread_rng());
+        let msg = Message::from_slice(&[1; 32]).unwrap();
+        let data = [[2u8; 32], [3u8; 32], [4u8; 32]];
+        let signed = data
+            .iter()
+            .map(|data| ecdsa_s2c_sign(SECP256K1, &msg, &sk, data))
+            .collect::<Vec<_>>();
+        for &(ref sig, _) in signed.iter() {
+            assert!(SECP256K1.verify(&msg, sig, &pk).is_ok());
+        }
+
+        let mut batch = signed
+            .iter()
+            .zip(data.iter())
+            .map(|(&(ref sig, ref opening), data)| (sig, data, opening))
+            .collect::<Vec<_>>();
+        assert_eq!(verify_s2c_commit_batch(SECP256K1, &batch), Ok(()));
+        assert_eq!(verify_s2c_commit_batch(SECP256K1, &[]), Ok(()));
+
+        batch[1].1 = &data[2];
+        assert_eq!(verify_s2c_commit_batch(SECP256K1, &batch), Err(vec![1]));
+    }
+
+    #[test]
+    fn anti_exfil_verify_batch() {
+        let signed = anti_exfil_batch(10);
+        let mut batch = signed
+            .iter()
+            .map(|s| (&s.sig, &s.msg, &s.pk, &s.host_data, &s.opening))
+            .collect::<Vec<_>>();
+
+        assert_eq!(anti_exfil_host_verify_batch(SECP256K1, &batch), Ok(()));
+        assert_eq!(anti_exfil_host_verify_batch(SECP256K1, &[]), Ok(()));
+
+        // A signature of another message, and a nonce that does not commit to the host's randomness
+        batch[2].1 = &signed[3].msg;
+        batch[7].3 = &signed[8].host_data;
+        assert_eq!(
+            anti_exfil_host_verify_batch(SECP256K1, &batch),
+            Err(vec![2, 7])
+        );
+    }
+}
@@ -1,21 +1,51 @@
+#[cfg(feature = "std")]
+mod ecdh_batch;
 mod ecdsa_adaptor;
+mod ecdsa_s2c;
 mod generator;
 #[cfg(feature = "std")]
+mod musig;
+#[cfg(feature = "std")]
 mod pedersen;
 #[cfg(feature = "std")]
+mod point_table;
+#[cfg(feature = "std")]
 mod rangeproof;
+#[cfg(all(feature = "std", feature = "recovery"))]
+mod recovery_batch;
+#[cfg(feature = "std")]
+mod schnorrsig_batch;
+#[cfg(feature = "std")]
+mod scratch;
 #[cfg(feature = "std")]
 mod surjection_proof;
 mod tag;
+#[cfg(feature = "std")]
+mod tweak_add_batch;
 mod whitelist;
 
+#[cfg(feature = "std")]
+pub use self::ecdh_batch::*;
 pub use self::ecdsa_adaptor::*;
+pub use self::ecdsa_s2c::*;
 pub use self::generator::*;
 #[cfg(feature = "std")]
+pub use self::musig::*;
+#[cfg(feature = "std")]
 pub use self::pedersen::*;
 #[cfg(feature = "std")]
+pub use self::point_table::*;
+#[cfg(feature = "std")]
 pub use self::rangeproof::*;
+#[cfg(all(feature = "std", feature = "recovery"))]
+pub use self::recovery_batch::*;
+#[cfg(feature = "std")]
+pub use self::schnorrsig_batch::*;
+#[cfg(feature = "std")]
+pub use self::scratch::*;
 #[cfg(feature = "std")]
 pub use self::surjection_proof::*;
 pub use self::tag::*;
+#[cfg(feature = "std")]
+pub use self::tweak_add_batch::*;
 pub use self::whitelist::*;
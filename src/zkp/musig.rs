@@ -0,0 +1,282 @@
+//! Bindings for the MuSig key aggregation of secp256k1-zkp.
+//!
+//! Key aggregation runs as a single multi-scalar multiplication over all keys, so aggregating the keys of a large
+//! federation through a [`ScratchSpace`] is much faster than tweaking and combining them one by one.
+
+use ffi::{self, CPtr};
+use {schnorrsig, Error, PublicKey, ScratchSpace, Secp256k1, Tweak, Verification};
+
+use core::ptr;
+
+/// Auxiliary data produced by MuSig key aggregation.
+///
+/// It is needed to sign for the aggregate public key, and to tweak it.
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Hash)]
+pub struct MusigPreSession(ffi::MusigPreSession);
+
+impl MusigPreSession {
+    /// Aggregates `pubkeys` into a MuSig public key.
+    ///
+    /// The order of the keys matters: a different order results in a different aggregate key. With a scratch space
+    /// the keys are combined with Pippenger's or Strauss' algorithm, without one they are added up one at a time.
+    pub fn new<C: Verification>(
+        secp: &Secp256k1<C>,
+        scratch: Option<&mut ScratchSpace>,
+        pubkeys: &[schnorrsig::PublicKey],
+    ) -> Result<(schnorrsig::PublicKey, MusigPreSession), Error> {
+        if pubkeys.is_empty() {
+            return Err(Error::CannotCombineMusigPublicKeys);
+        }
+        let pubkeys = pubkeys
+            .iter()
+            .map(|pk| unsafe { *pk.as_c_ptr() })
+            .collect::<Vec<_>>();
+        let scratch = match scratch {
+            Some(scratch) => scratch.as_mut_ptr(),
+            None => ptr::null_mut(),
+        };
+
+        let mut combined_pk = unsafe { ffi::XOnlyPublicKey::new() };
+        let mut pre_session = ffi::MusigPreSession::new();
+        let ret = unsafe {
+            ffi::secp256k1_musig_pubkey_combine(
+                *secp.ctx(),
+                scratch,
+                &mut combined_pk,
+                &mut pre_session,
+                pubkeys.as_ptr(),
+                pubkeys.len(),
+            )
+        };
+
+        if ret == 0 {
+            return Err(Error::CannotCombineMusigPublicKeys);
+        }
+
+        Ok((
+            schnorrsig::PublicKey::from(combined_pk),
+            MusigPreSession(pre_session),
+        ))
+    }
+
+    /// Tweaks the aggregate public key `internal_key` by adding the generator multiplied with `tweak` to it.
+    ///
+    /// This is how a MuSig key is committed to in a taproot output. The aggregate key can only be tweaked once, and
+    /// `internal_key` must be the key returned together with this pre-session.
+    pub fn tweak_add<C: Verification>(
+        &mut self,
+        secp: &Secp256k1<C>,
+        internal_key: &schnorrsig::PublicKey,
+        tweak: &Tweak,
+    ) -> Result<PublicKey, Error> {
+        if self.0.is_tweaked != 0 {
+            return Err(Error::InvalidMusigTweak);
+        }
+
+        let mut output_pubkey = unsafe { ffi::PublicKey::new() };
+        let ret = unsafe {
+            ffi::secp256k1_musig_pubkey_tweak_add(
+                *secp.ctx(),
+                &mut self.0,
+                &mut output_pubkey,
+                internal_key.as_c_ptr(),
+                tweak.as_ptr(),
+            )
+        };
+
+        if ret == 0 {
+            return Err(Error::InvalidMusigTweak);
+        }
+
+        Ok(PublicKey::from(output_pubkey))
+    }
+
+    /// Returns whether the aggregate public key was tweaked.
+    pub fn is_tweaked(&self) -> bool {
+        self.0.is_tweaked != 0
+    }
+
+    /// Obtains a raw const pointer suitable for use with FFI functions.
+    pub fn as_ptr(&self) -> *const ffi::MusigPreSession {
+        &self.0
+    }
+}
+
+/// Key aggregation data of a fixed set of signers, computed once and reused for every signing session.
+///
+/// Besides the aggregate key and the pre-session it holds the MuSig coefficient of every signer and a precomputed
+/// multiplication table for its public key, so that partial signatures can be verified without recomputing them.
+#[derive(Clone, Debug)]
+pub struct MusigKeyAggCache {
+    combined_pk: schnorrsig::PublicKey,
+    pre_session: MusigPreSession,
+    signers: Vec<ffi::MusigKeyaggSigner>,
+}
+
+impl MusigKeyAggCache {
+    /// Aggregates `pubkeys` like [`MusigPreSession::new`] and caches the data of every signer.
+    pub fn new<C: Verification>(
+        secp: &Secp256k1<C>,
+        scratch: Option<&mut ScratchSpace>,
+        pubkeys: &[schnorrsig::PublicKey],
+    ) -> Result<MusigKeyAggCache, Error> {
+        if pubkeys.is_empty() {
+            return Err(Error::CannotCombineMusigPublicKeys);
+        }
+        let pubkeys = pubkeys
+            .iter()
+            .map(|pk| unsafe { *pk.as_c_ptr() })
+            .collect::<Vec<_>>();
+        let scratch = match scratch {
+            Some(scratch) => scratch.as_mut_ptr(),
+            None => ptr::null_mut(),
+        };
+
+        let mut combined_pk = unsafe { ffi::XOnlyPublicKey::new() };
+        let mut pre_session = ffi::MusigPreSession::new();
+        let mut signers = vec![ffi::MusigKeyaggSigner::new(); pubkeys.len()];
+        let ret = unsafe {
+            ffi::secp256k1_musig_keyagg_cache_init(
+                *secp.ctx(),
+                scratch,
+                &mut combined_pk,
+                &mut pre_session,
+                signers.as_mut_ptr(),
+                pubkeys.as_ptr(),
+                pubkeys.len(),
+            )
+        };
+
+        if ret == 0 {
+            return Err(Error::CannotCombineMusigPublicKeys);
+        }
+
+        Ok(MusigKeyAggCache {
+            combined_pk: schnorrsig::PublicKey::from(combined_pk),
+            pre_session: MusigPreSession(pre_session),
+            signers,
+        })
+    }
+
+    /// Returns the aggregate public key.
+    pub fn combined_pk(&self) -> schnorrsig::PublicKey {
+        self.combined_pk
+    }
+
+    /// Returns the pre-session of the aggregate key, which can be tweaked and used to start signing sessions.
+    pub fn pre_session(&self) -> MusigPreSession {
+        self.pre_session
+    }
+
+    /// Returns the number of signers.
+    pub fn len(&self) -> usize {
+        self.signers.len()
+    }
+
+    /// Returns whether the signer set is empty, which is never the case.
+    pub fn is_empty(&self) -> bool {
+        self.signers.is_empty()
+    }
+
+    /// Returns the cached data of every signer, in the order of the keys, for use with FFI functions.
+    pub fn signers(&self) -> &[ffi::MusigKeyaggSigner] {
+        &self.signers
+    }
+}
+
+#[cfg(all(test, feature = "global-context"))] // use global context for convenience
+mod tests {
+    use super::*;
+    use rand::thread_rng;
+    use schnorrsig::KeyPair;
+    use SECP256K1;
+
+    #[cfg(target_arch = "wasm32")]
+    use wasm_bindgen_test::wasm_bindgen_test as test;
+
+    fn random_pubkeys(n: usize) -> Vec<schnorrsig::PublicKey> {
+        (0..n)
+            .map(|_| {
+                let keypair = KeyPair::new(SECP256K1, &mut thread_rng());
+                schnorrsig::PublicKey::from_keypair(SECP256K1, &keypair)
+            })
+            .collect()
+    }
+
+    #[test]
+    fn aggregate_with_and_without_scratch_space() {
+        // Enough keys for Pippenger's algorithm to be used.
+        let pubkeys = random_pubkeys(100);
+        let mut scratch = ScratchSpace::new(1 << 20);
+
+        let (without_scratch, _) = MusigPreSession::new(SECP256K1, None, &pubkeys).unwrap();
+        let (with_scratch, _) =
+            MusigPreSession::new(SECP256K1, Some(&mut scratch), &pubkeys).unwrap();
+        // The scratch space can be reused.
+        let (again, _) = MusigPreSession::new(SECP256K1, Some(&mut scratch), &pubkeys).unwrap();
+        // A scratch space too small for even a single batch falls back to adding up the keys.
+        let (too_small, _) =
+            MusigPreSession::new(SECP256K1, Some(&mut ScratchSpace::new(16)), &pubkeys).unwrap();
+
+        assert_eq!(with_scratch, without_scratch);
+        assert_eq!(again, without_scratch);
+        assert_eq!(too_small, without_scratch);
+
+        let mut reordered_keys = pubkeys.clone();
+        reordered_keys.swap(0, 1);
+        let (reordered, _) =
+            MusigPreSession::new(SECP256K1, Some(&mut scratch), &reordered_keys).unwrap();
+        assert_ne!(reordered, without_scratch);
+    }
+
+    #[test]
+    fn aggregate_no_keys() {
+        assert_eq!(
+            MusigPreSession::new(SECP256K1, None, &[]),
+            Err(Error::CannotCombineMusigPublicKeys)
+        );
+    }
+
+    #[test]
+    fn key_aggregation_cache() {
+        let pubkeys = random_pubkeys(15);
+        let mut scratch = ScratchSpace::new(1 << 20);
+
+        let (combined_pk, pre_session) = MusigPreSession::new(SECP256K1, None, &pubkeys).unwrap();
+        let cache = MusigKeyAggCache::new(SECP256K1, Some(&mut scratch), &pubkeys).unwrap();
+
+        assert_eq!(cache.combined_pk(), combined_pk);
+        assert_eq!(cache.pre_session().0.pk_hash, pre_session.0.pk_hash);
+        assert_eq!(cache.len(), 15);
+        assert!(cache.signers()[0][..] != cache.signers()[1][..]);
+
+        assert_eq!(
+            MusigKeyAggCache::new(SECP256K1, None, &[]).unwrap_err(),
+            Error::CannotCombineMusigPublicKeys
+        );
+    }
+
+    #[test]
+    fn tweak_aggregate_key() {
+        let pubkeys = random_pubkeys(3);
+        let (mut internal_key, mut pre_session) =
+            MusigPreSession::new(SECP256K1, None, &pubkeys).unwrap();
+        let tweak = Tweak::from_inner([1; 32]).unwrap();
+
+        assert!(!pre_session.is_tweaked());
+        let output_key = pre_session
+            .tweak_add(SECP256K1, &internal_key, &tweak)
+            .unwrap();
+        assert!(pre_session.is_tweaked());
+
+        internal_key
+            .tweak_add_assign(SECP256K1, &tweak[..])
+            .unwrap();
+        assert_eq!(&output_key.serialize()[1..], &internal_key.serialize()[..]);
+
+        assert_eq!(
+            pre_session.tweak_add(SECP256K1, &internal_key, &tweak),
+            Err(Error::InvalidMusigTweak)
+        );
+    }
+}
@@ -0,0 +1,116 @@
+//! Precomputed multiples of a public key.
+//!
+//! Protocols that multiply the same public key by many scalars, like ECDH with a long-lived key, can precompute a table
+//! of its multiples once. Each multiplication then adds one table entry per window of the scalar instead of doubling
+//! and adding for every bit, which is several times faster than [`PublicKey::mul_assign`].
+
+use ffi::types::c_void;
+use ffi::{self, CPtr};
+use zkp::scratch::ScratchWord;
+use {PublicKey, Secp256k1, SecretKey, Verification};
+
+/// A table of multiples of a public key for multiplying it by many scalars.
+///
+/// The table takes `ceil(256 / bits) * 2^bits * 64` bytes. More bits mean fewer additions per multiplication, but
+/// [`PointTable::mul`] reads the whole table every time and is fastest with around 5 bits (104 KiB), while
+/// [`PointTable::mul_var`] keeps getting faster up to 8 bits (512 KiB).
+pub struct PointTable {
+    table: *const ffi::PointTable,
+    _memory: Box<[ScratchWord]>,
+}
+
+unsafe impl Send for PointTable {}
+unsafe impl Sync for PointTable {}
+
+impl PointTable {
+    /// Precomputes the multiples of `pubkey` for windows of `bits` bits.
+    ///
+    /// # Panics
+    ///
+    /// If `bits` is not between 1 and 8.
+    pub fn new<C: Verification>(secp: &Secp256k1<C>, pubkey: &PublicKey, bits: u32) -> PointTable {
+        assert!(bits >= 1 && bits <= 8, "bits must be between 1 and 8");
+        let prealloc_size = unsafe { ffi::secp256k1_point_table_preallocated_size(bits) };
+        let n_words = (prealloc_size + 15) / 16;
+        let mut memory = vec![ScratchWord([0; 16]); n_words].into_boxed_slice();
+
+        let table = unsafe {
+            ffi::secp256k1_point_table_preallocated_create(
+                *secp.ctx(),
+                memory.as_mut_ptr() as *mut c_void,
+                pubkey.as_c_ptr(),
+                bits,
+            )
+        };
+        assert!(!table.is_null());
+
+        PointTable {
+            table,
+            _memory: memory,
+        }
+    }
+
+    /// Multiplies the public key of the table by `scalar`, in constant time.
+    pub fn mul<C: Verification>(&self, secp: &Secp256k1<C>, scalar: &SecretKey) -> PublicKey {
+        let mut pubkey = unsafe { ffi::PublicKey::new() };
+        let ret = unsafe {
+            ffi::secp256k1_point_table_mul(*secp.ctx(), &mut pubkey, self.table, scalar.as_c_ptr())
+        };
+        // Secret keys are never zero or out of range
+        assert_eq!(ret, 1);
+        PublicKey::from(pubkey)
+    }
+
+    /// Multiplies the public key of the table by `scalar` in variable time.
+    ///
+    /// This is faster than [`PointTable::mul`] but leaks the scalar through timing, so only use it with public
+    /// scalars, e.g. when verifying.
+    pub fn mul_var<C: Verification>(&self, secp: &Secp256k1<C>, scalar: &SecretKey) -> PublicKey {
+        let mut pubkey = unsafe { ffi::PublicKey::new() };
+        let ret = unsafe {
+            ffi::secp256k1_point_table_mul_var(
+                *secp.ctx(),
+                &mut pubkey,
+                self.table,
+                scalar.as_c_ptr(),
+            )
+        };
+        // Secret keys are never zero or out of range
+        assert_eq!(ret, 1);
+        PublicKey::from(pubkey)
+    }
+}
+
+#[cfg(all(test, feature = "global-context"))] // use global context for convenience
+mod tests {
+    use super::*;
+    use rand::thread_rng;
+    use SECP256K1;
+
+    #[cfg(target_arch = "wasm32")]
+    use wasm_bindgen_test::wasm_bindgen_test as test;
+
+    #[test]
+    fn mul_matches_tweak_mul() {
+        let (_, pubkey) = SECP256K1.generate_keypair(&mut thread_rng());
+
+        for bits in 1..9 {
+            let table = PointTable::new(SECP256K1, &pubkey, bits);
+            for _ in 0..4 {
+                let scalar = SecretKey::new(&mut thread_rng());
+                let mut expected = pubkey;
+                expected.mul_assign(SECP256K1, &scalar[..]).unwrap();
+
+                assert_eq!(table.mul(SECP256K1, &scalar), expected);
+                assert_eq!(table.mul_var(SECP256K1, &scalar), expected);
+            }
+        }
+    }
+
+    #[test]
+    #[should_panic]
+    fn new_rejects_too_many_bits() {
+        let (_, pubkey) = SECP256K1.generate_keypair(&mut thread_rng());
+        PointTable::new(SECP256K1, &pubkey, 9);
+    }
+}
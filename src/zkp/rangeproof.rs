@@ -1,3 +1,4 @@
+use ffi::CPtr;
 use ffi::RANGEPROOF_MAX_LENGTH;
 use from_hex;
 use std::ops::Range;
@@ -6,7 +7,7 @@ use Error;
 use Generator;
 use PedersenCommitment;
 use Verification;
-use {ffi, Secp256k1, SecretKey, Signing, Tweak};
+use {ffi, PublicKey, Secp256k1, SecretKey, Signing, Tweak};
 
 /// Represents a range proof.
 ///
@@ -16,6 +17,15 @@ pub struct RangeProof {
     inner: ffi::RangeProof,
 }
 
+/// A range proof borrowed from a byte slice.
+///
+/// This allows verifying and rewinding proofs in place, e.g. straight out of a memory-mapped file, without
+/// copying them into a [`RangeProof`] first.
+#[derive(Debug, PartialEq, Clone, Copy, Eq, Hash)]
+pub struct RangeProofRef<'a> {
+    inner: &'a [u8],
+}
+
 impl RangeProof {
     /// Serialize to bytes.
     pub fn serialize(&self) -> Vec<u8> {
@@ -26,6 +36,120 @@ impl RangeProof {
     ///
     /// TODO: Rename to parse (and other similar functions)
     pub fn from_slice(bytes: &[u8]) -> Result<Self, Error> {
+        Ok(RangeProofRef::from_slice(bytes)?.to_owned())
+    }
+
+    /// Borrows this range proof as a [`RangeProofRef`].
+    pub fn as_proof_ref(&self) -> RangeProofRef<'_> {
+        RangeProofRef {
+            inner: self.inner.as_slice(),
+        }
+    }
+
+    /// Get length.
+    pub fn len(&self) -> usize {
+        self.inner.len()
+    }
+
+    /// Check if it's empty.
+    pub fn is_empty(&self) -> bool {
+        self.inner.is_empty()
+    }
+
+    /// Prove that `commitment` hides a value within a range, with the lower bound set to `min_value`.
+    pub fn new<C: Signing>(
+        secp: &Secp256k1<C>,
+        min_value: u64,
+        commitment: PedersenCommitment,
+        value: u64,
+        commitment_blinding: Tweak,
+        message: &[u8],
+        additional_commitment: &[u8],
+        sk: SecretKey,
+        exp: i32,
+        min_bits: u8,
+        additional_generator: Generator,
+    ) -> Result<RangeProof, Error> {
+        let mut proof = [0u8; RANGEPROOF_MAX_LENGTH];
+
+        let proof = RangeProofRef::new_into(
+            secp,
+            &mut proof,
+            min_value,
+            commitment,
+            value,
+            commitment_blinding,
+            message,
+            additional_commitment,
+            sk,
+            exp,
+            min_bits,
+            additional_generator,
+        )?;
+
+        Ok(proof.to_owned())
+    }
+
+    /// Verify that the committed value is within a range.
+    ///
+    /// If the verification is successful, return the actual range of possible values.
+    pub fn verify<C: Verification>(
+        &self,
+        secp: &Secp256k1<C>,
+        commitment: PedersenCommitment,
+        additional_commitment: &[u8],
+        additional_generator: Generator,
+    ) -> Result<Range<u64>, Error> {
+        self.as_proof_ref().verify(
+            secp,
+            commitment,
+            additional_commitment,
+            additional_generator,
+        )
+    }
+
+    /// Verify a range proof proof and rewind the proof to recover information sent by its author.
+    pub fn rewind<C: Verification>(
+        &self,
+        secp: &Secp256k1<C>,
+        commitment: PedersenCommitment,
+        sk: SecretKey,
+        additional_commitment: &[u8],
+        additional_generator: Generator,
+    ) -> Result<(Opening, Range<u64>), Error> {
+        self.as_proof_ref().rewind(
+            secp,
+            commitment,
+            sk,
+            additional_commitment,
+            additional_generator,
+        )
+    }
+
+    /// Verify a range proof and recover only the committed value and its blinding factor.
+    ///
+    /// See [`RangeProofRef::rewind_value_only`].
+    pub fn rewind_value_only<C: Verification>(
+        &self,
+        secp: &Secp256k1<C>,
+        commitment: PedersenCommitment,
+        sk: SecretKey,
+        additional_commitment: &[u8],
+        additional_generator: Generator,
+    ) -> Result<(u64, Tweak, Range<u64>), Error> {
+        self.as_proof_ref().rewind_value_only(
+            secp,
+            commitment,
+            sk,
+            additional_commitment,
+            additional_generator,
+        )
+    }
+}
+
+impl<'a> RangeProofRef<'a> {
+    /// Borrows a range proof from a byte slice, checking that its header is well-formed.
+    pub fn from_slice(bytes: &'a [u8]) -> Result<Self, Error> {
         let mut exp = 0;
         let mut mantissa = 0;
         let mut min_value = 0;
@@ -47,24 +171,17 @@ impl RangeProof {
             return Err(Error::InvalidRangeProof);
         }
 
-        Ok(RangeProof {
-            inner: ffi::RangeProof::new(bytes),
-        })
+        Ok(RangeProofRef { inner: bytes })
     }
 
-    /// Get length.
-    pub fn len(&self) -> usize {
-        self.inner.len()
-    }
-
-    /// Check if it's empty.
-    pub fn is_empty(&self) -> bool {
-        self.inner.is_empty()
-    }
-
-    /// Prove that `commitment` hides a value within a range, with the lower bound set to `min_value`.
-    pub fn new<C: Signing>(
+    /// Prove that `commitment` hides a value within a range, with the lower bound set to `min_value`, writing the
+    /// proof into `proof`.
+    ///
+    /// Returns the part of `proof` holding the range proof. A buffer of [`ffi::RANGEPROOF_MAX_LENGTH`] bytes is
+    /// always large enough, if `proof` is too short this fails with [`Error::CannotMakeRangeProof`].
+    pub fn new_into<C: Signing>(
         secp: &Secp256k1<C>,
+        proof: &'a mut [u8],
         min_value: u64,
         commitment: PedersenCommitment,
         value: u64,
@@ -75,9 +192,8 @@ impl RangeProof {
         exp: i32,
         min_bits: u8,
         additional_generator: Generator,
-    ) -> Result<RangeProof, Error> {
-        let mut proof = [0u8; RANGEPROOF_MAX_LENGTH];
-        let mut proof_length = RANGEPROOF_MAX_LENGTH;
+    ) -> Result<RangeProofRef<'a>, Error> {
+        let mut proof_length = proof.len();
 
         let ret = unsafe {
             ffi::secp256k1_rangeproof_sign(
@@ -103,11 +219,34 @@ impl RangeProof {
             return Err(Error::CannotMakeRangeProof);
         }
 
-        Ok(RangeProof {
-            inner: ffi::RangeProof::new(&proof[..proof_length]),
+        let proof: &'a [u8] = proof;
+        Ok(RangeProofRef {
+            inner: &proof[..proof_length],
         })
     }
 
+    /// Copies the borrowed range proof into an owned [`RangeProof`].
+    pub fn to_owned(&self) -> RangeProof {
+        RangeProof {
+            inner: ffi::RangeProof::new(self.inner),
+        }
+    }
+
+    /// Returns the bytes of the range proof.
+    pub fn as_bytes(&self) -> &'a [u8] {
+        self.inner
+    }
+
+    /// Get length.
+    pub fn len(&self) -> usize {
+        self.inner.len()
+    }
+
+    /// Check if it's empty.
+    pub fn is_empty(&self) -> bool {
+        self.inner.is_empty()
+    }
+
     /// Verify that the committed value is within a range.
     ///
     /// If the verification is successful, return the actual range of possible values.
@@ -153,6 +292,25 @@ impl RangeProof {
         sk: SecretKey,
         additional_commitment: &[u8],
         additional_generator: Generator,
+    ) -> Result<(Opening, Range<u64>), Error> {
+        let mut nonce = [0u8; 32];
+        nonce.copy_from_slice(&sk[..]);
+        self.rewind_with_nonce(
+            secp,
+            commitment,
+            &nonce,
+            additional_commitment,
+            additional_generator,
+        )
+    }
+
+    fn rewind_with_nonce<C: Verification>(
+        &self,
+        secp: &Secp256k1<C>,
+        commitment: PedersenCommitment,
+        nonce: &[u8; 32],
+        additional_commitment: &[u8],
+        additional_generator: Generator,
     ) -> Result<(Opening, Range<u64>), Error> {
         let mut min_value = 0u64;
         let mut max_value = 0u64;
@@ -169,7 +327,7 @@ impl RangeProof {
                 &mut value,
                 message.as_mut_ptr(),
                 &mut message_length,
-                sk.as_ptr(),
+                nonce.as_ptr(),
                 &mut min_value,
                 &mut max_value,
                 commitment.as_inner(),
@@ -198,6 +356,169 @@ impl RangeProof {
 
         Ok((opening, range))
     }
+
+    /// Verify a range proof and recover only the committed value and its blinding factor.
+    ///
+    /// Unlike [`RangeProofRef::rewind`], this skips recovering the embedded message and does not allocate,
+    /// which makes it the cheaper choice when scanning many outputs for ones we can open.
+    pub fn rewind_value_only<C: Verification>(
+        &self,
+        secp: &Secp256k1<C>,
+        commitment: PedersenCommitment,
+        sk: SecretKey,
+        additional_commitment: &[u8],
+        additional_generator: Generator,
+    ) -> Result<(u64, Tweak, Range<u64>), Error> {
+        let mut min_value = 0u64;
+        let mut max_value = 0u64;
+
+        let mut blinding_factor = [0u8; 32];
+        let mut value = 0u64;
+
+        let ret = unsafe {
+            ffi::secp256k1_rangeproof_rewind_value_only(
+                *secp.ctx(),
+                blinding_factor.as_mut_ptr(),
+                &mut value,
+                sk.as_ptr(),
+                &mut min_value,
+                &mut max_value,
+                commitment.as_inner(),
+                self.inner.as_ptr(),
+                self.inner.len(),
+                additional_commitment.as_ptr(),
+                additional_commitment.len(),
+                additional_generator.as_inner(),
+            )
+        };
+
+        if ret == 0 {
+            return Err(Error::InvalidRangeProof);
+        }
+
+        let range = Range {
+            start: min_value,
+            end: max_value + 1,
+        };
+
+        Ok((value, Tweak::from_slice(&blinding_factor)?, range))
+    }
+}
+
+/// Derive the range proof nonce shared between `sk` and `pk`.
+///
+/// The sender of an output creates its range proof with the nonce of their ephemeral key and the receiver's scan
+/// key, which the receiver recovers from their scan key and the ephemeral key, see [`scan_range_proofs`].
+pub fn range_proof_nonce<C: Signing>(
+    secp: &Secp256k1<C>,
+    sk: &SecretKey,
+    pk: &PublicKey,
+) -> Result<SecretKey, Error> {
+    let mut nonce = [0u8; 32];
+
+    let ret = unsafe {
+        ffi::secp256k1_rangeproof_ecdh_nonces(
+            *secp.ctx(),
+            nonce.as_mut_ptr(),
+            sk.as_ptr(),
+            pk.as_c_ptr(),
+            1,
+        )
+    };
+    debug_assert_eq!(ret, 1);
+
+    Ok(SecretKey::from_slice(&nonce)?)
+}
+
+/// An output to scan with [`scan_range_proofs`].
+#[derive(Debug, Clone, Copy)]
+pub struct ScanOutput<'a> {
+    /// The commitment to the value of the output.
+    pub commitment: PedersenCommitment,
+    /// The range proof of the output.
+    pub proof: RangeProofRef<'a>,
+    /// The ephemeral public key the sender derived the range proof nonce with.
+    pub ephemeral_key: PublicKey,
+    /// The additional data the range proof commits to.
+    pub additional_commitment: &'a [u8],
+    /// The generator of the output's asset.
+    pub additional_generator: Generator,
+}
+
+/// An output found by [`scan_range_proofs`].
+#[derive(Debug, Clone)]
+pub struct ScanHit {
+    /// The position of the output in the scanned outputs.
+    pub index: usize,
+    /// The information recovered from the output's range proof.
+    pub opening: Opening,
+    /// The range the output's value was proven to be in.
+    pub range: Range<u64>,
+}
+
+/// Find the outputs blinded to `scan_key` and rewind their range proofs.
+///
+/// The nonce of each output is the [`range_proof_nonce`] of `scan_key` and its ephemeral key, i.e. the SHA256 of
+/// their [`ecdh::SharedSecret`](::ecdh::SharedSecret). All nonces are derived in one batch, after which the
+/// range proofs are checked for a value encoded under their nonce. Only the proofs that pass this cheap check are
+/// fully verified and rewound, so scanning costs little more than the ECDH for outputs that are not ours.
+pub fn scan_range_proofs<C: Verification>(
+    secp: &Secp256k1<C>,
+    scan_key: SecretKey,
+    outputs: &[ScanOutput<'_>],
+) -> Vec<ScanHit> {
+    let ephemeral_keys = outputs
+        .iter()
+        .map(|output| output.ephemeral_key)
+        .collect::<Vec<_>>();
+    let mut nonces = vec![[0u8; 32]; outputs.len()];
+
+    let ret = unsafe {
+        ffi::secp256k1_rangeproof_ecdh_nonces(
+            *secp.ctx(),
+            nonces.as_mut_ptr() as *mut u8,
+            scan_key.as_ptr(),
+            // This cast is legit because PublicKey has repr(transparent).
+            ephemeral_keys.as_ptr() as *const ffi::PublicKey,
+            ephemeral_keys.len(),
+        )
+    };
+    // Both the scan key and the ephemeral keys are valid by construction.
+    debug_assert_eq!(ret, 1);
+
+    outputs
+        .iter()
+        .zip(nonces.iter())
+        .enumerate()
+        .filter(|(_, (output, nonce))| unsafe {
+            ffi::secp256k1_rangeproof_rewind_precheck(
+                *secp.ctx(),
+                nonce.as_ptr(),
+                output.commitment.as_inner(),
+                output.proof.inner.as_ptr(),
+                output.proof.inner.len(),
+                output.additional_generator.as_inner(),
+            ) == 1
+        })
+        .filter_map(|(index, (output, nonce))| {
+            let (opening, range) = output
+                .proof
+                .rewind_with_nonce(
+                    secp,
+                    output.commitment,
+                    nonce,
+                    output.additional_commitment,
+                    output.additional_generator,
+                )
+                .ok()?;
+
+            Some(ScanHit {
+                index,
+                opening,
+                range,
+            })
+        })
+        .collect()
 }
 
 #[cfg(feature = "bitcoin_hashes")]
@@ -250,6 +571,7 @@ impl<'de> ::serde::Deserialize<'de> for RangeProof {
 /// The result of rewinding a range proof.
 ///
 /// Rewinding a range proof reveals ("opens") the stored information and allows us to access information the prover embedded in the proof.
+#[derive(Debug, Clone)]
 pub struct Opening {
     /// The value that the prover originally committed to in the Pedersen commitment.
     pub value: u64,
@@ -308,6 +630,93 @@ mod tests {
             .unwrap();
     }
 
+    #[test]
+    fn create_into_buffer_and_verify_borrowed_range_proof() {
+        let value = 1_000;
+        let commitment_secrets = CommitmentSecrets::random(value);
+        let tag = Tag::random();
+        let commitment = commitment_secrets.commit(tag);
+
+        let message = b"foo";
+        let additional_commitment = b"bar";
+
+        let sk = SecretKey::new(&mut thread_rng());
+        let additional_generator =
+            Generator::new_blinded(SECP256K1, tag, commitment_secrets.generator_blinding_factor);
+
+        let mut buffer = [0u8; RANGEPROOF_MAX_LENGTH];
+        let proof = RangeProofRef::new_into(
+            SECP256K1,
+            &mut buffer,
+            1,
+            commitment,
+            value,
+            commitment_secrets.value_blinding_factor,
+            message,
+            additional_commitment,
+            sk,
+            0,
+            52,
+            additional_generator,
+        )
+        .unwrap();
+        let proof_len = proof.len();
+
+        let range = proof
+            .verify(
+                SECP256K1,
+                commitment,
+                additional_commitment,
+                additional_generator,
+            )
+            .unwrap();
+        let (opening, _) = proof
+            .rewind(
+                SECP256K1,
+                commitment,
+                sk,
+                additional_commitment,
+                additional_generator,
+            )
+            .unwrap();
+        assert_eq!(opening.value, value);
+
+        let borrowed = RangeProofRef::from_slice(&buffer[..proof_len]).unwrap();
+        let owned = RangeProof::from_slice(&buffer[..proof_len]).unwrap();
+        assert_eq!(borrowed, owned.as_proof_ref());
+        assert_eq!(borrowed.to_owned(), owned);
+        assert_eq!(
+            owned
+                .verify(
+                    SECP256K1,
+                    commitment,
+                    additional_commitment,
+                    additional_generator
+                )
+                .unwrap(),
+            range
+        );
+
+        let mut short_buffer = [0u8; 64];
+        assert_eq!(
+            RangeProofRef::new_into(
+                SECP256K1,
+                &mut short_buffer,
+                1,
+                commitment,
+                value,
+                commitment_secrets.value_blinding_factor,
+                message,
+                additional_commitment,
+                sk,
+                0,
+                52,
+                additional_generator,
+            ),
+            Err(Error::CannotMakeRangeProof)
+        );
+    }
+
     #[test]
     fn rewind_range_proof() {
         let value = 1_000;
@@ -337,7 +746,7 @@ mod tests {
         )
         .unwrap();
 
-        let (opening, _range) = proof
+        let (opening, opening_range) = proof
             .rewind(
                 SECP256K1,
                 commitment,
@@ -357,5 +766,107 @@ mod tests {
         assert!(opening
             .message
             .ends_with(&vec![0; opening.message.len() - message.len()]));
+
+        let (value, blinding_factor, range) = proof
+            .rewind_value_only(
+                SECP256K1,
+                commitment,
+                sk,
+                additional_commitment,
+                additional_generator,
+            )
+            .unwrap();
+
+        assert_eq!(value, commitment_secrets.value);
+        assert_eq!(blinding_factor, commitment_secrets.value_blinding_factor);
+        assert_eq!(range, opening_range);
+
+        let wrong_sk = SecretKey::new(&mut thread_rng());
+        assert!(proof
+            .rewind_value_only(
+                SECP256K1,
+                commitment,
+                wrong_sk,
+                additional_commitment,
+                additional_generator,
+            )
+            .is_err());
+    }
+
+    #[test]
+    fn scan_range_proofs_finds_our_outputs() {
+        let scan_key = SecretKey::new(&mut thread_rng());
+        let scan_pk = PublicKey::from_secret_key(SECP256K1, &scan_key);
+        let other_pk = PublicKey::from_secret_key(SECP256K1, &SecretKey::new(&mut thread_rng()));
+        let additional_commitment = b"bar";
+
+        let outputs = [(1_000, scan_pk), (2_000, other_pk), (3_000, scan_pk)]
+            .iter()
+            .map(|&(value, receiver)| {
+                let commitment_secrets = CommitmentSecrets::random(value);
+                let tag = Tag::random();
+                let commitment = commitment_secrets.commit(tag);
+                let additional_generator = Generator::new_blinded(
+                    SECP256K1,
+                    tag,
+                    commitment_secrets.generator_blinding_factor,
+                );
+
+                let ephemeral_key = SecretKey::new(&mut thread_rng());
+                let nonce = range_proof_nonce(SECP256K1, &ephemeral_key, &receiver).unwrap();
+                let proof = RangeProof::new(
+                    SECP256K1,
+                    1,
+                    commitment,
+                    value,
+                    commitment_secrets.value_blinding_factor,
+                    b"foo",
+                    additional_commitment,
+                    nonce,
+                    0,
+                    52,
+                    additional_generator,
+                )
+                .unwrap();
+
+                (
+                    commitment_secrets,
+                    commitment,
+                    proof,
+                    PublicKey::from_secret_key(SECP256K1, &ephemeral_key),
+                    additional_generator,
+                )
+            })
+            .collect::<Vec<_>>();
+        let scan_outputs = outputs
+            .iter()
+            .map(
+                |(_, commitment, proof, ephemeral_key, additional_generator)| ScanOutput {
+                    commitment: *commitment,
+                    proof: proof.as_proof_ref(),
+                    ephemeral_key: *ephemeral_key,
+                    additional_commitment,
+                    additional_generator: *additional_generator,
+                },
+            )
+            .collect::<Vec<_>>();
+
+        let hits = scan_range_proofs(SECP256K1, scan_key, &scan_outputs);
+
+        assert_eq!(
+            hits.iter().map(|hit| hit.index).collect::<Vec<_>>(),
+            vec![0, 2]
+        );
+        for hit in hits {
+            let commitment_secrets = &outputs[hit.index].0;
+            assert_eq!(hit.opening.value, commitment_secrets.value);
+            assert_eq!(
+                hit.opening.blinding_factor,
+                commitment_secrets.value_blinding_factor
+            );
+            assert!(hit.opening.message.starts_with(b"foo"));
+            assert!(hit.range.start <= commitment_secrets.value);
+            assert!(hit.range.end > commitment_secrets.value);
+        }
     }
 }
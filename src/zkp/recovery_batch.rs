@@ -0,0 +1,109 @@
+//! Public key recovery for many ECDSA signatures at once.
+//!
+//! Indexers recover the signer of every signature in a block. Recovering them in one batch shares the inversion of
+//! the signatures' `r` values and the conversion of the recovered keys to affine coordinates.
+
+use ffi::{self, CPtr};
+use recovery::RecoverableSignature;
+use {Message, PublicKey, Secp256k1, Verification};
+
+/// Recovers the public keys of a batch of signatures, each given together with its message, into `pubkeys`.
+///
+/// `pubkeys[i]` receives the key recovered from `batch[i]`. If a signature cannot be recovered, its entry of
+/// `pubkeys` is left unchanged and the positions of all such signatures are returned, in ascending order.
+///
+/// # Panics
+///
+/// Panics if `pubkeys` is shorter than `batch`.
+pub fn recover_batch<C: Verification>(
+    secp: &Secp256k1<C>,
+    batch: &[(&RecoverableSignature, &Message)],
+    pubkeys: &mut [PublicKey],
+) -> Result<(), Vec<usize>> {
+    assert!(pubkeys.len() >= batch.len());
+
+    let sigs = batch
+        .iter()
+        .map(|&(sig, _)| sig.as_c_ptr())
+        .collect::<Vec<_>>();
+    let msgs = batch
+        .iter()
+        .map(|&(_, msg)| msg.as_c_ptr())
+        .collect::<Vec<_>>();
+    let mut invalid = vec![0usize; batch.len()];
+    let mut n_invalid = 0;
+
+    let ret = unsafe {
+        ffi::secp256k1_ecdsa_recover_batch(
+            *secp.ctx(),
+            // This cast is legit because PublicKey has repr(transparent).
+            pubkeys.as_mut_ptr() as *mut ffi::PublicKey,
+            invalid.as_mut_ptr(),
+            &mut n_invalid,
+            sigs.as_ptr(),
+            msgs.as_ptr(),
+            batch.len(),
+        )
+    };
+    if ret == 1 {
+        return Ok(());
+    }
+
+    invalid.truncate(n_invalid);
+    Err(invalid)
+}
+
+#[cfg(all(test, feature = "global-context"))] // use global context for convenience
+mod tests {
+    use super::*;
+    use rand::{thread_rng, RngCore};
+    use SECP256K1;
+
+    #[cfg(target_arch = "wasm32")]
+    use wasm_bindgen_test::wasm_bindgen_test as test;
+
+    fn random_batch(n: usize) -> Vec<(RecoverableSignature, Message, PublicKey)> {
+        (0..n)
+            .map(|_| {
+                let (sk, pk) = SECP256K1.generate_keypair(&mut thread_rng());
+                let mut buf = [0u8; 32];
+                thread_rng().fill_bytes(&mut buf);
+                let msg = Message::from_slice(&buf).unwrap();
+                let sig = SECP256K1.sign_recoverable(&msg, &sk);
+                (sig, msg, pk)
+            })
+            .collect()
+    }
+
+    #[test]
+    fn recover_batch_writes_into_buffer() {
+        let batch = random_batch(70);
+        let refs = batch
+            .iter()
+            .map(|&(ref sig, ref msg, _)| (sig, msg))
+            .collect::<Vec<_>>();
+        let mut pubkeys = vec![batch[0].2; 70];
+
+        assert_eq!(recover_batch(SECP256K1, &refs, &mut pubkeys), Ok(()));
+        for (&(_, _, pk), recovered) in batch.iter().zip(pubkeys.iter()) {
+            assert_eq!(pk, *recovered);
+        }
+        assert_eq!(recover_batch(SECP256K1, &[], &mut []), Ok(()));
+    }
+
+    #[test]
+    fn recover_batch_with_other_messages() {
+        let batch = random_batch(10);
+        let mut refs = batch
+            .iter()
+            .map(|&(ref sig, ref msg, _)| (sig, msg))
+            .collect::<Vec<_>>();
+        let mut pubkeys = vec![batch[0].2; 10];
+
+        // Signatures of other messages recover other keys
+        refs[3].1 = &batch[4].1;
+        assert!(recover_batch(SECP256K1, &refs, &mut pubkeys).is_ok());
+        assert_ne!(pubkeys[3], batch[3].2);
+        assert_eq!(pubkeys[4], batch[4].2);
+    }
+}
@@ -0,0 +1,129 @@
+//! Batch verification of BIP340 Schnorr signatures.
+//!
+//! All signatures of a batch are checked together with a single multi-scalar multiplication, which is several times
+//! faster than verifying them one by one once the batch holds more than a handful of signatures.
+
+use ffi::{self, CPtr};
+use {schnorrsig, Message, ScratchSpace, Secp256k1, Verification};
+
+use core::ptr;
+
+/// Verifies a batch of Schnorr signatures, each given together with its message and public key.
+///
+/// If the batch does not verify, every signature is checked on its own and the indices of the invalid ones are
+/// returned, in ascending order. An empty batch is valid. With a scratch space the batch is verified with Pippenger's
+/// or Strauss' algorithm, without one the points are multiplied one at a time.
+pub fn verify_schnorrsig_batch<C: Verification>(
+    secp: &Secp256k1<C>,
+    scratch: Option<&mut ScratchSpace>,
+    batch: &[(&schnorrsig::Signature, &Message, &schnorrsig::PublicKey)],
+) -> Result<(), Vec<usize>> {
+    let sigs = batch
+        .iter()
+        .map(|&(sig, _, _)| sig.as_c_ptr())
+        .collect::<Vec<_>>();
+    let msgs = batch
+        .iter()
+        .map(|&(_, msg, _)| msg.as_c_ptr())
+        .collect::<Vec<_>>();
+    let pubkeys = batch
+        .iter()
+        .map(|&(_, _, pk)| pk.as_c_ptr())
+        .collect::<Vec<_>>();
+    let scratch = match scratch {
+        Some(scratch) => scratch.as_mut_ptr(),
+        None => ptr::null_mut(),
+    };
+
+    let ret = unsafe {
+        ffi::secp256k1_schnorrsig_verify_batch(
+            *secp.ctx(),
+            scratch,
+            sigs.as_ptr(),
+            msgs.as_ptr(),
+            pubkeys.as_ptr(),
+            batch.len(),
+        )
+    };
+    if ret == 1 {
+        return Ok(());
+    }
+
+    let invalid = batch
+        .iter()
+        .enumerate()
+        .filter(|&(_, &(sig, msg, pk))| secp.schnorrsig_verify(sig, msg, pk).is_err())
+        .map(|(i, _)| i)
+        .collect::<Vec<_>>();
+    Err(invalid)
+}
+
+#[cfg(all(test, feature = "global-context"))] // use global context for convenience
+mod tests {
+    use super::*;
+    use rand::{thread_rng, RngCore};
+    use schnorrsig::KeyPair;
+    use SECP256K1;
+
+    #[cfg(target_arch = "wasm32")]
+    use wasm_bindgen_test::wasm_bindgen_test as test;
+
+    fn random_batch(n: usize) -> Vec<(schnorrsig::Signature, Message, schnorrsig::PublicKey)> {
+        (0..n)
+            .map(|_| {
+                let keypair = KeyPair::new(SECP256K1, &mut thread_rng());
+                let mut buf = [0u8; 32];
+                thread_rng().fill_bytes(&mut buf);
+                let msg = Message::from_slice(&buf).unwrap();
+                let sig = SECP256K1.schnorrsig_sign(&msg, &keypair);
+                let pk = schnorrsig::PublicKey::from_keypair(SECP256K1, &keypair);
+                (sig, msg, pk)
+            })
+            .collect()
+    }
+
+    fn as_refs(
+        batch: &[(schnorrsig::Signature, Message, schnorrsig::PublicKey)],
+    ) -> Vec<(&schnorrsig::Signature, &Message, &schnorrsig::PublicKey)> {
+        batch
+            .iter()
+            .map(|&(ref s, ref m, ref p)| (s, m, p))
+            .collect()
+    }
+
+    #[test]
+    fn verify_batch_with_and_without_scratch_space() {
+        let batch = random_batch(50);
+        let mut scratch = ScratchSpace::new(1 << 20);
+
+        assert_eq!(
+            verify_schnorrsig_batch(SECP256K1, None, &as_refs(&batch)),
+            Ok(())
+        );
+        assert_eq!(
+            verify_schnorrsig_batch(SECP256K1, Some(&mut scratch), &as_refs(&batch)),
+            Ok(())
+        );
+        assert_eq!(verify_schnorrsig_batch(SECP256K1, None, &[]), Ok(()));
+    }
+
+    #[test]
+    fn verify_batch_reports_invalid_signatures() {
+        let batch = random_batch(20);
+        let mut scratch = ScratchSpace::new(1 << 20);
+        let mut refs = as_refs(&batch);
+
+        // Signatures of other messages
+        refs[3].1 = &batch[4].1;
+        refs[17].1 = &batch[0].1;
+
+        assert_eq!(
+            verify_schnorrsig_batch(SECP256K1, Some(&mut scratch), &refs),
+            Err(vec![3, 17])
+        );
+        assert_eq!(
+            verify_schnorrsig_batch(SECP256K1, None, &refs),
+            Err(vec![3, 17])
+        );
+    }
+}
@@ -0,0 +1,119 @@
+//! Scratch space for algorithms whose memory use grows with their input.
+
+use ffi;
+use ffi::types::c_void;
+use {Secp256k1, Verification};
+
+use std::time::Instant;
+
+/// A unit of scratch memory aligned such that the C library can place any object in it.
+#[repr(C, align(16))]
+#[derive(Clone, Copy)]
+pub(crate) struct ScratchWord(pub(crate) [u8; 16]);
+
+/// Reusable memory for multi-scalar multiplications.
+///
+/// Functions taking a scratch space use it to combine many points at once with Pippenger's or Strauss' algorithm,
+/// in batches that fit into its size. Without one they fall back to a much slower point-by-point algorithm.
+/// Creating a scratch space once and passing it to many calls avoids allocating memory for each of them.
+pub struct ScratchSpace {
+    scratch: *mut ffi::ScratchSpace,
+    size: usize,
+    _memory: Box<[ScratchWord]>,
+}
+
+unsafe impl Send for ScratchSpace {}
+
+impl ScratchSpace {
+    /// Creates a scratch space that makes `size` bytes available to the algorithms using it.
+    pub fn new(size: usize) -> ScratchSpace {
+        let prealloc_size = unsafe { ffi::secp256k1_scratch_space_preallocated_size(size) };
+        let n_words = (prealloc_size + 15) / 16;
+        let mut memory = vec![ScratchWord([0; 16]); n_words].into_boxed_slice();
+
+        let scratch = unsafe {
+            ffi::secp256k1_scratch_space_preallocated_create(
+                ffi::secp256k1_context_no_precomp,
+                memory.as_mut_ptr() as *mut c_void,
+                size,
+            )
+        };
+        debug_assert!(!scratch.is_null());
+
+        ScratchSpace {
+            scratch,
+            size,
+            _memory: memory,
+        }
+    }
+
+    /// Returns the number of bytes available to the algorithms using this scratch space.
+    pub fn size(&self) -> usize {
+        self.size
+    }
+
+    /// Measures which multi-scalar multiplication algorithm is fastest on this CPU for each number of points, and makes
+    /// all functions given this scratch space choose by these measurements.
+    ///
+    /// Without calibration the choice follows measurements taken on other hardware. Calibration takes around a second
+    /// for a scratch space of a few megabytes, less for smaller ones, and applies to this scratch space only. Returns
+    /// `false` and leaves the scratch space unchanged if it is too small for Pippenger's algorithm.
+    pub fn calibrate<C: Verification>(&mut self, secp: &Secp256k1<C>) -> bool {
+        let start = Instant::now();
+        let ret = unsafe {
+            ffi::secp256k1_scratch_space_calibrate(
+                *secp.ctx(),
+                self.scratch,
+                elapsed_nanos,
+                &start as *const Instant as *mut c_void,
+            )
+        };
+        ret == 1
+    }
+
+    /// Obtains a raw mutable pointer suitable for use with FFI functions.
+    pub fn as_mut_ptr(&mut self) -> *mut ffi::ScratchSpace {
+        self.scratch
+    }
+}
+
+unsafe extern "C" fn elapsed_nanos(data: *mut c_void) -> u64 {
+    let elapsed = (*(data as *const Instant)).elapsed();
+    elapsed.as_secs() * 1_000_000_000 + u64::from(elapsed.subsec_nanos())
+}
+
+impl Drop for ScratchSpace {
+    fn drop(&mut self) {
+        unsafe {
+            ffi::secp256k1_scratch_space_preallocated_destroy(
+                ffi::secp256k1_context_no_precomp,
+                self.scratch,
+            );
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[cfg(target_arch = "wasm32")]
+    use wasm_bindgen_test::wasm_bindgen_test as test;
+
+    #[test]
+    fn scratch_space_is_aligned() {
+        let mut scratch = ScratchSpace::new(1000);
+
+        assert_eq!(scratch.size(), 1000);
+        assert_eq!(scratch.as_mut_ptr() as usize % 16, 0);
+    }
+
+    #[test]
+    #[cfg(feature = "global-context")]
+    fn calibrate_scratch_space() {
+        use SECP256K1;
+
+        assert!(!ScratchSpace::new(64).calibrate(SECP256K1));
+        assert!(ScratchSpace::new(1 << 18).calibrate(SECP256K1));
+    }
+}
@@ -6,9 +6,19 @@ use Verification;
 use {Error, Generator, Secp256k1};
 
 /// Represents a surjection proof.
+///
+/// The proof is stored in its serialized form, so it only takes as much memory as its serialization.
 #[derive(Debug, PartialEq, Clone, Eq, Hash)]
 pub struct SurjectionProof {
-    inner: ffi::SurjectionProof,
+    inner: Box<[u8]>,
+}
+
+/// A surjection proof borrowed from a serialized byte slice.
+///
+/// Parsing only checks the structure of the proof, the bytes are neither copied nor converted.
+#[derive(Debug, PartialEq, Clone, Copy, Eq, Hash)]
+pub struct SurjectionProofRef<'a> {
+    inner: &'a [u8],
 }
 
 #[cfg(feature = "rand")]
@@ -22,6 +32,8 @@ mod with_rand {
         ///
         /// Mathematically, we are proving that there exists a surjective mapping between the domain and codomain of tags.
         /// Blinding a tag produces a [`Generator`]. As such, to create this proof we need to provide the `[Generator]`s and the respective blinding factors that were used to create them.
+        ///
+        /// Up to three elements of the domain are put in the anonymity set of the proof.
         pub fn new<C: Signing, R: Rng>(
             secp: &Secp256k1<C>,
             rng: &mut R,
@@ -29,13 +41,43 @@ mod with_rand {
             codomain_blinding_factor: Tweak,
             domain: &[(Generator, Tag, Tweak)],
         ) -> Result<SurjectionProof, Error> {
+            SurjectionProof::new_with_n_used_inputs(
+                secp,
+                rng,
+                codomain_tag,
+                codomain_blinding_factor,
+                domain,
+                domain.len().min(3),
+            )
+        }
+
+        /// Prove that a given tag - when blinded - is contained within another set of blinded tags, using
+        /// `n_used_inputs` randomly selected elements of the domain as the anonymity set.
+        ///
+        /// Larger anonymity sets hide the codomain's preimage better but produce proportionally larger proofs
+        /// (32 bytes per used input). The set is chosen in a single pass, so this never fails as long as the
+        /// domain contains `codomain_tag` and `n_used_inputs` is between 1 and the size of the domain.
+        pub fn new_with_n_used_inputs<C: Signing, R: Rng>(
+            secp: &Secp256k1<C>,
+            rng: &mut R,
+            codomain_tag: Tag,
+            codomain_blinding_factor: Tweak,
+            domain: &[(Generator, Tag, Tweak)],
+            n_used_inputs: usize,
+        ) -> Result<SurjectionProof, Error> {
+            if domain.len() > ffi::SURJECTIONPROOF_MAX_N_INPUTS
+                || n_used_inputs > ffi::SURJECTIONPROOF_MAX_USED_INPUTS
+                || n_used_inputs > domain.len()
+            {
+                return Err(Error::CannotProveSurjection);
+            }
+
             let mut proof = ffi::SurjectionProof::new();
 
             let mut seed = [0u8; 32];
             rng.fill_bytes(&mut seed);
 
             let mut domain_index = 0;
-            let max_iteration = 100;
 
             let mut domain_blinded_tags = Vec::with_capacity(domain.len());
             let mut domain_tags = Vec::with_capacity(domain.len());
@@ -48,15 +90,14 @@ mod with_rand {
             }
 
             let ret = unsafe {
-                ffi::secp256k1_surjectionproof_initialize(
+                ffi::secp256k1_surjectionproof_initialize_direct(
                     *secp.ctx(),
                     &mut proof,
                     &mut domain_index,
                     domain_tags.as_ptr(),
                     domain.len(),
-                    domain.len().min(3),
+                    n_used_inputs,
                     codomain_tag.as_inner(),
-                    max_iteration,
                     seed.as_ptr(),
                 )
             };
@@ -89,7 +130,26 @@ mod with_rand {
                 return Err(Error::CannotProveSurjection);
             }
 
-            Ok(SurjectionProof { inner: proof })
+            let mut size = unsafe {
+                ffi::secp256k1_surjectionproof_serialized_size(
+                    ffi::secp256k1_context_no_precomp,
+                    &proof,
+                )
+            };
+            let mut bytes = vec![0u8; size];
+            let ret = unsafe {
+                ffi::secp256k1_surjectionproof_serialize(
+                    ffi::secp256k1_context_no_precomp,
+                    bytes.as_mut_ptr(),
+                    &mut size,
+                    &proof,
+                )
+            };
+            assert_eq!(ret, 1, "failed to serialize surjection proof"); // This is safe as long as we correctly computed the size of the proof upfront using `secp256k1_surjectionproof_serialized_size`.
+
+            Ok(SurjectionProof {
+                inner: bytes.into_boxed_slice(),
+            })
         }
     }
 }
@@ -97,61 +157,84 @@ mod with_rand {
 impl SurjectionProof {
     /// Creates a surjection proof from a slice of bytes.
     pub fn from_slice(bytes: &[u8]) -> Result<Self, Error> {
-        let mut proof = ffi::SurjectionProof::new();
-
-        let ret = unsafe {
-            ffi::secp256k1_surjectionproof_parse(
-                ffi::secp256k1_context_no_precomp,
-                &mut proof,
-                bytes.as_ptr(),
-                bytes.len(),
-            )
-        };
-
-        if ret != 1 {
-            return Err(Error::InvalidSurjectionProof);
-        }
+        Ok(SurjectionProofRef::from_slice(bytes)?.to_owned())
+    }
 
-        Ok(SurjectionProof { inner: proof })
+    /// Borrows this surjection proof as a [`SurjectionProofRef`].
+    pub fn as_proof_ref(&self) -> SurjectionProofRef<'_> {
+        SurjectionProofRef { inner: &self.inner }
     }
 
     /// Serializes a surjection proof.
     ///
     /// The format of this serialization is stable and platform-independent.
     pub fn serialize(&self) -> Vec<u8> {
-        let mut size = unsafe {
-            ffi::secp256k1_surjectionproof_serialized_size(
-                ffi::secp256k1_context_no_precomp,
-                &self.inner,
-            )
-        };
+        self.inner.to_vec()
+    }
 
-        let mut bytes = vec![0u8; size];
+    /// Find the length of surjection proof when serialized
+    pub fn len(&self) -> usize {
+        self.inner.len()
+    }
 
-        let ret = unsafe {
-            ffi::secp256k1_surjectionproof_serialize(
-                ffi::secp256k1_context_no_precomp,
-                bytes.as_mut_ptr(),
-                &mut size,
-                &self.inner,
-            )
-        };
-        assert_eq!(ret, 1, "failed to serialize surjection proof"); // This is safe as long as we correctly computed the size of the proof upfront using `secp256k1_surjectionproof_serialized_size`.
+    /// Verify a surjection proof.
+    #[must_use]
+    pub fn verify<C: Verification>(
+        &self,
+        secp: &Secp256k1<C>,
+        codomain: Generator,
+        domain: &[Generator],
+    ) -> bool {
+        self.as_proof_ref().verify(secp, codomain, domain)
+    }
+}
+
+impl<'a> SurjectionProofRef<'a> {
+    /// Borrows a surjection proof from a slice of bytes, checking that it is well-formed.
+    pub fn from_slice(bytes: &'a [u8]) -> Result<Self, Error> {
+        if bytes.len() < 2 {
+            return Err(Error::InvalidSurjectionProof);
+        }
+        let n_inputs = bytes[0] as usize + ((bytes[1] as usize) << 8);
+        let bitmap_len = (n_inputs + 7) / 8;
+        if n_inputs > ffi::SURJECTIONPROOF_MAX_N_INPUTS || bytes.len() < 2 + bitmap_len {
+            return Err(Error::InvalidSurjectionProof);
+        }
 
-        bytes
+        let bitmap = &bytes[2..2 + bitmap_len];
+        // The final byte of the bitmap must not have any padding bits set.
+        if n_inputs % 8 != 0 && bitmap[bitmap_len - 1] >> (n_inputs % 8) != 0 {
+            return Err(Error::InvalidSurjectionProof);
+        }
+        let n_used_inputs = bitmap
+            .iter()
+            .map(|byte| byte.count_ones() as usize)
+            .sum::<usize>();
+        if bytes.len() != 2 + bitmap_len + 32 * (1 + n_used_inputs) {
+            return Err(Error::InvalidSurjectionProof);
+        }
+
+        Ok(SurjectionProofRef { inner: bytes })
+    }
+
+    /// Copies the borrowed surjection proof into an owned [`SurjectionProof`].
+    pub fn to_owned(&self) -> SurjectionProof {
+        SurjectionProof {
+            inner: self.inner.into(),
+        }
+    }
+
+    /// Returns the serialization of the surjection proof.
+    pub fn as_bytes(&self) -> &'a [u8] {
+        self.inner
     }
 
     /// Find the length of surjection proof when serialized
     pub fn len(&self) -> usize {
-        unsafe {
-            ffi::secp256k1_surjectionproof_serialized_size(
-                ffi::secp256k1_context_no_precomp,
-                &self.inner,
-            )
-        }
+        self.inner.len()
     }
 
-    /// Verify a surjection proof.
+    /// Verify a surjection proof directly from its serialization.
     #[must_use]
     pub fn verify<C: Verification>(
         &self,
@@ -167,9 +250,10 @@ impl SurjectionProof {
         };
 
         let ret = unsafe {
-            ffi::secp256k1_surjectionproof_verify(
+            ffi::secp256k1_surjectionproof_verify_serialized(
                 *secp.ctx(),
-                &self.inner,
+                self.inner.as_ptr(),
+                self.inner.len(),
                 domain_blinded_tags.as_ptr(),
                 domain_blinded_tags.len(),
                 codomain.as_inner(),
@@ -271,6 +355,47 @@ mod tests {
         ))
     }
 
+    #[test]
+    fn test_create_and_verify_surjection_proof_with_n_used_inputs() {
+        let domain = (0..10).map(|_| random_blinded_tag()).collect::<Vec<_>>();
+        let domain_blinded_tags = domain.iter().map(|(_, gen, _)| *gen).collect::<Vec<_>>();
+        let domain = domain
+            .into_iter()
+            .map(|(tag, gen, bf)| (gen, tag, bf))
+            .collect::<Vec<_>>();
+
+        let codomain_tag = domain[7].1;
+        let (codomain_blinded_tag, codomain_bf) = blind_tag(codomain_tag);
+
+        for n_used_inputs in 1..=domain.len() {
+            let proof = SurjectionProof::new_with_n_used_inputs(
+                SECP256K1,
+                &mut thread_rng(),
+                codomain_tag,
+                codomain_bf,
+                &domain,
+                n_used_inputs,
+            )
+            .unwrap();
+
+            assert_eq!(proof.len(), 2 + 2 + 32 * (1 + n_used_inputs));
+            assert!(proof.verify(SECP256K1, codomain_blinded_tag, &domain_blinded_tags));
+        }
+
+        for &n_used_inputs in &[0, domain.len() + 1] {
+            let result = SurjectionProof::new_with_n_used_inputs(
+                SECP256K1,
+                &mut thread_rng(),
+                codomain_tag,
+                codomain_bf,
+                &domain,
+                n_used_inputs,
+            );
+
+            assert_eq!(result, Err(Error::CannotProveSurjection));
+        }
+    }
+
     #[test]
     fn test_serialize_and_parse_surjection_proof() {
         let (domain_tag_1, domain_blinded_tag_1, domain_bf_1) = random_blinded_tag();
@@ -291,6 +416,47 @@ mod tests {
         assert_eq!(parsed, proof)
     }
 
+    #[test]
+    fn test_verify_borrowed_surjection_proof() {
+        let (domain_tag_1, domain_blinded_tag_1, domain_bf_1) = random_blinded_tag();
+        let (domain_tag_2, domain_blinded_tag_2, domain_bf_2) = random_blinded_tag();
+        let codomain_tag = domain_tag_2;
+        let (codomain_blinded_tag, codomain_bf) = blind_tag(codomain_tag);
+
+        let proof = SurjectionProof::new(
+            SECP256K1,
+            &mut thread_rng(),
+            codomain_tag,
+            codomain_bf,
+            &[
+                (domain_blinded_tag_1, domain_tag_1, domain_bf_1),
+                (domain_blinded_tag_2, domain_tag_2, domain_bf_2),
+            ],
+        )
+        .unwrap();
+        let domain = [domain_blinded_tag_1, domain_blinded_tag_2];
+
+        let mut bytes = proof.serialize();
+        let borrowed = SurjectionProofRef::from_slice(&bytes).unwrap();
+        assert_eq!(borrowed, proof.as_proof_ref());
+        assert_eq!(borrowed.to_owned(), proof);
+        assert_eq!(borrowed.len(), proof.len());
+        assert!(borrowed.verify(SECP256K1, codomain_blinded_tag, &domain));
+        assert!(!borrowed.verify(SECP256K1, domain_blinded_tag_1, &domain));
+
+        let last = bytes.len() - 1;
+        bytes[last] ^= 1;
+        let borrowed = SurjectionProofRef::from_slice(&bytes).unwrap();
+        assert!(!borrowed.verify(SECP256K1, codomain_blinded_tag, &domain));
+
+        // Trailing garbage, a truncated signature and padding bits in the bitmap are all rejected.
+        bytes.push(0);
+        assert!(SurjectionProofRef::from_slice(&bytes).is_err());
+        bytes.truncate(bytes.len() - 2);
+        assert!(SurjectionProofRef::from_slice(&bytes).is_err());
+        assert!(SurjectionProofRef::from_slice(&[0x02, 0x00, 0x05]).is_err());
+    }
+
     fn random_blinded_tag() -> (Tag, Generator, Tweak) {
         let tag = Tag::random();
 
@@ -0,0 +1,150 @@
+//! Batch checking of tweaked x-only public keys.
+//!
+//! Verifying a Taproot output means checking that the output key is the internal key tweaked with the commitment to
+//! the script tree. All checks of a batch are combined into a single multi-scalar multiplication, which is much faster
+//! than checking every output on its own.
+
+use ffi::{self, CPtr};
+use {schnorrsig, ScratchSpace, Secp256k1, Verification};
+
+use core::ptr;
+
+/// Checks a batch of tweaked public keys, each given as internal key, tweak, tweaked key and parity of the tweaked key.
+///
+/// If the batch does not verify, the checks are repeated one by one and the index of the first failing one is
+/// returned. An empty batch is valid. With a scratch space the batch is checked with Pippenger's or Strauss'
+/// algorithm, without one the points are multiplied one at a time.
+pub fn verify_tweak_add_batch<C: Verification>(
+    secp: &Secp256k1<C>,
+    scratch: Option<&mut ScratchSpace>,
+    batch: &[(
+        &schnorrsig::PublicKey,
+        &[u8; 32],
+        &schnorrsig::PublicKey,
+        bool,
+    )],
+) -> Result<(), usize> {
+    let tweaked_keys = batch
+        .iter()
+        .map(|&(_, _, tweaked, _)| tweaked.serialize())
+        .collect::<Vec<_>>();
+    let tweaked_ptrs = tweaked_keys
+        .iter()
+        .map(|key| key.as_ptr())
+        .collect::<Vec<_>>();
+    let parities = batch
+        .iter()
+        .map(|&(_, _, _, parity)| parity as ffi::types::c_int)
+        .collect::<Vec<_>>();
+    let internal_keys = batch
+        .iter()
+        .map(|&(internal, _, _, _)| internal.as_c_ptr())
+        .collect::<Vec<_>>();
+    let tweaks = batch
+        .iter()
+        .map(|&(_, tweak, _, _)| tweak.as_ptr())
+        .collect::<Vec<_>>();
+    let scratch = match scratch {
+        Some(scratch) => scratch.as_mut_ptr(),
+        None => ptr::null_mut(),
+    };
+
+    let ret = unsafe {
+        ffi::secp256k1_xonly_pubkey_tweak_add_check_batch(
+            *secp.ctx(),
+            scratch,
+            tweaked_ptrs.as_ptr(),
+            parities.as_ptr(),
+            internal_keys.as_ptr(),
+            tweaks.as_ptr(),
+            batch.len(),
+        )
+    };
+    if ret == 1 {
+        return Ok(());
+    }
+
+    // The batch check only fails on a tweak or tweaked key that also fails its own check; a scratch space that is
+    // too small makes the library fall back to multiplying the points one at a time rather than fail.
+    let first_invalid = batch
+        .iter()
+        .position(|&(internal, tweak, tweaked, parity)| {
+            !internal.tweak_add_check(secp, tweaked, parity, *tweak)
+        })
+        .expect("a failing batch contains a failing check");
+    Err(first_invalid)
+}
+
+#[cfg(all(test, feature = "global-context"))] // use global context for convenience
+mod tests {
+    use super::*;
+    use rand::{thread_rng, RngCore};
+    use schnorrsig::KeyPair;
+    use SECP256K1;
+
+    #[cfg(target_arch = "wasm32")]
+    use wasm_bindgen_test::wasm_bindgen_test as test;
+
+    fn random_batch(
+        n: usize,
+    ) -> Vec<(schnorrsig::PublicKey, [u8; 32], schnorrsig::PublicKey, bool)> {
+        (0..n)
+            .map(|_| {
+                let keypair = KeyPair::new(SECP256K1, &mut thread_rng());
+                let internal = schnorrsig::PublicKey::from_keypair(SECP256K1, &keypair);
+                let mut tweak = [0u8; 32];
+                thread_rng().fill_bytes(&mut tweak);
+                let mut tweaked = internal;
+                let parity = tweaked.tweak_add_assign(SECP256K1, &tweak).unwrap();
+                (internal, tweak, tweaked, parity)
+            })
+            .collect()
+    }
+
+    fn as_refs(
+        batch: &[(schnorrsig::PublicKey, [u8; 32], schnorrsig::PublicKey, bool)],
+    ) -> Vec<(
+        &schnorrsig::PublicKey,
+        &[u8; 32],
+        &schnorrsig::PublicKey,
+        bool,
+    )> {
+        batch
+            .iter()
+            .map(|&(ref i, ref t, ref o, p)| (i, t, o, p))
+            .collect()
+    }
+
+    #[test]
+    fn verify_batch_with_and_without_scratch_space() {
+        let batch = random_batch(50);
+        let mut scratch = ScratchSpace::new(1 << 20);
+
+        assert_eq!(
+            verify_tweak_add_batch(SECP256K1, None, &as_refs(&batch)),
+            Ok(())
+        );
+        assert_eq!(
+            verify_tweak_add_batch(SECP256K1, Some(&mut scratch), &as_refs(&batch)),
+            Ok(())
+        );
+        assert_eq!(verify_tweak_add_batch(SECP256K1, None, &[]), Ok(()));
+    }
+
+    #[test]
+    fn verify_batch_reports_first_invalid_check() {
+        let batch = random_batch(20);
+        let mut scratch = ScratchSpace::new(1 << 20);
+        let mut refs = as_refs(&batch);
+
+        // Wrong tweak and wrong parity
+        refs[7].1 = &batch[8].1;
+        refs[12].3 = !refs[12].3;
+
+        assert_eq!(
+            verify_tweak_add_batch(SECP256K1, Some(&mut scratch), &refs),
+            Err(7)
+        );
+        assert_eq!(verify_tweak_add_batch(SECP256K1, None, &refs[8..]), Err(4));
+    }
+}
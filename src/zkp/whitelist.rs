@@ -136,6 +136,32 @@ impl WhitelistSignature {
         Ok(())
     }
 
+    /// Verify the given whitelist signature against a precomputed PAK list and whitelist key.
+    ///
+    /// Equivalent to [`WhitelistSignature::verify`] with the keys the [`WhitelistKeySet`] was
+    /// created from, but without parsing and serializing them again.
+    #[cfg(feature = "std")]
+    pub fn verify_with_keyset<C: Verification>(
+        &self,
+        secp: &Secp256k1<C>,
+        keyset: &WhitelistKeySet,
+        whitelist_key: &PublicKey,
+    ) -> Result<(), Error> {
+        let ret = unsafe {
+            ffi::secp256k1_whitelist_verify_keyset(
+                *secp.ctx(),
+                &self.0,
+                &*keyset.0,
+                whitelist_key.as_c_ptr(),
+            )
+        };
+        if ret != 1 {
+            return Err(Error::InvalidWhitelistProof);
+        }
+
+        Ok(())
+    }
+
     /// Obtains a raw const pointer suitable for use with FFI functions
     #[inline]
     pub fn as_ptr(&self) -> *const ffi::WhitelistSignature {
@@ -149,6 +175,53 @@ impl WhitelistSignature {
     }
 }
 
+/// A PAK list prepared for verifying many whitelist signatures.
+///
+/// Creating the key set parses the online and offline keys and serializes them once, so that
+/// [`WhitelistSignature::verify_with_keyset`] only does the work that depends on the
+/// whitelisted key.
+#[cfg(feature = "std")]
+#[derive(Clone)]
+pub struct WhitelistKeySet(Box<ffi::WhitelistKeySet>);
+
+#[cfg(feature = "std")]
+impl WhitelistKeySet {
+    /// Create a new key set from the given PAK list.
+    pub fn new<C: Verification>(
+        secp: &Secp256k1<C>,
+        online_keys: &[PublicKey],
+        offline_keys: &[PublicKey],
+    ) -> Result<WhitelistKeySet, Error> {
+        if online_keys.len() != offline_keys.len() || online_keys.len() > ffi::WHITELIST_MAX_N_KEYS
+        {
+            return Err(Error::InvalidPakList);
+        }
+        let n_keys = online_keys.len();
+
+        let mut keyset = Box::new(ffi::WhitelistKeySet::default());
+        let ret = unsafe {
+            ffi::secp256k1_whitelist_keyset_create(
+                *secp.ctx(),
+                &mut *keyset,
+                // These two casts are legit because PublicKey has repr(transparent).
+                online_keys.as_c_ptr() as *const secp256k1::secp256k1_sys::PublicKey,
+                offline_keys.as_c_ptr() as *const secp256k1::secp256k1_sys::PublicKey,
+                n_keys,
+            )
+        };
+        if ret != 1 {
+            return Err(Error::InvalidPakList);
+        }
+
+        Ok(WhitelistKeySet(keyset))
+    }
+
+    /// Number of keys in the key set.
+    pub fn n_keys(&self) -> usize {
+        self.0.n_keys as usize
+    }
+}
+
 #[cfg(feature = "std")]
 impl fmt::LowerHex for WhitelistSignature {
     fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
@@ -265,6 +338,12 @@ mod tests {
                 .verify(SECP256K1, &pak_online, &pak_offline, &whitelist_pk)
                 .unwrap();
 
+            let keyset = WhitelistKeySet::new(SECP256K1, &pak_online, &pak_offline).unwrap();
+            assert_eq!(n_keys, keyset.n_keys());
+            signature
+                .verify_with_keyset(SECP256K1, &keyset, &whitelist_pk)
+                .unwrap();
+
             // round trip
 
             let encoded = signature.serialize();
@@ -364,6 +443,20 @@ mod tests {
             );
         }
 
+        {
+            // wrong pak in key set
+            assert_eq!(
+                Err(Error::InvalidPakList),
+                WhitelistKeySet::new(SECP256K1, &pak_online, &pak_offline[1..])
+                    .map(|keyset| keyset.n_keys()),
+            );
+            let keyset = WhitelistKeySet::new(SECP256K1, &pak_offline, &pak_online).unwrap();
+            assert_eq!(
+                Err(Error::InvalidWhitelistProof),
+                correct_signature.verify_with_keyset(SECP256K1, &keyset, &whitelist_pk),
+            );
+        }
+
         {
             // verify for online pubkey
             assert_eq!(